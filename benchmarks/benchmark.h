@@ -0,0 +1,238 @@
+/**
+ * @file benchmark.h
+ * @brief Minimal microbenchmark registry and timing loop.
+ *
+ * Benchmarks are declared with @code WLIB_BENCHMARK @endcode and
+ * receive a state object whose @code keep_running @endcode loop is
+ * repeated until the measurement is long enough to be stable. Each
+ * benchmark is run once for every argument in its argument list.
+ *
+ * Benchmarks run on the host only and may use the C++ standard
+ * library for comparisons.
+ *
+ * Allocations made through @code mem::alloc @endcode and through
+ * @code operator new @endcode while the loop runs are counted, so that
+ * wlib containers and their standard counterparts are measured alike.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_BENCHMARK_H
+#define EMBEDDEDCPLUSPLUS_BENCHMARK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <initializer_list>
+#include <vector>
+
+namespace wlp {
+    namespace bench {
+
+        typedef uint64_t nanos_t;
+
+        /**
+         * @return monotonic time in nanoseconds
+         */
+        inline nanos_t now() {
+            timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<nanos_t>(ts.tv_sec) * 1000000000ull + static_cast<nanos_t>(ts.tv_nsec);
+        }
+
+        /**
+         * Prevent the compiler from discarding a computed value.
+         */
+        template<typename T>
+        inline void do_not_optimize(const T &val) {
+            asm volatile("" : : "g"(&val) : "memory");
+        }
+
+        /**
+         * Prevent the compiler from caching memory across this point.
+         */
+        inline void clobber_memory() {
+            asm volatile("" : : : "memory");
+        }
+
+        /**
+         * Heap counters, fed by the allocation functions of main.cpp.
+         * Updated atomically since benchmarks may allocate from
+         * several threads.
+         */
+        struct heap_counters {
+            size_t allocations;
+            size_t live_bytes;
+            size_t peak_bytes;
+        };
+
+        inline heap_counters &heap() {
+            static heap_counters counters = {0, 0, 0};
+            return counters;
+        }
+
+        inline void record_alloc(size_t bytes) {
+            heap_counters &h = heap();
+            __atomic_add_fetch(&h.allocations, 1, __ATOMIC_RELAXED);
+            size_t live = __atomic_add_fetch(&h.live_bytes, bytes, __ATOMIC_RELAXED);
+            size_t peak = __atomic_load_n(&h.peak_bytes, __ATOMIC_RELAXED);
+            while (live > peak &&
+                   !__atomic_compare_exchange_n(&h.peak_bytes, &peak, live, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+        }
+
+        inline void record_free(size_t bytes) {
+            __atomic_sub_fetch(&heap().live_bytes, bytes, __ATOMIC_RELAXED);
+        }
+
+        /**
+         * Per-run benchmark state. The timer starts on the first call
+         * to @code keep_running @endcode and stops once the requested
+         * number of iterations has completed.
+         */
+        class state {
+        public:
+            state(size_t arg, size_t iterations)
+                : m_arg(arg),
+                  m_iterations(iterations),
+                  m_done(0),
+                  m_items(1),
+                  m_start(0),
+                  m_elapsed(0),
+                  m_paused_at(0),
+                  m_allocs_at_start(0),
+                  m_live_at_start(0),
+                  m_allocations(0),
+                  m_peak_bytes(0) {}
+
+            /**
+             * @return the argument this run was parameterised with,
+             * usually the problem size
+             */
+            size_t arg() const {
+                return m_arg;
+            }
+
+            size_t iterations() const {
+                return m_iterations;
+            }
+
+            bool keep_running() {
+                if (m_done == 0 && m_start == 0) {
+                    heap_counters &h = heap();
+                    m_allocs_at_start = __atomic_load_n(&h.allocations, __ATOMIC_RELAXED);
+                    m_live_at_start = __atomic_load_n(&h.live_bytes, __ATOMIC_RELAXED);
+                    __atomic_store_n(&h.peak_bytes, m_live_at_start, __ATOMIC_RELAXED);
+                    m_start = now();
+                }
+                if (m_done == m_iterations) {
+                    m_elapsed += now() - m_start;
+                    heap_counters &h = heap();
+                    m_allocations = __atomic_load_n(&h.allocations, __ATOMIC_RELAXED) - m_allocs_at_start;
+                    size_t peak = __atomic_load_n(&h.peak_bytes, __ATOMIC_RELAXED);
+                    m_peak_bytes = peak > m_live_at_start ? peak - m_live_at_start : 0;
+                    return false;
+                }
+                ++m_done;
+                return true;
+            }
+
+            /**
+             * Stop the timer while setting up data inside the loop.
+             */
+            void pause_timing() {
+                m_paused_at = now();
+            }
+
+            void resume_timing() {
+                m_start += now() - m_paused_at;
+            }
+
+            /**
+             * Declare how many operations one iteration performs,
+             * so results are reported per operation.
+             */
+            void set_items_per_iteration(size_t items) {
+                m_items = items;
+            }
+
+            size_t items_per_iteration() const {
+                return m_items;
+            }
+
+            nanos_t elapsed() const {
+                return m_elapsed;
+            }
+
+            /**
+             * @return number of heap allocations made inside the loop
+             */
+            size_t allocations() const {
+                return m_allocations;
+            }
+
+            /**
+             * @return the most heap memory held at once inside the loop,
+             *         beyond what was held when it started
+             */
+            size_t peak_bytes() const {
+                return m_peak_bytes;
+            }
+
+        private:
+            size_t m_arg;
+            size_t m_iterations;
+            size_t m_done;
+            size_t m_items;
+            nanos_t m_start;
+            nanos_t m_elapsed;
+            nanos_t m_paused_at;
+            size_t m_allocs_at_start;
+            size_t m_live_at_start;
+            size_t m_allocations;
+            size_t m_peak_bytes;
+        };
+
+        typedef void (*function)(state &);
+
+        struct entry {
+            const char *group;
+            const char *name;
+            function fn;
+            std::vector<size_t> args;
+        };
+
+        inline std::vector<entry> &registry() {
+            static std::vector<entry> entries;
+            return entries;
+        }
+
+        struct registrar {
+            registrar(const char *group, const char *name, function fn, std::initializer_list<size_t> args) {
+                entry e;
+                e.group = group;
+                e.name = name;
+                e.fn = fn;
+                e.args.assign(args.begin(), args.end());
+                if (e.args.empty()) {
+                    e.args.push_back(0);
+                }
+                registry().push_back(e);
+            }
+        };
+
+    }
+}
+
+/**
+ * Declare and register a benchmark. The trailing arguments list
+ * the values passed to @code state::arg @endcode, one run each.
+ */
+#define WLIB_BENCHMARK(group, name, ...) \
+    static void __bench_##group##_##name(::wlp::bench::state &); \
+    static ::wlp::bench::registrar __bench_reg_##group##_##name( \
+        #group, #name, __bench_##group##_##name, {__VA_ARGS__}); \
+    static void __bench_##group##_##name(::wlp::bench::state &state)
+
+#endif //EMBEDDEDCPLUSPLUS_BENCHMARK_H
@@ -0,0 +1,541 @@
+/**
+ * @file compare.cpp
+ * @brief Compares two benchmark result files and reports regressions.
+ *
+ * Usage: benchmark_compare [--threshold=percent] [--alpha=p] base new
+ *
+ * The files are written by the benchmark runner with --json or --csv.
+ * A benchmark has regressed when its median time grew by more than the
+ * threshold, widened to twice the relative spread of either run, and
+ * a Mann-Whitney U test over the repetitions finds the difference
+ * significant at the given level. Benchmarks with a single repetition
+ * in either file are judged by the threshold alone, as are those with
+ * too few repetitions for the test to ever reach the level, with a
+ * warning. An increase of the allocations per operation beyond the
+ * threshold is also a regression.
+ *
+ * Exits with 0 if nothing regressed, 1 if something did and 2 if the
+ * files could not be read.
+ *
+ * @bug No known bugs
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "results.h"
+
+using namespace wlp::bench;
+
+namespace {
+
+    struct run {
+        context ctx;
+        std::vector<result> results;
+
+        const result *find(const std::string &name) const {
+            for (const result &r : results) {
+                if (r.name == name) {
+                    return &r;
+                }
+            }
+            return nullptr;
+        }
+
+        std::string get(const char *key) const {
+            for (const std::pair<std::string, std::string> &kv : ctx) {
+                if (kv.first == key) {
+                    return kv.second;
+                }
+            }
+            return std::string();
+        }
+    };
+
+    /**
+     * Reader of the JSON written by the runner. Values other than
+     * the ones it looks for are skipped, whatever their type.
+     */
+    class json_reader {
+    public:
+        explicit json_reader(const char *text)
+                : m_p(text) {}
+
+        bool read(run &out) {
+            if (!expect('{')) {
+                return false;
+            }
+            return members([&](const std::string &key) {
+                if (key == "context") {
+                    return read_context(out.ctx);
+                }
+                if (key == "benchmarks") {
+                    return read_benchmarks(out.results);
+                }
+                return skip();
+            });
+        }
+
+    private:
+        void space() {
+            while (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t') {
+                ++m_p;
+            }
+        }
+
+        bool expect(char c) {
+            space();
+            if (*m_p != c) {
+                return false;
+            }
+            ++m_p;
+            return true;
+        }
+
+        bool peek(char c) {
+            space();
+            return *m_p == c;
+        }
+
+        /**
+         * Read the members of an object whose brace has been read,
+         * calling a reader for each value.
+         */
+        template<typename Reader>
+        bool members(Reader reader) {
+            if (expect('}')) {
+                return true;
+            }
+            do {
+                std::string key;
+                if (!string(key) || !expect(':') || !reader(key)) {
+                    return false;
+                }
+            } while (expect(','));
+            return expect('}');
+        }
+
+        bool string(std::string &out) {
+            if (!expect('"')) {
+                return false;
+            }
+            out.clear();
+            while (*m_p && *m_p != '"') {
+                if (*m_p == '\\') {
+                    ++m_p;
+                    if (*m_p == 'u') {
+                        char *end;
+                        char hex[5] = {0};
+                        strncpy(hex, m_p + 1, 4);
+                        out.push_back(static_cast<char>(strtol(hex, &end, 16)));
+                        m_p += 4;
+                    } else if (*m_p == 'n') {
+                        out.push_back('\n');
+                    } else if (*m_p == 't') {
+                        out.push_back('\t');
+                    } else if (*m_p) {
+                        out.push_back(*m_p);
+                    } else {
+                        return false;
+                    }
+                } else {
+                    out.push_back(*m_p);
+                }
+                ++m_p;
+            }
+            return expect('"');
+        }
+
+        bool number(double &out) {
+            space();
+            char *end;
+            out = strtod(m_p, &end);
+            if (end == m_p) {
+                return false;
+            }
+            m_p = end;
+            return true;
+        }
+
+        bool skip() {
+            std::string str;
+            double num;
+            if (peek('"')) {
+                return string(str);
+            }
+            if (expect('{')) {
+                return members([&](const std::string &) { return skip(); });
+            }
+            if (expect('[')) {
+                if (expect(']')) {
+                    return true;
+                }
+                do {
+                    if (!skip()) {
+                        return false;
+                    }
+                } while (expect(','));
+                return expect(']');
+            }
+            for (const char *word : {"true", "false", "null"}) {
+                size_t len = strlen(word);
+                if (strncmp(m_p, word, len) == 0) {
+                    m_p += len;
+                    return true;
+                }
+            }
+            return number(num);
+        }
+
+        bool read_context(context &ctx) {
+            if (!expect('{')) {
+                return false;
+            }
+            return members([&](const std::string &key) {
+                std::string val;
+                if (!peek('"')) {
+                    return skip();
+                }
+                if (!string(val)) {
+                    return false;
+                }
+                ctx.emplace_back(key, val);
+                return true;
+            });
+        }
+
+        bool read_benchmarks(std::vector<result> &results) {
+            if (!expect('[')) {
+                return false;
+            }
+            if (expect(']')) {
+                return true;
+            }
+            do {
+                result r;
+                r.iterations = 0;
+                std::vector<double> ns;
+                double allocs = 0;
+                double peak = 0;
+                if (!expect('{')) {
+                    return false;
+                }
+                bool ok = members([&](const std::string &key) {
+                    double num;
+                    if (key == "name") {
+                        return string(r.name);
+                    }
+                    if (key == "iterations") {
+                        bool read = number(num);
+                        r.iterations = static_cast<size_t>(num);
+                        return read;
+                    }
+                    if (key == "allocs_per_op") {
+                        return number(allocs);
+                    }
+                    if (key == "peak_bytes") {
+                        return number(peak);
+                    }
+                    if (key == "samples_ns") {
+                        if (!expect('[')) {
+                            return false;
+                        }
+                        if (expect(']')) {
+                            return true;
+                        }
+                        do {
+                            if (!number(num)) {
+                                return false;
+                            }
+                            ns.push_back(num);
+                        } while (expect(','));
+                        return expect(']');
+                    }
+                    return skip();
+                });
+                if (!ok) {
+                    return false;
+                }
+                for (double x : ns) {
+                    sample s = {x, allocs, static_cast<size_t>(peak)};
+                    r.samples.push_back(s);
+                }
+                results.push_back(r);
+            } while (expect(','));
+            return expect(']');
+        }
+
+        const char *m_p;
+    };
+
+    bool read_csv(const std::string &text, run &out) {
+        size_t pos = 0;
+        bool header = false;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            std::string line = text.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+            pos = end == std::string::npos ? text.size() : end + 1;
+            if (line.empty()) {
+                continue;
+            }
+            if (line[0] == '#') {
+                size_t eq = line.find('=');
+                if (eq != std::string::npos) {
+                    out.ctx.emplace_back(line.substr(2, eq - 2), line.substr(eq + 1));
+                }
+                continue;
+            }
+            if (!header) {
+                header = true;
+                continue;
+            }
+            char name[256];
+            size_t repetition;
+            size_t iterations;
+            sample s;
+            if (sscanf(line.c_str(), "%255[^,],%zu,%zu,%lf,%lf,%zu", name, &repetition, &iterations,
+                       &s.ns_per_op, &s.allocs_per_op, &s.peak_bytes) != 6) {
+                return false;
+            }
+            if (out.results.empty() || out.results.back().name != name) {
+                result r;
+                r.name = name;
+                r.iterations = iterations;
+                out.results.push_back(r);
+            }
+            out.results.back().samples.push_back(s);
+        }
+        return header;
+    }
+
+    bool load(const char *path, run &out) {
+        FILE *file = fopen(path, "r");
+        if (!file) {
+            return false;
+        }
+        std::string text;
+        char buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+            text.append(buf, n);
+        }
+        fclose(file);
+        size_t first = text.find_first_not_of(" \t\r\n");
+        if (first != std::string::npos && text[first] == '{') {
+            return json_reader(text.c_str()).read(out);
+        }
+        return read_csv(text, out);
+    }
+
+    /**
+     * Largest total of both samples for which the exact distribution
+     * of the rank sum is computed.
+     */
+    const size_t exact_limit = 40;
+
+    /**
+     * Two-sided Mann-Whitney U test. Small samples use the exact
+     * distribution of the rank sum given the ties; larger ones the
+     * normal approximation corrected for ties and continuity.
+     *
+     * @return the p-value of the samples coming from one distribution
+     */
+    double mann_whitney(const std::vector<double> &a, const std::vector<double> &b) {
+        std::vector<std::pair<double, int>> all;
+        for (double x : a) {
+            all.emplace_back(x, 0);
+        }
+        for (double x : b) {
+            all.emplace_back(x, 1);
+        }
+        std::sort(all.begin(), all.end());
+        size_t n1 = a.size();
+        size_t n = all.size();
+        // ranks are doubled so that midranks of ties are integers
+        std::vector<size_t> ranks(n);
+        size_t rank_sum = 0;
+        double ties = 0;
+        for (size_t i = 0; i < n;) {
+            size_t j = i;
+            while (j < n && all[j].first == all[i].first) {
+                ++j;
+            }
+            double t = static_cast<double>(j - i);
+            ties += t * t * t - t;
+            for (size_t k = i; k < j; ++k) {
+                ranks[k] = i + j + 1;
+                if (all[k].second == 0) {
+                    rank_sum += i + j + 1;
+                }
+            }
+            i = j;
+        }
+        if (n <= exact_limit) {
+            // ways[k][s]: subsets of k ranks whose doubled sum is s
+            size_t max_sum = n * (n + 1);
+            std::vector<std::vector<double>> ways(n1 + 1, std::vector<double>(max_sum + 1, 0));
+            ways[0][0] = 1;
+            for (size_t r : ranks) {
+                for (size_t k = n1; k > 0; --k) {
+                    for (size_t sum = max_sum; sum >= r; --sum) {
+                        ways[k][sum] += ways[k - 1][sum - r];
+                    }
+                }
+            }
+            double total = 0;
+            double below = 0;
+            double above = 0;
+            for (size_t sum = 0; sum <= max_sum; ++sum) {
+                total += ways[n1][sum];
+                if (sum <= rank_sum) {
+                    below += ways[n1][sum];
+                }
+                if (sum >= rank_sum) {
+                    above += ways[n1][sum];
+                }
+            }
+            return std::min(1.0, 2 * std::min(below, above) / total);
+        }
+        double dn1 = static_cast<double>(n1);
+        double dn2 = static_cast<double>(b.size());
+        double dn = dn1 + dn2;
+        double u = static_cast<double>(rank_sum) / 2 - dn1 * (dn1 + 1) / 2;
+        double mu = dn1 * dn2 / 2;
+        double sigma = sqrt(dn1 * dn2 / 12 * ((dn + 1) - ties / (dn * (dn - 1))));
+        if (sigma == 0) {
+            return 1;
+        }
+        double z = (fabs(u - mu) - 0.5) / sigma;
+        return z > 0 ? erfc(z / sqrt(2.0)) : 1;
+    }
+
+    /**
+     * @return true if the U test of samples of these sizes cannot
+     *         reach the level even when they do not overlap at all
+     */
+    bool underpowered(size_t n1, size_t n2, double alpha) {
+        double orderings = 1;
+        for (size_t k = 1; k <= n2; ++k) {
+            orderings = orderings * static_cast<double>(n1 + k) / static_cast<double>(k);
+        }
+        return 2 / orderings >= alpha;
+    }
+
+    /**
+     * @return the spread of the samples relative to their median
+     */
+    double noise(const std::vector<double> &v) {
+        double m = median(v);
+        return m > 0 ? mad(v) / m : 0;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    double threshold = 5;
+    double alpha = 0.05;
+    const char *paths[2] = {nullptr, nullptr};
+    int npaths = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--threshold=", 12) == 0) {
+            threshold = atof(argv[i] + 12);
+        } else if (strncmp(argv[i], "--alpha=", 8) == 0) {
+            alpha = atof(argv[i] + 8);
+        } else if (argv[i][0] != '-' && npaths < 2) {
+            paths[npaths++] = argv[i];
+        } else {
+            npaths = 0;
+            break;
+        }
+    }
+    if (npaths != 2) {
+        fprintf(stderr, "usage: %s [--threshold=percent] [--alpha=p] base new\n", argv[0]);
+        return 2;
+    }
+    run base;
+    run next;
+    for (int i = 0; i < 2; ++i) {
+        if (!load(paths[i], i ? next : base)) {
+            fprintf(stderr, "cannot read benchmark results from %s\n", paths[i]);
+            return 2;
+        }
+    }
+    for (const char *key : {"revision", "date", "cpu", "compiler", "flags"}) {
+        std::string a = base.get(key);
+        std::string b = next.get(key);
+        if (!a.empty() || !b.empty()) {
+            printf("%-10s %s -> %s%s\n", key, a.c_str(), b.c_str(),
+                   a != b && (strcmp(key, "cpu") == 0 || strcmp(key, "flags") == 0)
+                   ? "  (differs)" : "");
+        }
+    }
+    printf("\n%-48s %12s %12s %9s %9s %9s  %s\n",
+           "benchmark", "base ns/op", "new ns/op", "change %", "noise %", "p", "verdict");
+    size_t regressions = 0;
+    size_t untested = 0;
+    for (const result &b : base.results) {
+        const result *n = next.find(b.name);
+        if (!n) {
+            printf("%-48s %12s\n", b.name.c_str(), "missing");
+            continue;
+        }
+        std::vector<double> xs = b.ns_per_op();
+        std::vector<double> ys = n->ns_per_op();
+        double before = median(xs);
+        double after = median(ys);
+        double change = before > 0 ? 100 * (after - before) / before : 0;
+        double spread = 100 * 2 * std::max(noise(xs), noise(ys));
+        double limit = std::max(threshold, spread);
+        bool repeated = xs.size() > 1 && ys.size() > 1;
+        double p = repeated ? mann_whitney(xs, ys) : 1;
+        bool weak = repeated && underpowered(xs.size(), ys.size(), alpha);
+        if (weak) {
+            ++untested;
+        }
+        bool significant = !repeated || weak || p < alpha;
+        double allocs_before = b.allocs_per_op();
+        double allocs_after = n->allocs_per_op();
+        const char *verdict = "";
+        if (change > limit && significant) {
+            verdict = "REGRESSION";
+        } else if (change < -limit && significant) {
+            verdict = "improved";
+        }
+        bool allocs_regressed = allocs_after - allocs_before > 0.001 &&
+                                allocs_after > allocs_before * (1 + threshold / 100);
+        if (*verdict == 'R' || allocs_regressed) {
+            ++regressions;
+        }
+        char pbuf[16];
+        if (repeated) {
+            snprintf(pbuf, sizeof(pbuf), weak ? "%.4f*" : "%.4f", p);
+        } else {
+            snprintf(pbuf, sizeof(pbuf), "-");
+        }
+        printf("%-48s %12.3f %12.3f %+9.2f %9.2f %9s  %s%s", b.name.c_str(), before, after,
+               change, spread, pbuf, verdict, allocs_regressed && *verdict ? ", " : "");
+        if (allocs_regressed) {
+            printf("ALLOCS %.3f -> %.3f", allocs_before, allocs_after);
+        }
+        printf("\n");
+    }
+    for (const result &n : next.results) {
+        if (!base.find(n.name)) {
+            printf("%-48s %12s\n", n.name.c_str(), "new");
+        }
+    }
+    if (untested) {
+        printf("\n* too few repetitions for the U test to reach p < %g; "
+               "%zu benchmark%s judged by the threshold alone\n",
+               alpha, untested, untested == 1 ? "" : "s");
+        fprintf(stderr, "warning: %zu benchmark%s underpowered, use more repetitions\n",
+                untested, untested == 1 ? " is" : "s are");
+    }
+    printf("\n%zu regression%s\n", regressions, regressions == 1 ? "" : "s");
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,317 @@
+/**
+ * @file footprint.cpp
+ * @brief Reports the memory used per element by each map container.
+ *
+ * Usage: container_footprint [--key=u16|u32|u64|str] [--val=u8|u32|u64|b32]
+ *                            [--sizes=n,n,...]
+ *
+ * Each container is filled with the given number of distinct keys and
+ * the heap memory it holds is divided by its size, together with the
+ * container object itself. The load is the share of the slots or
+ * capacity in use after inserting. Memory is counted three ways:
+ *
+ * - requested, the bytes asked of @code mem::alloc @endcode, which
+ *   include the nodes, bucket arrays and spare capacity at the load
+ *   reached by inserting, and the alignment headers of the allocator;
+ * - malloc, the blocks the host malloc hands out, with their headers;
+ * - tlsf, the blocks the TLSF pool of the embedded build would hand
+ *   out, with eight byte alignment, a one word header and a minimum
+ *   block size of three words.
+ *
+ * String keys are @code dynamic_string @endcode, whose characters are
+ * counted too; @code b32 @endcode values are 32 byte records.
+ *
+ * @bug No known bugs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/HashMap.h>
+#include <wlib/stl/OpenMap.h>
+#include <wlib/stl/TreeMap.h>
+#include <wlib/stl/Tuple.h>
+#include <wlib/strings/String.h>
+
+using namespace wlp;
+
+namespace {
+
+    struct heap_usage {
+        size_t allocations;
+        size_t requested;
+        size_t malloc_bytes;
+        size_t tlsf_bytes;
+    };
+
+    heap_usage usage = {0, 0, 0, 0};
+
+    /**
+     * Requested size of each live block.
+     */
+    std::unordered_map<void *, size_t> &blocks() {
+        static std::unordered_map<void *, size_t> sizes;
+        return sizes;
+    }
+
+    size_t malloc_block(void *ptr, size_t bytes) {
+#ifdef __GLIBC__
+        (void) bytes;
+        return malloc_usable_size(ptr) + sizeof(size_t);
+#else
+        (void) ptr;
+        return bytes + 2 * sizeof(size_t);
+#endif
+    }
+
+    size_t tlsf_block(size_t bytes) {
+        constexpr size_t align = 8;
+        constexpr size_t min_block = 3 * sizeof(void *);
+        size_t size = (bytes + align - 1) & ~(align - 1);
+        return (size < min_block ? min_block : size) + sizeof(size_t);
+    }
+
+    void track(void *ptr, size_t bytes) {
+        blocks()[ptr] = bytes;
+        ++usage.allocations;
+        usage.requested += bytes;
+        usage.malloc_bytes += malloc_block(ptr, bytes);
+        usage.tlsf_bytes += tlsf_block(bytes);
+    }
+
+    void untrack(void *ptr) {
+        std::unordered_map<void *, size_t>::iterator it = blocks().find(ptr);
+        size_t bytes = it->second;
+        --usage.allocations;
+        usage.requested -= bytes;
+        usage.malloc_bytes -= malloc_block(ptr, bytes);
+        usage.tlsf_bytes -= tlsf_block(bytes);
+        blocks().erase(it);
+    }
+
+}
+
+namespace wlp {
+    namespace mem {
+        void *alloc(size_t bytes) {
+            void *ptr = ::malloc(bytes);
+            if (ptr) {
+                track(ptr, bytes);
+            }
+            return ptr;
+        }
+
+        void free(void *ptr) {
+            if (ptr) {
+                untrack(ptr);
+                ::free(ptr);
+            }
+        }
+
+        void *realloc(void *ptr, size_t bytes) {
+            if (!ptr) {
+                return alloc(bytes);
+            }
+            size_t old_bytes = blocks()[ptr];
+            untrack(ptr);
+            void *moved = ::realloc(ptr, bytes);
+            if (moved) {
+                track(moved, bytes);
+            } else {
+                track(ptr, old_bytes);
+            }
+            return moved;
+        }
+    }
+}
+
+namespace {
+
+    struct record32 {
+        uint8_t bytes[32];
+    };
+
+    template<typename Key>
+    struct key_maker {
+        static Key make(size_t i) {
+            return static_cast<Key>(i);
+        }
+    };
+
+    template<>
+    struct key_maker<dynamic_string> {
+        static dynamic_string make(size_t i) {
+            return dynamic_string(("key" + std::to_string(i)).c_str());
+        }
+    };
+
+    template<typename Val>
+    Val make_val(size_t i) {
+        return static_cast<Val>(i);
+    }
+
+    template<>
+    record32 make_val<record32>(size_t i) {
+        record32 r;
+        memset(r.bytes, static_cast<int>(i), sizeof(r.bytes));
+        return r;
+    }
+
+    template<typename Key, typename Val>
+    struct fill_hash_map {
+        typedef hash_map<Key, Val> container;
+        static const char *name() { return "hash_map"; }
+        static void insert(container &c, size_t i) {
+            c.insert(key_maker<Key>::make(i), make_val<Val>(i));
+        }
+        static size_t capacity(const container &c) {
+            return c.capacity();
+        }
+    };
+
+    template<typename Key, typename Val>
+    struct fill_open_map {
+        typedef open_map<Key, Val> container;
+        static const char *name() { return "open_map"; }
+        static void insert(container &c, size_t i) {
+            c.insert(key_maker<Key>::make(i), make_val<Val>(i));
+        }
+        static size_t capacity(const container &c) {
+            return c.capacity();
+        }
+    };
+
+    template<typename Key, typename Val>
+    struct fill_tree_map {
+        typedef tree_map<Key, Val> container;
+        static const char *name() { return "tree_map"; }
+        static void insert(container &c, size_t i) {
+            c.insert(key_maker<Key>::make(i), make_val<Val>(i));
+        }
+        static size_t capacity(const container &) {
+            return 0;
+        }
+    };
+
+    template<typename Key, typename Val>
+    struct fill_array_list {
+        typedef array_list<tuple<Key, Val>> container;
+        static const char *name() { return "array_list<tuple>"; }
+        static void insert(container &c, size_t i) {
+            c.push_back(make_tuple(key_maker<Key>::make(i), make_val<Val>(i)));
+        }
+        static size_t capacity(const container &c) {
+            return c.capacity();
+        }
+    };
+
+    template<typename Fill>
+    void measure(size_t n) {
+        heap_usage before = usage;
+        heap_usage held;
+        size_t capacity;
+        {
+            typename Fill::container c;
+            for (size_t i = 0; i < n; ++i) {
+                Fill::insert(c, i);
+            }
+            held = usage;
+            capacity = Fill::capacity(c);
+        }
+        double self = static_cast<double>(sizeof(typename Fill::container));
+        double count = static_cast<double>(n);
+        char load[16] = "-";
+        if (capacity) {
+            snprintf(load, sizeof(load), "%zu", 100 * n / capacity);
+        }
+        printf("%-20s %8zu %8s %12.1f %12.1f %12.1f %10zu\n", Fill::name(), n, load,
+               (static_cast<double>(held.requested - before.requested) + self) / count,
+               (static_cast<double>(held.malloc_bytes - before.malloc_bytes) + self) / count,
+               (static_cast<double>(held.tlsf_bytes - before.tlsf_bytes) + self) / count,
+               held.allocations - before.allocations);
+    }
+
+    template<typename Key, typename Val>
+    void report(const char *key, const char *val, const std::vector<size_t> &sizes) {
+        printf("key %s, value %s\n", key, val);
+        printf("%-20s %8s %8s %12s %12s %12s %10s\n", "container", "elements", "load %",
+               "requested", "malloc", "tlsf", "blocks");
+        for (size_t n : sizes) {
+            measure<fill_hash_map<Key, Val>>(n);
+            measure<fill_open_map<Key, Val>>(n);
+            measure<fill_tree_map<Key, Val>>(n);
+            measure<fill_array_list<Key, Val>>(n);
+        }
+    }
+
+    template<typename Key>
+    bool report_val(const char *key, const std::string &val, const std::vector<size_t> &sizes) {
+        if (val == "u8") {
+            report<Key, uint8_t>(key, "uint8_t", sizes);
+        } else if (val == "u32") {
+            report<Key, uint32_t>(key, "uint32_t", sizes);
+        } else if (val == "u64") {
+            report<Key, uint64_t>(key, "uint64_t", sizes);
+        } else if (val == "b32") {
+            report<Key, record32>(key, "32 byte record", sizes);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    std::string key = "u32";
+    std::string val = "u32";
+    std::vector<size_t> sizes = {10, 100, 1000, 10000};
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--key=", 6) == 0) {
+            key = argv[i] + 6;
+        } else if (strncmp(argv[i], "--val=", 6) == 0) {
+            val = argv[i] + 6;
+        } else if (strncmp(argv[i], "--sizes=", 8) == 0) {
+            sizes.clear();
+            for (char *p = argv[i] + 8; *p;) {
+                char *end;
+                unsigned long n = strtoul(p, &end, 10);
+                if (end == p || n == 0) {
+                    break;
+                }
+                sizes.push_back(n);
+                p = *end == ',' ? end + 1 : end;
+            }
+        } else {
+            key.clear();
+        }
+    }
+    if (key == "u16") {
+        for (size_t n : sizes) {
+            if (n > 65536) {
+                fprintf(stderr, "u16 keys allow at most 65536 elements\n");
+                return 1;
+            }
+        }
+    }
+    bool ok = !sizes.empty() &&
+              ((key == "u16" && report_val<uint16_t>("uint16_t", val, sizes)) ||
+               (key == "u32" && report_val<uint32_t>("uint32_t", val, sizes)) ||
+               (key == "u64" && report_val<uint64_t>("uint64_t", val, sizes)) ||
+               (key == "str" && report_val<dynamic_string>("dynamic_string", val, sizes)));
+    if (!ok) {
+        fprintf(stderr, "usage: %s [--key=u16|u32|u64|str] [--val=u8|u32|u64|b32]"
+                        " [--sizes=n,n,...]\n", argv[0]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,352 @@
+/**
+ * @file hash_quality.cpp
+ * @brief Measures the quality and speed of the hash functions.
+ *
+ * Usage: hash_quality [--keys=n]
+ *
+ * Every hasher is run over the key sets of its key type, sequential
+ * and strided integers or random and common-prefix strings, and the
+ * table reports for each
+ *
+ * - chi2/df, the chi-square statistic of the hash codes modulo the
+ *   bucket count of a hash map holding the keys, divided by its degrees
+ *   of freedom; near 1 for a uniform spread, far above when keys pile
+ *   up in few buckets;
+ * - avalanche, the mean distance from one half of the chance that an
+ *   output bit flips when one input bit flips, scaled to 0 for a
+ *   perfect mix and 1 for none;
+ * - the longest chain walked in a @code hash_map @endcode and the
+ *   longest probe sequence in an @code open_map @endcode while inserting
+ *   and finding every key, read from the container statistics;
+ * - throughput in megabytes of keys hashed per second.
+ *
+ * To measure a new hasher, add a line for it to @code main @endcode.
+ *
+ * @bug No known bugs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <wlib/stl/HashMap.h>
+#include <wlib/stl/OpenMap.h>
+#include <wlib/strings/String.h>
+
+#include "benchmark.h"
+
+#ifndef WLIB_CONTAINER_STATS
+#error "hash_quality reads chain lengths from the container statistics"
+#endif
+
+using namespace wlp;
+
+namespace wlp {
+    namespace mem {
+        void *alloc(size_t bytes)
+        { return ::malloc(bytes); }
+        void free(void *ptr)
+        { ::free(ptr); }
+        void *realloc(void *ptr, size_t bytes)
+        { return ::realloc(ptr, bytes); }
+    }
+}
+
+namespace {
+
+    typedef std::vector<uint32_t> int_keys;
+    typedef std::vector<std::string> string_keys;
+
+    /**
+     * Number of keys flipped bit by bit for the avalanche score.
+     */
+    constexpr size_t avalanche_keys = 1000;
+    /**
+     * Only the first bytes of string keys are flipped.
+     */
+    constexpr size_t avalanche_bytes = 8;
+
+    uint32_t next_random(uint32_t &state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    int_keys sequential_ints(size_t n) {
+        int_keys keys;
+        for (uint32_t i = 0; i < n; ++i) {
+            keys.push_back(i);
+        }
+        return keys;
+    }
+
+    int_keys strided_ints(size_t n, uint32_t stride) {
+        int_keys keys;
+        for (uint32_t i = 0; i < n; ++i) {
+            keys.push_back(i * stride);
+        }
+        return keys;
+    }
+
+    string_keys random_strings(size_t n) {
+        static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+        uint32_t state = 0x9e3779b9u;
+        string_keys keys;
+        for (size_t i = 0; i < n; ++i) {
+            size_t len = 6 + next_random(state) % 15;
+            std::string key;
+            for (size_t c = 0; c < len; ++c) {
+                key.push_back(alphabet[next_random(state) % (sizeof(alphabet) - 1)]);
+            }
+            keys.push_back(key);
+        }
+        return keys;
+    }
+
+    string_keys prefix_strings(size_t n) {
+        string_keys keys;
+        for (size_t i = 0; i < n; ++i) {
+            keys.push_back("device/sensor/" + std::to_string(i));
+        }
+        return keys;
+    }
+
+    /**
+     * Conversion of the generated keys to the key type of a hasher.
+     * String keys point into the generated strings.
+     */
+    template<typename Key>
+    struct key_maker;
+
+    template<>
+    struct key_maker<uint32_t> {
+        static uint32_t make(uint32_t key) {
+            return key;
+        }
+    };
+
+    template<>
+    struct key_maker<const char *> {
+        static const char *make(const std::string &key) {
+            return key.c_str();
+        }
+    };
+
+    template<>
+    struct key_maker<dynamic_string> {
+        static dynamic_string make(const std::string &key) {
+            return dynamic_string(key.c_str());
+        }
+    };
+
+    template<size_t tSize>
+    struct key_maker<static_string<tSize>> {
+        static static_string<tSize> make(const std::string &key) {
+            return static_string<tSize>(key.c_str());
+        }
+    };
+
+    size_t input_bits(uint32_t) {
+        return 32;
+    }
+
+    size_t input_bits(const std::string &key) {
+        return 8 * (key.size() < avalanche_bytes ? key.size() : avalanche_bytes);
+    }
+
+    /**
+     * Flip one bit of a key.
+     *
+     * @return false if the flipped key is not a valid key, which is
+     *         a string with a null character
+     */
+    bool flip(uint32_t &key, size_t bit) {
+        key ^= static_cast<uint32_t>(1) << bit;
+        return true;
+    }
+
+    bool flip(std::string &key, size_t bit) {
+        key[bit / 8] = static_cast<char>(key[bit / 8] ^ (1 << (bit % 8)));
+        return key[bit / 8] != '\0';
+    }
+
+    size_t key_bytes(uint32_t) {
+        return sizeof(uint32_t);
+    }
+
+    size_t key_bytes(const std::string &key) {
+        return key.size();
+    }
+
+    struct quality {
+        size_t buckets;
+        double chi2_df;
+        double avalanche;
+        size_t max_chain;
+        size_t max_probe;
+        double mb_per_sec;
+    };
+
+    template<typename Hasher, typename Key, typename Source>
+    double chi_square(const std::vector<Source> &sources, size_t buckets) {
+        Hasher hasher;
+        std::vector<size_t> counts(buckets, 0);
+        for (const Source &s : sources) {
+            ++counts[hasher(key_maker<Key>::make(s)) % buckets];
+        }
+        double expected = static_cast<double>(sources.size()) / static_cast<double>(buckets);
+        double chi2 = 0;
+        for (size_t c : counts) {
+            double d = static_cast<double>(c) - expected;
+            chi2 += d * d / expected;
+        }
+        return buckets > 1 ? chi2 / static_cast<double>(buckets - 1) : 0;
+    }
+
+    template<typename Hasher, typename Key, typename Source>
+    double avalanche(const std::vector<Source> &sources) {
+        typedef decltype(Hasher()(key_maker<Key>::make(sources[0]))) code_type;
+        constexpr size_t out_bits = 8 * sizeof(code_type);
+        constexpr size_t in_bits = 8 * avalanche_bytes > 32 ? 8 * avalanche_bytes : 32;
+        Hasher hasher;
+        std::vector<size_t> flips(in_bits * out_bits, 0);
+        std::vector<size_t> trials(in_bits, 0);
+        size_t n = sources.size() < avalanche_keys ? sources.size() : avalanche_keys;
+        for (size_t k = 0; k < n; ++k) {
+            code_type h = hasher(key_maker<Key>::make(sources[k]));
+            for (size_t i = 0; i < input_bits(sources[k]); ++i) {
+                Source flipped = sources[k];
+                if (!flip(flipped, i)) {
+                    continue;
+                }
+                code_type diff = static_cast<code_type>(h ^ hasher(key_maker<Key>::make(flipped)));
+                ++trials[i];
+                for (size_t j = 0; j < out_bits; ++j) {
+                    flips[i * out_bits + j] += (diff >> j) & 1;
+                }
+            }
+        }
+        double bias = 0;
+        size_t cells = 0;
+        for (size_t i = 0; i < in_bits; ++i) {
+            if (!trials[i]) {
+                continue;
+            }
+            for (size_t j = 0; j < out_bits; ++j) {
+                double p = static_cast<double>(flips[i * out_bits + j]) / static_cast<double>(trials[i]);
+                bias += 2 * (p > 0.5 ? p - 0.5 : 0.5 - p);
+                ++cells;
+            }
+        }
+        return cells ? bias / static_cast<double>(cells) : 0;
+    }
+
+    template<typename Hasher, typename Key, typename Source>
+    double throughput(const std::vector<Source> &sources) {
+        std::vector<Key> keys;
+        size_t bytes = 0;
+        for (const Source &s : sources) {
+            keys.push_back(key_maker<Key>::make(s));
+            bytes += key_bytes(s);
+        }
+        Hasher hasher;
+        size_t rounds = 0;
+        bench::nanos_t start = bench::now();
+        bench::nanos_t elapsed;
+        do {
+            for (const Key &key : keys) {
+                bench::do_not_optimize(hasher(key));
+            }
+            ++rounds;
+            elapsed = bench::now() - start;
+        } while (elapsed < 50000000ull);
+        return static_cast<double>(bytes * rounds) * 1000 / static_cast<double>(elapsed);
+    }
+
+    template<typename Hasher, typename Key, typename Source>
+    quality measure(const std::vector<Source> &sources) {
+        quality q;
+        hash_map<Key, uint32_t, Hasher> chained;
+        open_map<Key, uint32_t, Hasher> open;
+        uint32_t i = 0;
+        for (const Source &s : sources) {
+            chained.insert(key_maker<Key>::make(s), i);
+            open.insert(key_maker<Key>::make(s), i);
+            ++i;
+        }
+        for (const Source &s : sources) {
+            bench::do_not_optimize(chained.find(key_maker<Key>::make(s)));
+            bench::do_not_optimize(open.find(key_maker<Key>::make(s)));
+        }
+        q.buckets = chained.capacity();
+        q.max_chain = chained.stats().max_probe();
+        q.max_probe = open.stats().max_probe();
+        q.chi2_df = chi_square<Hasher, Key>(sources, q.buckets);
+        q.avalanche = avalanche<Hasher, Key>(sources);
+        q.mb_per_sec = throughput<Hasher, Key>(sources);
+        return q;
+    }
+
+    template<typename Hasher, typename Key, typename Source>
+    void report(const char *hasher, const char *keys, const std::vector<Source> &sources) {
+        quality q = measure<Hasher, Key>(sources);
+        printf("%-34s %-18s %8zu %10.2f %10.3f %8zu %8zu %10.1f\n", hasher, keys, q.buckets,
+               q.chi2_df, q.avalanche, q.max_chain, q.max_probe, q.mb_per_sec);
+        fflush(stdout);
+    }
+
+    struct key_sets {
+        int_keys sequential;
+        int_keys strided_16;
+        int_keys strided_1024;
+        string_keys random;
+        string_keys prefix;
+    };
+
+    template<typename Hasher>
+    void run_ints(const char *hasher, const key_sets &sets) {
+        report<Hasher, uint32_t>(hasher, "sequential", sets.sequential);
+        report<Hasher, uint32_t>(hasher, "stride 16", sets.strided_16);
+        report<Hasher, uint32_t>(hasher, "stride 1024", sets.strided_1024);
+    }
+
+    template<typename Hasher, typename Key>
+    void run_strings(const char *hasher, const key_sets &sets) {
+        report<Hasher, Key>(hasher, "random strings", sets.random);
+        report<Hasher, Key>(hasher, "common prefix", sets.prefix);
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = 10000;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--keys=", 7) == 0 && atol(argv[i] + 7) > 0) {
+            n = static_cast<size_t>(atol(argv[i] + 7));
+        } else {
+            fprintf(stderr, "usage: %s [--keys=n]\n", argv[0]);
+            return 1;
+        }
+    }
+    key_sets sets;
+    sets.sequential = sequential_ints(n);
+    sets.strided_16 = strided_ints(n, 16);
+    sets.strided_1024 = strided_ints(n, 1024);
+    sets.random = random_strings(n);
+    sets.prefix = prefix_strings(n);
+
+    printf("%-34s %-18s %8s %10s %10s %8s %8s %10s\n", "hasher", "keys", "buckets",
+           "chi2/df", "avalanche", "chain", "probe", "MB/s");
+    run_ints<hash<uint32_t, uint16_t>>("hash<uint32_t, uint16_t>", sets);
+    run_ints<hash<uint32_t, uint32_t>>("hash<uint32_t, uint32_t>", sets);
+    run_strings<hash<const char *, uint16_t>, const char *>("hash<const char *, uint16_t>", sets);
+    run_strings<hash<const char *, uint32_t>, const char *>("hash<const char *, uint32_t>", sets);
+    run_strings<hash<dynamic_string, uint32_t>, dynamic_string>("hash<dynamic_string, uint32_t>", sets);
+    run_strings<hash<static_string<32>, uint16_t>, static_string<32>>("hash<static_string<32>, uint16_t>", sets);
+    run_strings<hash<static_string<32>, uint32_t>, static_string<32>>("hash<static_string<32>, uint32_t>", sets);
+    return 0;
+}
@@ -0,0 +1,340 @@
+/**
+ * @file main.cpp
+ * @brief Runs every registered benchmark and prints a table.
+ *
+ * Usage: benchmarks [--filter=substring] [--min-time=milliseconds]
+ *                   [--repetitions=n] [--json=path] [--csv=path]
+ *
+ * Each benchmark is calibrated until one run lasts the minimum time,
+ * then repeated with the same iteration count; the table shows the
+ * median of the repetitions and their coefficient of variation. The
+ * JSON and CSV files keep every repetition together with a description
+ * of the machine and build, for @code benchmark_compare @endcode.
+ *
+ * Both the wlib memory functions and the global operator new are
+ * routed through counting wrappers around malloc, which keep the size
+ * of each block in a header so that frees can be accounted for.
+ *
+ * @bug No known bugs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+
+#include <new>
+#include <string>
+
+#include "benchmark.h"
+#include "results.h"
+
+namespace {
+
+    /**
+     * Size of the header before each counted block, which keeps
+     * blocks aligned for any fundamental type.
+     */
+    constexpr size_t header_size = alignof(max_align_t);
+
+    void *counted_alloc(size_t bytes) {
+        char *raw = static_cast<char *>(::malloc(bytes + header_size));
+        if (!raw) {
+            return nullptr;
+        }
+        *reinterpret_cast<size_t *>(raw) = bytes;
+        wlp::bench::record_alloc(bytes);
+        return raw + header_size;
+    }
+
+    void counted_free(void *ptr) {
+        if (!ptr) {
+            return;
+        }
+        char *raw = static_cast<char *>(ptr) - header_size;
+        wlp::bench::record_free(*reinterpret_cast<size_t *>(raw));
+        ::free(raw);
+    }
+
+    void *counted_realloc(void *ptr, size_t bytes) {
+        if (!ptr) {
+            return counted_alloc(bytes);
+        }
+        char *raw = static_cast<char *>(ptr) - header_size;
+        size_t old_bytes = *reinterpret_cast<size_t *>(raw);
+        char *moved = static_cast<char *>(::realloc(raw, bytes + header_size));
+        if (!moved) {
+            return nullptr;
+        }
+        *reinterpret_cast<size_t *>(moved) = bytes;
+        wlp::bench::record_free(old_bytes);
+        wlp::bench::record_alloc(bytes);
+        return moved + header_size;
+    }
+
+    /**
+     * Benchmarks may be built without exceptions, so operator new
+     * aborts instead of throwing when memory runs out.
+     */
+    void *counted_new(size_t bytes) {
+        void *ptr = counted_alloc(bytes > 0 ? bytes : 1);
+        if (!ptr) {
+            abort();
+        }
+        return ptr;
+    }
+
+}
+
+namespace wlp {
+    namespace mem {
+        void *alloc(size_t bytes)
+        { return counted_alloc(bytes); }
+        void free(void *ptr)
+        { counted_free(ptr); }
+        void *realloc(void *ptr, size_t bytes)
+        { return counted_realloc(ptr, bytes); }
+    }
+}
+
+void *operator new(size_t bytes)
+{ return counted_new(bytes); }
+void *operator new[](size_t bytes)
+{ return counted_new(bytes); }
+void *operator new(size_t bytes, const std::nothrow_t &) noexcept
+{ return counted_alloc(bytes > 0 ? bytes : 1); }
+void *operator new[](size_t bytes, const std::nothrow_t &) noexcept
+{ return counted_alloc(bytes > 0 ? bytes : 1); }
+void operator delete(void *ptr) noexcept
+{ counted_free(ptr); }
+void operator delete[](void *ptr) noexcept
+{ counted_free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{ counted_free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{ counted_free(ptr); }
+
+using namespace wlp::bench;
+
+namespace {
+
+    /**
+     * @return the first line of a file, without the newline, or an
+     *         empty string if it cannot be read
+     */
+    std::string read_line(const char *path, const char *prefix = "") {
+        FILE *file = fopen(path, "r");
+        if (!file) {
+            return std::string();
+        }
+        char line[256];
+        std::string found;
+        size_t len = strlen(prefix);
+        while (fgets(line, sizeof(line), file)) {
+            if (strncmp(line, prefix, len) == 0) {
+                found = line + len;
+                break;
+            }
+        }
+        fclose(file);
+        while (!found.empty() && (found.back() == '\n' || found.back() == ' ' ||
+                                  found.back() == '\t')) {
+            found.pop_back();
+        }
+        size_t start = found.find_first_not_of(" \t:");
+        return start == std::string::npos ? std::string() : found.substr(start);
+    }
+
+    context describe(size_t repetitions, nanos_t min_time) {
+        context ctx;
+        char buf[256];
+        time_t t = time(nullptr);
+        strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", gmtime(&t));
+        ctx.emplace_back("date", buf);
+        if (gethostname(buf, sizeof(buf)) == 0) {
+            buf[sizeof(buf) - 1] = '\0';
+            ctx.emplace_back("host", buf);
+        }
+        utsname uts;
+        if (uname(&uts) == 0) {
+            ctx.emplace_back("os", std::string(uts.sysname) + " " + uts.release);
+            ctx.emplace_back("machine", uts.machine);
+        }
+        ctx.emplace_back("cpu", read_line("/proc/cpuinfo", "model name"));
+        ctx.emplace_back("cpus", std::to_string(sysconf(_SC_NPROCESSORS_ONLN)));
+        ctx.emplace_back("governor", read_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor"));
+#if defined(__clang__)
+        ctx.emplace_back("compiler", std::string("clang ") + __VERSION__);
+#elif defined(__GNUC__)
+        ctx.emplace_back("compiler", std::string("gcc ") + __VERSION__);
+#endif
+#ifdef WLIB_BENCHMARK_FLAGS
+        ctx.emplace_back("flags", WLIB_BENCHMARK_FLAGS);
+#endif
+#ifdef WLIB_BENCHMARK_REVISION
+        ctx.emplace_back("revision", WLIB_BENCHMARK_REVISION);
+#endif
+        ctx.emplace_back("repetitions", std::to_string(repetitions));
+        ctx.emplace_back("min_time_ms", std::to_string(min_time / 1000000ull));
+        return ctx;
+    }
+
+    void write_json_string(FILE *out, const std::string &str) {
+        fputc('"', out);
+        for (char c : str) {
+            if (c == '"' || c == '\\') {
+                fprintf(out, "\\%c", c);
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                fprintf(out, "\\u%04x", static_cast<unsigned>(c));
+            } else {
+                fputc(c, out);
+            }
+        }
+        fputc('"', out);
+    }
+
+    bool write_json(const char *path, const context &ctx, const std::vector<result> &results) {
+        FILE *out = fopen(path, "w");
+        if (!out) {
+            return false;
+        }
+        fprintf(out, "{\n  \"context\": {");
+        for (size_t i = 0; i < ctx.size(); ++i) {
+            fprintf(out, "%s\n    ", i ? "," : "");
+            write_json_string(out, ctx[i].first);
+            fprintf(out, ": ");
+            write_json_string(out, ctx[i].second);
+        }
+        fprintf(out, "\n  },\n  \"benchmarks\": [");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const result &r = results[i];
+            std::vector<double> ns = r.ns_per_op();
+            fprintf(out, "%s\n    {\n      \"name\": ", i ? "," : "");
+            write_json_string(out, r.name);
+            fprintf(out, ",\n      \"iterations\": %zu,\n", r.iterations);
+            fprintf(out, "      \"median_ns\": %.3f,\n", median(ns));
+            fprintf(out, "      \"mean_ns\": %.3f,\n", mean(ns));
+            fprintf(out, "      \"stddev_ns\": %.3f,\n", stddev(ns));
+            fprintf(out, "      \"min_ns\": %.3f,\n", min_of(ns));
+            fprintf(out, "      \"samples_ns\": [");
+            for (size_t j = 0; j < ns.size(); ++j) {
+                fprintf(out, "%s%.3f", j ? ", " : "", ns[j]);
+            }
+            fprintf(out, "],\n      \"allocs_per_op\": %.6f,\n", r.allocs_per_op());
+            fprintf(out, "      \"peak_bytes\": %zu\n    }", r.peak_bytes());
+        }
+        fprintf(out, "\n  ]\n}\n");
+        return fclose(out) == 0;
+    }
+
+    /**
+     * One row per repetition, preceded by the context as comment lines.
+     */
+    bool write_csv(const char *path, const context &ctx, const std::vector<result> &results) {
+        FILE *out = fopen(path, "w");
+        if (!out) {
+            return false;
+        }
+        for (const std::pair<std::string, std::string> &kv : ctx) {
+            fprintf(out, "# %s=%s\n", kv.first.c_str(), kv.second.c_str());
+        }
+        fprintf(out, "name,repetition,iterations,ns_per_op,allocs_per_op,peak_bytes\n");
+        for (const result &r : results) {
+            for (size_t j = 0; j < r.samples.size(); ++j) {
+                const sample &s = r.samples[j];
+                fprintf(out, "%s,%zu,%zu,%.3f,%.6f,%zu\n", r.name.c_str(), j, r.iterations,
+                        s.ns_per_op, s.allocs_per_op, s.peak_bytes);
+            }
+        }
+        return fclose(out) == 0;
+    }
+
+    sample measure(const entry &e, size_t arg, size_t iterations, nanos_t &elapsed) {
+        state s(arg, iterations);
+        e.fn(s);
+        elapsed = s.elapsed();
+        double ops = static_cast<double>(iterations * s.items_per_iteration());
+        sample m;
+        m.ns_per_op = static_cast<double>(s.elapsed()) / ops;
+        m.allocs_per_op = static_cast<double>(s.allocations()) / ops;
+        m.peak_bytes = s.peak_bytes();
+        return m;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    const char *filter = "";
+    nanos_t min_time = 200000000ull;
+    size_t repetitions = 1;
+    const char *json_path = nullptr;
+    const char *csv_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        } else if (strncmp(argv[i], "--min-time=", 11) == 0) {
+            min_time = static_cast<nanos_t>(atol(argv[i] + 11)) * 1000000ull;
+        } else if (strncmp(argv[i], "--repetitions=", 14) == 0 && atol(argv[i] + 14) > 0) {
+            repetitions = static_cast<size_t>(atol(argv[i] + 14));
+        } else if (strncmp(argv[i], "--json=", 7) == 0) {
+            json_path = argv[i] + 7;
+        } else if (strncmp(argv[i], "--csv=", 6) == 0) {
+            csv_path = argv[i] + 6;
+        } else {
+            fprintf(stderr, "usage: %s [--filter=substring] [--min-time=ms] [--repetitions=n]"
+                            " [--json=path] [--csv=path]\n", argv[0]);
+            return 1;
+        }
+    }
+    std::vector<result> results;
+    printf("%-48s %12s %14s %8s %12s %12s\n",
+           "benchmark", "iterations", "ns/op", "cv %", "allocs/op", "peak bytes");
+    for (const entry &e : registry()) {
+        for (size_t arg : e.args) {
+            std::string name = std::string(e.group) + "/" + e.name + "/" + std::to_string(arg);
+            if (!strstr(name.c_str(), filter)) {
+                continue;
+            }
+            result r;
+            r.name = name;
+            size_t iterations = 1;
+            for (;;) {
+                nanos_t elapsed;
+                sample m = measure(e, arg, iterations, elapsed);
+                if (elapsed >= min_time || iterations >= (static_cast<size_t>(1) << 40)) {
+                    r.samples.push_back(m);
+                    break;
+                }
+                size_t next = elapsed > 0
+                              ? static_cast<size_t>(static_cast<double>(iterations) * 1.4 *
+                                                    static_cast<double>(min_time) /
+                                                    static_cast<double>(elapsed))
+                              : iterations * 10;
+                iterations = next > iterations ? next : iterations + 1;
+            }
+            r.iterations = iterations;
+            while (r.samples.size() < repetitions) {
+                nanos_t elapsed;
+                r.samples.push_back(measure(e, arg, iterations, elapsed));
+            }
+            std::vector<double> ns = r.ns_per_op();
+            double med = median(ns);
+            printf("%-48s %12zu %14.3f %8.2f %12.3f %12zu\n", name.c_str(), iterations, med,
+                   med > 0 ? 100 * stddev(ns) / mean(ns) : 0.0, r.allocs_per_op(), r.peak_bytes());
+            fflush(stdout);
+            results.push_back(r);
+        }
+    }
+    context ctx = describe(repetitions, min_time);
+    if (json_path && !write_json(json_path, ctx, results)) {
+        fprintf(stderr, "cannot write %s\n", json_path);
+        return 1;
+    }
+    if (csv_path && !write_csv(csv_path, ctx, results)) {
+        fprintf(stderr, "cannot write %s\n", csv_path);
+        return 1;
+    }
+    return 0;
+}
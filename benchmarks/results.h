@@ -0,0 +1,124 @@
+/**
+ * @file results.h
+ * @brief Benchmark results and the statistics shared by the runner
+ * and the comparison tool.
+ *
+ * A benchmark is measured once per repetition, each repetition using
+ * the iteration count calibrated by the first one, so that the spread
+ * of the samples reflects the noise of the machine.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_BENCHMARK_RESULTS_H
+#define EMBEDDEDCPLUSPLUS_BENCHMARK_RESULTS_H
+
+#include <math.h>
+#include <stddef.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wlp {
+    namespace bench {
+
+        /**
+         * Measurement of one repetition.
+         */
+        struct sample {
+            double ns_per_op;
+            double allocs_per_op;
+            size_t peak_bytes;
+        };
+
+        struct result {
+            std::string name;
+            size_t iterations;
+            std::vector<sample> samples;
+
+            std::vector<double> ns_per_op() const {
+                std::vector<double> ns;
+                for (const sample &s : samples) {
+                    ns.push_back(s.ns_per_op);
+                }
+                return ns;
+            }
+
+            double allocs_per_op() const {
+                double sum = 0;
+                for (const sample &s : samples) {
+                    sum += s.allocs_per_op;
+                }
+                return samples.empty() ? 0 : sum / static_cast<double>(samples.size());
+            }
+
+            size_t peak_bytes() const {
+                size_t peak = 0;
+                for (const sample &s : samples) {
+                    peak = s.peak_bytes > peak ? s.peak_bytes : peak;
+                }
+                return peak;
+            }
+        };
+
+        /**
+         * Name and value pairs describing the machine and build.
+         */
+        typedef std::vector<std::pair<std::string, std::string>> context;
+
+        inline double mean(const std::vector<double> &v) {
+            double sum = 0;
+            for (double x : v) {
+                sum += x;
+            }
+            return v.empty() ? 0 : sum / static_cast<double>(v.size());
+        }
+
+        /**
+         * @return the sample standard deviation, zero for fewer
+         *         than two values
+         */
+        inline double stddev(const std::vector<double> &v) {
+            if (v.size() < 2) {
+                return 0;
+            }
+            double m = mean(v);
+            double sum = 0;
+            for (double x : v) {
+                sum += (x - m) * (x - m);
+            }
+            return sqrt(sum / static_cast<double>(v.size() - 1));
+        }
+
+        inline double median(std::vector<double> v) {
+            if (v.empty()) {
+                return 0;
+            }
+            std::sort(v.begin(), v.end());
+            size_t n = v.size();
+            return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+        }
+
+        /**
+         * @return the median absolute deviation, scaled to estimate
+         *         the standard deviation of normally distributed values
+         */
+        inline double mad(const std::vector<double> &v) {
+            double m = median(v);
+            std::vector<double> dev;
+            for (double x : v) {
+                dev.push_back(fabs(x - m));
+            }
+            return 1.4826 * median(dev);
+        }
+
+        inline double min_of(const std::vector<double> &v) {
+            return v.empty() ? 0 : *std::min_element(v.begin(), v.end());
+        }
+
+    }
+}
+
+#endif //EMBEDDEDCPLUSPLUS_BENCHMARK_RESULTS_H
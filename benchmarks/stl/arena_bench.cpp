@@ -0,0 +1,45 @@
+#include <wlib/stl/Arena.h>
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/HashMap.h>
+#include <wlib/strings/String.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * The temporaries of one control-loop tick: a list of samples, a map
+ * of readings by channel and a formatted status line. Items are ticks.
+ */
+template<typename Alloc>
+static int tick(size_t samples, const Alloc &alloc) {
+    array_list<int, Alloc> list(8, alloc);
+    hash_map<int, int, hash<int, uint16_t>, equals<int>, Alloc> readings(16, 75, alloc);
+    basic_dynamic_string<Alloc> status("status:", alloc);
+    for (size_t i = 0; i < samples; ++i) {
+        int v = static_cast<int>(i);
+        list.push_back(v);
+        readings[v & 31] = v;
+    }
+    for (int c = 0; c < 4; ++c) {
+        status += " ok";
+    }
+    return list[samples - 1] + readings[0] + static_cast<int>(status.length());
+}
+
+WLIB_BENCHMARK(arena, tick_global, 16, 64, 256) {
+    size_t samples = state.arg();
+    while (state.keep_running()) {
+        do_not_optimize(tick(samples, allocator()));
+    }
+}
+
+WLIB_BENCHMARK(arena, tick_arena, 16, 64, 256) {
+    size_t samples = state.arg();
+    inline_arena<4096> a;
+    while (state.keep_running()) {
+        arena_scope scope(a);
+        do_not_optimize(tick(samples, arena_allocator(a)));
+    }
+}
@@ -0,0 +1,192 @@
+#include <wlib/stl/Array2DKernels.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+typedef array2d<float> matrix;
+
+static void fill_matrix(matrix &m) {
+    for (size_t i = 0; i < m.x(); ++i) {
+        for (size_t j = 0; j < m.y(); ++j) {
+            m(i, j) = static_cast<float>((i * 31 + j * 17) % 13) * 0.25f;
+        }
+    }
+}
+
+WLIB_BENCHMARK(array2d, transpose_naive, 256, 1024, 4096) {
+    size_t n = state.arg();
+    matrix src(n, n);
+    matrix dst(n, n);
+    fill_matrix(src);
+    state.set_items_per_iteration(n * n);
+    while (state.keep_running()) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                dst[j][i] = src[i][j];
+            }
+        }
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(array2d, transpose_blocked, 256, 1024, 4096) {
+    size_t n = state.arg();
+    matrix src(n, n);
+    matrix dst(n, n);
+    fill_matrix(src);
+    state.set_items_per_iteration(n * n);
+    while (state.keep_running()) {
+        transpose(src, dst);
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(array2d, multiply_naive, 256, 512, 1024) {
+    size_t n = state.arg();
+    matrix a(n, n);
+    matrix b(n, n);
+    matrix c(n, n);
+    fill_matrix(a);
+    fill_matrix(b);
+    state.set_items_per_iteration(n * n * n);
+    while (state.keep_running()) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                float sum = 0;
+                for (size_t k = 0; k < n; ++k) {
+                    sum += a[i][k] * b[k][j];
+                }
+                c[i][j] = sum;
+            }
+        }
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(array2d, multiply_blocked, 256, 512, 1024) {
+    size_t n = state.arg();
+    matrix a(n, n);
+    matrix b(n, n);
+    matrix c(n, n);
+    fill_matrix(a);
+    fill_matrix(b);
+    state.set_items_per_iteration(n * n * n);
+    while (state.keep_running()) {
+        multiply(a, b, c);
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(array2d, add_naive, 256, 1024, 4096) {
+    size_t n = state.arg();
+    matrix a(n, n);
+    matrix b(n, n);
+    matrix c(n, n);
+    fill_matrix(a);
+    fill_matrix(b);
+    state.set_items_per_iteration(n * n);
+    while (state.keep_running()) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                c[i][j] = a[i][j] + b[i][j];
+            }
+        }
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(array2d, add_simd, 256, 1024, 4096) {
+    size_t n = state.arg();
+    matrix a(n, n);
+    matrix b(n, n);
+    matrix c(n, n);
+    fill_matrix(a);
+    fill_matrix(b);
+    state.set_items_per_iteration(n * n);
+    while (state.keep_running()) {
+        add(a, b, c);
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(array2d, convolve3x3_naive, 256, 1024, 4096) {
+    size_t n = state.arg();
+    matrix src(n, n);
+    matrix kernel(3, 3);
+    matrix dst(n, n);
+    fill_matrix(src);
+    fill_matrix(kernel);
+    state.set_items_per_iteration(n * n);
+    while (state.keep_running()) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                float sum = 0;
+                for (size_t u = 0; u < 3; ++u) {
+                    for (size_t v = 0; v < 3; ++v) {
+                        size_t si = i + 1 - u;
+                        size_t sj = j + 1 - v;
+                        if (si < n && sj < n) {
+                            sum += kernel[u][v] * src[si][sj];
+                        }
+                    }
+                }
+                dst[i][j] = sum;
+            }
+        }
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(array2d, convolve3x3_simd, 256, 1024, 4096) {
+    size_t n = state.arg();
+    matrix src(n, n);
+    matrix kernel(3, 3);
+    matrix dst(n, n);
+    fill_matrix(src);
+    fill_matrix(kernel);
+    state.set_items_per_iteration(n * n);
+    while (state.keep_running()) {
+        convolve(src, kernel, dst);
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(array2d, box5x5_naive, 256, 1024, 4096) {
+    size_t n = state.arg();
+    matrix src(n, n);
+    matrix dst(n, n);
+    fill_matrix(src);
+    state.set_items_per_iteration(n * n);
+    while (state.keep_running()) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                float sum = 0;
+                for (size_t u = 0; u < 5; ++u) {
+                    for (size_t v = 0; v < 5; ++v) {
+                        size_t si = i + u - 2;
+                        size_t sj = j + v - 2;
+                        if (si < n && sj < n) {
+                            sum += src[si][sj];
+                        }
+                    }
+                }
+                dst[i][j] = sum / 25.0f;
+            }
+        }
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(array2d, box5x5_running_sum, 256, 1024, 4096) {
+    size_t n = state.arg();
+    matrix src(n, n);
+    matrix dst(n, n);
+    fill_matrix(src);
+    state.set_items_per_iteration(n * n);
+    while (state.keep_running()) {
+        box_filter(src, static_cast<size_t>(2), dst);
+        clobber_memory();
+    }
+}
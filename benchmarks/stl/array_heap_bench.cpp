@@ -0,0 +1,39 @@
+#include <queue>
+#include <vector>
+
+#include <wlib/stl/ArrayHeap.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Push the given number of scrambled priorities and pop them all.
+ * Items are elements.
+ */
+template<typename Heap>
+static void push_pop(state &state) {
+    uint32_t n = static_cast<uint32_t>(state.arg());
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        Heap heap;
+        for (uint32_t i = 0; i < n; ++i) {
+            heap.push(i * 2654435761u);
+        }
+        uint32_t last = 0;
+        while (!heap.empty()) {
+            last ^= heap.top();
+            heap.pop();
+        }
+        do_not_optimize(last);
+    }
+}
+
+WLIB_BENCHMARK(heap, array_heap_u32, 16, 1024, 65536) {
+    push_pop<array_heap<uint32_t>>(state);
+}
+
+WLIB_BENCHMARK(heap, std_priority_queue_u32, 16, 1024, 65536) {
+    push_pop<std::priority_queue<uint32_t>>(state);
+}
@@ -0,0 +1,99 @@
+#include <vector>
+
+#include <wlib/stl/ArrayList.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Element larger than a cache line's worth of pointers, to show the
+ * cost of copying on growth.
+ */
+struct blob {
+    uint32_t words[16];
+
+    blob() : words() {}
+
+    explicit blob(uint32_t v) : words() {
+        words[0] = v;
+    }
+
+    uint32_t key() const {
+        return words[0];
+    }
+};
+
+static uint32_t key_of(uint32_t v) {
+    return v;
+}
+
+static uint32_t key_of(const blob &b) {
+    return b.key();
+}
+
+/**
+ * Append the given number of elements to an empty list, then sum them
+ * by index. Items are elements.
+ */
+template<typename List, typename T>
+static void append_and_sum(state &state) {
+    uint32_t n = static_cast<uint32_t>(state.arg());
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        List list;
+        for (uint32_t i = 0; i < n; ++i) {
+            list.push_back(T(i));
+        }
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < n; ++i) {
+            sum += key_of(list[i]);
+        }
+        do_not_optimize(sum);
+    }
+}
+
+WLIB_BENCHMARK(list_append, array_list_u32, 16, 1024, 65536) {
+    append_and_sum<array_list<uint32_t>, uint32_t>(state);
+}
+
+WLIB_BENCHMARK(list_append, std_vector_u32, 16, 1024, 65536) {
+    append_and_sum<std::vector<uint32_t>, uint32_t>(state);
+}
+
+WLIB_BENCHMARK(list_append, array_list_blob, 16, 1024, 65536) {
+    append_and_sum<array_list<blob>, blob>(state);
+}
+
+WLIB_BENCHMARK(list_append, std_vector_blob, 16, 1024, 65536) {
+    append_and_sum<std::vector<blob>, blob>(state);
+}
+
+/**
+ * Iterate a filled list. Items are elements.
+ */
+template<typename List>
+static void iterate(state &state) {
+    uint32_t n = static_cast<uint32_t>(state.arg());
+    state.set_items_per_iteration(n);
+    List list;
+    for (uint32_t i = 0; i < n; ++i) {
+        list.push_back(i);
+    }
+    while (state.keep_running()) {
+        uint32_t sum = 0;
+        for (auto it = list.begin(); it != list.end(); ++it) {
+            sum += *it;
+        }
+        do_not_optimize(sum);
+    }
+}
+
+WLIB_BENCHMARK(list_iterate, array_list_u32, 1024, 65536) {
+    iterate<array_list<uint32_t>>(state);
+}
+
+WLIB_BENCHMARK(list_iterate, std_vector_u32, 1024, 65536) {
+    iterate<std::vector<uint32_t>>(state);
+}
@@ -0,0 +1,107 @@
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <wlib/stl/AtomicSharedPtr.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+struct config {
+    int gain;
+    int limit;
+
+    config(int v) : gain(v), limit(v) {}
+};
+
+typedef atomic_count<uint32_t> policy;
+typedef shared_ptr<config, policy> config_ptr;
+
+/**
+ * Baseline: a shared pointer guarded by a mutex, which readers must
+ * hold while copying.
+ */
+class locked_config {
+public:
+    explicit locked_config(config_ptr c)
+        : m_config(move(c)) {}
+
+    config_ptr load() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_config;
+    }
+
+    void store(config_ptr c) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_config = move(c);
+    }
+
+private:
+    std::mutex m_mutex;
+    config_ptr m_config;
+};
+
+/**
+ * Each of the given number of reader threads takes a batch of
+ * snapshots while one writer publishes a new version after every
+ * few hundred reads. Items are reader loads.
+ */
+template<typename holder_t>
+static void readers_under_updates(state &state) {
+    const size_t batch = 20000;
+    size_t readers = state.arg();
+    holder_t holder(make_shared<config, policy>(0));
+    state.set_items_per_iteration(readers * batch);
+    while (state.keep_running()) {
+        int done = 0;
+        std::thread writer([&holder, &done]() {
+            int v = 0;
+            while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+                holder.store(make_shared<config, policy>(++v));
+                std::this_thread::yield();
+            }
+        });
+        std::vector<std::thread> workers;
+        for (size_t r = 0; r < readers; ++r) {
+            workers.push_back(std::thread([&holder]() {
+                int sum = 0;
+                for (size_t i = 0; i < batch; ++i) {
+                    config_ptr c = holder.load();
+                    sum += c->gain + c->limit;
+                }
+                do_not_optimize(sum);
+            }));
+        }
+        for (std::thread &w : workers) {
+            w.join();
+        }
+        __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+        writer.join();
+    }
+}
+
+WLIB_BENCHMARK(atomic_shared_ptr, load_uncontended, 1) {
+    atomic_shared_ptr<config, policy> ap(make_shared<config, policy>(1));
+    while (state.keep_running()) {
+        config_ptr c = ap.load();
+        do_not_optimize(c);
+    }
+}
+
+WLIB_BENCHMARK(atomic_shared_ptr, load_locked_uncontended, 1) {
+    locked_config lc(make_shared<config, policy>(1));
+    while (state.keep_running()) {
+        config_ptr c = lc.load();
+        do_not_optimize(c);
+    }
+}
+
+WLIB_BENCHMARK(atomic_shared_ptr, readers_under_updates, 1, 2, 4, 8) {
+    readers_under_updates<atomic_shared_ptr<config, policy>>(state);
+}
+
+WLIB_BENCHMARK(atomic_shared_ptr, readers_under_updates_locked, 1, 2, 4, 8) {
+    readers_under_updates<locked_config>(state);
+}
@@ -0,0 +1,47 @@
+#include <bitset>
+
+#include <wlib/stl/Bitset.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Set, flip and test a scattered sequence of bits. Items are bit
+ * operations.
+ */
+template<typename Bits, uint16_t nBits>
+static void set_flip_test(state &state) {
+    state.set_items_per_iteration(3 * nBits);
+    Bits bits;
+    while (state.keep_running()) {
+        for (uint16_t i = 0; i < nBits; ++i) {
+            bits.set(static_cast<uint16_t>((i * 37u) % nBits));
+        }
+        for (uint16_t i = 0; i < nBits; ++i) {
+            bits.flip(static_cast<uint16_t>((i * 11u) % nBits));
+        }
+        size_t count = 0;
+        for (uint16_t i = 0; i < nBits; ++i) {
+            count += bits.test(i);
+        }
+        do_not_optimize(count);
+    }
+}
+
+WLIB_BENCHMARK(bit_set, bit_set_64, 0) {
+    set_flip_test<bit_set<64>, 64>(state);
+}
+
+WLIB_BENCHMARK(bit_set, std_bitset_64, 0) {
+    set_flip_test<std::bitset<64>, 64>(state);
+}
+
+WLIB_BENCHMARK(bit_set, bit_set_255, 0) {
+    set_flip_test<bit_set<255>, 255>(state);
+}
+
+WLIB_BENCHMARK(bit_set, std_bitset_255, 0) {
+    set_flip_test<std::bitset<255>, 255>(state);
+}
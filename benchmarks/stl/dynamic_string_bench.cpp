@@ -0,0 +1,60 @@
+#include <string.h>
+
+#include <string>
+
+#include <wlib/strings/String.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Build a string by appending the given number of short pieces.
+ * Items are appends.
+ */
+template<typename String>
+static void append(state &state) {
+    size_t n = state.arg();
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        String str("");
+        for (size_t i = 0; i < n; ++i) {
+            str += "abcd";
+        }
+        do_not_optimize(str);
+    }
+}
+
+WLIB_BENCHMARK(string_append, dynamic_string, 8, 256) {
+    append<dynamic_string>(state);
+}
+
+WLIB_BENCHMARK(string_append, std_string, 8, 256) {
+    append<std::string>(state);
+}
+
+/**
+ * Copy a string of the given length and compare the copy with the
+ * original. Items are copies.
+ */
+template<typename String>
+static void copy_compare(state &state) {
+    std::string text(state.arg(), 'x');
+    String str(text.c_str());
+    size_t equal = 0;
+    while (state.keep_running()) {
+        String copy(str);
+        equal += copy == str;
+        do_not_optimize(copy);
+    }
+    do_not_optimize(equal);
+}
+
+WLIB_BENCHMARK(string_copy, dynamic_string, 8, 64, 1024) {
+    copy_compare<dynamic_string>(state);
+}
+
+WLIB_BENCHMARK(string_copy, std_string, 8, 64, 1024) {
+    copy_compare<std::string>(state);
+}
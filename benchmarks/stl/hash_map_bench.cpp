@@ -0,0 +1,124 @@
+#include <stdio.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <wlib/stl/HashMap.h>
+#include <wlib/stl/OpenMap.h>
+#include <wlib/strings/String.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Distinct integer keys in scrambled order.
+ */
+static std::vector<uint32_t> int_keys(size_t n) {
+    std::vector<uint32_t> keys;
+    for (uint32_t i = 0; i < n; ++i) {
+        keys.push_back(i * 2654435761u);
+    }
+    return keys;
+}
+
+/**
+ * Distinct keys sharing a prefix, like sensor or topic names.
+ */
+template<typename String>
+static std::vector<String> string_keys(size_t n) {
+    std::vector<String> keys;
+    char buf[32];
+    for (size_t i = 0; i < n; ++i) {
+        snprintf(buf, sizeof(buf), "sensor/%zu", i * 7919);
+        keys.push_back(String(buf));
+    }
+    return keys;
+}
+
+/**
+ * Insert the given number of keys into an empty map. Items are keys.
+ */
+template<typename Map, typename Key>
+static void insert(state &state, const std::vector<Key> &keys) {
+    state.set_items_per_iteration(keys.size());
+    while (state.keep_running()) {
+        Map map;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            map[keys[i]] = static_cast<uint32_t>(i);
+        }
+        do_not_optimize(map);
+    }
+}
+
+/**
+ * Look up every key of a filled map. Items are lookups.
+ */
+template<typename Map, typename Key>
+static void lookup(state &state, const std::vector<Key> &keys) {
+    state.set_items_per_iteration(keys.size());
+    Map map;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        map[keys[i]] = static_cast<uint32_t>(i);
+    }
+    while (state.keep_running()) {
+        size_t hits = 0;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            hits += map.find(keys[i]) != map.end();
+        }
+        do_not_optimize(hits);
+    }
+}
+
+typedef hash<uint32_t, uint32_t> hash_u32;
+typedef hash<dynamic_string, uint32_t> hash_str;
+
+WLIB_BENCHMARK(hash_insert, hash_map_u32, 16, 1024, 16384) {
+    insert<hash_map<uint32_t, uint32_t, hash_u32>>(state, int_keys(state.arg()));
+}
+
+WLIB_BENCHMARK(hash_insert, open_map_u32, 16, 1024, 16384) {
+    insert<open_map<uint32_t, uint32_t, hash_u32>>(state, int_keys(state.arg()));
+}
+
+WLIB_BENCHMARK(hash_insert, std_unordered_map_u32, 16, 1024, 16384) {
+    insert<std::unordered_map<uint32_t, uint32_t>>(state, int_keys(state.arg()));
+}
+
+WLIB_BENCHMARK(hash_insert, hash_map_str, 16, 1024) {
+    insert<hash_map<dynamic_string, uint32_t, hash_str>>(state, string_keys<dynamic_string>(state.arg()));
+}
+
+WLIB_BENCHMARK(hash_insert, open_map_str, 16, 1024) {
+    insert<open_map<dynamic_string, uint32_t, hash_str>>(state, string_keys<dynamic_string>(state.arg()));
+}
+
+WLIB_BENCHMARK(hash_insert, std_unordered_map_str, 16, 1024) {
+    insert<std::unordered_map<std::string, uint32_t>>(state, string_keys<std::string>(state.arg()));
+}
+
+WLIB_BENCHMARK(hash_lookup, hash_map_u32, 16, 1024, 16384) {
+    lookup<hash_map<uint32_t, uint32_t, hash_u32>>(state, int_keys(state.arg()));
+}
+
+WLIB_BENCHMARK(hash_lookup, open_map_u32, 16, 1024, 16384) {
+    lookup<open_map<uint32_t, uint32_t, hash_u32>>(state, int_keys(state.arg()));
+}
+
+WLIB_BENCHMARK(hash_lookup, std_unordered_map_u32, 16, 1024, 16384) {
+    lookup<std::unordered_map<uint32_t, uint32_t>>(state, int_keys(state.arg()));
+}
+
+WLIB_BENCHMARK(hash_lookup, hash_map_str, 16, 1024) {
+    lookup<hash_map<dynamic_string, uint32_t, hash_str>>(state, string_keys<dynamic_string>(state.arg()));
+}
+
+WLIB_BENCHMARK(hash_lookup, open_map_str, 16, 1024) {
+    lookup<open_map<dynamic_string, uint32_t, hash_str>>(state, string_keys<dynamic_string>(state.arg()));
+}
+
+WLIB_BENCHMARK(hash_lookup, std_unordered_map_str, 16, 1024) {
+    lookup<std::unordered_map<std::string, uint32_t>>(state, string_keys<std::string>(state.arg()));
+}
@@ -0,0 +1,51 @@
+#include <wlib/memory>
+#include <wlib/stl/IntrusivePtr.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+struct plain_message : public intrusive_ref_counter<plain_count<uint32_t>> {
+    int v;
+
+    plain_message(int i) : v(i) {}
+};
+
+struct atomic_message : public intrusive_ref_counter<atomic_count<uint32_t>> {
+    int v;
+
+    atomic_message(int i) : v(i) {}
+};
+
+template<typename T>
+static void copy_destroy(state &state) {
+    intrusive_ptr<T> ip = make_intrusive<T>(1);
+    while (state.keep_running()) {
+        intrusive_ptr<T> copy(ip);
+        do_not_optimize(copy);
+    }
+}
+
+WLIB_BENCHMARK(intrusive_ptr, copy_destroy_plain, 1) {
+    copy_destroy<plain_message>(state);
+}
+
+WLIB_BENCHMARK(intrusive_ptr, copy_destroy_atomic, 1) {
+    copy_destroy<atomic_message>(state);
+}
+
+WLIB_BENCHMARK(intrusive_ptr, construct, 1) {
+    while (state.keep_running()) {
+        intrusive_ptr<plain_message> ip = make_intrusive<plain_message>(1);
+        do_not_optimize(ip);
+    }
+}
+
+WLIB_BENCHMARK(intrusive_ptr, unique_handoff, 1) {
+    while (state.keep_running()) {
+        intrusive_ptr<plain_message> ip(unique_ptr<plain_message>(create<plain_message>(1)));
+        unique_ptr<plain_message> up = ip.release_unique();
+        do_not_optimize(up);
+    }
+}
@@ -0,0 +1,40 @@
+#include <list>
+
+#include <wlib/stl/LinkedList.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Append the given number of elements, walk the list and remove them
+ * from the front. Items are elements.
+ */
+template<typename List>
+static void queue_cycle(state &state) {
+    uint32_t n = static_cast<uint32_t>(state.arg());
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        List list;
+        for (uint32_t i = 0; i < n; ++i) {
+            list.push_back(i);
+        }
+        uint32_t sum = 0;
+        for (auto it = list.begin(); it != list.end(); ++it) {
+            sum += *it;
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            list.pop_front();
+        }
+        do_not_optimize(sum);
+    }
+}
+
+WLIB_BENCHMARK(linked_list, linked_list_u32, 16, 1024, 16384) {
+    queue_cycle<linked_list<uint32_t>>(state);
+}
+
+WLIB_BENCHMARK(linked_list, std_list_u32, 16, 1024, 16384) {
+    queue_cycle<std::list<uint32_t>>(state);
+}
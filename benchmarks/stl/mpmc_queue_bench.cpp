@@ -0,0 +1,96 @@
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/MpmcQueue.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Elements passed through the queue in each iteration, over all
+ * producers.
+ */
+static const size_t elements = 160000;
+
+/**
+ * Baseline: an array list used as a bounded queue behind one mutex,
+ * with condition variables for the blocking calls.
+ */
+struct locked_array_queue {
+    std::mutex lock;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+    array_list<uint64_t> list;
+    size_t bound;
+
+    explicit locked_array_queue(size_t capacity)
+            : list(capacity),
+              bound(capacity) {}
+
+    void push(uint64_t v) {
+        std::unique_lock<std::mutex> guard(lock);
+        while (list.size() >= bound) {
+            not_full.wait(guard);
+        }
+        list.push_back(v);
+        not_empty.notify_one();
+    }
+
+    void pop(uint64_t &v) {
+        std::unique_lock<std::mutex> guard(lock);
+        while (list.empty()) {
+            not_empty.wait(guard);
+        }
+        v = list.front();
+        list.pop_front();
+        not_full.notify_one();
+    }
+};
+
+/**
+ * As many producers as consumers, the argument, pass the elements
+ * through a queue of 1024 slots with the blocking calls. Items are
+ * elements.
+ */
+template<typename Queue>
+static void pipeline(state &state) {
+    size_t threads = state.arg();
+    size_t per_thread = elements / threads;
+    state.set_items_per_iteration(per_thread * threads);
+    Queue q(1024);
+    while (state.keep_running()) {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.push_back(std::thread([&q, per_thread, t]() {
+                for (size_t i = 0; i < per_thread; ++i) {
+                    q.push(t * per_thread + i);
+                }
+            }));
+            workers.push_back(std::thread([&q, per_thread]() {
+                uint64_t sum = 0;
+                uint64_t v;
+                for (size_t i = 0; i < per_thread; ++i) {
+                    q.pop(v);
+                    sum += v;
+                }
+                do_not_optimize(sum);
+            }));
+        }
+        for (std::thread &w : workers) {
+            w.join();
+        }
+    }
+}
+
+WLIB_BENCHMARK(mpmc_queue, pipeline_locked_array, 1, 2, 4, 8, 16) {
+    pipeline<locked_array_queue>(state);
+}
+
+WLIB_BENCHMARK(mpmc_queue, pipeline_mpmc, 1, 2, 4, 8, 16) {
+    pipeline<mpmc_queue<uint64_t>>(state);
+}
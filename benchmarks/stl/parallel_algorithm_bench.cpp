@@ -0,0 +1,135 @@
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/ParallelAlgorithm.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Elements of each range, enough to outgrow the caches.
+ */
+static const size_t elements = 1 << 20;
+
+static void fill(array_list<int> &list) {
+    list.clear();
+    uint32_t state = 2463534242u;
+    for (size_t i = 0; i < elements; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        list.push_back(static_cast<int>(state >> 1));
+    }
+}
+
+/**
+ * Runs the algorithms on the calling thread with a serial executor for
+ * the baseline, where the argument is ignored, or on a pool of that
+ * many workers. Items are elements.
+ */
+template<typename Executor>
+struct parallel_case {
+    static void transform(state &state) {
+        Executor ex(state.arg());
+        array_list<int> in(elements);
+        array_list<int> out(elements);
+        fill(in);
+        fill(out);
+        state.set_items_per_iteration(elements);
+        while (state.keep_running()) {
+            parallel_transform(ex, in.begin(), in.end(), out.begin(), [](int v) { return v / 3 + (v & 7); });
+            do_not_optimize(out[elements / 2]);
+        }
+    }
+
+    static void reduce(state &state) {
+        Executor ex(state.arg());
+        array_list<int> in(elements);
+        fill(in);
+        state.set_items_per_iteration(elements);
+        while (state.keep_running()) {
+            do_not_optimize(parallel_reduce(ex, in.begin(), in.end(), 0L, [](long a, long b) { return a + b; }));
+        }
+    }
+
+    static void inclusive_scan(state &state) {
+        Executor ex(state.arg());
+        array_list<int> in(elements);
+        array_list<int> out(elements);
+        fill(in);
+        fill(out);
+        state.set_items_per_iteration(elements);
+        while (state.keep_running()) {
+            parallel_inclusive_scan(ex, in.begin(), in.end(), out.begin(), [](int a, int b) { return a ^ b; });
+            do_not_optimize(out[elements - 1]);
+        }
+    }
+
+    static void sort(state &state) {
+        Executor ex(state.arg());
+        array_list<int> list(elements);
+        state.set_items_per_iteration(elements);
+        while (state.keep_running()) {
+            state.pause_timing();
+            fill(list);
+            state.resume_timing();
+            parallel_sort(ex, list.begin(), list.end());
+            do_not_optimize(list[0]);
+        }
+    }
+
+    static void partition(state &state) {
+        Executor ex(state.arg());
+        array_list<int> list(elements);
+        state.set_items_per_iteration(elements);
+        while (state.keep_running()) {
+            state.pause_timing();
+            fill(list);
+            state.resume_timing();
+            do_not_optimize(parallel_partition(ex, list.begin(), list.end(), [](int v) { return (v & 1) == 0; }));
+        }
+    }
+};
+
+typedef parallel_case<serial_executor> serial_case;
+typedef parallel_case<thread_pool> pool_case;
+
+WLIB_BENCHMARK(parallel_algorithm, transform_serial, 1) {
+    serial_case::transform(state);
+}
+
+WLIB_BENCHMARK(parallel_algorithm, transform_pool, 1, 2, 4, 8) {
+    pool_case::transform(state);
+}
+
+WLIB_BENCHMARK(parallel_algorithm, reduce_serial, 1) {
+    serial_case::reduce(state);
+}
+
+WLIB_BENCHMARK(parallel_algorithm, reduce_pool, 1, 2, 4, 8) {
+    pool_case::reduce(state);
+}
+
+WLIB_BENCHMARK(parallel_algorithm, inclusive_scan_serial, 1) {
+    serial_case::inclusive_scan(state);
+}
+
+WLIB_BENCHMARK(parallel_algorithm, inclusive_scan_pool, 1, 2, 4, 8) {
+    pool_case::inclusive_scan(state);
+}
+
+WLIB_BENCHMARK(parallel_algorithm, sort_serial, 1) {
+    serial_case::sort(state);
+}
+
+WLIB_BENCHMARK(parallel_algorithm, sort_pool, 1, 2, 4, 8) {
+    pool_case::sort(state);
+}
+
+WLIB_BENCHMARK(parallel_algorithm, partition_serial, 1) {
+    serial_case::partition(state);
+}
+
+WLIB_BENCHMARK(parallel_algorithm, partition_pool, 1, 2, 4, 8) {
+    pool_case::partition(state);
+}
@@ -0,0 +1,94 @@
+#include <thread>
+#include <vector>
+
+#include <wlib/memory>
+#include <wlib/stl/SharedPtr.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+typedef shared_ptr<int, plain_count<uint32_t>> plain_ptr;
+typedef shared_ptr<int, atomic_count<uint32_t>> atomic_ptr;
+
+template<typename ptr_t>
+static void copy_destroy(state &state) {
+    ptr_t sp(create<int>(1));
+    while (state.keep_running()) {
+        ptr_t copy(sp);
+        do_not_optimize(copy);
+    }
+}
+
+template<typename ptr_t>
+static void weak_lock(state &state) {
+    ptr_t sp(create<int>(1));
+    auto wp = sp.weak();
+    while (state.keep_running()) {
+        ptr_t locked = wp.lock();
+        do_not_optimize(locked);
+    }
+}
+
+/**
+ * Every thread copies and destroys its own handle to one shared
+ * object, so all threads contend on the same counter. Each
+ * iteration starts the threads afresh; the batch is large enough
+ * that thread start-up is a small part of the measurement.
+ */
+template<typename ptr_t>
+static void contended_copy(state &state) {
+    const size_t batch = 20000;
+    ptr_t sp(create<int>(1));
+    size_t threads = state.arg();
+    state.set_items_per_iteration(threads * batch);
+    while (state.keep_running()) {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.push_back(std::thread([&sp]() {
+                for (size_t i = 0; i < batch; ++i) {
+                    ptr_t copy(sp);
+                    do_not_optimize(copy);
+                }
+            }));
+        }
+        for (std::thread &w : workers) {
+            w.join();
+        }
+    }
+}
+
+WLIB_BENCHMARK(shared_ptr, copy_destroy_plain, 1) {
+    copy_destroy<plain_ptr>(state);
+}
+
+WLIB_BENCHMARK(shared_ptr, copy_destroy_atomic, 1) {
+    copy_destroy<atomic_ptr>(state);
+}
+
+WLIB_BENCHMARK(shared_ptr, weak_lock_plain, 1) {
+    weak_lock<plain_ptr>(state);
+}
+
+WLIB_BENCHMARK(shared_ptr, weak_lock_atomic, 1) {
+    weak_lock<atomic_ptr>(state);
+}
+
+WLIB_BENCHMARK(shared_ptr, contended_copy_atomic, 1, 2, 4, 8) {
+    contended_copy<atomic_ptr>(state);
+}
+
+WLIB_BENCHMARK(shared_ptr, construct_separate, 1) {
+    while (state.keep_running()) {
+        plain_ptr sp(create<int>(1));
+        do_not_optimize(sp);
+    }
+}
+
+WLIB_BENCHMARK(shared_ptr, construct_make_shared, 1) {
+    while (state.keep_running()) {
+        plain_ptr sp = make_shared<int, plain_count<uint32_t>>(1);
+        do_not_optimize(sp);
+    }
+}
@@ -0,0 +1,64 @@
+#include <wlib/stl/HashMap.h>
+#include <wlib/stl/SlotMap.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+struct entity {
+    float x;
+    float y;
+    float vx;
+    float vy;
+};
+
+/**
+ * Create the given number of entities, look each one up by its key,
+ * update all of them and remove them. Items are entities.
+ */
+WLIB_BENCHMARK(slot_map, lifecycle_hash_map, 64, 1024) {
+    uint32_t n = static_cast<uint32_t>(state.arg());
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        hash_map<uint32_t, entity, hash<uint32_t, uint32_t>> map(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            map[i] = entity{static_cast<float>(i), 0, 1, 1};
+        }
+        float sum = 0;
+        for (uint32_t i = 0; i < n; ++i) {
+            sum += map[i].x;
+        }
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            it->x += it->vx;
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            map.erase(i);
+        }
+        do_not_optimize(sum);
+    }
+}
+
+WLIB_BENCHMARK(slot_map, lifecycle_slot_map, 64, 1024) {
+    uint32_t n = static_cast<uint32_t>(state.arg());
+    state.set_items_per_iteration(n);
+    slot_handle *handles = new slot_handle[n];
+    while (state.keep_running()) {
+        slot_map<entity> map(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            handles[i] = map.insert(entity{static_cast<float>(i), 0, 1, 1});
+        }
+        float sum = 0;
+        for (uint32_t i = 0; i < n; ++i) {
+            sum += map[handles[i]].x;
+        }
+        for (entity &e : map) {
+            e.x += e.vx;
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            map.erase(handles[i]);
+        }
+        do_not_optimize(sum);
+    }
+    delete[] handles;
+}
@@ -0,0 +1,91 @@
+#include <wlib/stl/HashSet.h>
+#include <wlib/stl/OpenSet.h>
+#include <wlib/stl/SparseSet.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Keys are a quarter of the ids below 4096, scattered the way
+ * component ids of live entities are.
+ */
+static uint16_t key_of(uint16_t i) {
+    return static_cast<uint16_t>((i * 2749u) & 4095u);
+}
+
+/**
+ * Insert the given number of keys, test membership of every id in the
+ * key range, sum the members and clear. Items are keys inserted.
+ */
+template<typename Set>
+static void membership(state &state, Set &set) {
+    uint16_t n = static_cast<uint16_t>(state.arg());
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        for (uint16_t i = 0; i < n; ++i) {
+            set.insert(key_of(i));
+        }
+        unsigned hits = 0;
+        for (uint16_t k = 0; k < 4096; k += 4) {
+            hits += set.contains(k);
+        }
+        unsigned sum = 0;
+        for (auto it = set.begin(); it != set.end(); ++it) {
+            sum += *it;
+        }
+        set.clear();
+        do_not_optimize(hits);
+        do_not_optimize(sum);
+    }
+}
+
+WLIB_BENCHMARK(sparse_set, membership_hash_set, 64, 1024) {
+    hash_set<uint16_t> set(2048);
+    membership(state, set);
+}
+
+WLIB_BENCHMARK(sparse_set, membership_open_set, 64, 1024) {
+    open_set<uint16_t> set(2048);
+    membership(state, set);
+}
+
+WLIB_BENCHMARK(sparse_set, membership_sparse_set, 64, 1024) {
+    sparse_set<uint16_t> set(4096);
+    membership(state, set);
+}
+
+/**
+ * Insert the given number of keys and erase them in another order.
+ * Items are keys.
+ */
+template<typename Set>
+static void churn(state &state, Set &set) {
+    uint16_t n = static_cast<uint16_t>(state.arg());
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        for (uint16_t i = 0; i < n; ++i) {
+            set.insert(key_of(i));
+        }
+        for (uint16_t i = n; i > 0; --i) {
+            set.erase(key_of(static_cast<uint16_t>(i - 1)));
+        }
+        do_not_optimize(set.size());
+    }
+}
+
+WLIB_BENCHMARK(sparse_set, churn_hash_set, 64, 1024) {
+    hash_set<uint16_t> set(2048);
+    churn(state, set);
+}
+
+WLIB_BENCHMARK(sparse_set, churn_open_set, 64, 1024) {
+    open_set<uint16_t> set(2048);
+    churn(state, set);
+}
+
+WLIB_BENCHMARK(sparse_set, churn_sparse_set, 64, 1024) {
+    sparse_set<uint16_t> set(4096);
+    churn(state, set);
+}
@@ -0,0 +1,150 @@
+#include <mutex>
+#include <thread>
+
+#include <wlib/stl/LinkedList.h>
+#include <wlib/stl/SpscQueue.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Samples handed from the producer to the consumer in each iteration.
+ */
+static const size_t samples = 100000;
+
+/**
+ * Baseline: a linked list behind a mutex, which allocates a node per
+ * sample and locks on every push and pop.
+ */
+struct locked_list_queue {
+    std::mutex lock;
+    linked_list<uint64_t> list;
+
+    explicit locked_list_queue(size_t) {}
+
+    bool push(uint64_t v) {
+        std::lock_guard<std::mutex> guard(lock);
+        list.push_back(v);
+        return true;
+    }
+
+    bool pop(uint64_t &v) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (list.empty()) {
+            return false;
+        }
+        v = list.front();
+        list.pop_front();
+        return true;
+    }
+
+    size_t push_n(const uint64_t *vals, size_t n) {
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t i = 0; i < n; ++i) {
+            list.push_back(vals[i]);
+        }
+        return n;
+    }
+
+    size_t pop_n(uint64_t *vals, size_t n) {
+        std::lock_guard<std::mutex> guard(lock);
+        size_t k = 0;
+        for (; k < n && !list.empty(); ++k) {
+            vals[k] = list.front();
+            list.pop_front();
+        }
+        return k;
+    }
+};
+
+/**
+ * Streams samples from a producer thread to the consumer in batches of
+ * the argument's size. Items are samples.
+ */
+template<typename Queue>
+static void stream(state &state) {
+    size_t batch = state.arg();
+    state.set_items_per_iteration(samples);
+    Queue q(1024);
+    while (state.keep_running()) {
+        std::thread producer([&q, batch]() {
+            uint64_t vals[64];
+            for (size_t sent = 0; sent < samples;) {
+                size_t n = samples - sent < batch ? samples - sent : batch;
+                for (size_t i = 0; i < n; ++i) {
+                    vals[i] = sent + i;
+                }
+                size_t k = n == 1 ? (q.push(vals[0]) ? 1 : 0) : q.push_n(vals, n);
+                if (k == 0) {
+                    std::this_thread::yield();
+                }
+                sent += k;
+            }
+        });
+        uint64_t vals[64];
+        uint64_t sum = 0;
+        for (size_t received = 0; received < samples;) {
+            size_t k = batch == 1 ? (q.pop(vals[0]) ? 1 : 0) : q.pop_n(vals, batch);
+            if (k == 0) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < k; ++i) {
+                sum += vals[i];
+            }
+            received += k;
+        }
+        producer.join();
+        do_not_optimize(sum);
+    }
+}
+
+/**
+ * Bounces one sample between two threads through a pair of queues.
+ * Items are round trips, so the time per item is the round trip
+ * latency, including the cost of waking the other thread.
+ */
+template<typename Queue>
+static void ping_pong(state &state) {
+    const size_t trips = 10000;
+    state.set_items_per_iteration(trips);
+    Queue there(16);
+    Queue back(16);
+    while (state.keep_running()) {
+        std::thread echo([&there, &back]() {
+            uint64_t v;
+            for (size_t i = 0; i < trips; ++i) {
+                while (!there.pop(v)) {
+                    std::this_thread::yield();
+                }
+                back.push(v + 1);
+            }
+        });
+        uint64_t v = 0;
+        for (size_t i = 0; i < trips; ++i) {
+            there.push(v);
+            while (!back.pop(v)) {
+                std::this_thread::yield();
+            }
+        }
+        echo.join();
+        do_not_optimize(v);
+    }
+}
+
+WLIB_BENCHMARK(spsc_queue, stream_locked_list, 1, 16, 64) {
+    stream<locked_list_queue>(state);
+}
+
+WLIB_BENCHMARK(spsc_queue, stream_spsc, 1, 16, 64) {
+    stream<spsc_queue<uint64_t>>(state);
+}
+
+WLIB_BENCHMARK(spsc_queue, ping_pong_locked_list, 1) {
+    ping_pong<locked_list_queue>(state);
+}
+
+WLIB_BENCHMARK(spsc_queue, ping_pong_spsc, 1) {
+    ping_pong<spsc_queue<uint64_t>>(state);
+}
@@ -0,0 +1,79 @@
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <wlib/stl/Allocator.h>
+#include <wlib/stl/ThreadCache.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Baseline: the shared pool behind one lock, as every thread sees
+ * a single non thread-safe heap.
+ */
+struct locked_pool_allocator {
+    static std::mutex &lock() {
+        static std::mutex m;
+        return m;
+    }
+
+    void *allocate(size_t size, size_t align) const {
+        std::lock_guard<std::mutex> guard(lock());
+        return allocator().allocate(size, align);
+    }
+
+    void deallocate(void *ptr, size_t size, size_t align) const {
+        std::lock_guard<std::mutex> guard(lock());
+        allocator().deallocate(ptr, size, align);
+    }
+};
+
+/**
+ * Each thread keeps a window of live blocks of mixed small sizes and
+ * replaces one per step, as when building and discarding container
+ * nodes. Items are allocate/free pairs over all threads.
+ */
+template<typename Alloc>
+static void churn(state &state) {
+    const size_t steps = 20000;
+    const size_t window = 64;
+    size_t threads = state.arg();
+    state.set_items_per_iteration(threads * steps);
+    while (state.keep_running()) {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.push_back(std::thread([t]() {
+                Alloc alloc;
+                void *live[window] = {};
+                size_t sizes[window] = {};
+                uint32_t seed = static_cast<uint32_t>(t) * 2654435761u + 1;
+                for (size_t i = 0; i < steps; ++i) {
+                    seed = seed * 1664525u + 1013904223u;
+                    size_t slot = (seed >> 8) % window;
+                    size_t size = 16 + ((seed >> 20) % 16) * 16;
+                    alloc.deallocate(live[slot], sizes[slot], alignof(max_align_t));
+                    live[slot] = alloc.allocate(size, alignof(max_align_t));
+                    sizes[slot] = size;
+                    do_not_optimize(live[slot]);
+                }
+                for (size_t s = 0; s < window; ++s) {
+                    alloc.deallocate(live[s], sizes[s], alignof(max_align_t));
+                }
+            }));
+        }
+        for (std::thread &w : workers) {
+            w.join();
+        }
+    }
+}
+
+WLIB_BENCHMARK(thread_cache, churn_locked_pool, 1, 2, 4, 8, 16, 32) {
+    churn<locked_pool_allocator>(state);
+}
+
+WLIB_BENCHMARK(thread_cache, churn_thread_cache, 1, 2, 4, 8, 16, 32) {
+    churn<thread_cache_allocator>(state);
+}
@@ -0,0 +1,86 @@
+#include <wlib/stl/ThreadPool.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+/**
+ * Below this size a subproblem is solved serially, so that each task
+ * does a few microseconds of work.
+ */
+static const int fib_cutoff = 12;
+
+static int serial_fib(int n) {
+    return n < 2 ? n : serial_fib(n - 1) + serial_fib(n - 2);
+}
+
+static int spawn_fib(thread_pool &pool, int n) {
+    if (n < fib_cutoff) {
+        return serial_fib(n);
+    }
+    future<int> a = pool.spawn([&pool, n]() { return spawn_fib(pool, n - 1); });
+    int b = spawn_fib(pool, n - 2);
+    return a.get() + b;
+}
+
+static int invoke_fib(thread_pool &pool, int n) {
+    if (n < fib_cutoff) {
+        return serial_fib(n);
+    }
+    int a = 0;
+    int b = 0;
+    pool.parallel_invoke([&]() { a = invoke_fib(pool, n - 1); },
+                         [&]() { b = invoke_fib(pool, n - 2); });
+    return a + b;
+}
+
+/**
+ * Baseline for the fork-join benchmarks: the same recursion on one
+ * thread.
+ */
+WLIB_BENCHMARK(thread_pool, fib_serial, 1) {
+    while (state.keep_running()) {
+        do_not_optimize(serial_fib(25));
+    }
+}
+
+/**
+ * Fork-join by futures, scaling with the number of workers.
+ */
+WLIB_BENCHMARK(thread_pool, fib_spawn, 1, 2, 4, 8) {
+    thread_pool pool(state.arg());
+    while (state.keep_running()) {
+        future<int> f = pool.submit([&pool]() { return spawn_fib(pool, 25); });
+        do_not_optimize(f.get());
+    }
+}
+
+WLIB_BENCHMARK(thread_pool, fib_parallel_invoke, 1, 2, 4, 8) {
+    thread_pool pool(state.arg());
+    while (state.keep_running()) {
+        future<int> f = pool.submit([&pool]() { return invoke_fib(pool, 25); });
+        do_not_optimize(f.get());
+    }
+}
+
+/**
+ * Many independent small tasks submitted from outside the pool. Items
+ * are tasks.
+ */
+WLIB_BENCHMARK(thread_pool, small_tasks, 1, 2, 4, 8) {
+    const size_t tasks = 1000;
+    thread_pool pool(state.arg(), tasks);
+    state.set_items_per_iteration(tasks);
+    while (state.keep_running()) {
+        future<size_t> results[tasks];
+        for (size_t i = 0; i < tasks; ++i) {
+            results[i] = pool.submit([i]() { return i * i; });
+        }
+        size_t sum = 0;
+        for (size_t i = 0; i < tasks; ++i) {
+            sum += results[i].get();
+        }
+        do_not_optimize(sum);
+    }
+}
@@ -0,0 +1,103 @@
+#include <wlib/memory>
+#include <wlib/stl/Transform.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+typedef vector3d<float> vec3f;
+
+static vec3f *make_points(size_t n) {
+    vec3f *pts = create<vec3f[]>(n);
+    for (size_t i = 0; i < n; ++i) {
+        pts[i] = vec3f(static_cast<float>(i % 101), static_cast<float>(i % 37) - 18.0f, static_cast<float>(i % 13));
+    }
+    return pts;
+}
+
+static mat4<float> make_transform() {
+    quaternion<float> q = quaternion<float>::from_axis_angle(vec3f(0.0f, 0.6f, 0.8f), 0.3f);
+    return q.to_mat4(vec3f(1.0f, -2.0f, 3.0f));
+}
+
+WLIB_BENCHMARK(transform, mat4_per_point, 1000, 10000, 100000) {
+    vec3f *in = make_points(state.arg());
+    vec3f *out = create<vec3f[]>(state.arg());
+    mat4<float> m = make_transform();
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        for (size_t i = 0; i < state.arg(); ++i) {
+            out[i] = m.transform_point(in[i]);
+        }
+        clobber_memory();
+    }
+    destroy<vec3f[]>(out);
+    destroy<vec3f[]>(in);
+}
+
+WLIB_BENCHMARK(transform, mat4_batched, 1000, 10000, 100000) {
+    vec3f *in = make_points(state.arg());
+    vec3f *out = create<vec3f[]>(state.arg());
+    mat4<float> m = make_transform();
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        transform_points(m, in, out, state.arg());
+        clobber_memory();
+    }
+    destroy<vec3f[]>(out);
+    destroy<vec3f[]>(in);
+}
+
+WLIB_BENCHMARK(transform, quaternion_per_point, 1000, 10000, 100000) {
+    vec3f *in = make_points(state.arg());
+    vec3f *out = create<vec3f[]>(state.arg());
+    quaternion<float> q = quaternion<float>::from_axis_angle(vec3f(0.0f, 0.6f, 0.8f), 0.3f);
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        for (size_t i = 0; i < state.arg(); ++i) {
+            out[i] = q.rotate(in[i]);
+        }
+        clobber_memory();
+    }
+    destroy<vec3f[]>(out);
+    destroy<vec3f[]>(in);
+}
+
+WLIB_BENCHMARK(transform, quaternion_batched, 1000, 10000, 100000) {
+    vec3f *in = make_points(state.arg());
+    vec3f *out = create<vec3f[]>(state.arg());
+    quaternion<float> q = quaternion<float>::from_axis_angle(vec3f(0.0f, 0.6f, 0.8f), 0.3f);
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        rotate_points(q, in, out, state.arg());
+        clobber_memory();
+    }
+    destroy<vec3f[]>(out);
+    destroy<vec3f[]>(in);
+}
+
+WLIB_BENCHMARK(transform, mat4_homogeneous, 1000, 10000, 100000) {
+    vector4d<float> *in = create<vector4d<float>[]>(state.arg());
+    vector4d<float> *out = create<vector4d<float>[]>(state.arg());
+    for (size_t i = 0; i < state.arg(); ++i) {
+        in[i] = vector4d<float>(static_cast<float>(i % 101), 1.0f, static_cast<float>(i % 13), 1.0f);
+    }
+    mat4<float> m = make_transform();
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        transform_points(m, in, out, state.arg());
+        clobber_memory();
+    }
+    destroy<vector4d<float>[]>(out);
+    destroy<vector4d<float>[]>(in);
+}
+
+WLIB_BENCHMARK(transform, mat4_multiply, 1) {
+    mat4<float> a = make_transform();
+    mat4<float> b = mat4<float>::scaling(vec3f(1.0f, 1.0001f, 0.9999f));
+    while (state.keep_running()) {
+        a = a * b;
+        do_not_optimize(a);
+    }
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <wlib/stl/TreeMap.h>
+#include <wlib/strings/String.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+static std::vector<uint32_t> int_keys(size_t n) {
+    std::vector<uint32_t> keys;
+    for (uint32_t i = 0; i < n; ++i) {
+        keys.push_back(i * 2654435761u);
+    }
+    return keys;
+}
+
+template<typename String>
+static std::vector<String> string_keys(size_t n) {
+    std::vector<String> keys;
+    char buf[32];
+    for (size_t i = 0; i < n; ++i) {
+        snprintf(buf, sizeof(buf), "sensor/%zu", i * 7919);
+        keys.push_back(String(buf));
+    }
+    return keys;
+}
+
+/**
+ * Insert the given number of keys into an empty map. Items are keys.
+ */
+template<typename Map, typename Key>
+static void insert(state &state, const std::vector<Key> &keys) {
+    state.set_items_per_iteration(keys.size());
+    while (state.keep_running()) {
+        Map map;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            map[keys[i]] = static_cast<uint32_t>(i);
+        }
+        do_not_optimize(map);
+    }
+}
+
+/**
+ * Look up every key of a filled map. Items are lookups.
+ */
+template<typename Map, typename Key>
+static void lookup(state &state, const std::vector<Key> &keys) {
+    state.set_items_per_iteration(keys.size());
+    Map map;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        map[keys[i]] = static_cast<uint32_t>(i);
+    }
+    while (state.keep_running()) {
+        size_t hits = 0;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            hits += map.find(keys[i]) != map.end();
+        }
+        do_not_optimize(hits);
+    }
+}
+
+WLIB_BENCHMARK(tree_insert, tree_map_u32, 16, 1024, 16384) {
+    insert<tree_map<uint32_t, uint32_t>>(state, int_keys(state.arg()));
+}
+
+WLIB_BENCHMARK(tree_insert, std_map_u32, 16, 1024, 16384) {
+    insert<std::map<uint32_t, uint32_t>>(state, int_keys(state.arg()));
+}
+
+WLIB_BENCHMARK(tree_insert, tree_map_str, 16, 1024) {
+    insert<tree_map<dynamic_string, uint32_t>>(state, string_keys<dynamic_string>(state.arg()));
+}
+
+WLIB_BENCHMARK(tree_insert, std_map_str, 16, 1024) {
+    insert<std::map<std::string, uint32_t>>(state, string_keys<std::string>(state.arg()));
+}
+
+WLIB_BENCHMARK(tree_lookup, tree_map_u32, 16, 1024, 16384) {
+    lookup<tree_map<uint32_t, uint32_t>>(state, int_keys(state.arg()));
+}
+
+WLIB_BENCHMARK(tree_lookup, std_map_u32, 16, 1024, 16384) {
+    lookup<std::map<uint32_t, uint32_t>>(state, int_keys(state.arg()));
+}
+
+WLIB_BENCHMARK(tree_lookup, tree_map_str, 16, 1024) {
+    lookup<tree_map<dynamic_string, uint32_t>>(state, string_keys<dynamic_string>(state.arg()));
+}
+
+WLIB_BENCHMARK(tree_lookup, std_map_str, 16, 1024) {
+    lookup<std::map<std::string, uint32_t>>(state, string_keys<std::string>(state.arg()));
+}
@@ -0,0 +1,151 @@
+#include <math.h>
+
+#include <wlib/stl/Vector2DSoA.h>
+
+#include "../benchmark.h"
+
+using namespace wlp;
+using namespace wlp::bench;
+
+typedef vector2d<float> vec_t;
+
+static void fill_list(array_list<vec_t> &list, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        list.push_back(vec_t(static_cast<float>(i % 97) - 48.0f, static_cast<float>(i % 89) * 0.5f + 1.0f));
+    }
+}
+
+WLIB_BENCHMARK(vector2d, norm_aos, 1000, 10000, 100000) {
+    array_list<vec_t> list(state.arg());
+    fill_list(list, state.arg());
+    float *out = create<float[]>(state.arg());
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        for (size_t i = 0; i < list.size(); ++i) {
+            out[i] = static_cast<float>(list[i].norm());
+        }
+        clobber_memory();
+    }
+    destroy<float[]>(out);
+}
+
+WLIB_BENCHMARK(vector2d, norm_soa, 1000, 10000, 100000) {
+    array_list<vec_t> list(state.arg());
+    fill_list(list, state.arg());
+    vector2d_soa<float> soa(list);
+    float *out = create<float[]>(state.arg());
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        norm(soa, out);
+        clobber_memory();
+    }
+    destroy<float[]>(out);
+}
+
+WLIB_BENCHMARK(vector2d, normalize_aos, 1000, 10000, 100000) {
+    array_list<vec_t> list(state.arg());
+    fill_list(list, state.arg());
+    array_list<vec_t> out(state.arg());
+    fill_list(out, state.arg());
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        for (size_t i = 0; i < list.size(); ++i) {
+            out[i] = list[i].n();
+        }
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(vector2d, normalize_soa, 1000, 10000, 100000) {
+    array_list<vec_t> list(state.arg());
+    fill_list(list, state.arg());
+    vector2d_soa<float> soa(list);
+    vector2d_soa<float> out(state.arg());
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        normalize(soa, out);
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(vector2d, dot_aos, 1000, 10000, 100000) {
+    array_list<vec_t> list(state.arg());
+    fill_list(list, state.arg());
+    float *out = create<float[]>(state.arg());
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        for (size_t i = 0; i < list.size(); ++i) {
+            out[i] = list[i].dot(list[list.size() - 1 - i]);
+        }
+        clobber_memory();
+    }
+    destroy<float[]>(out);
+}
+
+WLIB_BENCHMARK(vector2d, dot_soa, 1000, 10000, 100000) {
+    array_list<vec_t> list(state.arg());
+    fill_list(list, state.arg());
+    vector2d_soa<float> a(list);
+    vector2d_soa<float> b(list);
+    float *out = create<float[]>(state.arg());
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        dot(a, b, out);
+        clobber_memory();
+    }
+    destroy<float[]>(out);
+}
+
+WLIB_BENCHMARK(vector2d, rotate_aos, 1000, 10000, 100000) {
+    array_list<vec_t> list(state.arg());
+    fill_list(list, state.arg());
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        for (size_t i = 0; i < list.size(); ++i) {
+            vec_t &v = list[i];
+            float c = cosf(0.01f);
+            float s = sinf(0.01f);
+            v = vec_t(c * v.x() - s * v.y(), s * v.x() + c * v.y());
+        }
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(vector2d, rotate_soa, 1000, 10000, 100000) {
+    array_list<vec_t> list(state.arg());
+    fill_list(list, state.arg());
+    vector2d_soa<float> soa(list);
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        rotate(soa, 0.01f, soa);
+        clobber_memory();
+    }
+}
+
+WLIB_BENCHMARK(vector2d, distance_aos, 1000, 10000, 100000) {
+    array_list<vec_t> list(state.arg());
+    fill_list(list, state.arg());
+    float *out = create<float[]>(state.arg());
+    vec_t p(3.0f, -2.0f);
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        for (size_t i = 0; i < list.size(); ++i) {
+            out[i] = static_cast<float>((list[i] - p).norm());
+        }
+        clobber_memory();
+    }
+    destroy<float[]>(out);
+}
+
+WLIB_BENCHMARK(vector2d, distance_soa, 1000, 10000, 100000) {
+    array_list<vec_t> list(state.arg());
+    fill_list(list, state.arg());
+    vector2d_soa<float> soa(list);
+    float *out = create<float[]>(state.arg());
+    state.set_items_per_iteration(state.arg());
+    while (state.keep_running()) {
+        distance(soa, vec_t(3.0f, -2.0f), out);
+        clobber_memory();
+    }
+    destroy<float[]>(out);
+}
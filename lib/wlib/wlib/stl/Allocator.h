@@ -0,0 +1,201 @@
+/**
+ * @file Allocator.h
+ * @brief Default allocator over the wlib memory functions.
+ *
+ * An allocator is any copyable type providing
+ *
+ * @code
+ * void *allocate(size_t size, size_t align);
+ * void deallocate(void *ptr, size_t size, size_t align);
+ * @endcode
+ *
+ * where @code deallocate @endcode receives the same size and
+ * alignment that were passed to @code allocate @endcode. An
+ * allocator returns @code nullptr @endcode when it is out of memory.
+ * Stateless allocators should be empty classes, so that types
+ * holding them can store them at no cost.
+ *
+ * Containers take an allocator as their last template parameter,
+ * defaulting to @code allocator @endcode, and build their nodes and
+ * arrays with the typed helpers below in place of @code create @endcode
+ * and @code destroy @endcode. A copy of a container's allocator
+ * must be able to free memory obtained from the original.
+ *
+ * Defining @code WLIB_THREAD_CACHE @endcode sends requests of the
+ * default allocator through the per-thread caches of ThreadCache.h,
+ * which is only safe if nothing else calls into the memory pool from
+ * several threads.
+ * Defining @code WLIB_MEM_STATS @endcode counts its requests under the
+ * global tag of MemStats.h.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_ALLOCATOR_H
+#define EMBEDDEDCPLUSPLUS_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <wlib/memory>
+#include <wlib/utility>
+
+#ifdef WLIB_THREAD_CACHE
+#include <wlib/stl/ThreadCache.h>
+#endif
+
+#ifdef WLIB_MEM_STATS
+#include <wlib/stl/MemStats.h>
+#endif
+
+namespace wlp {
+
+    /**
+     * Stateless allocator that forwards to @code mem::alloc @endcode and
+     * @code mem::free @endcode. Requests for alignment stricter than
+     * that of any fundamental type over-allocate and store the
+     * original pointer just before the aligned block.
+     */
+    struct allocator {
+        static constexpr size_t fundamental_alignment = alignof(max_align_t);
+
+        void *allocate(size_t size, size_t align) const {
+#ifdef WLIB_MEM_STATS
+            void *ptr = allocate_block(size, align);
+            if (ptr) {
+                mem_stats_global().record_alloc(size);
+            } else {
+                mem_stats_global().record_failure();
+            }
+            return ptr;
+#else
+            return allocate_block(size, align);
+#endif
+        }
+
+        void deallocate(void *ptr, size_t size, size_t align) const {
+#ifdef WLIB_MEM_STATS
+            if (ptr) {
+                mem_stats_global().record_free(size);
+            }
+#endif
+            deallocate_block(ptr, size, align);
+        }
+
+        bool operator==(const allocator &) const {
+            return true;
+        }
+
+        bool operator!=(const allocator &) const {
+            return false;
+        }
+
+    private:
+        void *allocate_block(size_t size, size_t align) const {
+            if (align <= fundamental_alignment) {
+#ifdef WLIB_THREAD_CACHE
+                return thread_cache_alloc(size);
+#else
+                return mem::alloc(size);
+#endif
+            }
+#ifdef WLIB_THREAD_CACHE
+            return __thread_cache::pool_alloc_aligned(size, align);
+#else
+            void *raw = mem::alloc(size + align + sizeof(void *));
+            if (!raw) {
+                return nullptr;
+            }
+            uintptr_t addr = reinterpret_cast<uintptr_t>(raw) + sizeof(void *);
+            addr = (addr + align - 1) & ~static_cast<uintptr_t>(align - 1);
+            void **aligned = reinterpret_cast<void **>(addr);
+            aligned[-1] = raw;
+            return aligned;
+#endif
+        }
+
+        void deallocate_block(void *ptr, size_t size, size_t align) const {
+            if (!ptr) {
+                return;
+            }
+            if (align <= fundamental_alignment) {
+#ifdef WLIB_THREAD_CACHE
+                thread_cache_free(ptr, size);
+#else
+                static_cast<void>(size);
+                mem::free(ptr);
+#endif
+            } else {
+#ifdef WLIB_THREAD_CACHE
+                __thread_cache::pool_free_aligned(ptr);
+#else
+                mem::free(static_cast<void **>(ptr)[-1]);
+#endif
+            }
+        }
+    };
+
+    /**
+     * Construct an object in storage from an allocator.
+     *
+     * @return the object, or null if the allocator is out of memory
+     */
+    template<typename T, typename Alloc, typename... Args>
+    inline T *alloc_create(Alloc &alloc, Args &&... args) {
+        void *mem = alloc.allocate(sizeof(T), alignof(T));
+        if (!mem) {
+            return nullptr;
+        }
+        return new (mem) T(forward<Args>(args)...);
+    }
+
+    /**
+     * Destroy an object made by @code alloc_create @endcode with the
+     * same allocator. Null pointers are ignored.
+     */
+    template<typename T, typename Alloc>
+    inline void alloc_destroy(Alloc &alloc, T *ptr) {
+        if (!ptr) {
+            return;
+        }
+        ptr->~T();
+        alloc.deallocate(ptr, sizeof(T), alignof(T));
+    }
+
+    /**
+     * Allocate an array of value-initialized elements.
+     *
+     * @return the array, or null if the allocator is out of memory
+     */
+    template<typename T, typename Alloc>
+    inline T *alloc_create_array(Alloc &alloc, size_t n) {
+        void *mem = alloc.allocate(n * sizeof(T), alignof(T));
+        if (!mem) {
+            return nullptr;
+        }
+        T *arr = static_cast<T *>(mem);
+        for (size_t i = 0; i < n; ++i) {
+            new (static_cast<void *>(arr + i)) T();
+        }
+        return arr;
+    }
+
+    /**
+     * Destroy an array of @code n @endcode elements made by
+     * @code alloc_create_array @endcode with the same allocator.
+     * Null pointers are ignored.
+     */
+    template<typename T, typename Alloc>
+    inline void alloc_destroy_array(Alloc &alloc, T *arr, size_t n) {
+        if (!arr) {
+            return;
+        }
+        for (size_t i = n; i > 0; --i) {
+            arr[i - 1].~T();
+        }
+        alloc.deallocate(arr, n * sizeof(T), alignof(T));
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_ALLOCATOR_H
@@ -0,0 +1,322 @@
+/**
+ * @file Arena.h
+ * @brief Monotonic bump-pointer arena and scoped reset.
+ *
+ * An arena hands out memory by advancing a pointer through a buffer
+ * and never frees individual allocations; everything allocated since
+ * a point in time is released at once by rewinding to it. This suits
+ * data that lives for one iteration of a loop: containers built during
+ * the iteration draw from the arena and an @code arena_scope @endcode
+ * at the top of the loop body takes it all back in constant time.
+ *
+ * The arena starts from an optional caller-supplied buffer, typically
+ * on the stack, and when that is exhausted chains blocks obtained from
+ * @code mem::alloc @endcode. Chained blocks are kept across rewinds and
+ * reused, so a loop whose iterations need the same amount of memory
+ * stops calling @code mem::alloc @endcode after the first iteration.
+ *
+ * Containers take an @code arena_allocator @endcode, which refers to
+ * an arena and satisfies the allocator concept of Allocator.h.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_ARENA_H
+#define EMBEDDEDCPLUSPLUS_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <wlib/memory>
+
+namespace wlp {
+
+    /**
+     * Monotonic arena. Not copyable, and not safe to use from several
+     * threads at once.
+     */
+    class arena {
+        /**
+         * Header of a chained block; the usable memory follows it.
+         */
+        struct block {
+            block *m_next;
+            char *m_end;
+
+            char *begin() {
+                return reinterpret_cast<char *>(this + 1);
+            }
+        };
+
+    public:
+        static constexpr size_t default_block_size = 1024;
+
+        /**
+         * Position in the arena, returned by @code mark @endcode.
+         */
+        struct marker {
+            block *m_block;
+            char *m_cur;
+        };
+
+        /**
+         * Create an arena with no initial buffer, which allocates its
+         * first block on first use.
+         *
+         * @param block_size size of the chained blocks, or zero to
+         *                   never allocate any
+         */
+        explicit arena(size_t block_size = default_block_size)
+                : arena(nullptr, 0, block_size) {}
+
+        /**
+         * Create an arena that first uses the given buffer, which must
+         * outlive it.
+         *
+         * @param buffer     the initial buffer
+         * @param size       size of the initial buffer in bytes
+         * @param block_size size of the chained blocks, or zero to
+         *                   fail allocations once the buffer is full
+         */
+        arena(void *buffer, size_t size, size_t block_size = default_block_size)
+                : m_buffer(static_cast<char *>(buffer)),
+                  m_buffer_end(static_cast<char *>(buffer) + size),
+                  m_cur(m_buffer),
+                  m_end(m_buffer_end),
+                  m_block(nullptr),
+                  m_first(nullptr),
+                  m_block_size(block_size) {}
+
+        /**
+         * Free the chained blocks. Objects still in the arena are
+         * not destroyed.
+         */
+        ~arena() {
+            block *b = m_first;
+            while (b) {
+                block *next = b->m_next;
+                mem::free(b);
+                b = next;
+            }
+        }
+
+        /**
+         * Allocate memory from the arena.
+         *
+         * @param size  number of bytes
+         * @param align alignment, a power of two
+         * @return the memory, or null if the arena cannot grow
+         */
+        void *allocate(size_t size, size_t align) {
+            char *p = align_up(m_cur, align);
+            if (p + size > m_end || p < m_cur) {
+                p = grow(size, align);
+                if (!p) {
+                    return nullptr;
+                }
+            }
+            m_cur = p + size;
+            return p;
+        }
+
+        /**
+         * Memory is not returned individually, except that the most
+         * recent allocation is taken back, so a temporary freed right
+         * after it was made costs no space.
+         */
+        void deallocate(void *ptr, size_t size, size_t) {
+            if (static_cast<char *>(ptr) + size == m_cur) {
+                m_cur = static_cast<char *>(ptr);
+            }
+        }
+
+        /**
+         * @return the current position, to later @code rewind @endcode to
+         */
+        marker mark() const {
+            return {m_block, m_cur};
+        }
+
+        /**
+         * Release everything allocated since the marker was taken.
+         * Objects in the released memory must already be destroyed.
+         *
+         * @param m a marker of this arena that is not older than any
+         *          marker already rewound to
+         */
+        void rewind(const marker &m) {
+            m_block = m.m_block;
+            m_cur = m.m_cur;
+            m_end = m_block ? m_block->m_end : m_buffer_end;
+        }
+
+        /**
+         * Release everything in the arena. Chained blocks are kept.
+         */
+        void reset() {
+            rewind({nullptr, m_buffer});
+        }
+
+        /**
+         * @return number of bytes handed out in the current block
+         *         and all blocks before it, including alignment padding
+         */
+        size_t used() const {
+            if (!m_block) {
+                return static_cast<size_t>(m_cur - m_buffer);
+            }
+            size_t total = static_cast<size_t>(m_buffer_end - m_buffer);
+            for (block *b = m_first; b != m_block; b = b->m_next) {
+                total += static_cast<size_t>(b->m_end - b->begin());
+            }
+            return total + static_cast<size_t>(m_cur - m_block->begin());
+        }
+
+        /**
+         * @return total bytes held by the initial buffer and all blocks
+         */
+        size_t capacity() const {
+            size_t total = static_cast<size_t>(m_buffer_end - m_buffer);
+            for (block *b = m_first; b; b = b->m_next) {
+                total += static_cast<size_t>(b->m_end - b->begin());
+            }
+            return total;
+        }
+
+    private:
+        static char *align_up(char *p, size_t align) {
+            uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+            addr = (addr + align - 1) & ~static_cast<uintptr_t>(align - 1);
+            return reinterpret_cast<char *>(addr);
+        }
+
+        /**
+         * Move to the next block that can hold the request, reusing
+         * blocks kept from before a rewind and allocating one otherwise.
+         */
+        char *grow(size_t size, size_t align) {
+            block *prev = m_block;
+            block *next = m_block ? m_block->m_next : m_first;
+            while (next) {
+                char *p = align_up(next->begin(), align);
+                if (p + size <= next->m_end) {
+                    m_block = next;
+                    m_end = next->m_end;
+                    return p;
+                }
+                prev = next;
+                next = next->m_next;
+            }
+            if (m_block_size == 0) {
+                return nullptr;
+            }
+            size_t need = size + align;
+            size_t bytes = need > m_block_size ? need : m_block_size;
+            block *b = static_cast<block *>(mem::alloc(sizeof(block) + bytes));
+            if (!b) {
+                return nullptr;
+            }
+            b->m_next = nullptr;
+            b->m_end = b->begin() + bytes;
+            if (prev) {
+                prev->m_next = b;
+            } else {
+                m_first = b;
+            }
+            m_block = b;
+            m_end = b->m_end;
+            return align_up(b->begin(), align);
+        }
+
+        char *m_buffer;
+        char *m_buffer_end;
+        char *m_cur;
+        char *m_end;
+        /**
+         * Current chained block, or null while in the initial buffer.
+         */
+        block *m_block;
+        block *m_first;
+        size_t m_block_size;
+
+        arena(const arena &) = delete;
+
+        arena &operator=(const arena &) = delete;
+    };
+
+    /**
+     * Arena with an initial buffer of the given size inside the object,
+     * for placing on the stack.
+     *
+     * @tparam tSize size of the inline buffer in bytes
+     */
+    template<size_t tSize>
+    class inline_arena : public arena {
+    public:
+        explicit inline_arena(size_t block_size = default_block_size)
+                : arena(m_storage, tSize, block_size) {}
+
+    private:
+        alignas(max_align_t) char m_storage[tSize];
+    };
+
+    /**
+     * Rewinds an arena to where it was when the scope was entered.
+     * Containers using the arena must be declared after the scope, so
+     * that they are destroyed before it.
+     */
+    class arena_scope {
+    public:
+        explicit arena_scope(arena &a)
+                : m_arena(a),
+                  m_mark(a.mark()) {}
+
+        ~arena_scope() {
+            m_arena.rewind(m_mark);
+        }
+
+    private:
+        arena &m_arena;
+        arena::marker m_mark;
+
+        arena_scope(const arena_scope &) = delete;
+
+        arena_scope &operator=(const arena_scope &) = delete;
+    };
+
+    /**
+     * Allocator that draws from an arena, for use as the allocator
+     * of containers and strings. Copies refer to the same arena.
+     */
+    class arena_allocator {
+    public:
+        explicit arena_allocator(arena &a)
+                : m_arena(&a) {}
+
+        void *allocate(size_t size, size_t align) {
+            return m_arena->allocate(size, align);
+        }
+
+        void deallocate(void *ptr, size_t size, size_t align) {
+            m_arena->deallocate(ptr, size, align);
+        }
+
+        arena *get_arena() const {
+            return m_arena;
+        }
+
+        bool operator==(const arena_allocator &o) const {
+            return m_arena == o.m_arena;
+        }
+
+        bool operator!=(const arena_allocator &o) const {
+            return m_arena != o.m_arena;
+        }
+
+    private:
+        arena *m_arena;
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_ARENA_H
@@ -1,139 +1,450 @@
+/**
+ * @file Array2D.h
+ * @brief Two-dimensional array backed by a single contiguous block.
+ *
+ * The array is stored row-major in one allocation made through
+ * the wlib memory functions. Each row occupies @code stride @endcode
+ * elements, of which the first @code y @endcode are used, so rows
+ * may be padded to keep every row aligned for vectorized sweeps.
+ *
+ * @bug No known bugs
+ */
+
 #ifndef EMBEDDEDCPLUSPLUS_ARRAY2D_H
 #define EMBEDDEDCPLUSPLUS_ARRAY2D_H
 
 #include <wlib/stl/InitializerList.h>
 #include <wlib/utility>
+#include <wlib/memory>
+#include <stdint.h>
 #include <string.h>
 
+/**
+ * Byte alignment of the first element of an array2d. Rows
+ * created with a padded stride are aligned to this boundary.
+ */
+#ifndef WLIB_ARRAY2D_ALIGN
+#define WLIB_ARRAY2D_ALIGN 32
+#endif
+
 namespace wlp {
 
+    /**
+     * View over a single row of an array2d. The view does
+     * not own the elements and is invalidated if the array
+     * is destroyed or moved.
+     *
+     * @tparam val_t element type, which may be const
+     * @tparam len_t index type
+     */
     template<typename val_t, typename len_t>
-    class __array2d_access {
+    class array2d_row {
     public:
-
-        __array2d_access(val_t *sub_arr, len_t len)
-            : m_sub_arr(sub_arr),
+        array2d_row(val_t *data, len_t len)
+            : m_data(data),
               m_len(len) {}
 
-        val_t *get() {
-            return m_sub_arr;
+        /**
+         * @return pointer to the first element of the row
+         */
+        val_t *data() const {
+            return m_data;
+        }
+
+        /**
+         * @return pointer to the first element of the row, the same
+         * as @code data @endcode
+         */
+        val_t *get() const {
+            return m_data;
         }
 
-        val_t &operator[](len_t t) {
-            return m_sub_arr[t];
+        /**
+         * @return the number of elements in the row
+         */
+        len_t size() const {
+            return m_len;
+        }
+
+        val_t &operator[](len_t j) const {
+            return m_data[j];
+        }
+
+        val_t *begin() const {
+            return m_data;
+        }
+
+        val_t *end() const {
+            return m_data + m_len;
         }
 
     private:
-        val_t *m_sub_arr;
+        val_t *m_data;
         len_t m_len;
     };
 
+    /**
+     * View over a single column of an array2d. Consecutive
+     * elements are one stride apart in memory.
+     *
+     * @tparam val_t element type, which may be const
+     * @tparam len_t index type
+     */
+    template<typename val_t, typename len_t>
+    class array2d_col {
+    public:
+        array2d_col(val_t *data, len_t len, len_t stride)
+            : m_data(data),
+              m_len(len),
+              m_stride(stride) {}
+
+        /**
+         * @return the number of elements in the column
+         */
+        len_t size() const {
+            return m_len;
+        }
+
+        /**
+         * @return the distance in elements between consecutive
+         * elements of the column
+         */
+        len_t stride() const {
+            return m_stride;
+        }
+
+        val_t &operator[](len_t i) const {
+            return m_data[static_cast<size_t>(i) * static_cast<size_t>(m_stride)];
+        }
+
+    private:
+        val_t *m_data;
+        len_t m_len;
+        len_t m_stride;
+    };
+
+    /**
+     * Row proxy returned by @code array2d::operator[] @endcode.
+     */
+    template<typename val_t, typename len_t>
+    using __array2d_access = array2d_row<val_t, len_t>;
+
+    /**
+     * Two-dimensional array of @code x @endcode rows by
+     * @code y @endcode columns. The elements are stored in a single
+     * allocation, so iterating over rows and then columns is a linear
+     * scan through memory.
+     *
+     * @tparam val_t element type
+     * @tparam len_t index type
+     */
     template<typename val_t, typename len_t = size_t>
     class array2d {
     public:
+        typedef val_t val_type;
+        typedef len_t size_type;
+        typedef array2d_row<val_t, len_t> row_type;
+        typedef array2d_row<const val_t, len_t> const_row_type;
+        typedef array2d_col<val_t, len_t> col_type;
+        typedef array2d_col<const val_t, len_t> const_col_type;
+
+        /**
+         * Byte alignment of the first element.
+         */
+        static constexpr size_t alignment = WLIB_ARRAY2D_ALIGN;
+
+        /**
+         * Compute the smallest stride no less than @code y @endcode
+         * for which every row starts on an aligned boundary. If the
+         * element size does not divide the alignment, no padding
+         * is added.
+         *
+         * @param y number of columns
+         * @return padded row stride in elements
+         */
+        static len_t padded_stride(len_t y) {
+            if (alignment % sizeof(val_t) != 0) {
+                return y;
+            }
+            size_t per = alignment / sizeof(val_t);
+            return static_cast<len_t>((static_cast<size_t>(y) + per - 1) / per * per);
+        }
 
+        /**
+         * Create an array with rows packed without padding.
+         *
+         * @param x number of rows
+         * @param y number of columns
+         */
         array2d(len_t x, len_t y)
+            : array2d(x, y, y) {}
+
+        /**
+         * Create an array with each row occupying @code stride @endcode
+         * elements. A stride smaller than @code y @endcode is raised
+         * to @code y @endcode. The array is 0 by 0 and its data null
+         * if it could not be allocated.
+         *
+         * @param x      number of rows
+         * @param y      number of columns
+         * @param stride distance in elements between row starts
+         */
+        array2d(len_t x, len_t y, len_t stride)
             : m_x(x),
-              m_y(y) {
-            make_array(x, y);
+              m_y(y),
+              m_stride(stride < y ? y : stride) {
+            make_array();
         }
 
-        array2d(wlp::initializer_list<wlp::initializer_list<val_t>> l) {
-            m_x = static_cast<len_t>(l.size());
-            m_y = static_cast<len_t>(l.begin()->size());
-            make_array(m_x, m_y);
+        array2d(wlp::initializer_list<wlp::initializer_list<val_t>> l)
+            : m_x(static_cast<len_t>(l.size())),
+              m_y(static_cast<len_t>(l.size() ? l.begin()->size() : 0)),
+              m_stride(m_y) {
+            make_array();
+            if (!m_data) {
+                return;
+            }
 
-            int i = 0;
+            val_t *row = m_data;
             for (auto &array : l) {
-                int j = 0;
+                val_t *cur = row;
                 for (auto &e : array) {
-                    m_arr[i][j] = wlp::move(e);
-                    j++;
+                    *cur++ = wlp::move(e);
                 }
-                i++;
+                row += m_stride;
             }
         }
 
         array2d(array2d<val_t, len_t> &&arr) noexcept
-            : m_arr(arr.m_arr),
+            : m_block(arr.m_block),
+              m_data(arr.m_data),
               m_x(arr.m_x),
-              m_y(arr.m_y) {
+              m_y(arr.m_y),
+              m_stride(arr.m_stride) {
+            arr.m_block = nullptr;
+            arr.m_data = nullptr;
             arr.m_x = 0;
             arr.m_y = 0;
-            arr.m_arr = nullptr;
+            arr.m_stride = 0;
         }
 
         ~array2d() {
-            if (m_arr) {
-                delete_array();
-            }
+            delete_array();
         }
 
+        /**
+         * @return number of rows
+         */
         len_t x() const {
             return m_x;
         }
 
+        /**
+         * @return number of columns
+         */
         len_t y() const {
             return m_y;
         }
 
+        /**
+         * @return number of logical elements
+         */
         len_t xy() const {
-            return m_x * m_y;
+            return static_cast<len_t>(m_x * m_y);
+        }
+
+        /**
+         * @return distance in elements between the starts of
+         * consecutive rows
+         */
+        len_t stride() const {
+            return m_stride;
         }
 
+        /**
+         * @return number of elements in the backing block,
+         * including row padding
+         */
+        size_t capacity() const {
+            return static_cast<size_t>(m_x) * static_cast<size_t>(m_stride);
+        }
+
+        /**
+         * @return whether rows are stored without padding, such that
+         * the logical elements form one unbroken sequence
+         */
+        bool packed() const {
+            return m_stride == m_y;
+        }
+
+        /**
+         * @return pointer to the first element of the first row
+         */
+        val_t *data() {
+            return m_data;
+        }
+
+        /**
+         * @return pointer to the first element of the first row
+         */
+        const val_t *data() const {
+            return m_data;
+        }
+
+        /**
+         * Set every byte of the backing block, padding included, to zero
+         * with a single call to @code memset @endcode.
+         */
         void zero_clear() {
-            for (len_t x = 0; x < m_x; ++x) {
-                memset(m_arr[x], 0, static_cast<size_t>(m_y) * sizeof(val_t));
+            memset(m_data, 0, capacity() * sizeof(val_t));
+        }
+
+        /**
+         * Assign a value to every element of the backing block,
+         * padding included.
+         *
+         * @param val value to assign
+         */
+        void fill(const val_t &val) {
+            val_t *end = m_data + capacity();
+            for (val_t *cur = m_data; cur != end; ++cur) {
+                *cur = val;
             }
         }
 
         array2d<val_t, len_t> &operator=(array2d<val_t, len_t> &&arr) noexcept {
-            m_x = arr.m_x;
-            m_y = arr.m_y;
-            m_arr = arr.m_arr;
-            arr.m_x = 0;
-            arr.m_y = 0;
-            arr.m_arr = nullptr;
+            if (this != &arr) {
+                delete_array();
+                m_block = arr.m_block;
+                m_data = arr.m_data;
+                m_x = arr.m_x;
+                m_y = arr.m_y;
+                m_stride = arr.m_stride;
+                arr.m_block = nullptr;
+                arr.m_data = nullptr;
+                arr.m_x = 0;
+                arr.m_y = 0;
+                arr.m_stride = 0;
+            }
             return *this;
         };
 
-        val_t **get() {
-            return m_arr;
+        /**
+         * Unchecked element access.
+         *
+         * @param i row index
+         * @param j column index
+         * @return reference to the element
+         */
+        val_t &operator()(len_t i, len_t j) {
+            return m_data[offset(i, j)];
+        }
+
+        const val_t &operator()(len_t i, len_t j) const {
+            return m_data[offset(i, j)];
+        }
+
+        /**
+         * Kept from when the array was a table of row pointers;
+         * @code get()[i][j] @endcode indexes through the row views.
+         *
+         * @return this array
+         */
+        array2d<val_t, len_t> &get() {
+            return *this;
+        }
+
+        const array2d<val_t, len_t> &get() const {
+            return *this;
         }
 
-        __array2d_access<val_t, len_t> operator[](len_t x) {
-            return __array2d_access<val_t, len_t>(m_arr[x], m_y);
+        row_type operator[](len_t i) {
+            return row(i);
+        };
+
+        const_row_type operator[](len_t i) const {
+            return row(i);
         };
 
+        /**
+         * @param i row index
+         * @return a view of the row
+         */
+        row_type row(len_t i) {
+            return row_type(m_data + offset(i, 0), m_y);
+        }
+
+        const_row_type row(len_t i) const {
+            return const_row_type(m_data + offset(i, 0), m_y);
+        }
+
+        /**
+         * @param j column index
+         * @return a strided view of the column
+         */
+        col_type col(len_t j) {
+            return col_type(m_data + j, m_x, m_stride);
+        }
+
+        const_col_type col(len_t j) const {
+            return const_col_type(m_data + j, m_x, m_stride);
+        }
+
         // Disable copy constructor and assignment
         array2d(const array2d<val_t, len_t> &) = delete;
 
         array2d<val_t, len_t> &operator=(const array2d<val_t, len_t> &) = delete;
 
     private:
-        void make_array(int x, int y) {
-            if (m_arr) {
-                delete_array();
+        size_t offset(len_t i, len_t j) const {
+            return static_cast<size_t>(i) * static_cast<size_t>(m_stride) + static_cast<size_t>(j);
+        }
+
+        /**
+         * Allocate the backing block with enough slack elements
+         * to move the first element onto an aligned boundary.
+         * If it cannot be allocated the array is left 0 by 0.
+         */
+        void make_array() {
+            size_t slack = alignment % sizeof(val_t) == 0 ? alignment / sizeof(val_t) - 1 : 0;
+            m_block = create<val_t[]>(capacity() + slack);
+            m_data = m_block;
+            if (!m_block) {
+                m_x = 0;
+                m_y = 0;
+                m_stride = 0;
+                return;
             }
-            m_arr = new val_t *[x];
-            for (int tx = 0; tx < x; ++tx) {
-                m_arr[tx] = new val_t[y];
-                memset(m_arr[tx], 0, static_cast<size_t>(y) * sizeof(val_t));
+            for (size_t k = 0; k < slack && reinterpret_cast<uintptr_t>(m_data) % alignment; ++k) {
+                ++m_data;
             }
+            zero_clear();
         }
 
         void delete_array() noexcept {
-            for (len_t x = 0; x < m_x; ++x) {
-                delete[] m_arr[x];
+            if (m_block) {
+                destroy<val_t[]>(m_block);
+                m_block = nullptr;
+                m_data = nullptr;
             }
-            delete[] m_arr;
         }
 
-        val_t **m_arr = nullptr;
+        /**
+         * Pointer returned by the allocator.
+         */
+        val_t *m_block = nullptr;
+        /**
+         * Aligned pointer to the first element.
+         */
+        val_t *m_data = nullptr;
         len_t m_x = 0;
         len_t m_y = 0;
+        len_t m_stride = 0;
     };
 
+    template<typename val_t, typename len_t>
+    constexpr size_t array2d<val_t, len_t>::alignment;
+
 }
 
 #endif //EMBEDDEDCPLUSPLUS_ARRAY2D_H
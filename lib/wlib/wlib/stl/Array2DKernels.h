@@ -0,0 +1,347 @@
+/**
+ * @file Array2DKernels.h
+ * @brief Numeric kernels over array2d.
+ *
+ * Cache-blocked transpose and matrix multiply, elementwise
+ * arithmetic, 2D convolution and box filtering over arrays of
+ * arithmetic types. Row operations use SSE or AVX for float,
+ * double and int when the compiler targets those instruction
+ * sets, and fall back to scalar loops otherwise, or when
+ * @code WLIB_NO_SIMD @endcode is defined.
+ *
+ * Kernels return false and leave the output untouched if the
+ * dimensions of the arguments do not agree.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_ARRAY2DKERNELS_H
+#define EMBEDDEDCPLUSPLUS_ARRAY2DKERNELS_H
+
+#include <wlib/stl/Allocator.h>
+#include <wlib/stl/Array2D.h>
+#include <wlib/stl/SimdOps.h>
+
+/**
+ * Edge length, in elements, of the square tiles used by
+ * the blocked transpose and the column tiles of multiply.
+ */
+#ifndef WLIB_ARRAY2D_BLOCK
+#define WLIB_ARRAY2D_BLOCK 32
+#endif
+
+namespace wlp {
+
+    template<typename T, typename L>
+    inline bool __array2d_same_shape(const array2d<T, L> &a, const array2d<T, L> &b) {
+        return a.x() == b.x() && a.y() == b.y();
+    }
+
+    /**
+     * Apply a binary row primitive to every row. If all three arrays
+     * are packed, the whole block is processed in one call.
+     */
+    template<typename T, typename L, typename RowOp>
+    inline bool __array2d_binary(const array2d<T, L> &a, const array2d<T, L> &b,
+                                 array2d<T, L> &out, RowOp op) {
+        if (!__array2d_same_shape(a, b) || !__array2d_same_shape(a, out)) {
+            return false;
+        }
+        if (a.packed() && b.packed() && out.packed()) {
+            op(a.data(), b.data(), out.data(), a.capacity());
+            return true;
+        }
+        for (L i = 0; i < a.x(); ++i) {
+            op(a.row(i).data(), b.row(i).data(), out.row(i).data(), static_cast<size_t>(a.y()));
+        }
+        return true;
+    }
+
+    /**
+     * Compute @code out = a + b @endcode elementwise. The output
+     * may be one of the inputs.
+     */
+    template<typename T, typename L>
+    bool add(const array2d<T, L> &a, const array2d<T, L> &b, array2d<T, L> &out) {
+        return __array2d_binary(a, b, out, &__simd_ops<T>::add);
+    }
+
+    /**
+     * Compute @code out = a - b @endcode elementwise.
+     */
+    template<typename T, typename L>
+    bool subtract(const array2d<T, L> &a, const array2d<T, L> &b, array2d<T, L> &out) {
+        return __array2d_binary(a, b, out, &__simd_ops<T>::sub);
+    }
+
+    /**
+     * Compute the elementwise (Hadamard) product of two arrays.
+     */
+    template<typename T, typename L>
+    bool multiply_elements(const array2d<T, L> &a, const array2d<T, L> &b, array2d<T, L> &out) {
+        return __array2d_binary(a, b, out, &__simd_ops<T>::mul);
+    }
+
+    /**
+     * Compute @code out = s * a @endcode.
+     */
+    template<typename T, typename L>
+    bool scale(const array2d<T, L> &a, T s, array2d<T, L> &out) {
+        if (!__array2d_same_shape(a, out)) {
+            return false;
+        }
+        if (a.packed() && out.packed()) {
+            __simd_ops<T>::scale(a.data(), s, out.data(), a.capacity());
+            return true;
+        }
+        for (L i = 0; i < a.x(); ++i) {
+            __simd_ops<T>::scale(a.row(i).data(), s, out.row(i).data(), static_cast<size_t>(a.y()));
+        }
+        return true;
+    }
+
+    template<typename T>
+    inline void __transpose_tile(const T *src, size_t src_stride, T *dst, size_t dst_stride,
+                                 size_t rows, size_t cols) {
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                dst[j * dst_stride + i] = src[i * src_stride + j];
+            }
+        }
+    }
+
+#ifdef WLIB_SIMD
+    /**
+     * Float tiles are transposed in 4x4 register blocks.
+     */
+    template<>
+    inline void __transpose_tile<float>(const float *src, size_t src_stride, float *dst, size_t dst_stride,
+                                        size_t rows, size_t cols) {
+        size_t i = 0;
+        for (; i + 4 <= rows; i += 4) {
+            size_t j = 0;
+            for (; j + 4 <= cols; j += 4) {
+                const float *s = src + i * src_stride + j;
+                __m128 r0 = _mm_loadu_ps(s);
+                __m128 r1 = _mm_loadu_ps(s + src_stride);
+                __m128 r2 = _mm_loadu_ps(s + 2 * src_stride);
+                __m128 r3 = _mm_loadu_ps(s + 3 * src_stride);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                float *d = dst + j * dst_stride + i;
+                _mm_storeu_ps(d, r0);
+                _mm_storeu_ps(d + dst_stride, r1);
+                _mm_storeu_ps(d + 2 * dst_stride, r2);
+                _mm_storeu_ps(d + 3 * dst_stride, r3);
+            }
+            for (; j < cols; ++j) {
+                for (size_t k = i; k < i + 4; ++k) {
+                    dst[j * dst_stride + k] = src[k * src_stride + j];
+                }
+            }
+        }
+        for (; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                dst[j * dst_stride + i] = src[i * src_stride + j];
+            }
+        }
+    }
+#endif
+
+    /**
+     * Transpose an array in square tiles so that both the reads
+     * and the writes of a tile stay within cache.
+     *
+     * @param src x by y source array
+     * @param dst y by x destination array, which must not be src
+     * @return false if the dimensions do not match
+     */
+    template<typename T, typename L>
+    bool transpose(const array2d<T, L> &src, array2d<T, L> &dst) {
+        if (&src == &dst || src.x() != dst.y() || src.y() != dst.x()) {
+            return false;
+        }
+        const size_t rows = static_cast<size_t>(src.x());
+        const size_t cols = static_cast<size_t>(src.y());
+        const size_t ss = static_cast<size_t>(src.stride());
+        const size_t ds = static_cast<size_t>(dst.stride());
+        const size_t block = WLIB_ARRAY2D_BLOCK;
+        for (size_t ib = 0; ib < rows; ib += block) {
+            size_t ilen = rows - ib < block ? rows - ib : block;
+            for (size_t jb = 0; jb < cols; jb += block) {
+                size_t jlen = cols - jb < block ? cols - jb : block;
+                __transpose_tile<T>(src.data() + ib * ss + jb, ss, dst.data() + jb * ds + ib, ds, ilen, jlen);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Compute the matrix product @code c = a * b @endcode. The
+     * loops run in i-k-j order over column tiles of @code b @endcode
+     * so the innermost loop is a vectorized sweep along rows.
+     *
+     * @param a x by n array
+     * @param b n by y array
+     * @param c x by y output, which must not alias a or b
+     * @return false if the dimensions do not match
+     */
+    template<typename T, typename L>
+    bool multiply(const array2d<T, L> &a, const array2d<T, L> &b, array2d<T, L> &c) {
+        if (a.y() != b.x() || c.x() != a.x() || c.y() != b.y() || &c == &a || &c == &b) {
+            return false;
+        }
+        const size_t n = static_cast<size_t>(a.y());
+        const size_t cols = static_cast<size_t>(b.y());
+        const size_t as = static_cast<size_t>(a.stride());
+        const size_t bs = static_cast<size_t>(b.stride());
+        const size_t cs = static_cast<size_t>(c.stride());
+        const size_t kblock = 4 * WLIB_ARRAY2D_BLOCK;
+        const size_t jblock = 8 * WLIB_ARRAY2D_BLOCK;
+        c.zero_clear();
+        for (size_t kb = 0; kb < n; kb += kblock) {
+            size_t kend = n - kb < kblock ? n : kb + kblock;
+            for (size_t jb = 0; jb < cols; jb += jblock) {
+                size_t jlen = cols - jb < jblock ? cols - jb : jblock;
+                for (size_t i = 0; i < static_cast<size_t>(a.x()); ++i) {
+                    const T *arow = a.data() + i * as;
+                    T *crow = c.data() + i * cs + jb;
+                    for (size_t k = kb; k < kend; ++k) {
+                        __simd_ops<T>::axpy(arow[k], b.data() + k * bs + jb, crow, jlen);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Convolve an array with a kernel, producing an output of the
+     * same size. Samples outside the source are treated as zero and
+     * the kernel is centred on element @code (kx / 2, ky / 2) @endcode.
+     *
+     * @param src    source array
+     * @param kernel kx by ky convolution kernel
+     * @param dst    output with the shape of src, which must not be src
+     * @return false if the dimensions do not match
+     */
+    template<typename T, typename L>
+    bool convolve(const array2d<T, L> &src, const array2d<T, L> &kernel, array2d<T, L> &dst) {
+        if (!__array2d_same_shape(src, dst) || &src == &dst) {
+            return false;
+        }
+        typedef long diff_t;
+        const diff_t rows = static_cast<diff_t>(src.x());
+        const diff_t cols = static_cast<diff_t>(src.y());
+        const diff_t cx = static_cast<diff_t>(kernel.x() / 2);
+        const diff_t cy = static_cast<diff_t>(kernel.y() / 2);
+        dst.zero_clear();
+        for (diff_t i = 0; i < rows; ++i) {
+            T *drow = dst.row(static_cast<L>(i)).data();
+            for (L u = 0; u < kernel.x(); ++u) {
+                diff_t si = i + cx - static_cast<diff_t>(u);
+                if (si < 0 || si >= rows) {
+                    continue;
+                }
+                const T *srow = src.row(static_cast<L>(si)).data();
+                for (L v = 0; v < kernel.y(); ++v) {
+                    diff_t d = cy - static_cast<diff_t>(v);
+                    diff_t lo = d < 0 ? -d : 0;
+                    diff_t hi = d > 0 ? cols - d : cols;
+                    if (lo >= hi) {
+                        continue;
+                    }
+                    __simd_ops<T>::axpy(kernel(u, v), srow + lo + d, drow + lo, static_cast<size_t>(hi - lo));
+                }
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    inline void __box_normalize(const T *acc, T *out, size_t n, size_t area) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<T>(acc[i] / static_cast<T>(area));
+        }
+    }
+
+    inline void __box_normalize(const float *acc, float *out, size_t n, size_t area) {
+        __simd_ops<float>::scale(acc, 1.0f / static_cast<float>(area), out, n);
+    }
+
+    inline void __box_normalize(const double *acc, double *out, size_t n, size_t area) {
+        __simd_ops<double>::scale(acc, 1.0 / static_cast<double>(area), out, n);
+    }
+
+    /**
+     * Replace each element by the mean over the square window of
+     * the given radius centred on it, treating samples outside the
+     * source as zero. Running sums make the cost independent of the
+     * radius. Integer arrays are divided with truncation.
+     *
+     * @param src    source array
+     * @param radius window radius, such that the window is
+     *               @code 2 * radius + 1 @endcode elements wide
+     * @param dst    output with the shape of src; may be src
+     * @return false if the dimensions do not match or the scratch
+     *         space, an array of the source's size and one row, could
+     *         not be allocated
+     */
+    template<typename T, typename L>
+    bool box_filter(const array2d<T, L> &src, L radius, array2d<T, L> &dst) {
+        if (!__array2d_same_shape(src, dst)) {
+            return false;
+        }
+        const size_t rows = static_cast<size_t>(src.x());
+        const size_t cols = static_cast<size_t>(src.y());
+        const size_t r = static_cast<size_t>(radius);
+        const size_t area = (2 * r + 1) * (2 * r + 1);
+        if (rows == 0 || cols == 0) {
+            return true;
+        }
+        // Horizontal window sums
+        array2d<T, L> sums(src.x(), src.y(), src.stride());
+        if (!sums.data()) {
+            return false;
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            const T *srow = src.data() + i * static_cast<size_t>(src.stride());
+            T *hrow = sums.data() + i * static_cast<size_t>(sums.stride());
+            T acc = T();
+            for (size_t j = 0; j < r && j < cols; ++j) {
+                acc = static_cast<T>(acc + srow[j]);
+            }
+            for (size_t j = 0; j < cols; ++j) {
+                if (j + r < cols) {
+                    acc = static_cast<T>(acc + srow[j + r]);
+                }
+                hrow[j] = acc;
+                if (j >= r) {
+                    acc = static_cast<T>(acc - srow[j - r]);
+                }
+            }
+        }
+        // Vertical window sums over whole rows
+        allocator alloc;
+        T *acc = alloc_create_array<T>(alloc, cols);
+        if (!acc) {
+            return false;
+        }
+        for (size_t i = 0; i < r && i < rows; ++i) {
+            __simd_ops<T>::add(acc, sums.row(static_cast<L>(i)).data(), acc, cols);
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            if (i + r < rows) {
+                __simd_ops<T>::add(acc, sums.row(static_cast<L>(i + r)).data(), acc, cols);
+            }
+            __box_normalize(acc, dst.row(static_cast<L>(i)).data(), cols, area);
+            if (i >= r) {
+                __simd_ops<T>::sub(acc, sums.row(static_cast<L>(i - r)).data(), acc, cols);
+            }
+        }
+        alloc_destroy_array(alloc, acc, cols);
+        return true;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_ARRAY2DKERNELS_H
@@ -15,12 +15,14 @@
 
 #include <wlib/utility>
 #include <wlib/memory>
+#include <wlib/stl/Allocator.h>
+#include <wlib/stl/ContainerStats.h>
 #include <stddef.h>
 
 namespace wlp {
 
     // ArrayList forward declaration.
-    template<typename T>
+    template<typename T, typename Alloc = allocator>
     class array_list;
 
     /**
@@ -29,8 +31,9 @@ namespace wlp {
      * @tparam T list element type
      * @tparam Ref reference type, which may be const
      * @tparam Ptr pointer type, which may be const
+     * @tparam Alloc allocator of the backing list
      */
-    template<typename T, typename Ref, typename Ptr>
+    template<typename T, typename Ref, typename Ptr, typename Alloc = allocator>
     class ArrayListIterator {
     public:
         typedef size_t size_type;
@@ -38,8 +41,8 @@ namespace wlp {
         typedef T val_type;
         typedef Ref reference;
         typedef Ptr pointer;
-        typedef array_list<T> array_list_t;
-        typedef ArrayListIterator<T, Ref, Ptr> self_type;
+        typedef array_list<T, Alloc> array_list_t;
+        typedef ArrayListIterator<T, Ref, Ptr, Alloc> self_type;
 
     private:
         /**
@@ -51,7 +54,7 @@ namespace wlp {
          */
         size_type m_i;
 
-        friend class array_list<T>;
+        friend class array_list<T, Alloc>;
 
     public:
         /**
@@ -267,15 +270,17 @@ namespace wlp {
      * will resize if attempting to insert into a full array.
      *
      * @tparam T value type
+     * @tparam Alloc allocator of the backing array, see Allocator.h
      */
-    template<typename T>
-    class array_list {
+    template<typename T, typename Alloc>
+    class array_list : private Alloc {
     public:
         typedef T val_type;
         typedef size_t size_type;
-        typedef array_list<T> list_type;
-        typedef ArrayListIterator<T, T &, T *> iterator;
-        typedef ArrayListIterator<T, const T &, const T *> const_iterator;
+        typedef Alloc allocator_type;
+        typedef array_list<T, Alloc> list_type;
+        typedef ArrayListIterator<T, T &, T *, Alloc> iterator;
+        typedef ArrayListIterator<T, const T &, const T *, Alloc> const_iterator;
 
     private:
         /**
@@ -291,9 +296,13 @@ namespace wlp {
          */
         size_type m_capacity;
 
-        friend class ArrayListIterator<T, T &, T *>;
+#ifdef WLIB_CONTAINER_STATS
+        container_stats m_stats{&container_stats_global(array_list_kind)};
+#endif
 
-        friend class ArrayListIterator<T, const T &, const T *>;
+        friend class ArrayListIterator<T, T &, T *, Alloc>;
+
+        friend class ArrayListIterator<T, const T &, const T *, Alloc>;
 
     public:
         /**
@@ -301,9 +310,11 @@ namespace wlp {
          * backing array.
          *
          * @param initial_capacity the initial size of the backing array
+         * @param alloc            allocator for the backing array
          */
-        explicit array_list(size_type initial_capacity = 12)
-                : m_size(0),
+        explicit array_list(size_type initial_capacity = 12, const Alloc &alloc = Alloc())
+                : Alloc(alloc),
+                  m_size(0),
                   m_capacity(initial_capacity) {
             init_array(initial_capacity);
         }
@@ -319,7 +330,8 @@ namespace wlp {
          * @param list array list whose resources to transfer
          */
         array_list(list_type &&list)
-                : m_data(move(list.m_data)),
+                : Alloc(list.get_allocator()),
+                  m_data(move(list.m_data)),
                   m_size(move(list.m_size)),
                   m_capacity(move(list.m_capacity)) {
             list.m_data = nullptr;
@@ -335,9 +347,12 @@ namespace wlp {
          *
          * @param values array of values
          * @param length length of the array
+         * @param alloc  allocator for the backing array
          */
-        array_list(const val_type *values, size_type length, size_type initial_capacity)
-                : m_size(length),
+        array_list(const val_type *values, size_type length, size_type initial_capacity,
+                   const Alloc &alloc = Alloc())
+                : Alloc(alloc),
+                  m_size(length),
                   m_capacity(initial_capacity) {
             if (m_capacity < length) {
                 m_capacity = length;
@@ -368,10 +383,26 @@ namespace wlp {
             if (!m_data) {
                 return;
             }
-            destroy<val_type[]>(m_data);
+            alloc_destroy_array(get_alloc(), m_data, m_capacity);
             m_data = nullptr;
         }
 
+        /**
+         * @return a copy of the allocator of this list
+         */
+        allocator_type get_allocator() const {
+            return *this;
+        }
+
+#ifdef WLIB_CONTAINER_STATS
+        /**
+         * @return the operation counters of this list
+         */
+        const container_stats &stats() const {
+            return m_stats;
+        }
+#endif
+
     private:
         /**
          * Initialize the backing array. This function
@@ -381,7 +412,11 @@ namespace wlp {
          * @param initial_size the initial capacity for the backing array
          */
         void init_array(size_type initial_size) {
-            m_data = create<val_type[]>(initial_size);
+            m_data = alloc_create_array<val_type>(get_alloc(), initial_size);
+        }
+
+        Alloc &get_alloc() {
+            return *this;
         }
 
         /**
@@ -403,8 +438,11 @@ namespace wlp {
          * this function will extend the size of the
          * array to twice its capacity and copy
          * the elements of the previous array.
+         *
+         * @return false if the array is full and could
+         *         not be extended, leaving it unchanged
          */
-        void ensure_capacity();
+        bool ensure_capacity();
 
         /**
          * Shift elements in the array at position @code i @endcode
@@ -605,7 +643,9 @@ namespace wlp {
          */
         template<typename V>
         iterator insert(size_type i, V &&val) {
-            ensure_capacity();
+            if (!ensure_capacity()) {
+                return end();
+            }
             normalize(i);
             shift_right(i);
             m_data[i] = forward<V>(val);
@@ -626,7 +666,9 @@ namespace wlp {
             if (it.m_i > m_size) {
                 return end();
             }
-            ensure_capacity();
+            if (!ensure_capacity()) {
+                return end();
+            }
             shift_right(it.m_i);
             m_data[it.m_i] = forward<V>(val);
             ++m_size;
@@ -665,13 +707,16 @@ namespace wlp {
         }
 
         /**
-         * Insert an element to the back of the list.
+         * Insert an element to the back of the list. Nothing
+         * is inserted if the list is full and cannot grow.
          *
          * @param val element to insert
          */
         template<typename V>
         void push_back(V &&val) {
-            ensure_capacity();
+            if (!ensure_capacity()) {
+                return;
+            }
             m_data[m_size] = forward<V>(val);
             ++m_size;
         }
@@ -683,7 +728,9 @@ namespace wlp {
          */
         template<typename V>
         void push_front(V &&val) {
-            ensure_capacity();
+            if (!ensure_capacity()) {
+                return;
+            }
             shift_right(0);
             m_data[0] = forward<V>(val);
             ++m_size;
@@ -751,7 +798,8 @@ namespace wlp {
          * @return reference to this list
          */
         list_type &operator=(list_type &&list) {
-            destroy<val_type[]>(m_data);
+            alloc_destroy_array(get_alloc(), m_data, m_capacity);
+            get_alloc() = list.get_alloc();
             m_data = move(list.m_data);
             m_size = move(list.m_size);
             m_capacity = move(list.m_capacity);
@@ -763,58 +811,68 @@ namespace wlp {
 
     };
 
-    template<typename T>
-    void array_list<T>::ensure_capacity() {
+    template<typename T, typename Alloc>
+    bool array_list<T, Alloc>::ensure_capacity() {
         if (m_size < m_capacity) {
-            return;
+            return true;
         }
         size_type new_capacity = static_cast<size_type>(2 * m_capacity);
-        val_type *new_data = create<val_type[]>(new_capacity);
+        val_type *new_data = alloc_create_array<val_type>(get_alloc(), new_capacity);
+        if (!new_data) {
+            return false;
+        }
         for (size_type i = 0; i < m_size; i++) {
             new_data[i] = m_data[i];
         }
-        destroy<val_type[]>(m_data);
+        WLIB_CONTAINER_STAT(m_stats.record_growth(m_size * sizeof(val_type)));
+        alloc_destroy_array(get_alloc(), m_data, m_capacity);
         m_data = new_data;
         m_capacity = new_capacity;
+        return true;
     }
 
-    template<typename T>
-    void array_list<T>::reserve(size_type new_capacity) {
+    template<typename T, typename Alloc>
+    void array_list<T, Alloc>::reserve(size_type new_capacity) {
         if (new_capacity <= m_capacity) {
             return;
         }
-        val_type *new_data = create<val_type[]>(new_capacity);
+        val_type *new_data = alloc_create_array<val_type>(get_alloc(), new_capacity);
+        if (!new_data) {
+            return;
+        }
         for (size_type i = 0; i < m_size; i++) {
             new_data[i] = m_data[i];
         }
-        destroy<val_type[]>(m_data);
+        WLIB_CONTAINER_STAT(m_stats.record_growth(m_size * sizeof(val_type)));
+        alloc_destroy_array(get_alloc(), m_data, m_capacity);
         m_data = new_data;
         m_capacity = new_capacity;
     }
 
-    template<typename T>
-    void array_list<T>::shrink() {
+    template<typename T, typename Alloc>
+    void array_list<T, Alloc>::shrink() {
         if (m_size == m_capacity) {
             return;
         }
-        val_type *new_data = create<val_type[]>(m_size);
+        val_type *new_data = alloc_create_array<val_type>(get_alloc(), m_size);
         for (size_type i = 0; i < m_size; i++) {
             new_data[i] = m_data[i];
         }
-        destroy<val_type[]>(m_data);
+        WLIB_CONTAINER_STAT(m_stats.record_growth(m_size * sizeof(val_type)));
+        alloc_destroy_array(get_alloc(), m_data, m_capacity);
         m_data = new_data;
         m_capacity = m_size;
     }
 
-    template<typename T>
-    inline void array_list<T>::shift_right(size_type i) {
+    template<typename T, typename Alloc>
+    inline void array_list<T, Alloc>::shift_right(size_type i) {
         for (size_type j = m_size; j > i; j--) {
             m_data[j] = m_data[j - 1];
         }
     }
 
-    template<typename T>
-    inline void array_list<T>::shift_left(size_type i) {
+    template<typename T, typename Alloc>
+    inline void array_list<T, Alloc>::shift_left(size_type i) {
         for (size_type j = i; j < m_size - 1; j++) {
             m_data[j] = m_data[j + 1];
         }
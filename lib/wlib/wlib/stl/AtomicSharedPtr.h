@@ -0,0 +1,224 @@
+/**
+ * @file AtomicSharedPtr.h
+ * @brief Shared pointer that can be read and replaced concurrently.
+ *
+ * An atomic shared pointer publishes one version of an object to
+ * many readers. Readers take snapshots with @code load @endcode while
+ * a writer installs new versions with @code store @endcode or
+ * @code exchange @endcode. A replaced version is not freed until
+ * every snapshot of it has been released.
+ *
+ * The implementation uses split reference counting. The published
+ * version is held by a node whose address shares a 64-bit word with
+ * a count of readers that are in the middle of copying it. A reader
+ * pins the node with one atomic add on that word, copies the shared
+ * pointer out of it, and unpins it. The writer swaps the word and
+ * moves the pin count it got back onto the old node, which is
+ * destroyed by whichever of the writer and the pinned readers finishes
+ * last. No reader ever waits on the writer or on another reader
+ * except to retry a failed unpin when the word changed under it.
+ *
+ * Node addresses must fit in the low 48 bits of the word, which holds
+ * for 32-bit targets and for user-space addresses on 64-bit targets.
+ * Readers may be copying a version at the same time, so the count
+ * policy of the shared pointers must be atomic.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_ATOMICSHAREDPTR_H
+#define EMBEDDEDCPLUSPLUS_ATOMICSHAREDPTR_H
+
+#include <stdint.h>
+
+#include <wlib/memory>
+#include <wlib/utility>
+#include <wlib/stl/SharedPtr.h>
+
+namespace wlp {
+
+    /**
+     * Atomically replaceable shared pointer.
+     *
+     * @tparam T      pointed-to type
+     * @tparam Policy the count policy of the published shared pointers,
+     *                which must be safe to use from several threads
+     */
+    template<typename T, typename Policy = atomic_count<WLIB_SHARED_PTR_COUNT_TYPE>>
+    class atomic_shared_ptr {
+    public:
+        typedef shared_ptr<T, Policy> value_type;
+
+    private:
+        /**
+         * One published version. @code m_refs @endcode collects the pin
+         * counts handed over by the writer and the unpins of readers
+         * that found the word already replaced; it is zero once all of
+         * them are accounted for.
+         */
+        struct node {
+            value_type m_value;
+            int32_t m_refs;
+
+            node(value_type &&value)
+                    : m_value(move(value)),
+                      m_refs(0) {}
+        };
+
+        static constexpr int pin_shift = 48;
+        static constexpr uint64_t pin_one = static_cast<uint64_t>(1) << pin_shift;
+        static constexpr uint64_t ptr_mask = pin_one - 1;
+
+        mutable uint64_t m_word;
+
+    public:
+        constexpr atomic_shared_ptr()
+                : m_word(0) {}
+
+        /**
+         * @param value the first version; the pointer is left empty if
+         *              its node cannot be allocated
+         */
+        explicit atomic_shared_ptr(value_type value)
+                : m_word(0) {
+            make_word(move(value), m_word);
+        }
+
+        ~atomic_shared_ptr() {
+            retire(m_word);
+        }
+
+        /**
+         * Take a snapshot of the current version. The snapshot keeps
+         * its version alive however often the pointer is replaced.
+         *
+         * @return a shared pointer to the current version
+         */
+        value_type load() const {
+            uint64_t word = __atomic_add_fetch(&m_word, pin_one, __ATOMIC_ACQUIRE);
+            node *n = to_node(word);
+            if (!n) {
+                // Pins on an empty word are never read back. They are
+                // left in place, and wrap around within the pin bits
+                // without touching the address.
+                return value_type();
+            }
+            value_type result(n->m_value);
+            unpin(n);
+            return result;
+        }
+
+        /**
+         * Publish a new version. The previous version is released once
+         * no reader is still copying it.
+         *
+         * @param value the new version
+         * @return false if the node for the new version could not be
+         *         allocated, in which case the previous version stays
+         *         published
+         */
+        bool store(value_type value) {
+            uint64_t word;
+            if (!make_word(move(value), word)) {
+                return false;
+            }
+            retire(__atomic_exchange_n(&m_word, word, __ATOMIC_ACQ_REL));
+            return true;
+        }
+
+        /**
+         * Publish a new version and take back the previous one. If the
+         * node for the new version cannot be allocated, the previous
+         * version stays published and an empty pointer is returned;
+         * use @code store @endcode where that must be told apart from
+         * an empty previous version.
+         *
+         * @param value the new version
+         * @return the previous version
+         */
+        value_type exchange(value_type value) {
+            uint64_t word;
+            if (!make_word(move(value), word)) {
+                return value_type();
+            }
+            uint64_t old = __atomic_exchange_n(&m_word, word, __ATOMIC_ACQ_REL);
+            node *n = to_node(old);
+            value_type result;
+            if (n) {
+                result = n->m_value;
+            }
+            retire(old);
+            return result;
+        }
+
+        operator value_type() const {
+            return load();
+        }
+
+        atomic_shared_ptr &operator=(value_type value) {
+            store(move(value));
+            return *this;
+        }
+
+    private:
+        /**
+         * Wrap a version in a node and build its word, which is zero
+         * for an empty version.
+         *
+         * @return false if the node could not be allocated
+         */
+        static bool make_word(value_type &&value, uint64_t &word) {
+            if (!value) {
+                word = 0;
+                return true;
+            }
+            node *n = create<node>(move(value));
+            word = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(n));
+            return n != nullptr;
+        }
+
+        static node *to_node(uint64_t word) {
+            return reinterpret_cast<node *>(static_cast<uintptr_t>(word & ptr_mask));
+        }
+
+        /**
+         * Release the pin of a reader of @code n @endcode. If the node is
+         * still published, the pin is taken off the word; otherwise the
+         * writer has moved it onto the node.
+         */
+        void unpin(node *n) const {
+            uint64_t word = __atomic_load_n(&m_word, __ATOMIC_RELAXED);
+            while (to_node(word) == n) {
+                if (__atomic_compare_exchange_n(&m_word, &word, word - pin_one, true,
+                                                __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+                    return;
+                }
+            }
+            if (__atomic_sub_fetch(&n->m_refs, 1, __ATOMIC_ACQ_REL) == 0) {
+                destroy<node>(n);
+            }
+        }
+
+        /**
+         * Hand a replaced word's pins over to its node, destroying the
+         * node if no reader is still pinning it.
+         */
+        static void retire(uint64_t word) {
+            node *n = to_node(word);
+            if (!n) {
+                return;
+            }
+            int32_t pins = static_cast<int32_t>(word >> pin_shift);
+            if (__atomic_add_fetch(&n->m_refs, pins, __ATOMIC_ACQ_REL) == 0) {
+                destroy<node>(n);
+            }
+        }
+
+        atomic_shared_ptr(const atomic_shared_ptr &) = delete;
+
+        atomic_shared_ptr &operator=(const atomic_shared_ptr &) = delete;
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_ATOMICSHAREDPTR_H
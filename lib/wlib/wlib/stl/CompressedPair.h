@@ -0,0 +1,113 @@
+/**
+ * @file CompressedPair.h
+ * @brief Pair that stores an empty second member at no cost.
+ *
+ * Smart pointers and containers hold a deleter or an allocator that is
+ * usually an empty class. Held as a member, an empty class still takes
+ * at least one byte plus padding; held as a base class, it takes none.
+ * The compressed pair chooses between the two so that owners need not.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_COMPRESSEDPAIR_H
+#define EMBEDDEDCPLUSPLUS_COMPRESSEDPAIR_H
+
+#include <wlib/utility>
+#include <wlib/stl/Helper.h>
+
+namespace wlp {
+
+    /**
+     * Pair of a value and a policy object, such as a deleter or an
+     * allocator. The policy object is a private base when its type is
+     * empty and not final, and a member otherwise.
+     *
+     * @tparam T     the type of the first member
+     * @tparam E     the type of the second member
+     */
+    template<typename T, typename E, bool = __is_empty(E) && !__is_final(E)>
+    class __compressed_pair {
+    public:
+        constexpr __compressed_pair()
+                : m_first(),
+                  m_second() {}
+
+        explicit constexpr __compressed_pair(const T &first)
+                : m_first(first),
+                  m_second() {}
+
+        template<typename F>
+        constexpr __compressed_pair(const T &first, F &&second)
+                : m_first(first),
+                  m_second(forward<F>(second)) {}
+
+        T &first() {
+            return m_first;
+        }
+
+        constexpr const T &first() const {
+            return m_first;
+        }
+
+        E &second() {
+            return m_second;
+        }
+
+        constexpr const E &second() const {
+            return m_second;
+        }
+
+        void swap(__compressed_pair &o) {
+            wlp::swap(m_first, o.m_first);
+            wlp::swap(m_second, o.m_second);
+        }
+
+    private:
+        T m_first;
+        E m_second;
+    };
+
+    template<typename T, typename E>
+    class __compressed_pair<T, E, true> : private E {
+    public:
+        constexpr __compressed_pair()
+                : E(),
+                  m_first() {}
+
+        explicit constexpr __compressed_pair(const T &first)
+                : E(),
+                  m_first(first) {}
+
+        template<typename F>
+        constexpr __compressed_pair(const T &first, F &&second)
+                : E(forward<F>(second)),
+                  m_first(first) {}
+
+        T &first() {
+            return m_first;
+        }
+
+        constexpr const T &first() const {
+            return m_first;
+        }
+
+        E &second() {
+            return *this;
+        }
+
+        constexpr const E &second() const {
+            return *this;
+        }
+
+        void swap(__compressed_pair &o) {
+            wlp::swap(m_first, o.m_first);
+        }
+
+    private:
+        T m_first;
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_COMPRESSEDPAIR_H
@@ -0,0 +1,227 @@
+/**
+ * @file ContainerStats.h
+ * @brief Operation counters for tuning container capacities.
+ *
+ * Building with @code WLIB_CONTAINER_STATS @endcode gives each
+ * @code hash_table @endcode, @code open_table @endcode,
+ * @code array_list @endcode, @code tree @endcode and
+ * @code basic_dynamic_string @endcode a @code stats() @endcode member
+ * counting
+ *
+ * - rebuilds of the backing storage, from growth or rehashing,
+ *   and the bytes carried over into the new storage;
+ * - lookups and a histogram of their probe lengths, the number of
+ *   chain nodes or table slots examined, in hash tables;
+ * - rotations done while inserting and erasing in trees.
+ *
+ * Every instance also adds its counts to a global set for its kind
+ * of container, read with @code container_stats_global @endcode.
+ *
+ * Without the macro the containers have no counters and the hooks
+ * expand to nothing.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_CONTAINERSTATS_H
+#define EMBEDDEDCPLUSPLUS_CONTAINERSTATS_H
+
+#include <stddef.h>
+
+#ifdef WLIB_CONTAINER_STATS
+#define WLIB_CONTAINER_STAT(...) __VA_ARGS__
+#else
+#define WLIB_CONTAINER_STAT(...)
+#endif
+
+namespace wlp {
+
+    /**
+     * Kinds of containers with global counters.
+     */
+    enum container_kind {
+        hash_table_kind,
+        open_table_kind,
+        array_list_kind,
+        tree_kind,
+        dynamic_string_kind,
+        num_container_kinds
+    };
+
+    /**
+     * Counters of one container, or of all containers of a kind.
+     * Updated with relaxed atomics, since the global counters are
+     * shared by every thread.
+     */
+    class container_stats {
+    public:
+        /**
+         * Number of probe length buckets. Bucket @code i @endcode counts
+         * lookups that examined fewer than @code 1 << i @endcode entries
+         * and at least half as many, and the last bucket counts all
+         * longer lookups.
+         */
+        static constexpr size_t probe_buckets = 8;
+
+        /**
+         * @param parent counters that also receive every update
+         */
+        constexpr explicit container_stats(container_stats *parent = nullptr)
+                : m_parent(parent),
+                  m_growths(0),
+                  m_bytes_moved(0),
+                  m_lookups(0),
+                  m_max_probe(0),
+                  m_rotations(0),
+                  m_probes{} {}
+
+        container_stats(const container_stats &stats)
+                : container_stats(stats.m_parent) {}
+
+        container_stats &operator=(const container_stats &) {
+            return *this;
+        }
+
+        /**
+         * @return the bucket of a lookup that examined
+         *         @code probes @endcode entries
+         */
+        static size_t probe_bucket(size_t probes) {
+            size_t b = 0;
+            while (b < probe_buckets - 1 && probes >= (static_cast<size_t>(1) << b)) {
+                ++b;
+            }
+            return b;
+        }
+
+        void record_growth(size_t bytes_moved) {
+            add(m_growths, 1);
+            add(m_bytes_moved, bytes_moved);
+            if (m_parent) {
+                m_parent->record_growth(bytes_moved);
+            }
+        }
+
+        void record_lookup(size_t probes) {
+            add(m_lookups, 1);
+            add(m_probes[probe_bucket(probes)], 1);
+            size_t max = __atomic_load_n(&m_max_probe, __ATOMIC_RELAXED);
+            while (probes > max &&
+                   !__atomic_compare_exchange_n(&m_max_probe, &max, probes, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+            if (m_parent) {
+                m_parent->record_lookup(probes);
+            }
+        }
+
+        void record_rotation() {
+            add(m_rotations, 1);
+            if (m_parent) {
+                m_parent->record_rotation();
+            }
+        }
+
+        /**
+         * Zero these counters; the global counters are not affected.
+         */
+        void reset() {
+            __atomic_store_n(&m_growths, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&m_bytes_moved, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&m_lookups, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&m_max_probe, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&m_rotations, 0, __ATOMIC_RELAXED);
+            for (size_t b = 0; b < probe_buckets; ++b) {
+                __atomic_store_n(&m_probes[b], 0, __ATOMIC_RELAXED);
+            }
+        }
+
+        /**
+         * @return number of times the backing storage was rebuilt
+         */
+        size_t growths() const {
+            return load(m_growths);
+        }
+
+        /**
+         * @return bytes of elements or bucket pointers carried over
+         *         into rebuilt storage
+         */
+        size_t bytes_moved() const {
+            return load(m_bytes_moved);
+        }
+
+        size_t lookups() const {
+            return load(m_lookups);
+        }
+
+        /**
+         * @return number of lookups in probe length bucket @code b @endcode
+         */
+        size_t probe_count(size_t b) const {
+            return load(m_probes[b]);
+        }
+
+        /**
+         * @return the longest probe length of any lookup
+         */
+        size_t max_probe() const {
+            return load(m_max_probe);
+        }
+
+        size_t rotations() const {
+            return load(m_rotations);
+        }
+
+    private:
+        static void add(size_t &counter, size_t n) {
+            __atomic_add_fetch(&counter, n, __ATOMIC_RELAXED);
+        }
+
+        static size_t load(const size_t &counter) {
+            return __atomic_load_n(&counter, __ATOMIC_RELAXED);
+        }
+
+        container_stats *m_parent;
+        size_t m_growths;
+        size_t m_bytes_moved;
+        size_t m_lookups;
+        size_t m_max_probe;
+        size_t m_rotations;
+        size_t m_probes[probe_buckets];
+    };
+
+    namespace __container_stats {
+
+        /**
+         * Global counters, a template so that the header can define them.
+         */
+        template<typename = void>
+        struct registry {
+            static container_stats kinds[num_container_kinds];
+        };
+
+        template<typename V>
+        container_stats registry<V>::kinds[num_container_kinds];
+
+    }
+
+    /**
+     * @return the counters summed over all containers of a kind
+     */
+    inline container_stats &container_stats_global(container_kind kind) {
+        return __container_stats::registry<>::kinds[kind];
+    }
+
+    /**
+     * @return the name of a kind of container
+     */
+    inline const char *container_kind_name(container_kind kind) {
+        static const char *const names[num_container_kinds] = {
+                "hash_table", "open_table", "array_list", "tree", "dynamic_string"
+        };
+        return names[kind];
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_CONTAINERSTATS_H
@@ -0,0 +1,135 @@
+/**
+ * @file CountPolicy.h
+ * @brief Counter policies for reference-counted pointers.
+ *
+ * A count policy decides how the use and weak counts of a shared
+ * pointer are modified. @code plain_count @endcode uses ordinary
+ * loads and stores and is only correct when all owners live on one
+ * thread. @code atomic_count @endcode uses atomic read-modify-write
+ * operations so that owners may be copied and destroyed on
+ * different threads.
+ *
+ * The counter width is a template parameter of both policies. The
+ * policy used when none is given is chosen at build time:
+ *
+ * - @code WLIB_SHARED_PTR_ATOMIC @endcode selects atomic counting
+ * - @code WLIB_SHARED_PTR_COUNT_TYPE @endcode sets the counter type,
+ *   which defaults to @code uint16_t @endcode
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_COUNTPOLICY_H
+#define EMBEDDEDCPLUSPLUS_COUNTPOLICY_H
+
+#include <stdint.h>
+
+#ifndef WLIB_SHARED_PTR_COUNT_TYPE
+#define WLIB_SHARED_PTR_COUNT_TYPE uint16_t
+#endif
+
+namespace wlp {
+
+    template<typename IntType>
+    static inline IntType exchange_and_add(IntType *mem, IntType val) {
+        IntType res = *mem;
+        *mem = static_cast<IntType>(*mem + val);
+        return res;
+    }
+
+    template<typename IntType>
+    static inline IntType exchange_and_sub(IntType *mem, IntType val) {
+        IntType res = *mem;
+        *mem = static_cast<IntType>(*mem - val);
+        return res;
+    }
+
+    /**
+     * Non-atomic counting for single-threaded use.
+     *
+     * @tparam IntType unsigned counter type
+     */
+    template<typename IntType>
+    struct plain_count {
+        typedef IntType count_type;
+
+        static count_type load(const count_type *c) {
+            return *c;
+        }
+
+        static void increment(count_type *c) {
+            ++*c;
+        }
+
+        /**
+         * Increment the counter unless it is zero.
+         *
+         * @return whether the counter was incremented
+         */
+        static bool increment_if_nonzero(count_type *c) {
+            if (*c == 0) {
+                return false;
+            }
+            ++*c;
+            return true;
+        }
+
+        /**
+         * Decrement the counter.
+         *
+         * @return the value of the counter before the decrement
+         */
+        static count_type decrement(count_type *c) {
+            return exchange_and_sub<count_type>(c, 1);
+        }
+    };
+
+    /**
+     * Atomic counting for owners shared across threads.
+     *
+     * Increments are relaxed, since a new owner can only be made from
+     * an existing one. Decrements are acquire-release, so that every
+     * write made through other owners happens before the final owner
+     * disposes of the object.
+     *
+     * @tparam IntType unsigned counter type supported by the target's
+     *                 atomic instructions
+     */
+    template<typename IntType>
+    struct atomic_count {
+        typedef IntType count_type;
+
+        static count_type load(const count_type *c) {
+            return __atomic_load_n(c, __ATOMIC_RELAXED);
+        }
+
+        static void increment(count_type *c) {
+            __atomic_fetch_add(c, static_cast<count_type>(1), __ATOMIC_RELAXED);
+        }
+
+        static bool increment_if_nonzero(count_type *c) {
+            count_type cur = __atomic_load_n(c, __ATOMIC_RELAXED);
+            while (cur != 0) {
+                if (__atomic_compare_exchange_n(
+                    c, &cur, static_cast<count_type>(cur + 1), true,
+                    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static count_type decrement(count_type *c) {
+            return __atomic_fetch_sub(c, static_cast<count_type>(1), __ATOMIC_ACQ_REL);
+        }
+    };
+
+#ifdef WLIB_SHARED_PTR_ATOMIC
+    typedef atomic_count<WLIB_SHARED_PTR_COUNT_TYPE> default_count;
+#else
+    typedef plain_count<WLIB_SHARED_PTR_COUNT_TYPE> default_count;
+#endif
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_COUNTPOLICY_H
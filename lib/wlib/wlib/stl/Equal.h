@@ -52,16 +52,16 @@ namespace wlp {
         }
     };
 
-    template<>
-    struct equals<dynamic_string> {
-        bool operator()(const dynamic_string &str1, const dynamic_string &str2) const {
+    template<typename Alloc>
+    struct equals<basic_dynamic_string<Alloc>> {
+        bool operator()(const basic_dynamic_string<Alloc> &str1, const basic_dynamic_string<Alloc> &str2) const {
             return strcmp(str1.c_str(), str2.c_str()) == 0;
         }
     };
 
-    template<>
-    struct equals<const dynamic_string> {
-        bool operator()(const dynamic_string &str1, const dynamic_string &str2) const {
+    template<typename Alloc>
+    struct equals<const basic_dynamic_string<Alloc>> {
+        bool operator()(const basic_dynamic_string<Alloc> &str1, const basic_dynamic_string<Alloc> &str2) const {
             return strcmp(str1.c_str(), str2.c_str()) == 0;
         }
     };
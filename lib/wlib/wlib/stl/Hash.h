@@ -86,9 +86,9 @@ namespace wlp {
         }
     };
 
-    template<class IntType>
-    struct hash<dynamic_string, IntType> {
-        IntType operator()(const dynamic_string &str) const {
+    template<class IntType, class Alloc>
+    struct hash<basic_dynamic_string<Alloc>, IntType> {
+        IntType operator()(const basic_dynamic_string<Alloc> &str) const {
             return hash_string<IntType>(str.c_str());
         }
     };
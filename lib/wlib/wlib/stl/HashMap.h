@@ -30,23 +30,26 @@ namespace wlp {
      * @tparam Val    value type
      * @tparam Hasher hash function
      * @tparam Equals key equality function
+     * @tparam Alloc  allocator of the nodes and buckets
      */
     template<typename Key,
             typename Val,
             typename Hasher = hash<Key, uint16_t>,
-            typename Equals = equals<Key>>
+            typename Equals = equals<Key>,
+            typename Alloc = allocator>
     class hash_map {
     public:
-        typedef hash_map<Key, Val, Hasher, Equals> map_type;
+        typedef hash_map<Key, Val, Hasher, Equals, Alloc> map_type;
         typedef hash_table<tuple<Key, Val>,
                 Key, Val,
                 MapGetKey<Key, Val>, MapGetVal<Key, Val>,
-                Hasher, Equals
+                Hasher, Equals, Alloc
         > table_type;
         typedef typename table_type::iterator iterator;
         typedef typename table_type::const_iterator const_iterator;
         typedef typename table_type::size_type size_type;
         typedef typename table_type::percent_type percent_type;
+        typedef Alloc allocator_type;
 
         typedef Key key_type;
         typedef Val val_type;
@@ -55,8 +58,8 @@ namespace wlp {
         table_type m_table;
 
     public:
-        explicit hash_map(size_type n = 12, percent_type max_load = 75)
-                : m_table(n, max_load) {
+        explicit hash_map(size_type n = 12, percent_type max_load = 75, const Alloc &alloc = Alloc())
+                : m_table(n, max_load, alloc) {
         }
 
         hash_map(const map_type &) = delete;
@@ -65,6 +68,19 @@ namespace wlp {
                 : m_table(move(map.m_table)) {
         }
 
+        allocator_type get_allocator() const {
+            return m_table.get_allocator();
+        }
+
+#ifdef WLIB_CONTAINER_STATS
+        /**
+         * @return the operation counters of the underlying table
+         */
+        const container_stats &stats() const {
+            return m_table.stats();
+        }
+#endif
+
         size_type size() const {
             return m_table.size();
         }
@@ -27,19 +27,22 @@ namespace wlp {
      * @tparam Key   the element type
      * @tparam Hash  the hash function
      * @tparam Equal the equality function
+     * @tparam Alloc the allocator of the nodes and buckets
      */
     template<class Key,
             class Hasher = hash <Key, uint16_t>,
-            class Equals = equals <Key>>
+            class Equals = equals <Key>,
+            class Alloc = allocator>
     class hash_set {
     public:
-        typedef hash_set<Key, Hasher, Equals> set_type;
-        typedef hash_table<Key, Key, Key, SetGetKey<Key>, SetGetVal<Key>, Hasher, Equals> table_type;
+        typedef hash_set<Key, Hasher, Equals, Alloc> set_type;
+        typedef hash_table<Key, Key, Key, SetGetKey<Key>, SetGetVal<Key>, Hasher, Equals, Alloc> table_type;
 
         typedef typename table_type::iterator iterator;
         typedef typename table_type::const_iterator const_iterator;
         typedef typename table_type::size_type size_type;
         typedef typename table_type::percent_type percent_type;
+        typedef Alloc allocator_type;
 
         typedef Key key_type;
 
@@ -53,9 +56,10 @@ namespace wlp {
          *
          * @param n        the initial size of the backing array
          * @param max_load the maximum load factor before rehash
+         * @param alloc    the allocator of the nodes and buckets
          */
-        explicit hash_set(size_type n = 12, percent_type max_load = 75)
-                : m_table(n, max_load) {
+        explicit hash_set(size_type n = 12, percent_type max_load = 75, const Alloc &alloc = Alloc())
+                : m_table(n, max_load, alloc) {
         }
 
         hash_set(const set_type &) = delete;
@@ -64,6 +68,19 @@ namespace wlp {
                 : m_table(move(set.m_table)) {
         }
 
+        allocator_type get_allocator() const {
+            return m_table.get_allocator();
+        }
+
+#ifdef WLIB_CONTAINER_STATS
+        /**
+         * @return the operation counters of the underlying table
+         */
+        const container_stats &stats() const {
+            return m_table.stats();
+        }
+#endif
+
         size_type size() const {
             return m_table.size();
         }
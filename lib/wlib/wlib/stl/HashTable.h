@@ -1,6 +1,8 @@
 #ifndef EMBEDDEDCPLUSPLUS_HASHTABLE_H
 #define EMBEDDEDCPLUSPLUS_HASHTABLE_H
 
+#include <wlib/stl/Allocator.h>
+#include <wlib/stl/ContainerStats.h>
 #include <wlib/stl/Equal.h>
 #include <wlib/stl/Hash.h>
 #include <wlib/stl/Pair.h>
@@ -11,7 +13,7 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
+            typename Hasher, typename Equals, typename Alloc>
     class hash_table;
 
     template<typename Element>
@@ -32,10 +34,10 @@ namespace wlp {
     template<typename Element, typename Key, typename Val,
             typename Ref, typename Ptr,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
+            typename Hasher, typename Equals, typename Alloc>
     struct HashTableIterator {
-        typedef HashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals> self_type;
-        typedef hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals> table_type;
+        typedef HashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals, Alloc> self_type;
+        typedef hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc> table_type;
         typedef HashTableNode<Element> node_type;
 
         typedef Element element_type;
@@ -149,22 +151,23 @@ namespace wlp {
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
             typename Hasher = hash <Key, uint16_t>,
-            typename Equals = equals <Key>>
-    class hash_table {
+            typename Equals = equals <Key>,
+            typename Alloc = allocator>
+    class hash_table : private Alloc {
     public:
-        typedef hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals> table_type;
+        typedef hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc> table_type;
         typedef HashTableNode<Element> node_type;
         typedef HashTableIterator<
                 Element, Key, Val,
                 Val &, Val *,
                 GetKey, GetVal,
-                Hasher, Equals
+                Hasher, Equals, Alloc
         > iterator;
         typedef HashTableIterator<
                 Element, Key, Val,
                 const Val &, const Val *,
                 GetKey, GetVal,
-                Hasher, Equals
+                Hasher, Equals, Alloc
         > const_iterator;
 
         typedef Element element_type;
@@ -178,18 +181,19 @@ namespace wlp {
 
         typedef Hasher hash_function;
         typedef Equals key_equals;
+        typedef Alloc allocator_type;
 
         friend struct HashTableIterator<
                 Element, Key, Val,
                 Val &, Val *,
                 GetKey, GetVal,
-                Hasher, Equals
+                Hasher, Equals, Alloc
         >;
         friend struct HashTableIterator<
                 Element, Key, Val,
                 const Val &, const Val *,
                 GetKey, GetVal,
-                Hasher, Equals
+                Hasher, Equals, Alloc
         >;
 
     private:
@@ -225,9 +229,18 @@ namespace wlp {
          */
         get_key m_get_key{};
 
+#ifdef WLIB_CONTAINER_STATS
+        mutable container_stats m_stats{&container_stats_global(hash_table_kind)};
+#endif
+
+        Alloc &get_alloc() {
+            return *this;
+        }
+
     public:
-        explicit hash_table(size_type n = 12, percent_type max_load = 75)
-                : m_size(0),
+        explicit hash_table(size_type n = 12, percent_type max_load = 75, const Alloc &alloc = Alloc())
+                : Alloc(alloc),
+                  m_size(0),
                   m_capacity(n),
                   m_max_load(max_load) {
             init_buckets(n);
@@ -236,7 +249,8 @@ namespace wlp {
         hash_table(const table_type &) = delete;
 
         hash_table(table_type &&table)
-                : m_buckets(table.m_buckets),
+                : Alloc(table.get_allocator()),
+                  m_buckets(table.m_buckets),
                   m_size(table.m_size),
                   m_capacity(table.m_capacity),
                   m_max_load(table.m_max_load) {
@@ -250,10 +264,26 @@ namespace wlp {
                 return;
             }
             clear();
-            destroy<node_type *[]>(m_buckets);
+            alloc_destroy_array(get_alloc(), m_buckets, m_capacity);
             m_buckets = nullptr;
         }
 
+        /**
+         * @return a copy of the allocator of this table
+         */
+        allocator_type get_allocator() const {
+            return *this;
+        }
+
+#ifdef WLIB_CONTAINER_STATS
+        /**
+         * @return the operation counters of this table
+         */
+        const container_stats &stats() const {
+            return m_stats;
+        }
+#endif
+
     private:
         void init_buckets(size_type n);
 
@@ -267,6 +297,20 @@ namespace wlp {
 
         void ensure_capacity();
 
+        node_type *find_node(const key_type &key) const {
+            size_type n = hash(key);
+            node_type *first;
+            WLIB_CONTAINER_STAT(size_type probes = 0);
+            for (first = m_buckets[n]; first; first = first->m_next) {
+                WLIB_CONTAINER_STAT(++probes);
+                if (m_key_equals(m_get_key(first->m_element), key)) {
+                    break;
+                }
+            }
+            WLIB_CONTAINER_STAT(m_stats.record_lookup(probes));
+            return first;
+        }
+
     public:
         size_type size() const {
             return m_size;
@@ -320,21 +364,11 @@ namespace wlp {
         element_type &find_or_insert(E &&element);
 
         iterator find(const key_type &key) {
-            size_type n = hash(key);
-            node_type *first;
-            for (first = m_buckets[n];
-                 first && !m_key_equals(m_get_key(first->m_element), key);
-                 first = first->m_next) {}
-            return iterator(first, this);
+            return iterator(find_node(key), this);
         }
 
         const_iterator find(const key_type &key) const {
-            size_type n = hash(key);
-            node_type *first;
-            for (first = m_buckets[n];
-                 first && !m_key_equals(m_get_key(first->m_element), key);
-                 first = first->m_next) {}
-            return const_iterator(first, this);
+            return const_iterator(find_node(key), this);
         }
 
         size_type count(const key_type &key) const {
@@ -363,8 +397,9 @@ namespace wlp {
         table_type &operator=(table_type &&table) {
             if (m_buckets) {
                 clear();
-                destroy<node_type *[]>(m_buckets);
+                alloc_destroy_array(get_alloc(), m_buckets, m_capacity);
             }
+            get_alloc() = table.get_alloc();
             m_buckets = table.m_buckets;
             m_size = table.m_size;
             m_capacity = table.m_capacity;
@@ -378,9 +413,9 @@ namespace wlp {
     template<typename Element, typename Key, typename Val,
             typename Ref, typename Ptr,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    typename HashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals>::self_type &
-    HashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    typename HashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals, Alloc>::self_type &
+    HashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals, Alloc>
     ::operator++() {
         if (!m_node) {
             return *this;
@@ -399,9 +434,9 @@ namespace wlp {
     template<typename Element, typename Key, typename Val,
             typename Ref, typename Ptr,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    typename HashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals>::self_type
-    HashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    typename HashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals, Alloc>::self_type
+    HashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals, Alloc>
     ::operator++(int) {
         self_type tmp = *this;
         ++*this;
@@ -410,20 +445,24 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
+            typename Hasher, typename Equals, typename Alloc>
     template<typename E>
-    pair<typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::iterator, bool>
-    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+    pair<typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::iterator, bool>
+    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::insert_unique(E &&element) {
         ensure_capacity();
         const size_type n = hash(m_get_key(element));
         node_type *first = m_buckets[n];
+        WLIB_CONTAINER_STAT(size_type probes = 0);
         for (node_type *cur = first; cur; cur = cur->m_next) {
+            WLIB_CONTAINER_STAT(++probes);
             if (m_key_equals(m_get_key(cur->m_element), m_get_key(element))) {
+                WLIB_CONTAINER_STAT(m_stats.record_lookup(probes));
                 return pair<iterator, bool>(iterator(cur, this), false);
             }
         }
-        node_type *tmp = create<node_type>();
+        WLIB_CONTAINER_STAT(m_stats.record_lookup(probes));
+        node_type *tmp = alloc_create<node_type>(get_alloc());
         tmp->m_element = forward<E>(element);
         tmp->m_next = first;
         m_buckets[n] = tmp;
@@ -433,17 +472,17 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
+            typename Hasher, typename Equals, typename Alloc>
     template<typename E>
-    typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::iterator
-    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+    typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::iterator
+    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::insert_equal(E &&element) {
         ensure_capacity();
         const size_type n = hash(m_get_key(element));
         node_type *first = m_buckets[n];
         for (node_type *cur = first; cur; cur = cur->m_next) {
             if (m_key_equals(m_get_key(cur->m_element), m_get_key(element))) {
-                node_type *tmp = create<node_type>();
+                node_type *tmp = alloc_create<node_type>(get_alloc());
                 tmp->m_element = forward<E>(element);
                 tmp->m_next = cur->m_next;
                 cur->m_next = tmp;
@@ -451,7 +490,7 @@ namespace wlp {
                 return iterator(tmp, this);
             }
         }
-        node_type *tmp = create<node_type>();
+        node_type *tmp = alloc_create<node_type>(get_alloc());
         tmp->m_element = forward<E>(element);
         tmp->m_next = first;
         m_buckets[n] = tmp;
@@ -461,20 +500,24 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
+            typename Hasher, typename Equals, typename Alloc>
     template<typename E>
-    typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::element_type &
-    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+    typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::element_type &
+    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::find_or_insert(E &&element) {
         ensure_capacity();
         size_type n = hash(m_get_key(element));
         node_type *first = m_buckets[n];
+        WLIB_CONTAINER_STAT(size_type probes = 0);
         for (node_type *cur = first; cur; cur = cur->m_next) {
+            WLIB_CONTAINER_STAT(++probes);
             if (m_key_equals(m_get_key(cur->m_element), m_get_key(element))) {
+                WLIB_CONTAINER_STAT(m_stats.record_lookup(probes));
                 return cur->m_element;
             }
         }
-        node_type *tmp = create<node_type>();
+        WLIB_CONTAINER_STAT(m_stats.record_lookup(probes));
+        node_type *tmp = alloc_create<node_type>(get_alloc());
         tmp->m_element = forward<E>(element);
         tmp->m_next = first;
         m_buckets[n] = tmp;
@@ -484,10 +527,10 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    pair<typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::iterator,
-            typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::iterator>
-    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    pair<typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::iterator,
+            typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::iterator>
+    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::equal_range(const key_type &key) {
         typedef pair<iterator, iterator> ret_type;
         const size_type n = hash(key);
@@ -511,10 +554,10 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    pair<typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::const_iterator,
-            typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::const_iterator>
-    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    pair<typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::const_iterator,
+            typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::const_iterator>
+    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::equal_range(const key_type &key) const {
         typedef pair<const_iterator, const_iterator> ret_type;
         const size_type n = hash(key);
@@ -538,8 +581,8 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    void hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    void hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::erase(const iterator &it) {
         node_type *node = it.m_node;
         if (node) {
@@ -547,7 +590,7 @@ namespace wlp {
             node_type *cur = m_buckets[n];
             if (cur == node) {
                 m_buckets[n] = cur->m_next;
-                destroy<node_type>(cur);
+                alloc_destroy(get_alloc(), cur);
                 --m_size;
                 return;
             }
@@ -555,7 +598,7 @@ namespace wlp {
             while (next) {
                 if (next == node) {
                     cur->m_next = next->m_next;
-                    destroy<node_type>(next);
+                    alloc_destroy(get_alloc(), next);
                     --m_size;
                     break;
                 }
@@ -567,9 +610,9 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::size_type
-    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    typename hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::size_type
+    hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::erase(const key_type &key) {
         const size_type n = hash(key);
         node_type *first = m_buckets[n];
@@ -580,7 +623,7 @@ namespace wlp {
             while (next) {
                 if (m_key_equals(m_get_key(next->m_element), key)) {
                     cur->m_next = next->m_next;
-                    destroy<node_type>(next);
+                    alloc_destroy(get_alloc(), next);
                     next = cur->m_next;
                     ++erased;
                     --m_size;
@@ -591,7 +634,7 @@ namespace wlp {
             }
             if (m_key_equals(m_get_key(first->m_element), key)) {
                 m_buckets[n] = first->m_next;
-                destroy<node_type>(first);
+                alloc_destroy(get_alloc(), first);
                 ++erased;
                 --m_size;
             }
@@ -601,15 +644,15 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    void hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    void hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::clear() noexcept {
         for (size_type i = 0; i < m_capacity; ++i) {
             node_type *cur = m_buckets[i];
             node_type *next;
             while (cur) {
                 next = cur->m_next;
-                destroy<node_type>(cur);
+                alloc_destroy(get_alloc(), cur);
                 cur = next;
             }
             m_buckets[i] = nullptr;
@@ -619,23 +662,23 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    void hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    void hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::init_buckets(size_type n) {
-        m_buckets = create<node_type *[]>(n);
+        m_buckets = alloc_create_array<node_type *>(get_alloc(), n);
         memset(m_buckets, 0, n * sizeof(node_type *));
     }
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    void hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    void hash_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::ensure_capacity() {
         if (m_size * 100 < m_max_load * m_capacity) {
             return;
         }
         size_type new_capacity = static_cast<size_type>(m_capacity * 2);
-        node_type **new_buckets = create<node_type *[]>(new_capacity);
+        node_type **new_buckets = alloc_create_array<node_type *>(get_alloc(), new_capacity);
         memset(new_buckets, 0, new_capacity * sizeof(node_type *));
         for (size_type i = 0; i < m_capacity; ++i) {
             if (!m_buckets[i]) {
@@ -651,7 +694,8 @@ namespace wlp {
                 cur = next;
             }
         }
-        destroy<node_type *[]>(m_buckets);
+        WLIB_CONTAINER_STAT(m_stats.record_growth(m_capacity * sizeof(node_type *)));
+        alloc_destroy_array(get_alloc(), m_buckets, m_capacity);
         m_buckets = new_buckets;
         m_capacity = new_capacity;
     }
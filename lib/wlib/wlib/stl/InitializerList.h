@@ -1,6 +1,8 @@
 #ifndef EMBEDDEDCPLUSPLUS_INITIALIZERLIST_H
 #define EMBEDDEDCPLUSPLUS_INITIALIZERLIST_H
 
+#include <stddef.h>
+
 namespace wlp {
 
     template<typename val_t>
@@ -0,0 +1,320 @@
+/**
+ * @file IntrusivePtr.h
+ * @brief Reference-counted pointer with the count inside the object.
+ *
+ * An intrusive pointer is as wide as a raw pointer. The reference count
+ * lives in the pointed-to object and is changed through two hooks,
+ *
+ * @code
+ * void add_ref() const;
+ * bool release() const;
+ * @endcode
+ *
+ * where @code release @endcode returns true when the last reference
+ * was dropped. The pointer then frees the object with
+ * @code destroy @endcode, the same as unique_ptr, so objects must be
+ * created with @code create @endcode and ownership can be handed
+ * between the two pointer types.
+ *
+ * The hooks are usually inherited from @code intrusive_ref_counter @endcode,
+ * whose count policy selects single-threaded or atomic counting. Types
+ * that cannot have member hooks can specialize @code intrusive_hooks @endcode.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_INTRUSIVEPTR_H
+#define EMBEDDEDCPLUSPLUS_INTRUSIVEPTR_H
+
+#include <wlib/stl/CountPolicy.h>
+#include <wlib/stl/UniquePtr.h>
+#include <wlib/type_traits>
+#include <wlib/utility>
+#include <wlib/memory>
+
+namespace wlp {
+
+    /**
+     * Embeddable reference count providing the intrusive pointer
+     * hooks. A new or copied object starts with a count of zero,
+     * since references belong to pointers and not to values.
+     *
+     * @tparam Policy the count policy, see CountPolicy.h
+     */
+    template<typename Policy = default_count>
+    class intrusive_ref_counter {
+    public:
+        typedef typename Policy::count_type count_type;
+
+        void add_ref() const {
+            Policy::increment(&m_count);
+        }
+
+        /**
+         * @return whether the last reference was released
+         */
+        bool release() const {
+            return Policy::decrement(&m_count) == 1;
+        }
+
+        /**
+         * @return the number of intrusive pointers to this object
+         */
+        count_type use_count() const {
+            return Policy::load(&m_count);
+        }
+
+    protected:
+        intrusive_ref_counter()
+                : m_count(0) {}
+
+        intrusive_ref_counter(const intrusive_ref_counter &)
+                : m_count(0) {}
+
+        intrusive_ref_counter &operator=(const intrusive_ref_counter &) {
+            return *this;
+        }
+
+        ~intrusive_ref_counter() {}
+
+    private:
+        mutable count_type m_count;
+    };
+
+    /**
+     * Adapter from an intrusive pointer to the hooks of its
+     * pointed-to type. The default calls the member hooks.
+     *
+     * @tparam T the pointed-to type
+     */
+    template<typename T>
+    struct intrusive_hooks {
+        static void add_ref(T *ptr) {
+            ptr->add_ref();
+        }
+
+        static bool release(T *ptr) {
+            return ptr->release();
+        }
+    };
+
+    template<typename T>
+    class intrusive_ptr {
+        typedef intrusive_hooks<T> hooks;
+
+    public:
+        typedef T val_type;
+        typedef T *pointer;
+
+    private:
+        template<typename U> friend
+        class intrusive_ptr;
+
+        val_type *m_ptr;
+
+    public:
+        constexpr intrusive_ptr()
+                : m_ptr(nullptr) {}
+
+        constexpr intrusive_ptr(nullptr_t)
+                : m_ptr(nullptr) {}
+
+        /**
+         * Take a reference to an object.
+         *
+         * @param ptr     the object
+         * @param add_ref whether to add a reference; pass false to adopt
+         *                a reference previously given up with @code detach @endcode
+         */
+        explicit intrusive_ptr(T *ptr, bool add_ref = true)
+                : m_ptr(ptr) {
+            if (m_ptr && add_ref) { hooks::add_ref(m_ptr); }
+        }
+
+        intrusive_ptr(const intrusive_ptr<T> &ip)
+                : m_ptr(ip.m_ptr) {
+            if (m_ptr) { hooks::add_ref(m_ptr); }
+        }
+
+        template<typename U, typename = typename enable_if<
+                is_convertible<U *, T *>::value
+        >::type>
+        intrusive_ptr(const intrusive_ptr<U> &ip)
+                : m_ptr(ip.m_ptr) {
+            if (m_ptr) { hooks::add_ref(m_ptr); }
+        }
+
+        intrusive_ptr(intrusive_ptr<T> &&ip)
+                : m_ptr(ip.m_ptr) {
+            ip.m_ptr = nullptr;
+        }
+
+        template<typename U, typename = typename enable_if<
+                is_convertible<U *, T *>::value
+        >::type>
+        intrusive_ptr(intrusive_ptr<U> &&ip)
+                : m_ptr(ip.m_ptr) {
+            ip.m_ptr = nullptr;
+        }
+
+        /**
+         * Take over an object owned by a unique pointer.
+         *
+         * @param up the unique pointer, which is left empty
+         */
+        template<typename U, typename = typename enable_if<
+                is_convertible<U *, T *>::value
+        >::type>
+        intrusive_ptr(unique_ptr<U> &&up)
+                : m_ptr(up.release()) {
+            if (m_ptr) { hooks::add_ref(m_ptr); }
+        }
+
+        ~intrusive_ptr() {
+            drop(m_ptr);
+        }
+
+        intrusive_ptr<T> &operator=(const intrusive_ptr<T> &ip) {
+            intrusive_ptr<T>(ip).swap(*this);
+            return *this;
+        }
+
+        template<typename U>
+        intrusive_ptr<T> &operator=(const intrusive_ptr<U> &ip) {
+            intrusive_ptr<T>(ip).swap(*this);
+            return *this;
+        }
+
+        intrusive_ptr<T> &operator=(intrusive_ptr<T> &&ip) {
+            intrusive_ptr<T>(move(ip)).swap(*this);
+            return *this;
+        }
+
+        template<typename U>
+        intrusive_ptr<T> &operator=(intrusive_ptr<U> &&ip) {
+            intrusive_ptr<T>(move(ip)).swap(*this);
+            return *this;
+        }
+
+        template<typename U>
+        intrusive_ptr<T> &operator=(unique_ptr<U> &&up) {
+            intrusive_ptr<T>(move(up)).swap(*this);
+            return *this;
+        }
+
+        void reset() {
+            intrusive_ptr<T>().swap(*this);
+        }
+
+        void reset(T *ptr, bool add_ref = true) {
+            intrusive_ptr<T>(ptr, add_ref).swap(*this);
+        }
+
+        typename add_lvalue_reference<T>::type operator*() const {
+            return *m_ptr;
+        }
+
+        val_type *operator->() const {
+            return m_ptr;
+        }
+
+        val_type *get() const {
+            return m_ptr;
+        }
+
+        explicit operator bool() const {
+            return m_ptr != nullptr;
+        }
+
+        /**
+         * Give up this pointer's reference without releasing it. The
+         * reference can later be adopted with @code reset(ptr, false) @endcode.
+         *
+         * @return the object, whose count still includes the reference
+         */
+        val_type *detach() {
+            val_type *ptr = m_ptr;
+            m_ptr = nullptr;
+            return ptr;
+        }
+
+        /**
+         * Hand the object over to a unique pointer. This succeeds only
+         * if this is the last reference to the object; otherwise the
+         * reference is released and the result is empty. Because the
+         * check and the release are one step, exactly one of several
+         * owners racing to hand off the object receives it.
+         *
+         * @return a unique pointer owning the object, or an empty one
+         */
+        unique_ptr<T> release_unique() {
+            val_type *ptr = detach();
+            if (ptr && hooks::release(ptr)) {
+                return unique_ptr<T>(ptr);
+            }
+            return unique_ptr<T>();
+        }
+
+        void swap(intrusive_ptr<T> &ip) {
+            wlp::swap(m_ptr, ip.m_ptr);
+        }
+
+    private:
+        static void drop(val_type *ptr) {
+            if (ptr && hooks::release(ptr)) {
+                destroy<val_type>(ptr);
+            }
+        }
+    };
+
+    template<typename T>
+    inline void swap(intrusive_ptr<T> &ip1, intrusive_ptr<T> &ip2) {
+        ip1.swap(ip2);
+    }
+
+    /**
+     * Create an object and return the first intrusive pointer to it.
+     */
+    template<typename T, typename... Args>
+    inline intrusive_ptr<T> make_intrusive(Args &&... args) {
+        return intrusive_ptr<T>(create<T>(forward<Args>(args)...));
+    }
+
+    template<typename T, typename U>
+    inline bool operator==(const intrusive_ptr<T> &a, const intrusive_ptr<U> &b) {
+        return a.get() == b.get();
+    }
+
+    template<typename T, typename U>
+    inline bool operator!=(const intrusive_ptr<T> &a, const intrusive_ptr<U> &b) {
+        return a.get() != b.get();
+    }
+
+    template<typename T>
+    inline bool operator==(const intrusive_ptr<T> &a, nullptr_t) {
+        return a.get() == nullptr;
+    }
+
+    template<typename T>
+    inline bool operator!=(const intrusive_ptr<T> &a, nullptr_t) {
+        return a.get() != nullptr;
+    }
+
+    template<typename T, typename U>
+    inline intrusive_ptr<T> static_pointer_cast(const intrusive_ptr<U> &ip) {
+        return intrusive_ptr<T>(static_cast<T *>(ip.get()));
+    }
+
+    template<typename T, typename U>
+    inline intrusive_ptr<T> const_pointer_cast(const intrusive_ptr<U> &ip) {
+        return intrusive_ptr<T>(const_cast<T *>(ip.get()));
+    }
+
+    template<typename T, typename U>
+    inline intrusive_ptr<T> dynamic_pointer_cast(const intrusive_ptr<U> &ip) {
+        return intrusive_ptr<T>(dynamic_cast<T *>(ip.get()));
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_INTRUSIVEPTR_H
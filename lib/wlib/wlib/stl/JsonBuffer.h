@@ -0,0 +1,96 @@
+/**
+ * @file JsonBuffer.h
+ * @brief Allocation-free writer of JSON text into a fixed buffer.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_JSONBUFFER_H
+#define EMBEDDEDCPLUSPLUS_JSONBUFFER_H
+
+#include <stddef.h>
+
+namespace wlp {
+
+    /**
+     * Appends to a fixed buffer, always leaving it terminated, and
+     * counts the characters that did not fit. A null buffer of size
+     * zero only counts, to find the length of the output.
+     */
+    class json_buffer {
+    public:
+        json_buffer(char *buf, size_t size)
+                : m_buf(buf),
+                  m_size(size),
+                  m_len(0) {}
+
+        void put(char c) {
+            if (m_len + 1 < m_size) {
+                m_buf[m_len] = c;
+                m_buf[m_len + 1] = '\0';
+            }
+            ++m_len;
+        }
+
+        void put(const char *str) {
+            while (*str) {
+                put(*str++);
+            }
+        }
+
+        void put_string(const char *str) {
+            static const char hex[] = "0123456789abcdef";
+            put('"');
+            for (; *str; ++str) {
+                unsigned char c = static_cast<unsigned char>(*str);
+                if (c == '"' || c == '\\') {
+                    put('\\');
+                    put(*str);
+                } else if (c == '\n') {
+                    put("\\n");
+                } else if (c == '\t') {
+                    put("\\t");
+                } else if (c == '\r') {
+                    put("\\r");
+                } else if (c < 0x20) {
+                    put("\\u00");
+                    put(hex[c >> 4]);
+                    put(hex[c & 0xf]);
+                } else {
+                    put(*str);
+                }
+            }
+            put('"');
+        }
+
+        void put_number(unsigned long long n) {
+            char digits[24];
+            size_t i = 0;
+            do {
+                digits[i++] = static_cast<char>('0' + n % 10);
+                n /= 10;
+            } while (n > 0);
+            while (i > 0) {
+                put(digits[--i]);
+            }
+        }
+
+        void put_field(const char *key, unsigned long long n) {
+            put_string(key);
+            put(':');
+            put_number(n);
+        }
+
+        size_t length() const {
+            return m_len;
+        }
+
+    private:
+        char *m_buf;
+        size_t m_size;
+        size_t m_len;
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_JSONBUFFER_H
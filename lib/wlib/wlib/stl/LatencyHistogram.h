@@ -0,0 +1,409 @@
+/**
+ * @file LatencyHistogram.h
+ * @brief Allocation-free latency histograms and scoped timers.
+ *
+ * A latency histogram counts values in log-linear buckets, as HDR
+ * histograms do: values below @code 2^Precision @endcode each have a
+ * bucket, and every power of two above that is split into
+ * @code 2^(Precision - 1) @endcode buckets, so any value is known to
+ * within one part in @code 2^(Precision - 1) @endcode.
+ * The buckets are a fixed array inside the histogram.
+ *
+ * Recording is not synchronized, to keep it cheap; threads record into
+ * histograms of their own, which are merged to be read.
+ *
+ * A scoped timer records the time from its construction to its
+ * destruction. Times come from a clock, a type with a static
+ * @code now @endcode returning ticks as a 64-bit count. On POSIX hosts
+ * the default clock is @code monotonic_clock @endcode, in nanoseconds;
+ * elsewhere it is @code pluggable_clock @endcode, which calls the
+ * function registered with @code set_latency_clock_source @endcode, such
+ * as a cycle counter or a microsecond timer. @code tsc_clock @endcode
+ * reads the time stamp counter of x86 processors.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_LATENCYHISTOGRAM_H
+#define EMBEDDEDCPLUSPLUS_LATENCYHISTOGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#define WLIB_HAS_MONOTONIC_CLOCK
+#endif
+
+#include <wlib/stl/JsonBuffer.h>
+#include <wlib/strings/String.h>
+
+namespace wlp {
+
+    typedef uint64_t (*latency_clock_source)();
+
+    namespace __latency {
+
+        /**
+         * Registered clock source, a template so that the header can
+         * define it.
+         */
+        template<typename = void>
+        struct registry {
+            static latency_clock_source source;
+        };
+
+        template<typename V>
+        latency_clock_source registry<V>::source = nullptr;
+
+    }
+
+    /**
+     * Set the function read by @code pluggable_clock @endcode.
+     */
+    inline void set_latency_clock_source(latency_clock_source source) {
+        __atomic_store_n(&__latency::registry<>::source, source, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * Clock reading the registered source, or always zero if none is
+     * registered.
+     */
+    struct pluggable_clock {
+        static uint64_t now() {
+            latency_clock_source source = __atomic_load_n(&__latency::registry<>::source, __ATOMIC_ACQUIRE);
+            return source ? source() : 0;
+        }
+    };
+
+#ifdef WLIB_HAS_MONOTONIC_CLOCK
+    /**
+     * Monotonic clock in nanoseconds.
+     */
+    struct monotonic_clock {
+        static uint64_t now() {
+            timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+        }
+    };
+
+    typedef monotonic_clock default_latency_clock;
+#else
+    typedef pluggable_clock default_latency_clock;
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+    /**
+     * Time stamp counter in cycles of its reference frequency. Cheaper
+     * to read than the monotonic clock, but not comparable across
+     * processors without an invariant counter.
+     */
+    struct tsc_clock {
+        static uint64_t now() {
+            uint32_t lo;
+            uint32_t hi;
+            __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+            return (static_cast<uint64_t>(hi) << 32) | lo;
+        }
+    };
+#endif
+
+    /**
+     * Histogram of latencies, or of any unsigned values.
+     *
+     * @tparam Precision bits of each value kept, from 2 to 16
+     * @tparam MaxBits   bits of the largest value told apart; larger
+     *                   values are counted in the last bucket
+     */
+    template<unsigned Precision = 5, unsigned MaxBits = 40>
+    class latency_histogram {
+        static_assert(Precision >= 2 && Precision <= 16, "precision must be from 2 to 16 bits");
+        static_assert(MaxBits > Precision && MaxBits <= 64, "maximum must be above the precision");
+
+    public:
+        typedef uint64_t value_type;
+        typedef size_t size_type;
+
+        /**
+         * Buckets in each power of two, and below the first.
+         */
+        static constexpr size_type sub_buckets = static_cast<size_type>(1) << (Precision - 1);
+        static constexpr size_type buckets = (MaxBits - Precision + 2) * sub_buckets;
+
+        latency_histogram() {
+            reset();
+        }
+
+        /**
+         * @return the bucket counting a value
+         */
+        static size_type bucket_of(value_type value) {
+            if (value < 2 * sub_buckets) {
+                return static_cast<size_type>(value);
+            }
+            unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(value));
+            if (msb >= MaxBits) {
+                return buckets - 1;
+            }
+            unsigned shift = msb - (Precision - 1);
+            return shift * sub_buckets + static_cast<size_type>(value >> shift);
+        }
+
+        /**
+         * @return the smallest value counted in a bucket
+         */
+        static value_type lowest(size_type bucket) {
+            if (bucket < 2 * sub_buckets) {
+                return bucket;
+            }
+            unsigned shift = static_cast<unsigned>(bucket / sub_buckets - 1);
+            return static_cast<value_type>(bucket % sub_buckets + sub_buckets) << shift;
+        }
+
+        /**
+         * @return the largest value counted in a bucket, other than the
+         *         last, which counts every larger value too
+         */
+        static value_type highest(size_type bucket) {
+            if (bucket < 2 * sub_buckets) {
+                return bucket;
+            }
+            unsigned shift = static_cast<unsigned>(bucket / sub_buckets - 1);
+            return lowest(bucket) + ((static_cast<value_type>(1) << shift) - 1);
+        }
+
+        /**
+         * Count a value.
+         *
+         * @param value the value
+         * @param n     number of times to count it
+         */
+        void record(value_type value, size_type n = 1) {
+            m_counts[bucket_of(value)] += n;
+            m_total += n;
+            m_sum += value * n;
+            m_min = value < m_min ? value : m_min;
+            m_max = value > m_max ? value : m_max;
+        }
+
+        /**
+         * Add the counts of another histogram to this one.
+         */
+        void merge(const latency_histogram &h) {
+            for (size_type b = 0; b < buckets; ++b) {
+                m_counts[b] += h.m_counts[b];
+            }
+            m_total += h.m_total;
+            m_sum += h.m_sum;
+            m_min = h.m_min < m_min ? h.m_min : m_min;
+            m_max = h.m_max > m_max ? h.m_max : m_max;
+        }
+
+        void reset() {
+            for (size_type b = 0; b < buckets; ++b) {
+                m_counts[b] = 0;
+            }
+            m_total = 0;
+            m_sum = 0;
+            m_min = static_cast<value_type>(-1);
+            m_max = 0;
+        }
+
+        /**
+         * @return the number of values counted
+         */
+        size_type count() const {
+            return m_total;
+        }
+
+        size_type count_at(size_type bucket) const {
+            return m_counts[bucket];
+        }
+
+        /**
+         * @return the smallest value, or zero if there are none
+         */
+        value_type min() const {
+            return m_total ? m_min : 0;
+        }
+
+        value_type max() const {
+            return m_max;
+        }
+
+        /**
+         * @return the sum of the values, which may wrap around
+         */
+        value_type sum() const {
+            return m_sum;
+        }
+
+        /**
+         * @return the mean value, rounded down
+         */
+        value_type mean() const {
+            return m_total ? m_sum / m_total : 0;
+        }
+
+        /**
+         * @param percent percentage of values at or below the result,
+         *                from 0 to 100
+         * @return the highest value of the bucket reaching that share
+         *         of the values, clamped to the recorded range, or zero
+         *         if there are none
+         */
+        value_type percentile(double percent) const {
+            if (m_total == 0) {
+                return 0;
+            }
+            double want = percent / 100 * static_cast<double>(m_total);
+            size_type rank = static_cast<size_type>(want);
+            rank = static_cast<double>(rank) < want ? rank + 1 : rank;
+            rank = rank < 1 ? 1 : rank > m_total ? m_total : rank;
+            size_type seen = 0;
+            size_type b = 0;
+            for (; b < buckets - 1; ++b) {
+                seen += m_counts[b];
+                if (seen >= rank) {
+                    break;
+                }
+            }
+            value_type value = b == buckets - 1 ? m_max : highest(b);
+            value = value > m_max ? m_max : value;
+            return value < m_min ? m_min : value;
+        }
+
+        /**
+         * Write the summary, percentiles and non-empty buckets, as
+         * pairs of the highest value and the count, as a JSON object.
+         *
+         * @param buf  the buffer, which may be null if the size is zero
+         * @param size size of the buffer
+         * @return the length of the complete output, excluding the
+         *         terminator, so a result of at least @code size @endcode
+         *         means it was cut off
+         */
+        size_t json(char *buf, size_t size) const {
+            json_buffer out(buf, size);
+            if (size > 0) {
+                buf[0] = '\0';
+            }
+            out.put('{');
+            out.put_field("count", m_total);
+            out.put(',');
+            out.put_field("min", min());
+            out.put(',');
+            out.put_field("max", max());
+            out.put(',');
+            out.put_field("mean", mean());
+            out.put(',');
+            out.put_field("p50", percentile(50));
+            out.put(',');
+            out.put_field("p90", percentile(90));
+            out.put(',');
+            out.put_field("p99", percentile(99));
+            out.put(',');
+            out.put_field("p99.9", percentile(99.9));
+            out.put(",\"buckets\":[");
+            bool first = true;
+            for (size_type b = 0; b < buckets; ++b) {
+                if (!m_counts[b]) {
+                    continue;
+                }
+                out.put(first ? "[" : ",[");
+                first = false;
+                out.put_number(b == buckets - 1 ? m_max : highest(b));
+                out.put(',');
+                out.put_number(m_counts[b]);
+                out.put(']');
+            }
+            out.put("]}");
+            return out.length();
+        }
+
+        /**
+         * Replace the contents of a string with the JSON object.
+         *
+         * @return false if the string could not hold it
+         */
+        template<typename Alloc>
+        bool json(basic_dynamic_string<Alloc> &str) const {
+            size_t len = json(nullptr, 0);
+            str.resize(static_cast<typename basic_dynamic_string<Alloc>::size_type>(len));
+            if (!str.c_str()) {
+                return false;
+            }
+            json(str.c_str(), len + 1);
+            str.length_set(static_cast<typename basic_dynamic_string<Alloc>::size_type>(len));
+            return true;
+        }
+
+    private:
+        size_type m_counts[buckets];
+        size_type m_total;
+        value_type m_sum;
+        value_type m_min;
+        value_type m_max;
+    };
+
+    template<unsigned Precision, unsigned MaxBits>
+    constexpr typename latency_histogram<Precision, MaxBits>::size_type
+            latency_histogram<Precision, MaxBits>::sub_buckets;
+
+    template<unsigned Precision, unsigned MaxBits>
+    constexpr typename latency_histogram<Precision, MaxBits>::size_type
+            latency_histogram<Precision, MaxBits>::buckets;
+
+    /**
+     * Records the time of its own lifetime into a histogram.
+     *
+     * @tparam Clock the clock to read
+     */
+    template<typename Clock = default_latency_clock>
+    class scoped_timer {
+    public:
+        template<typename Histogram>
+        explicit scoped_timer(Histogram &histogram)
+                : m_histogram(&histogram),
+                  m_record(&record_into<Histogram>),
+                  m_start(Clock::now()) {}
+
+        scoped_timer(const scoped_timer &) = delete;
+
+        ~scoped_timer() {
+            if (m_histogram) {
+                m_record(m_histogram, elapsed());
+            }
+        }
+
+        scoped_timer &operator=(const scoped_timer &) = delete;
+
+        /**
+         * @return ticks since the timer was created
+         */
+        uint64_t elapsed() const {
+            return Clock::now() - m_start;
+        }
+
+        /**
+         * Do not record anything when destroyed.
+         */
+        void cancel() {
+            m_histogram = nullptr;
+        }
+
+    private:
+        template<typename Histogram>
+        static void record_into(void *histogram, uint64_t ticks) {
+            static_cast<Histogram *>(histogram)->record(ticks);
+        }
+
+        void *m_histogram;
+        void (*m_record)(void *, uint64_t);
+        uint64_t m_start;
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_LATENCYHISTOGRAM_H
@@ -15,6 +15,7 @@
 #define CORE_STL_LIST_H
 
 #include <wlib/memory>
+#include <wlib/stl/Allocator.h>
 
 namespace wlp {
 
@@ -29,7 +30,7 @@ namespace wlp {
     };
 
     // Forward Declaration of List class
-    template<typename T>
+    template<typename T, typename Alloc = allocator>
     class linked_list;
 
     /**
@@ -37,15 +38,15 @@ namespace wlp {
      *
      * @tparam T value type
      */
-    template<typename T, typename Ref, typename Ptr>
+    template<typename T, typename Ref, typename Ptr, typename Alloc = allocator>
     struct LinkedListIterator {
         typedef T val_type;
         typedef Ref reference;
         typedef Ptr pointer;
         typedef size_t size_type;
         typedef LinkedListNode<T> node_type;
-        typedef linked_list<T> list_type;
-        typedef LinkedListIterator<T, Ref, Ptr> self_type;
+        typedef linked_list<T, Alloc> list_type;
+        typedef LinkedListIterator<T, Ref, Ptr, Alloc> self_type;
 
         /**
          * Pointer to the node referenced by this iterator.
@@ -188,16 +189,18 @@ namespace wlp {
      * List implementation as a Doubly-Linked list.
      *
      * @tparam T value type
+     * @tparam Alloc allocator of the nodes, see Allocator.h
      */
-    template<typename T>
-    class linked_list {
+    template<typename T, typename Alloc>
+    class linked_list : private Alloc {
     public:
         typedef T val_type;
         typedef size_t size_type;
-        typedef linked_list<T> list_type;
+        typedef Alloc allocator_type;
+        typedef linked_list<T, Alloc> list_type;
         typedef LinkedListNode<T> node_type;
-        typedef LinkedListIterator<T, T &, T *> iterator;
-        typedef LinkedListIterator<T, const T &, const T *> const_iterator;
+        typedef LinkedListIterator<T, T &, T *, Alloc> iterator;
+        typedef LinkedListIterator<T, const T &, const T *, Alloc> const_iterator;
 
     private:
         /**
@@ -213,15 +216,22 @@ namespace wlp {
          */
         size_type m_size;
 
-        friend struct LinkedListIterator<T, T &, T *>;
-        friend struct LinkedListIterator<T, const T &, const T *>;
+        friend struct LinkedListIterator<T, T &, T *, Alloc>;
+        friend struct LinkedListIterator<T, const T &, const T *, Alloc>;
+
+        Alloc &get_alloc() {
+            return *this;
+        }
 
     public:
         /**
          * Default Constructor creates an empty List.
+         *
+         * @param alloc allocator for the nodes
          */
-        linked_list()
-                : m_head(nullptr),
+        explicit linked_list(const Alloc &alloc = Alloc())
+                : Alloc(alloc),
+                  m_head(nullptr),
                   m_tail(nullptr),
                   m_size(0) {}
 
@@ -238,6 +248,7 @@ namespace wlp {
          * @param list the list to move
          */
         linked_list(list_type &&list) :
+            Alloc(list.get_allocator()),
             m_head(move(list.m_head)),
             m_tail(move(list.m_tail)),
             m_size(move(list.m_size)) {
@@ -253,6 +264,13 @@ namespace wlp {
             clear();
         }
 
+        /**
+         * @return a copy of the allocator of this list
+         */
+        allocator_type get_allocator() const {
+            return *this;
+        }
+
         /**
          * @return whether the list has no elements
          */
@@ -390,7 +408,7 @@ namespace wlp {
         iterator insert(size_type i, V &&val) {
             if (!m_size) { i = 0; }
             else { i %= m_size; }
-            node_type *node = create<node_type>();
+            node_type *node = alloc_create<node_type>(get_alloc());
             node->m_val = forward<V>(val);
             if (m_head == nullptr) {
                 node->m_next = nullptr;
@@ -426,7 +444,7 @@ namespace wlp {
                 push_back(forward<V>(val));
                 return iterator(m_tail, this);
             }
-            node_type *node = create<node_type>();
+            node_type *node = alloc_create<node_type>(get_alloc());
             node->m_val = forward<V>(val);
             node->m_next = it.m_current;
             node->m_prev = it.m_current->m_prev;
@@ -467,7 +485,7 @@ namespace wlp {
                 m_tail = pTmp->m_prev;
             }
             node_type *next = pTmp->m_next;
-            destroy<node_type>(pTmp);
+            alloc_destroy(get_alloc(), pTmp);
             --m_size;
             return iterator(next, this);
         }
@@ -479,7 +497,7 @@ namespace wlp {
          */
         template<typename V>
         void push_back(V &&val) {
-            node_type *node = create<node_type>();
+            node_type *node = alloc_create<node_type>(get_alloc());
             node->m_val = forward<V>(val);
             node->m_next = nullptr;
             if (m_head == nullptr) {
@@ -500,7 +518,7 @@ namespace wlp {
          */
         template<typename V>
         void push_front(V &&val) {
-            node_type *node = create<node_type>();
+            node_type *node = alloc_create<node_type>(get_alloc());
             node->m_val = forward<V>(val);
             node->m_prev = nullptr;
 
@@ -529,7 +547,7 @@ namespace wlp {
             } else {
                 m_head = nullptr;
             }
-            destroy<node_type>(pTmp);
+            alloc_destroy(get_alloc(), pTmp);
             m_size--;
         }
 
@@ -547,7 +565,7 @@ namespace wlp {
             } else {
                 m_tail = nullptr;
             }
-            destroy<node_type>(pTmp);
+            alloc_destroy(get_alloc(), pTmp);
             m_size--;
         }
 
@@ -612,6 +630,7 @@ namespace wlp {
          */
         list_type &operator=(list_type &&list) {
             clear();
+            get_alloc() = list.get_alloc();
             m_size = list.m_size;
             m_head = list.m_head;
             m_tail = list.m_tail;
@@ -622,22 +641,22 @@ namespace wlp {
         }
     };
 
-    template<typename T>
-    inline void linked_list<T>::clear() noexcept {
+    template<typename T, typename Alloc>
+    inline void linked_list<T, Alloc>::clear() noexcept {
         node_type *pTmp;
         while (m_head != nullptr) {
             pTmp = m_head;
             m_head = m_head->m_next;
-            destroy<node_type>(pTmp);
+            alloc_destroy(get_alloc(), pTmp);
         }
         m_size = 0;
         m_tail = nullptr;
         m_head = nullptr;
     }
 
-    template<typename T>
-    typename linked_list<T>::iterator
-    linked_list<T>::erase(size_type i) {
+    template<typename T, typename Alloc>
+    typename linked_list<T, Alloc>::iterator
+    linked_list<T, Alloc>::erase(size_type i) {
         if (!m_size) {
             return end();
         }
@@ -659,14 +678,14 @@ namespace wlp {
             m_tail = pTmp->m_prev;
         }
         node_type *next = pTmp->m_next;
-        destroy<node_type>(pTmp);
+        alloc_destroy(get_alloc(), pTmp);
         m_size--;
         return iterator(next, this);
     }
 
-    template<typename T>
-    inline typename linked_list<T>::val_type &
-    linked_list<T>::at(size_type i) {
+    template<typename T, typename Alloc>
+    inline typename linked_list<T, Alloc>::val_type &
+    linked_list<T, Alloc>::at(size_type i) {
         if (i >= m_size) {
             i %= m_size;
         }
@@ -677,9 +696,9 @@ namespace wlp {
         return pTmp->m_val;
     }
 
-    template<typename T>
-    inline const typename linked_list<T>::val_type &
-    linked_list<T>::at(size_type i) const {
+    template<typename T, typename Alloc>
+    inline const typename linked_list<T, Alloc>::val_type &
+    linked_list<T, Alloc>::at(size_type i) const {
         if (i >= m_size) {
             i %= m_size;
         }
@@ -690,9 +709,9 @@ namespace wlp {
         return pTmp->m_val;
     }
 
-    template<typename T>
-    inline typename linked_list<T>::size_type
-    linked_list<T>::index_of(const val_type &val) const {
+    template<typename T, typename Alloc>
+    inline typename linked_list<T, Alloc>::size_type
+    linked_list<T, Alloc>::index_of(const val_type &val) const {
         node_type *pTmp = m_head;
         for (size_type i = 0; i < m_size; i++) {
             if (pTmp->m_val == val) {
@@ -0,0 +1,201 @@
+/**
+ * @file Mat3.h
+ * @brief Three-by-three matrix over vector3d.
+ *
+ * The matrix is stored column-major as three vector3d columns.
+ * Constructors take elements in row-major reading order, so the
+ * arguments read like the matrix written on paper.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_MAT3_H
+#define EMBEDDEDCPLUSPLUS_MAT3_H
+
+#include <math.h>
+
+#include <wlib/type_traits>
+#include <wlib/stl/InitializerList.h>
+#include <wlib/stl/Vector3D.h>
+
+namespace wlp {
+
+    template<typename val_t>
+    class mat3 {
+    public:
+        typedef vector3d<val_t> col_type;
+
+        /**
+         * Create a zero matrix.
+         */
+        constexpr mat3() :
+            m_c{col_type(), col_type(), col_type()} {}
+
+        constexpr mat3(
+            val_t a00, val_t a01, val_t a02,
+            val_t a10, val_t a11, val_t a12,
+            val_t a20, val_t a21, val_t a22) :
+            m_c{
+                col_type(a00, a10, a20),
+                col_type(a01, a11, a21),
+                col_type(a02, a12, a22)
+            } {}
+
+        /**
+         * Create a matrix from its columns.
+         */
+        constexpr mat3(const col_type &c0, const col_type &c1, const col_type &c2) :
+            m_c{c0, c1, c2} {}
+
+        /**
+         * Create a matrix from nine elements in row-major order.
+         */
+        mat3(wlp::initializer_list<val_t> l) :
+            mat3(
+                l.begin()[0], l.begin()[1], l.begin()[2],
+                l.begin()[3], l.begin()[4], l.begin()[5],
+                l.begin()[6], l.begin()[7], l.begin()[8]) {}
+
+        static constexpr mat3<val_t> identity() {
+            return mat3<val_t>(
+                1, 0, 0,
+                0, 1, 0,
+                0, 0, 1);
+        }
+
+        static constexpr mat3<val_t> scaling(const vector3d<val_t> &s) {
+            return mat3<val_t>(
+                s.x(), 0, 0,
+                0, s.y(), 0,
+                0, 0, s.z());
+        }
+
+        static mat3<val_t> rotation_x(val_t angle) {
+            val_t c = static_cast<val_t>(cos(angle));
+            val_t s = static_cast<val_t>(sin(angle));
+            return mat3<val_t>(
+                1, 0, 0,
+                0, c, -s,
+                0, s, c);
+        }
+
+        static mat3<val_t> rotation_y(val_t angle) {
+            val_t c = static_cast<val_t>(cos(angle));
+            val_t s = static_cast<val_t>(sin(angle));
+            return mat3<val_t>(
+                c, 0, s,
+                0, 1, 0,
+                -s, 0, c);
+        }
+
+        static mat3<val_t> rotation_z(val_t angle) {
+            val_t c = static_cast<val_t>(cos(angle));
+            val_t s = static_cast<val_t>(sin(angle));
+            return mat3<val_t>(
+                c, -s, 0,
+                s, c, 0,
+                0, 0, 1);
+        }
+
+        /**
+         * @param i row index
+         * @param j column index
+         * @return reference to the element
+         */
+        val_t &operator()(size_t i, size_t j) {
+            return component(m_c[j], i);
+        }
+
+        const val_t &operator()(size_t i, size_t j) const {
+            return component(m_c[j], i);
+        }
+
+        col_type &col(size_t j) {
+            return m_c[j];
+        }
+
+        constexpr const col_type &col(size_t j) const {
+            return m_c[j];
+        }
+
+        vector3d<val_t> row(size_t i) const {
+            return {(*this)(i, 0), (*this)(i, 1), (*this)(i, 2)};
+        }
+
+        mat3<val_t> operator+(const mat3<val_t> &o) const {
+            return mat3<val_t>(m_c[0] + o.m_c[0], m_c[1] + o.m_c[1], m_c[2] + o.m_c[2]);
+        }
+
+        mat3<val_t> operator-(const mat3<val_t> &o) const {
+            return mat3<val_t>(m_c[0] - o.m_c[0], m_c[1] - o.m_c[1], m_c[2] - o.m_c[2]);
+        }
+
+        template<
+            typename scalar_t,
+            typename = typename enable_if<
+                is_arithmetic<scalar_t>::value
+            >::type
+        >
+        mat3<val_t> operator*(scalar_t b) const {
+            return mat3<val_t>(m_c[0] * b, m_c[1] * b, m_c[2] * b);
+        }
+
+        vector3d<val_t> operator*(const vector3d<val_t> &v) const {
+            return m_c[0] * v.x() + m_c[1] * v.y() + m_c[2] * v.z();
+        }
+
+        mat3<val_t> operator*(const mat3<val_t> &o) const {
+            return mat3<val_t>(*this * o.m_c[0], *this * o.m_c[1], *this * o.m_c[2]);
+        }
+
+        bool operator==(const mat3<val_t> &o) const {
+            return m_c[0] == o.m_c[0] && m_c[1] == o.m_c[1] && m_c[2] == o.m_c[2];
+        }
+
+        bool operator!=(const mat3<val_t> &o) const {
+            return !(*this == o);
+        }
+
+        mat3<val_t> transpose() const {
+            return mat3<val_t>(row(0), row(1), row(2));
+        }
+
+        val_t determinant() const {
+            return m_c[0].dot(m_c[1].cross(m_c[2]));
+        }
+
+        /**
+         * Compute the inverse through the adjugate.
+         *
+         * @param out receives the inverse
+         * @return false if the matrix is singular, in which case
+         * @code out @endcode is unchanged
+         */
+        bool inverse(mat3<val_t> &out) const {
+            vector3d<val_t> r0 = m_c[1].cross(m_c[2]);
+            vector3d<val_t> r1 = m_c[2].cross(m_c[0]);
+            vector3d<val_t> r2 = m_c[0].cross(m_c[1]);
+            val_t det = m_c[0].dot(r0);
+            if (det == 0) {
+                return false;
+            }
+            // the cross products are the rows of the adjugate
+            out = mat3<val_t>(r0, r1, r2).transpose() * (static_cast<val_t>(1) / det);
+            return true;
+        }
+
+    private:
+        static val_t &component(col_type &c, size_t i) {
+            return i == 0 ? c.x() : i == 1 ? c.y() : c.z();
+        }
+
+        static const val_t &component(const col_type &c, size_t i) {
+            return i == 0 ? c.x() : i == 1 ? c.y() : c.z();
+        }
+
+        col_type m_c[3];
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_MAT3_H
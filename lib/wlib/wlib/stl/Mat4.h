@@ -0,0 +1,272 @@
+/**
+ * @file Mat4.h
+ * @brief Four-by-four matrix over vector4d.
+ *
+ * The matrix is stored column-major as four vector4d columns, so a
+ * matrix-vector product is a sum of scaled columns and maps onto
+ * the four-lane primitives of vector4d. Constructors take elements
+ * in row-major reading order.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_MAT4_H
+#define EMBEDDEDCPLUSPLUS_MAT4_H
+
+#include <wlib/type_traits>
+#include <wlib/stl/InitializerList.h>
+#include <wlib/stl/Mat3.h>
+#include <wlib/stl/Vector4D.h>
+
+namespace wlp {
+
+    template<typename val_t>
+    class mat4 {
+        typedef __vec4_ops<val_t> ops;
+
+    public:
+        typedef vector4d<val_t> col_type;
+
+        /**
+         * Create a zero matrix.
+         */
+        constexpr mat4() :
+            m_c{col_type(), col_type(), col_type(), col_type()} {}
+
+        constexpr mat4(
+            val_t a00, val_t a01, val_t a02, val_t a03,
+            val_t a10, val_t a11, val_t a12, val_t a13,
+            val_t a20, val_t a21, val_t a22, val_t a23,
+            val_t a30, val_t a31, val_t a32, val_t a33) :
+            m_c{
+                col_type(a00, a10, a20, a30),
+                col_type(a01, a11, a21, a31),
+                col_type(a02, a12, a22, a32),
+                col_type(a03, a13, a23, a33)
+            } {}
+
+        /**
+         * Create a matrix from its columns.
+         */
+        constexpr mat4(const col_type &c0, const col_type &c1, const col_type &c2, const col_type &c3) :
+            m_c{c0, c1, c2, c3} {}
+
+        /**
+         * Create the affine transform that applies @code m @endcode
+         * and then translates by @code t @endcode.
+         */
+        constexpr mat4(const mat3<val_t> &m, const vector3d<val_t> &t) :
+            m_c{
+                col_type(m.col(0), 0),
+                col_type(m.col(1), 0),
+                col_type(m.col(2), 0),
+                col_type(t, 1)
+            } {}
+
+        /**
+         * Create a matrix from sixteen elements in row-major order.
+         */
+        mat4(wlp::initializer_list<val_t> l) :
+            mat4(
+                l.begin()[0], l.begin()[1], l.begin()[2], l.begin()[3],
+                l.begin()[4], l.begin()[5], l.begin()[6], l.begin()[7],
+                l.begin()[8], l.begin()[9], l.begin()[10], l.begin()[11],
+                l.begin()[12], l.begin()[13], l.begin()[14], l.begin()[15]) {}
+
+        static constexpr mat4<val_t> identity() {
+            return mat4<val_t>(
+                1, 0, 0, 0,
+                0, 1, 0, 0,
+                0, 0, 1, 0,
+                0, 0, 0, 1);
+        }
+
+        static constexpr mat4<val_t> translation(const vector3d<val_t> &t) {
+            return mat4<val_t>(
+                1, 0, 0, t.x(),
+                0, 1, 0, t.y(),
+                0, 0, 1, t.z(),
+                0, 0, 0, 1);
+        }
+
+        static constexpr mat4<val_t> scaling(const vector3d<val_t> &s) {
+            return mat4<val_t>(
+                s.x(), 0, 0, 0,
+                0, s.y(), 0, 0,
+                0, 0, s.z(), 0,
+                0, 0, 0, 1);
+        }
+
+        /**
+         * @param i row index
+         * @param j column index
+         * @return reference to the element
+         */
+        val_t &operator()(size_t i, size_t j) {
+            return m_c[j][i];
+        }
+
+        constexpr const val_t &operator()(size_t i, size_t j) const {
+            return m_c[j][i];
+        }
+
+        col_type &col(size_t j) {
+            return m_c[j];
+        }
+
+        constexpr const col_type &col(size_t j) const {
+            return m_c[j];
+        }
+
+        constexpr vector4d<val_t> row(size_t i) const {
+            return {m_c[0][i], m_c[1][i], m_c[2][i], m_c[3][i]};
+        }
+
+        /**
+         * @return the upper-left block holding rotation and scale
+         */
+        constexpr mat3<val_t> linear() const {
+            return mat3<val_t>(m_c[0].xyz(), m_c[1].xyz(), m_c[2].xyz());
+        }
+
+        mat4<val_t> operator+(const mat4<val_t> &o) const {
+            return mat4<val_t>(m_c[0] + o.m_c[0], m_c[1] + o.m_c[1], m_c[2] + o.m_c[2], m_c[3] + o.m_c[3]);
+        }
+
+        mat4<val_t> operator-(const mat4<val_t> &o) const {
+            return mat4<val_t>(m_c[0] - o.m_c[0], m_c[1] - o.m_c[1], m_c[2] - o.m_c[2], m_c[3] - o.m_c[3]);
+        }
+
+        template<
+            typename scalar_t,
+            typename = typename enable_if<
+                is_arithmetic<scalar_t>::value
+            >::type
+        >
+        mat4<val_t> operator*(scalar_t b) const {
+            return mat4<val_t>(m_c[0] * b, m_c[1] * b, m_c[2] * b, m_c[3] * b);
+        }
+
+        vector4d<val_t> operator*(const vector4d<val_t> &v) const {
+            const val_t *c[4] = {m_c[0].data(), m_c[1].data(), m_c[2].data(), m_c[3].data()};
+            vector4d<val_t> r;
+            ops::combine(c, v.data(), r.data());
+            return r;
+        }
+
+        mat4<val_t> operator*(const mat4<val_t> &o) const {
+            const val_t *c[4] = {m_c[0].data(), m_c[1].data(), m_c[2].data(), m_c[3].data()};
+            mat4<val_t> r;
+            for (size_t j = 0; j < 4; ++j) {
+                ops::combine(c, o.m_c[j].data(), r.m_c[j].data());
+            }
+            return r;
+        }
+
+        mat4<val_t> &operator*=(const mat4<val_t> &o) {
+            return *this = *this * o;
+        }
+
+        bool operator==(const mat4<val_t> &o) const {
+            return m_c[0] == o.m_c[0] && m_c[1] == o.m_c[1] && m_c[2] == o.m_c[2] && m_c[3] == o.m_c[3];
+        }
+
+        bool operator!=(const mat4<val_t> &o) const {
+            return !(*this == o);
+        }
+
+        /**
+         * Apply the transform to a point, taking its fourth component
+         * as one. No perspective division is done.
+         */
+        vector3d<val_t> transform_point(const vector3d<val_t> &p) const {
+            return (*this * vector4d<val_t>(p, 1)).xyz();
+        }
+
+        /**
+         * Apply the transform to a direction, taking its fourth
+         * component as zero so that translation is ignored.
+         */
+        vector3d<val_t> transform_vector(const vector3d<val_t> &v) const {
+            return (*this * vector4d<val_t>(v, 0)).xyz();
+        }
+
+        mat4<val_t> transpose() const {
+            return mat4<val_t>(row(0), row(1), row(2), row(3));
+        }
+
+        val_t determinant() const {
+            val_t s[6];
+            val_t c[6];
+            minors(s, c);
+            return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+        }
+
+        /**
+         * Compute the inverse through cofactor expansion over
+         * pairs of two-by-two minors.
+         *
+         * @param out receives the inverse
+         * @return false if the matrix is singular, in which case
+         * @code out @endcode is unchanged
+         */
+        bool inverse(mat4<val_t> &out) const {
+            val_t s[6];
+            val_t c[6];
+            minors(s, c);
+            val_t det = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+            if (det == 0) {
+                return false;
+            }
+            const mat4<val_t> &a = *this;
+            val_t k = static_cast<val_t>(1) / det;
+            out = mat4<val_t>(
+                (a(1, 1) * c[5] - a(1, 2) * c[4] + a(1, 3) * c[3]) * k,
+                (-a(0, 1) * c[5] + a(0, 2) * c[4] - a(0, 3) * c[3]) * k,
+                (a(3, 1) * s[5] - a(3, 2) * s[4] + a(3, 3) * s[3]) * k,
+                (-a(2, 1) * s[5] + a(2, 2) * s[4] - a(2, 3) * s[3]) * k,
+
+                (-a(1, 0) * c[5] + a(1, 2) * c[2] - a(1, 3) * c[1]) * k,
+                (a(0, 0) * c[5] - a(0, 2) * c[2] + a(0, 3) * c[1]) * k,
+                (-a(3, 0) * s[5] + a(3, 2) * s[2] - a(3, 3) * s[1]) * k,
+                (a(2, 0) * s[5] - a(2, 2) * s[2] + a(2, 3) * s[1]) * k,
+
+                (a(1, 0) * c[4] - a(1, 1) * c[2] + a(1, 3) * c[0]) * k,
+                (-a(0, 0) * c[4] + a(0, 1) * c[2] - a(0, 3) * c[0]) * k,
+                (a(3, 0) * s[4] - a(3, 1) * s[2] + a(3, 3) * s[0]) * k,
+                (-a(2, 0) * s[4] + a(2, 1) * s[2] - a(2, 3) * s[0]) * k,
+
+                (-a(1, 0) * c[3] + a(1, 1) * c[1] - a(1, 2) * c[0]) * k,
+                (a(0, 0) * c[3] - a(0, 1) * c[1] + a(0, 2) * c[0]) * k,
+                (-a(3, 0) * s[3] + a(3, 1) * s[1] - a(3, 2) * s[0]) * k,
+                (a(2, 0) * s[3] - a(2, 1) * s[1] + a(2, 2) * s[0]) * k);
+            return true;
+        }
+
+    private:
+        /**
+         * Compute the two-by-two minors of the upper two rows into
+         * @code s @endcode and of the lower two rows into @code c @endcode.
+         */
+        void minors(val_t *s, val_t *c) const {
+            const mat4<val_t> &a = *this;
+            s[0] = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+            s[1] = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+            s[2] = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+            s[3] = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+            s[4] = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+            s[5] = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+            c[0] = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+            c[1] = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+            c[2] = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+            c[3] = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+            c[4] = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+            c[5] = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+        }
+
+        col_type m_c[4];
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_MAT4_H
@@ -0,0 +1,400 @@
+/**
+ * @file MemStats.h
+ * @brief Opt-in allocation statistics and their JSON dump.
+ *
+ * Statistics are gathered per tag. A tag counts the bytes it has live,
+ * the peak of that count, allocations, frees and failed allocations,
+ * and allocations sorted into power-of-two size classes. Tags register
+ * themselves on first use, so the registry can be walked and dumped at
+ * runtime with @code mem_stats_json @endcode.
+ *
+ * Memory is attributed to a tag by giving a container a
+ * @code tagged_allocator @endcode referring to it; one tag per call site
+ * or one per container type gives the matching breakdown. Building with
+ * @code WLIB_MEM_STATS @endcode also counts every request of the default
+ * allocator under the tag returned by @code mem_stats_global @endcode.
+ * Without it the default allocator is unchanged and nothing is counted
+ * unless a tagged allocator is used.
+ *
+ * The pool behind @code mem::alloc @endcode is not visible from here.
+ * A platform that can walk its pool registers a probe with
+ * @code mem_stats_set_pool_probe @endcode to report free space and the
+ * largest free block, from which the fragmentation is derived.
+ *
+ * Tags are updated with relaxed atomics and may be shared by threads.
+ * A tag must outlive every allocator referring to it and, once used,
+ * stays in the registry; tags should have static storage duration.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_MEMSTATS_H
+#define EMBEDDEDCPLUSPLUS_MEMSTATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <wlib/stl/JsonBuffer.h>
+
+namespace wlp {
+
+    struct allocator;
+
+    /**
+     * Number of size classes. Class @code i @endcode counts requests of
+     * at most @code 16 << i @endcode bytes, and the last class counts
+     * all larger requests.
+     */
+    constexpr size_t mem_size_classes = 12;
+
+    /**
+     * @return the size class of a request of @code size @endcode bytes
+     */
+    inline size_t mem_size_class(size_t size) {
+        size_t c = 0;
+        size_t limit = 16;
+        while (c < mem_size_classes - 1 && size > limit) {
+            ++c;
+            limit <<= 1;
+        }
+        return c;
+    }
+
+    /**
+     * Allocation counters under one name.
+     */
+    class mem_tag {
+    public:
+        /**
+         * @param name name of the tag, which must outlive it
+         */
+        constexpr explicit mem_tag(const char *name)
+                : m_name(name),
+                  m_next(nullptr),
+                  m_registered(false),
+                  m_live(0),
+                  m_peak(0),
+                  m_allocs(0),
+                  m_frees(0),
+                  m_failures(0),
+                  m_classes{} {}
+
+        void record_alloc(size_t size) {
+            enroll();
+            size_t live = __atomic_add_fetch(&m_live, size, __ATOMIC_RELAXED);
+            size_t peak = __atomic_load_n(&m_peak, __ATOMIC_RELAXED);
+            while (live > peak &&
+                   !__atomic_compare_exchange_n(&m_peak, &peak, live, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+            __atomic_add_fetch(&m_allocs, 1, __ATOMIC_RELAXED);
+            __atomic_add_fetch(&m_classes[mem_size_class(size)], 1, __ATOMIC_RELAXED);
+        }
+
+        void record_free(size_t size) {
+            __atomic_sub_fetch(&m_live, size, __ATOMIC_RELAXED);
+            __atomic_add_fetch(&m_frees, 1, __ATOMIC_RELAXED);
+        }
+
+        void record_failure() {
+            enroll();
+            __atomic_add_fetch(&m_failures, 1, __ATOMIC_RELAXED);
+        }
+
+        /**
+         * Restart the peak from the bytes live now.
+         */
+        void reset_peak() {
+            __atomic_store_n(&m_peak, live_bytes(), __ATOMIC_RELAXED);
+        }
+
+        const char *name() const {
+            return m_name;
+        }
+
+        size_t live_bytes() const {
+            return __atomic_load_n(&m_live, __ATOMIC_RELAXED);
+        }
+
+        size_t peak_bytes() const {
+            return __atomic_load_n(&m_peak, __ATOMIC_RELAXED);
+        }
+
+        size_t allocations() const {
+            return __atomic_load_n(&m_allocs, __ATOMIC_RELAXED);
+        }
+
+        size_t frees() const {
+            return __atomic_load_n(&m_frees, __ATOMIC_RELAXED);
+        }
+
+        size_t failures() const {
+            return __atomic_load_n(&m_failures, __ATOMIC_RELAXED);
+        }
+
+        /**
+         * @return number of allocations in size class @code c @endcode
+         */
+        size_t class_allocations(size_t c) const {
+            return __atomic_load_n(&m_classes[c], __ATOMIC_RELAXED);
+        }
+
+        /**
+         * @return the next registered tag, or null
+         */
+        mem_tag *next() const {
+            return __atomic_load_n(&m_next, __ATOMIC_ACQUIRE);
+        }
+
+        /**
+         * @return the most recently registered tag, or null
+         */
+        static mem_tag *first();
+
+    private:
+        /**
+         * Add the tag to the registry the first time it is used.
+         */
+        void enroll();
+
+        const char *m_name;
+        mem_tag *m_next;
+        bool m_registered;
+        size_t m_live;
+        size_t m_peak;
+        size_t m_allocs;
+        size_t m_frees;
+        size_t m_failures;
+        size_t m_classes[mem_size_classes];
+
+        mem_tag(const mem_tag &) = delete;
+
+        mem_tag &operator=(const mem_tag &) = delete;
+    };
+
+    /**
+     * State of the memory pool as reported by a platform probe.
+     */
+    struct mem_pool_info {
+        size_t free_bytes;
+        size_t largest_free_block;
+
+        /**
+         * @return share of the free memory not in the largest free
+         *         block, in percent; zero when nothing is free
+         */
+        unsigned fragmentation_percent() const {
+            if (free_bytes == 0) {
+                return 0;
+            }
+            return static_cast<unsigned>(100 - largest_free_block * 100 / free_bytes);
+        }
+    };
+
+    /**
+     * Fills in the state of the pool, returning false if it cannot.
+     */
+    typedef bool (*mem_pool_probe)(mem_pool_info &info);
+
+    namespace __mem_stats {
+
+        /**
+         * Registry state, a template so that the header can define it.
+         * Every member is constant-initialised.
+         */
+        template<typename = void>
+        struct registry {
+            static mem_tag *head;
+            static mem_tag global;
+            static mem_pool_probe probe;
+        };
+
+        template<typename V>
+        mem_tag *registry<V>::head = nullptr;
+
+        template<typename V>
+        mem_tag registry<V>::global("global");
+
+        template<typename V>
+        mem_pool_probe registry<V>::probe = nullptr;
+
+    }
+
+    inline mem_tag *mem_tag::first() {
+        return __atomic_load_n(&__mem_stats::registry<>::head, __ATOMIC_ACQUIRE);
+    }
+
+    inline void mem_tag::enroll() {
+        if (__atomic_load_n(&m_registered, __ATOMIC_RELAXED) ||
+            __atomic_exchange_n(&m_registered, true, __ATOMIC_RELAXED)) {
+            return;
+        }
+        mem_tag *&head = __mem_stats::registry<>::head;
+        mem_tag *old = __atomic_load_n(&head, __ATOMIC_RELAXED);
+        do {
+            m_next = old;
+        } while (!__atomic_compare_exchange_n(&head, &old, this, true,
+                                              __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+
+    /**
+     * @return the tag counting requests of the default allocator when
+     *         built with @code WLIB_MEM_STATS @endcode
+     */
+    inline mem_tag &mem_stats_global() {
+        return __mem_stats::registry<>::global;
+    }
+
+    /**
+     * Find a registered tag by name.
+     *
+     * @return the tag, or null if no used tag has the name
+     */
+    inline mem_tag *mem_stats_find(const char *name) {
+        for (mem_tag *tag = mem_tag::first(); tag; tag = tag->next()) {
+            const char *a = tag->name();
+            const char *b = name;
+            while (*a && *a == *b) {
+                ++a;
+                ++b;
+            }
+            if (*a == *b) {
+                return tag;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Register the function reporting the state of the pool, or null
+     * to remove it.
+     */
+    inline void mem_stats_set_pool_probe(mem_pool_probe probe) {
+        __atomic_store_n(&__mem_stats::registry<>::probe, probe, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * @return false if no probe is registered or it failed
+     */
+    inline bool mem_stats_pool(mem_pool_info &info) {
+        mem_pool_probe probe = __atomic_load_n(&__mem_stats::registry<>::probe, __ATOMIC_ACQUIRE);
+        return probe && probe(info);
+    }
+
+    /**
+     * Write every registered tag, and the pool state if a probe is
+     * registered, as a JSON object. Output that does not fit is cut
+     * off, but the buffer is always terminated.
+     *
+     * @param buf  the buffer
+     * @param size size of the buffer
+     * @return the length of the complete output, excluding the
+     *         terminator, so a result of at least @code size @endcode
+     *         means it was cut off
+     */
+    inline size_t mem_stats_json(char *buf, size_t size) {
+        json_buffer out(buf, size);
+        if (size > 0) {
+            buf[0] = '\0';
+        }
+        out.put("{\"tags\":[");
+        for (mem_tag *tag = mem_tag::first(); tag; tag = tag->next()) {
+            if (tag != mem_tag::first()) {
+                out.put(',');
+            }
+            out.put("{\"name\":");
+            out.put_string(tag->name());
+            out.put(',');
+            out.put_field("live_bytes", tag->live_bytes());
+            out.put(',');
+            out.put_field("peak_bytes", tag->peak_bytes());
+            out.put(',');
+            out.put_field("allocations", tag->allocations());
+            out.put(',');
+            out.put_field("frees", tag->frees());
+            out.put(',');
+            out.put_field("failures", tag->failures());
+            out.put(",\"size_classes\":[");
+            for (size_t c = 0; c < mem_size_classes; ++c) {
+                if (c > 0) {
+                    out.put(',');
+                }
+                out.put_number(tag->class_allocations(c));
+            }
+            out.put("]}");
+        }
+        out.put("],\"pool\":");
+        mem_pool_info info;
+        if (mem_stats_pool(info)) {
+            out.put('{');
+            out.put_field("free_bytes", info.free_bytes);
+            out.put(',');
+            out.put_field("largest_free_block", info.largest_free_block);
+            out.put(',');
+            out.put_field("fragmentation_percent", info.fragmentation_percent());
+            out.put('}');
+        } else {
+            out.put("null");
+        }
+        out.put('}');
+        return out.length();
+    }
+
+    /**
+     * Allocator that counts its requests under a tag and forwards them
+     * to another allocator. Copies count under the same tag.
+     *
+     * @tparam Alloc the allocator doing the work
+     */
+    template<typename Alloc = allocator>
+    class tagged_allocator : private Alloc {
+    public:
+        explicit tagged_allocator(mem_tag &tag, const Alloc &alloc = Alloc())
+                : Alloc(alloc),
+                  m_tag(&tag) {}
+
+        void *allocate(size_t size, size_t align) {
+            void *ptr = get_alloc().allocate(size, align);
+            if (ptr) {
+                m_tag->record_alloc(size);
+            } else {
+                m_tag->record_failure();
+            }
+            return ptr;
+        }
+
+        void deallocate(void *ptr, size_t size, size_t align) {
+            if (ptr) {
+                m_tag->record_free(size);
+            }
+            get_alloc().deallocate(ptr, size, align);
+        }
+
+        mem_tag *get_tag() const {
+            return m_tag;
+        }
+
+        bool operator==(const tagged_allocator &o) const {
+            return m_tag == o.m_tag && static_cast<const Alloc &>(*this) == static_cast<const Alloc &>(o);
+        }
+
+        bool operator!=(const tagged_allocator &o) const {
+            return !(*this == o);
+        }
+
+    private:
+        Alloc &get_alloc() {
+            return *this;
+        }
+
+        mem_tag *m_tag;
+    };
+
+}
+
+/*
+ * The default allocator of tagged_allocator; Allocator.h includes this
+ * header first when built with WLIB_MEM_STATS.
+ */
+#include <wlib/stl/Allocator.h>
+
+#endif //EMBEDDEDCPLUSPLUS_MEMSTATS_H
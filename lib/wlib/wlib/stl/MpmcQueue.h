@@ -0,0 +1,401 @@
+/**
+ * @file MpmcQueue.h
+ * @brief Bounded lock-free queue for many producers and consumers.
+ *
+ * The queue is Vyukov's bounded ring: every slot carries a sequence
+ * number telling whether it is ready to be written or read on the
+ * current lap of the ring. A producer claims a slot by advancing the
+ * enqueue position with a compare-and-swap, writes the element and
+ * publishes it by bumping the slot's sequence; consumers do the same
+ * with the dequeue position. Threads only contend on the two positions,
+ * which sit on separate cache lines, and never wait on a lock.
+ *
+ * The blocking @code push @endcode and @code pop @endcode retry for a
+ * while, then yield, then sleep until the other side makes room or
+ * adds an element. On Linux they sleep on a futex, which costs nothing
+ * while nobody sleeps; on other POSIX hosts they sleep briefly and
+ * retry; elsewhere they spin.
+ *
+ * @code mpmc_queue @endcode takes its slots from an allocator once,
+ * when constructed; @code static_mpmc_queue @endcode keeps them inside
+ * the object. Neither allocates afterwards.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_MPMCQUEUE_H
+#define EMBEDDEDCPLUSPLUS_MPMCQUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define __WLIB_MPMC_FUTEX
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sched.h>
+#include <time.h>
+#endif
+
+#include <wlib/memory>
+#include <wlib/utility>
+#include <wlib/stl/Allocator.h>
+
+namespace wlp {
+
+    namespace __mpmc_queue {
+
+        template<typename T>
+        struct cell {
+            size_t sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T *get() {
+                return reinterpret_cast<T *>(storage);
+            }
+        };
+
+        /**
+         * Attempts at an operation before yielding, and yields before
+         * sleeping.
+         */
+        static constexpr unsigned spin_limit = 64;
+        static constexpr unsigned yield_limit = 16;
+
+        inline void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+
+        inline void yield() {
+#if defined(__WLIB_MPMC_FUTEX) || defined(__unix__) || defined(__APPLE__)
+            sched_yield();
+#endif
+        }
+
+        /**
+         * Sleep while the event count still equals the value seen.
+         */
+        inline void wait(uint32_t *event, uint32_t seen) {
+#if defined(__WLIB_MPMC_FUTEX)
+            syscall(SYS_futex, event, FUTEX_WAIT_PRIVATE, seen, nullptr, nullptr, 0);
+#elif defined(__unix__) || defined(__APPLE__)
+            (void) event;
+            (void) seen;
+            timespec pause = {0, 50000};
+            nanosleep(&pause, nullptr);
+#else
+            (void) event;
+            (void) seen;
+#endif
+        }
+
+        inline void wake_one(uint32_t *event) {
+#if defined(__WLIB_MPMC_FUTEX)
+            syscall(SYS_futex, event, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+            (void) event;
+#endif
+        }
+
+    }
+
+    /**
+     * Multi-producer multi-consumer queue.
+     *
+     * @tparam T     element type
+     * @tparam Alloc allocator of the slots, see Allocator.h
+     */
+    template<typename T, typename Alloc = allocator>
+    class mpmc_queue : private Alloc {
+        typedef __mpmc_queue::cell<T> cell;
+
+    public:
+        typedef T val_type;
+        typedef size_t size_type;
+
+        /**
+         * Allocate the slots.
+         *
+         * @param capacity the least number of elements held, rounded up
+         *                 to a power of two of at least two; the capacity
+         *                 is zero if the slots could not be allocated
+         * @param alloc    the allocator
+         */
+        explicit mpmc_queue(size_type capacity, const Alloc &alloc = Alloc())
+                : Alloc(alloc),
+                  m_cells(nullptr),
+                  m_capacity(0),
+                  m_owned(true) {
+            size_type n = 2;
+            while (n < capacity) {
+                n <<= 1;
+            }
+            init(static_cast<cell *>(this->allocate(n * sizeof(cell), alignof(cell))), n);
+        }
+
+        mpmc_queue(const mpmc_queue &) = delete;
+
+        ~mpmc_queue() {
+            size_type tail = __atomic_load_n(&m_enqueue_pos, __ATOMIC_ACQUIRE);
+            for (size_type pos = m_dequeue_pos; pos != tail; ++pos) {
+                m_cells[pos & (m_capacity - 1)].get()->~T();
+            }
+            if (m_owned && m_cells) {
+                this->deallocate(m_cells, m_capacity * sizeof(cell), alignof(cell));
+            }
+        }
+
+        mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+        /**
+         * Add an element if there is room.
+         *
+         * @return false if the queue is full
+         */
+        bool try_push(const T &val) {
+            return try_emplace(val);
+        }
+
+        bool try_push(T &&val) {
+            return try_emplace(move(val));
+        }
+
+        /**
+         * Construct an element in place if there is room. The arguments
+         * are left untouched if there is not.
+         *
+         * @return false if the queue is full
+         */
+        template<typename... Args>
+        bool try_emplace(Args &&... args) {
+            if (m_capacity == 0) {
+                return false;
+            }
+            size_type pos = __atomic_load_n(&m_enqueue_pos, __ATOMIC_RELAXED);
+            for (;;) {
+                cell *c = &m_cells[pos & (m_capacity - 1)];
+                size_type seq = __atomic_load_n(&c->sequence, __ATOMIC_ACQUIRE);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (__atomic_compare_exchange_n(&m_enqueue_pos, &pos, pos + 1, true,
+                                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                        new (static_cast<void *>(c->storage)) T(forward<Args>(args)...);
+                        __atomic_store_n(&c->sequence, pos + 1, __ATOMIC_RELEASE);
+                        signal(&m_pushed, &m_pop_waiters);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = __atomic_load_n(&m_enqueue_pos, __ATOMIC_RELAXED);
+                }
+            }
+        }
+
+        /**
+         * Move the oldest element out if there is one.
+         *
+         * @return false if the queue is empty
+         */
+        bool try_pop(T &val) {
+            if (m_capacity == 0) {
+                return false;
+            }
+            size_type pos = __atomic_load_n(&m_dequeue_pos, __ATOMIC_RELAXED);
+            for (;;) {
+                cell *c = &m_cells[pos & (m_capacity - 1)];
+                size_type seq = __atomic_load_n(&c->sequence, __ATOMIC_ACQUIRE);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (__atomic_compare_exchange_n(&m_dequeue_pos, &pos, pos + 1, true,
+                                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                        val = move(*c->get());
+                        c->get()->~T();
+                        __atomic_store_n(&c->sequence, pos + m_capacity, __ATOMIC_RELEASE);
+                        signal(&m_popped, &m_push_waiters);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = __atomic_load_n(&m_dequeue_pos, __ATOMIC_RELAXED);
+                }
+            }
+        }
+
+        /**
+         * Add an element, waiting for room if the queue is full. A queue
+         * whose slots could not be allocated waits forever.
+         */
+        void push(const T &val) {
+            emplace(val);
+        }
+
+        void push(T &&val) {
+            emplace(move(val));
+        }
+
+        template<typename... Args>
+        void emplace(Args &&... args) {
+            for (unsigned attempt = 0; !try_emplace(forward<Args>(args)...); ++attempt) {
+                if (backoff(attempt)) {
+                    sleep(&m_popped, &m_push_waiters, [this]() { return full(); });
+                }
+            }
+        }
+
+        /**
+         * Move the oldest element out, waiting for one if the queue is
+         * empty.
+         */
+        void pop(T &val) {
+            for (unsigned attempt = 0; !try_pop(val); ++attempt) {
+                if (backoff(attempt)) {
+                    sleep(&m_pushed, &m_pop_waiters, [this]() { return empty(); });
+                }
+            }
+        }
+
+        /**
+         * @return the number of elements, which may be out of date by
+         *         the time it is read
+         */
+        size_type size() const {
+            size_type head = __atomic_load_n(&m_dequeue_pos, __ATOMIC_ACQUIRE);
+            size_type tail = __atomic_load_n(&m_enqueue_pos, __ATOMIC_ACQUIRE);
+            return tail > head ? tail - head : 0;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        bool full() const {
+            return size() >= m_capacity;
+        }
+
+        size_type capacity() const {
+            return m_capacity;
+        }
+
+    protected:
+        /**
+         * Use slots owned by a derived class.
+         *
+         * @param cells    storage for the slots
+         * @param capacity number of slots, a power of two of at least two
+         */
+        mpmc_queue(cell *cells, size_type capacity)
+                : m_owned(false) {
+            init(cells, capacity);
+        }
+
+    private:
+        void init(cell *cells, size_type capacity) {
+            m_cells = cells;
+            m_capacity = cells ? capacity : 0;
+            for (size_type i = 0; i < m_capacity; ++i) {
+                m_cells[i].sequence = i;
+            }
+            m_enqueue_pos = 0;
+            m_dequeue_pos = 0;
+            m_pushed = 0;
+            m_popped = 0;
+            m_push_waiters = 0;
+            m_pop_waiters = 0;
+        }
+
+        /**
+         * Spin, then yield, between attempts.
+         *
+         * @return true once the caller should sleep
+         */
+        static bool backoff(unsigned attempt) {
+            if (attempt < __mpmc_queue::spin_limit) {
+                __mpmc_queue::pause();
+                return false;
+            }
+            if (attempt < __mpmc_queue::spin_limit + __mpmc_queue::yield_limit) {
+                __mpmc_queue::yield();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * Sleep on an event unless it fires, or the condition clears,
+         * after registering as a waiter. The fence pairs with the one
+         * in @code signal @endcode and keeps the queue check from
+         * being ordered before the registration.
+         */
+        template<typename Blocked>
+        static void sleep(uint32_t *event, uint32_t *waiters, Blocked blocked) {
+            __atomic_add_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            uint32_t seen = __atomic_load_n(event, __ATOMIC_SEQ_CST);
+            if (blocked()) {
+                __mpmc_queue::wait(event, seen);
+            }
+            __atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+        }
+
+        /**
+         * Fire an event if anyone sleeps on it. The fence orders the
+         * change to the queue before the check for sleepers, as the
+         * sleeper registers before checking the queue, so one of the
+         * two sees the other.
+         */
+        static void signal(uint32_t *event, uint32_t *waiters) {
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            if (__atomic_load_n(waiters, __ATOMIC_RELAXED) > 0) {
+                __atomic_add_fetch(event, 1, __ATOMIC_SEQ_CST);
+                __mpmc_queue::wake_one(event);
+            }
+        }
+
+        alignas(64) size_type m_enqueue_pos;
+        alignas(64) size_type m_dequeue_pos;
+        alignas(64) cell *m_cells;
+        size_type m_capacity;
+        bool m_owned;
+        /**
+         * Counts of pops and pushes made while threads slept, which
+         * producers and consumers sleep on, and the sleepers.
+         */
+        alignas(64) uint32_t m_popped;
+        uint32_t m_push_waiters;
+        uint32_t m_pushed;
+        uint32_t m_pop_waiters;
+    };
+
+    /**
+     * Multi-producer multi-consumer queue with its slots inside the
+     * object.
+     *
+     * @tparam T         element type
+     * @tparam tCapacity number of elements held, a power of two of at
+     *                   least two
+     */
+    template<typename T, size_t tCapacity>
+    class static_mpmc_queue : public mpmc_queue<T> {
+        static_assert(tCapacity >= 2 && (tCapacity & (tCapacity - 1)) == 0,
+                      "capacity must be a power of two of at least two");
+
+    public:
+        static_mpmc_queue()
+                : mpmc_queue<T>(m_cells, tCapacity) {}
+
+    private:
+        __mpmc_queue::cell<T> m_cells[tCapacity];
+    };
+
+}
+
+#undef __WLIB_MPMC_FUTEX
+
+#endif //EMBEDDEDCPLUSPLUS_MPMCQUEUE_H
@@ -29,22 +29,25 @@ namespace wlp {
      * @tparam Key   the unique element type
      * @tparam Hash  the hash function of the stored elements
      * @tparam Equal test for equality function of the stored elements
+     * @tparam Alloc allocator of the elements and buckets
      */
     template<class Key,
             class Hasher = hash <Key, uint16_t>,
-            class Equals = equals <Key>>
+            class Equals = equals <Key>,
+            class Alloc = allocator>
     class open_set {
     public:
-        typedef open_set<Key, Hasher, Equals> set_type;
+        typedef open_set<Key, Hasher, Equals, Alloc> set_type;
         typedef open_table<Key,
             Key, Key,
             SetGetKey<Key>, SetGetVal<Key>,
-            Hasher, Equals
+            Hasher, Equals, Alloc
         > table_type;
         typedef typename table_type::iterator iterator;
         typedef typename table_type::const_iterator const_iterator;
         typedef typename table_type::size_type size_type;
         typedef typename table_type::percent_type percent_type;
+        typedef Alloc allocator_type;
 
         typedef Key key_type;
 
@@ -54,8 +57,9 @@ namespace wlp {
     public:
         explicit open_set(
                 size_type n = 12,
-                percent_type max_load = 75)
-                : m_table(n, max_load) {
+                percent_type max_load = 75,
+                const Alloc &alloc = Alloc())
+                : m_table(n, max_load, alloc) {
         }
 
         open_set(const set_type &) = delete;
@@ -64,6 +68,19 @@ namespace wlp {
                 : m_table(move(set.m_table)) {
         }
 
+        allocator_type get_allocator() const {
+            return m_table.get_allocator();
+        }
+
+#ifdef WLIB_CONTAINER_STATS
+        /**
+         * @return the operation counters of the underlying table
+         */
+        const container_stats &stats() const {
+            return m_table.stats();
+        }
+#endif
+
         size_type size() const {
             return m_table.size();
         }
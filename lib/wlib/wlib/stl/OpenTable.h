@@ -15,6 +15,8 @@
 #ifndef CORE_STL_HASH_TABLE_H
 #define CORE_STL_HASH_TABLE_H
 
+#include <wlib/stl/Allocator.h>
+#include <wlib/stl/ContainerStats.h>
 #include <wlib/stl/Equal.h>
 #include <wlib/stl/Hash.h>
 #include <wlib/stl/Pair.h>
@@ -29,7 +31,7 @@ namespace wlp {
             typename GetKey,
             typename GetVal,
             typename Hasher,
-            typename Equals>
+            typename Equals, typename Alloc>
     class open_table;
 
     /**
@@ -51,10 +53,10 @@ namespace wlp {
             typename GetKey,
             typename GetVal,
             typename Hasher,
-            typename Equals>
+            typename Equals, typename Alloc>
     struct OpenHashTableIterator {
-        typedef OpenHashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals> self_type;
-        typedef open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals> table_type;
+        typedef OpenHashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals, Alloc> self_type;
+        typedef open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc> table_type;
 
         typedef Element element_type;
         typedef Key key_type;
@@ -196,21 +198,22 @@ namespace wlp {
             typename GetKey,
             typename GetVal,
             typename Hasher = hash <Key, uint16_t>,
-            typename Equals = equals <Key>>
-    class open_table {
+            typename Equals = equals <Key>,
+            typename Alloc = allocator>
+    class open_table : private Alloc {
     public:
-        typedef open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals> table_type;
+        typedef open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc> table_type;
         typedef OpenHashTableIterator<
                 Element, Key,
                 Val, Val &, Val *,
                 GetKey, GetVal,
-                Hasher, Equals
+                Hasher, Equals, Alloc
         > iterator;
         typedef OpenHashTableIterator<
                 Element, Key, Val,
                 const Val &, const Val *,
                 GetKey, GetVal,
-                Hasher, Equals
+                Hasher, Equals, Alloc
         > const_iterator;
 
         typedef Element element_type;
@@ -224,17 +227,18 @@ namespace wlp {
 
         typedef Hasher hash_function;
         typedef Equals key_equals;
+        typedef Alloc allocator_type;
 
         friend struct OpenHashTableIterator<
                 Element, Key,
                 Val, Val &, Val *,
                 GetKey, GetVal,
-                Hasher, Equals>;
+                Hasher, Equals, Alloc>;
         friend struct OpenHashTableIterator<
                 Element, Key, Val,
                 const Val &, const Val *,
                 GetKey, GetVal,
-                Hasher, Equals>;
+                Hasher, Equals, Alloc>;
 
     private:
         /**
@@ -273,6 +277,10 @@ namespace wlp {
          */
         get_key m_get_key{};
 
+#ifdef WLIB_CONTAINER_STATS
+        mutable container_stats m_stats{&container_stats_global(open_table_kind)};
+#endif
+
     public:
         /**
          * Create and initialize an empty hash map. The hash map uses
@@ -285,11 +293,14 @@ namespace wlp {
          * @param max_load an integer value denoting the max percent load factory, e.g. 75 = 0.75
          * @param hash     hash function for the key type, default is @code wlp::Hasher @endcode
          * @param equal    equality function for the key type, default is @code wlp::Equals @endcode
+         * @param alloc    allocator of the elements and the bucket array
          */
         explicit open_table(
                 size_type n = 12,
-                percent_type max_load = 75)
-                : m_num_elements(0),
+                percent_type max_load = 75,
+                const Alloc &alloc = Alloc())
+                : Alloc(alloc),
+                  m_num_elements(0),
                   m_capacity(n),
                   m_max_load(max_load) {
             init_buckets(n);
@@ -310,7 +321,8 @@ namespace wlp {
          * @param map map from which to transfer
          */
         open_table(table_type &&map)
-                : m_buckets(move(map.m_buckets)),
+                : Alloc(map.get_allocator()),
+                  m_buckets(move(map.m_buckets)),
                   m_num_elements(move(map.m_num_elements)),
                   m_capacity(move(map.m_capacity)),
                   m_max_load(move(map.m_max_load)) {
@@ -325,7 +337,27 @@ namespace wlp {
          */
         ~open_table();
 
+        /**
+         * @return a copy of the allocator of this table
+         */
+        allocator_type get_allocator() const {
+            return *this;
+        }
+
+#ifdef WLIB_CONTAINER_STATS
+        /**
+         * @return the operation counters of this table
+         */
+        const container_stats &stats() const {
+            return m_stats;
+        }
+#endif
+
     private:
+        Alloc &get_alloc() {
+            return *this;
+        }
+
         /**
          * Function called when creating the hash map. This function
          * will allocate memory for the backing array and initialize each
@@ -387,7 +419,7 @@ namespace wlp {
         }
 
         /**
-         * @see OpenHashTable<Key, Val, Hasher, Equals>::begin()
+         * @see OpenHashTable<Key, Val, Hasher, Equals, Alloc>::begin()
          * @return a constant iterator to the first element
          */
         const_iterator begin() const {
@@ -410,7 +442,7 @@ namespace wlp {
         }
 
         /**
-         * @see OpenHashTable<Key, Val, Hasher, Equals>::end()
+         * @see OpenHashTable<Key, Val, Hasher, Equals, Alloc>::end()
          * @return a constant pass-the-end iterator
          */
         const_iterator end() const {
@@ -502,7 +534,7 @@ namespace wlp {
         iterator find(const key_type &key);
 
         /**
-         * @see OpenHashTable<Key, Val, Hasher, Equals>::find()
+         * @see OpenHashTable<Key, Val, Hasher, Equals, Alloc>::find()
          * @param key the key to map
          * @return a const iterator to the element mapped by the key
          */
@@ -528,10 +560,10 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    void open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
-    ::init_buckets(open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::size_type n) {
-        m_buckets = create<element_type *[]>(n);
+            typename Hasher, typename Equals, typename Alloc>
+    void open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
+    ::init_buckets(open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::size_type n) {
+        m_buckets = alloc_create_array<element_type *>(get_alloc(), n);
         for (size_type i = 0; i < n; ++i) {
             m_buckets[i] = nullptr;
         }
@@ -539,14 +571,14 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    void open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    void open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::ensure_capacity() {
         if (m_num_elements * 100 < m_max_load * m_capacity) {
             return;
         }
         size_type new_capacity = static_cast<size_type>(m_capacity * 2);
-        element_type **new_buckets = create<element_type *[]>(new_capacity);
+        element_type **new_buckets = alloc_create_array<element_type *>(get_alloc(), new_capacity);
         for (size_type i = 0; i < new_capacity; ++i) {
             new_buckets[i] = nullptr;
         }
@@ -563,19 +595,20 @@ namespace wlp {
             }
             new_buckets[k] = node;
         }
-        destroy<element_type *[]>(m_buckets);
+        WLIB_CONTAINER_STAT(m_stats.record_growth(m_capacity * sizeof(element_type *)));
+        alloc_destroy_array(get_alloc(), m_buckets, m_capacity);
         m_buckets = new_buckets;
         m_capacity = new_capacity;
     }
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    void open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    void open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::clear() noexcept {
         for (size_type i = 0; i < m_capacity; ++i) {
             if (m_buckets[i]) {
-                destroy<element_type>(m_buckets[i]);
+                alloc_destroy(get_alloc(), m_buckets[i]);
                 m_buckets[i] = nullptr;
             }
         }
@@ -584,23 +617,26 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
+            typename Hasher, typename Equals, typename Alloc>
     template<typename E>
-    pair<typename open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::iterator, bool>
-    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+    pair<typename open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::iterator, bool>
+    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::insert_unique(E &&element) {
         ensure_capacity();
         size_type i = hash(m_get_key(element));
+        WLIB_CONTAINER_STAT(size_type probes = 1);
         while (m_buckets[i] && !m_key_equals(m_get_key(element), m_get_key(*m_buckets[i]))) {
+            WLIB_CONTAINER_STAT(++probes);
             if (++i >= m_capacity) {
                 i = 0;
             }
         }
+        WLIB_CONTAINER_STAT(m_stats.record_lookup(probes));
         if (m_buckets[i]) {
             return pair<iterator, bool>(iterator(m_buckets[i], this), false);
         } else {
             ++m_num_elements;
-            element_type *node = create<element_type>();
+            element_type *node = alloc_create<element_type>(get_alloc());
             *node = forward<E>(element);
             m_buckets[i] = node;
             return pair<iterator, bool>(iterator(node, this), true);
@@ -609,8 +645,8 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    void open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    void open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::erase(const iterator &pos) {
         const element_type *cur_node = pos.m_node;
         if (!cur_node) {
@@ -626,9 +662,9 @@ namespace wlp {
             return;
         }
         --m_num_elements;
-        destroy<element_type>(m_buckets[i]);
+        alloc_destroy(get_alloc(), m_buckets[i]);
         m_buckets[i] = nullptr;
-        element_type **new_buckets = create<element_type *[]>(m_capacity);
+        element_type **new_buckets = alloc_create_array<element_type *>(get_alloc(), m_capacity);
         for (size_type k = 0; k < m_capacity; k++) {
             new_buckets[k] = nullptr;
         }
@@ -645,15 +681,16 @@ namespace wlp {
             }
             new_buckets[j] = node;
         }
-        destroy<element_type *[]>(m_buckets);
+        WLIB_CONTAINER_STAT(m_stats.record_growth(m_capacity * sizeof(element_type *)));
+        alloc_destroy_array(get_alloc(), m_buckets, m_capacity);
         m_buckets = new_buckets;
     }
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    typename open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::size_type
-    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    typename open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::size_type
+    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::erase(const key_type &key) {
         size_type i = hash(key);
         while (m_buckets[i] && !m_key_equals(key, m_get_key(*m_buckets[i]))) {
@@ -665,9 +702,9 @@ namespace wlp {
             return 0;
         }
         --m_num_elements;
-        destroy<element_type>(m_buckets[i]);
+        alloc_destroy(get_alloc(), m_buckets[i]);
         m_buckets[i] = nullptr;
-        element_type **new_buckets = create<element_type *[]>(m_capacity);
+        element_type **new_buckets = alloc_create_array<element_type *>(get_alloc(), m_capacity);
         for (size_type k = 0; k < m_capacity; k++) {
             new_buckets[k] = nullptr;
         }
@@ -684,23 +721,27 @@ namespace wlp {
             }
             new_buckets[j] = node;
         }
-        destroy<element_type *[]>(m_buckets);
+        WLIB_CONTAINER_STAT(m_stats.record_growth(m_capacity * sizeof(element_type *)));
+        alloc_destroy_array(get_alloc(), m_buckets, m_capacity);
         m_buckets = new_buckets;
         return 1;
     }
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    inline typename open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::iterator
-    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    inline typename open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::iterator
+    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::find(const key_type &key) {
         size_type i = hash(key);
+        WLIB_CONTAINER_STAT(size_type probes = 1);
         while (m_buckets[i] && !m_key_equals(key, m_get_key(*m_buckets[i]))) {
+            WLIB_CONTAINER_STAT(++probes);
             if (++i >= m_capacity) {
                 i = 0;
             }
         }
+        WLIB_CONTAINER_STAT(m_stats.record_lookup(probes));
         if (m_buckets[i]) {
             return iterator(m_buckets[i], this);
         } else {
@@ -710,16 +751,19 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    inline typename open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>::const_iterator
-    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    inline typename open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>::const_iterator
+    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::find(const key_type &key) const {
         size_type i = hash(key);
+        WLIB_CONTAINER_STAT(size_type probes = 1);
         while (m_buckets[i] && !m_key_equals(key, m_get_key(*m_buckets[i]))) {
+            WLIB_CONTAINER_STAT(++probes);
             if (++i >= m_capacity) {
                 i = 0;
             }
         }
+        WLIB_CONTAINER_STAT(m_stats.record_lookup(probes));
         if (m_buckets[i]) {
             return const_iterator(m_buckets[i], this);
         } else {
@@ -729,30 +773,31 @@ namespace wlp {
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
     ::~open_table() {
         if (!m_buckets) {
             return;
         }
         for (size_type i = 0; i < m_capacity; ++i) {
             if (m_buckets[i]) {
-                destroy<element_type>(m_buckets[i]);
+                alloc_destroy(get_alloc(), m_buckets[i]);
                 m_buckets[i] = nullptr;
             }
         }
-        destroy<element_type *[]>(m_buckets);
+        alloc_destroy_array(get_alloc(), m_buckets, m_capacity);
         m_buckets = nullptr;
     }
 
     template<typename Element, typename Key, typename Val,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals> &
-    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals>
-    ::operator=(open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals> &&map) {
+            typename Hasher, typename Equals, typename Alloc>
+    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc> &
+    open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc>
+    ::operator=(open_table<Element, Key, Val, GetKey, GetVal, Hasher, Equals, Alloc> &&map) {
         clear();
-        destroy<element_type *[]>(m_buckets);
+        alloc_destroy_array(get_alloc(), m_buckets, m_capacity);
+        get_alloc() = map.get_alloc();
         m_capacity = move(map.m_capacity);
         m_max_load = move(map.m_max_load);
         m_num_elements = move(map.m_num_elements);
@@ -766,9 +811,9 @@ namespace wlp {
     template<typename Element, typename Key, typename Val,
             typename Ref, typename Ptr,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    OpenHashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals> &
-    OpenHashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals>
+            typename Hasher, typename Equals, typename Alloc>
+    OpenHashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals, Alloc> &
+    OpenHashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals, Alloc>
     ::operator++() {
         if (!m_node) {
             return *this;
@@ -791,9 +836,9 @@ namespace wlp {
     template<typename Element, typename Key, typename Val,
             typename Ref, typename Ptr,
             typename GetKey, typename GetVal,
-            typename Hasher, typename Equals>
-    inline OpenHashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals>
-    OpenHashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals>::operator++(int) {
+            typename Hasher, typename Equals, typename Alloc>
+    inline OpenHashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals, Alloc>
+    OpenHashTableIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Hasher, Equals, Alloc>::operator++(int) {
         self_type tmp = *this;
         ++*this;
         return tmp;
@@ -0,0 +1,594 @@
+/**
+ * @file ParallelAlgorithm.h
+ * @brief Parallel algorithms over random access ranges.
+ *
+ * Each algorithm splits its range in halves until the pieces are no
+ * larger than a grain size and hands the halves to an executor, which
+ * may run them on different threads. An executor is a type with
+ * @code size() @endcode, its number of threads, and
+ * @code parallel_invoke(f, g) @endcode, which runs both callables and
+ * returns when both have finished; @code thread_pool @endcode is one,
+ * and @code serial_executor @endcode runs everything on the calling
+ * thread. A grain size of zero picks one from the range length and the
+ * number of threads.
+ *
+ * Defining @code WLIB_SINGLE_THREADED @endcode leaves out the thread
+ * pool, and @code parallel_executor @endcode is then the serial one.
+ *
+ * Callables may run concurrently on different elements, so they must
+ * not share state without synchronization, and the operations of
+ * reductions and scans must be associative.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_PARALLELALGORITHM_H
+#define EMBEDDEDCPLUSPLUS_PARALLELALGORITHM_H
+
+#include <stddef.h>
+
+#include <wlib/type_traits>
+#include <wlib/utility>
+#include <wlib/stl/Comparator.h>
+#include <wlib/stl/Concept.h>
+#include <wlib/stl/Helper.h>
+
+#ifndef WLIB_SINGLE_THREADED
+#include <wlib/stl/ThreadPool.h>
+#endif
+
+namespace wlp {
+
+    /**
+     * Executor running every task on the calling thread.
+     */
+    struct serial_executor {
+        explicit serial_executor(size_t = 0) {}
+
+        size_t size() const {
+            return 1;
+        }
+
+        template<typename F, typename G>
+        void parallel_invoke(F &&f, G &&g) {
+            f();
+            g();
+        }
+    };
+
+#ifdef WLIB_SINGLE_THREADED
+    typedef serial_executor parallel_executor;
+#else
+    typedef thread_pool parallel_executor;
+#endif
+
+    namespace __parallel {
+
+        /**
+         * Ranges split no finer than this by default.
+         */
+        static constexpr size_t min_grain = 256;
+
+        /**
+         * Ranges of the sort no larger than this are sorted by
+         * insertion.
+         */
+        static constexpr size_t insertion_limit = 16;
+
+        inline size_t grain_of(size_t grain, size_t n, size_t threads) {
+            if (grain > 0) {
+                return grain;
+            }
+            grain = n / (8 * (threads > 0 ? threads : 1));
+            return grain > min_grain ? grain : min_grain;
+        }
+
+        template<typename It>
+        auto at(It first, size_t i) -> decltype(*first) {
+            return *(first + static_cast<typename It::size_type>(i));
+        }
+
+        /**
+         * Run an algorithm through an executor.
+         */
+        template<typename Executor, typename Fn>
+        void run(Executor &, Fn &fn) {
+            fn();
+        }
+
+#ifndef WLIB_SINGLE_THREADED
+        /**
+         * Move the algorithm into the pool unless already inside it, so
+         * that the calling thread does not block a worker's steals.
+         */
+        template<typename Fn>
+        void run(thread_pool &pool, Fn &fn) {
+            if (thread_pool::current() == &pool || pool.size() == 0) {
+                fn();
+            } else {
+                pool.submit([&fn]() { fn(); }).wait();
+            }
+        }
+#endif
+
+        /**
+         * Call @code body(lo, hi) @endcode on pieces of
+         * @code [lo, hi) @endcode no larger than the grain.
+         */
+        template<typename Executor, typename Body>
+        void for_range(Executor &ex, size_t lo, size_t hi, size_t grain, Body &body) {
+            if (hi - lo <= grain) {
+                body(lo, hi);
+                return;
+            }
+            size_t mid = lo + (hi - lo) / 2;
+            ex.parallel_invoke([&]() { for_range(ex, lo, mid, grain, body); },
+                               [&]() { for_range(ex, mid, hi, grain, body); });
+        }
+
+        /**
+         * Combine the results of @code leaf(lo, hi) @endcode over
+         * pieces of a non-empty range, from left to right.
+         */
+        template<typename T, typename Executor, typename Leaf, typename Op>
+        T reduce_range(Executor &ex, size_t lo, size_t hi, size_t grain, Leaf &leaf, Op &op) {
+            if (hi - lo <= grain) {
+                return leaf(lo, hi);
+            }
+            size_t mid = lo + (hi - lo) / 2;
+            T left;
+            T right;
+            ex.parallel_invoke([&]() { left = reduce_range<T>(ex, lo, mid, grain, leaf, op); },
+                               [&]() { right = reduce_range<T>(ex, mid, hi, grain, leaf, op); });
+            return op(move(left), move(right));
+        }
+
+        template<typename It, typename Cmp>
+        void insertion_sort(It first, size_t lo, size_t hi, Cmp &cmp) {
+            typedef typename It::val_type val_type;
+            for (size_t i = lo + 1; i < hi; ++i) {
+                val_type value(move(at(first, i)));
+                size_t j = i;
+                for (; j > lo && cmp.__lt__(value, at(first, j - 1)); --j) {
+                    at(first, j) = move(at(first, j - 1));
+                }
+                at(first, j) = move(value);
+            }
+        }
+
+        template<typename It, typename Cmp>
+        void sift_down(It first, size_t lo, size_t root, size_t n, Cmp &cmp) {
+            for (size_t child = 2 * root + 1; child < n; child = 2 * root + 1) {
+                if (child + 1 < n && cmp.__lt__(at(first, lo + child), at(first, lo + child + 1))) {
+                    ++child;
+                }
+                if (!cmp.__lt__(at(first, lo + root), at(first, lo + child))) {
+                    return;
+                }
+                swap(at(first, lo + root), at(first, lo + child));
+                root = child;
+            }
+        }
+
+        template<typename It, typename Cmp>
+        void heap_sort(It first, size_t lo, size_t hi, Cmp &cmp) {
+            size_t n = hi - lo;
+            for (size_t root = n / 2; root > 0; --root) {
+                sift_down(first, lo, root - 1, n, cmp);
+            }
+            for (size_t end = n; end > 1; --end) {
+                swap(at(first, lo), at(first, lo + end - 1));
+                sift_down(first, lo, 0, end - 1, cmp);
+            }
+        }
+
+        /**
+         * Swap the median of three elements into the first position.
+         */
+        template<typename It, typename Cmp>
+        void move_median_to_first(It first, size_t result, size_t a, size_t b, size_t c, Cmp &cmp) {
+            size_t median;
+            if (cmp.__lt__(at(first, a), at(first, b))) {
+                median = cmp.__lt__(at(first, b), at(first, c)) ? b
+                         : cmp.__lt__(at(first, a), at(first, c)) ? c : a;
+            } else {
+                median = cmp.__lt__(at(first, a), at(first, c)) ? a
+                         : cmp.__lt__(at(first, b), at(first, c)) ? c : b;
+            }
+            swap(at(first, result), at(first, median));
+        }
+
+        /**
+         * Partition @code [lo + 1, hi) @endcode around the pivot at
+         * @code lo @endcode, which the scans cannot run past.
+         *
+         * @return the first index of the upper part
+         */
+        template<typename It, typename Cmp>
+        size_t partition_pivot(It first, size_t lo, size_t hi, Cmp &cmp) {
+            size_t l = lo + 1;
+            size_t r = hi;
+            for (;;) {
+                while (cmp.__lt__(at(first, l), at(first, lo))) {
+                    ++l;
+                }
+                --r;
+                while (cmp.__lt__(at(first, lo), at(first, r))) {
+                    --r;
+                }
+                if (l >= r) {
+                    return l;
+                }
+                swap(at(first, l), at(first, r));
+                ++l;
+            }
+        }
+
+        /**
+         * Quicksort with a median of three pivot, sorting both parts in
+         * parallel above the grain and falling back to heap sort when
+         * the recursion gets too deep.
+         */
+        template<typename Executor, typename It, typename Cmp>
+        void sort_range(Executor &ex, It first, size_t lo, size_t hi, size_t grain, size_t depth, Cmp &cmp) {
+            while (hi - lo > insertion_limit) {
+                if (depth == 0) {
+                    heap_sort(first, lo, hi, cmp);
+                    return;
+                }
+                --depth;
+                move_median_to_first(first, lo, lo + 1, lo + (hi - lo) / 2, hi - 1, cmp);
+                size_t cut = partition_pivot(first, lo, hi, cmp);
+                if (hi - lo > grain) {
+                    ex.parallel_invoke([&]() { sort_range(ex, first, lo, cut, grain, depth, cmp); },
+                                       [&]() { sort_range(ex, first, cut, hi, grain, depth, cmp); });
+                    return;
+                }
+                sort_range(ex, first, cut, hi, grain, depth, cmp);
+                hi = cut;
+            }
+            insertion_sort(first, lo, hi, cmp);
+        }
+
+        /**
+         * Partition the halves in parallel, then swap the false elements
+         * of the left half with the true elements of the right.
+         *
+         * @return the index of the first false element
+         */
+        template<typename Executor, typename It, typename Pred>
+        size_t partition_range(Executor &ex, It first, size_t lo, size_t hi, size_t grain, Pred &pred) {
+            if (hi - lo <= grain) {
+                size_t cut = lo;
+                for (size_t i = lo; i < hi; ++i) {
+                    if (pred(at(first, i))) {
+                        if (i != cut) {
+                            swap(at(first, i), at(first, cut));
+                        }
+                        ++cut;
+                    }
+                }
+                return cut;
+            }
+            size_t mid = lo + (hi - lo) / 2;
+            size_t left_cut;
+            size_t right_cut;
+            ex.parallel_invoke([&]() { left_cut = partition_range(ex, first, lo, mid, grain, pred); },
+                               [&]() { right_cut = partition_range(ex, first, mid, hi, grain, pred); });
+            size_t left_false = mid - left_cut;
+            size_t right_true = right_cut - mid;
+            size_t n = left_false < right_true ? left_false : right_true;
+            size_t from = right_cut - n;
+            auto body = [first, left_cut, from](size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    swap(at(first, left_cut + i), at(first, from + i));
+                }
+            };
+            for_range(ex, 0, n, grain, body);
+            return left_cut + right_true;
+        }
+
+    }
+
+    /**
+     * Call a function on every element.
+     *
+     * @param ex    the executor
+     * @param first iterator to the first element
+     * @param last  iterator past the last element
+     * @param fn    function taking a reference to an element
+     * @param grain the most elements handled by one task, or zero
+     */
+    template<
+            typename Executor,
+            typename RandomAccessIterator,
+            typename Fn,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type
+    >
+    void parallel_for_each(
+            Executor &ex,
+            RandomAccessIterator first,
+            RandomAccessIterator last,
+            Fn fn,
+            size_t grain = 0
+    ) {
+        size_t n = static_cast<size_t>(last - first);
+        grain = __parallel::grain_of(grain, n, ex.size());
+        auto body = [first, &fn](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                fn(__parallel::at(first, i));
+            }
+        };
+        auto algorithm = [&]() { __parallel::for_range(ex, 0, n, grain, body); };
+        __parallel::run(ex, algorithm);
+    }
+
+    /**
+     * Write the result of an operation on every element to an output
+     * range, which may be the input range.
+     *
+     * @param out iterator to the first element of the output range,
+     *            which must be as long as the input
+     * @param op  operation taking an element
+     * @return an iterator past the last element written
+     */
+    template<
+            typename Executor,
+            typename RandomAccessIterator,
+            typename OutputIterator,
+            typename Op,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>() &&
+                    is_random_access_iterator<OutputIterator>()
+            >::type
+    >
+    OutputIterator parallel_transform(
+            Executor &ex,
+            RandomAccessIterator first,
+            RandomAccessIterator last,
+            OutputIterator out,
+            Op op,
+            size_t grain = 0
+    ) {
+        size_t n = static_cast<size_t>(last - first);
+        grain = __parallel::grain_of(grain, n, ex.size());
+        auto body = [first, out, &op](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                __parallel::at(out, i) = op(__parallel::at(first, i));
+            }
+        };
+        auto algorithm = [&]() { __parallel::for_range(ex, 0, n, grain, body); };
+        __parallel::run(ex, algorithm);
+        return out + static_cast<typename OutputIterator::size_type>(n);
+    }
+
+    /**
+     * Combine an initial value with the result of an operation on every
+     * element by an associative operation. Results are grouped in an
+     * unspecified way but kept in order, so the operation need not be
+     * commutative.
+     *
+     * @tparam T the result type, which must be default constructible
+     * @param init      the initial value, combined once on the left
+     * @param reduce    operation taking two values of the result type
+     * @param transform operation taking an element
+     * @return the combined value
+     */
+    template<
+            typename Executor,
+            typename RandomAccessIterator,
+            typename T,
+            typename ReduceOp,
+            typename TransformOp,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type
+    >
+    T parallel_transform_reduce(
+            Executor &ex,
+            RandomAccessIterator first,
+            RandomAccessIterator last,
+            T init,
+            ReduceOp reduce,
+            TransformOp transform,
+            size_t grain = 0
+    ) {
+        size_t n = static_cast<size_t>(last - first);
+        if (n == 0) {
+            return init;
+        }
+        grain = __parallel::grain_of(grain, n, ex.size());
+        auto leaf = [first, &reduce, &transform](size_t lo, size_t hi) -> T {
+            T acc(transform(__parallel::at(first, lo)));
+            for (size_t i = lo + 1; i < hi; ++i) {
+                acc = reduce(move(acc), transform(__parallel::at(first, i)));
+            }
+            return acc;
+        };
+        T result;
+        auto algorithm = [&]() { result = __parallel::reduce_range<T>(ex, 0, n, grain, leaf, reduce); };
+        __parallel::run(ex, algorithm);
+        return reduce(move(init), move(result));
+    }
+
+    /**
+     * Combine an initial value with every element by an associative
+     * operation, as @code parallel_transform_reduce @endcode.
+     *
+     * @param op operation taking two values of the result type
+     */
+    template<
+            typename Executor,
+            typename RandomAccessIterator,
+            typename T,
+            typename Op,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type
+    >
+    T parallel_reduce(
+            Executor &ex,
+            RandomAccessIterator first,
+            RandomAccessIterator last,
+            T init,
+            Op op,
+            size_t grain = 0
+    ) {
+        typedef typename RandomAccessIterator::val_type val_type;
+        auto identity = [](const val_type &v) -> const val_type & { return v; };
+        return parallel_transform_reduce(ex, first, last, move(init), op, identity, grain);
+    }
+
+    /**
+     * Write the running combinations of the elements, each including
+     * the element at its position, to an output range, which may be
+     * the input range. The elements are read and written twice.
+     *
+     * @param out iterator to the first element of the output range
+     * @param op  associative operation taking two elements
+     * @return an iterator past the last element written
+     */
+    template<
+            typename Executor,
+            typename RandomAccessIterator,
+            typename OutputIterator,
+            typename Op,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>() &&
+                    is_random_access_iterator<OutputIterator>()
+            >::type
+    >
+    OutputIterator parallel_inclusive_scan(
+            Executor &ex,
+            RandomAccessIterator first,
+            RandomAccessIterator last,
+            OutputIterator out,
+            Op op,
+            size_t grain = 0
+    ) {
+        size_t n = static_cast<size_t>(last - first);
+        OutputIterator end = out + static_cast<typename OutputIterator::size_type>(n);
+        if (n == 0) {
+            return end;
+        }
+        grain = __parallel::grain_of(grain, n, ex.size());
+        size_t chunks = (n + grain - 1) / grain;
+        // scan each chunk on its own
+        auto local = [first, out, n, grain, &op](size_t lo, size_t hi) {
+            for (size_t c = lo; c < hi; ++c) {
+                size_t b = c * grain;
+                size_t e = b + grain < n ? b + grain : n;
+                __parallel::at(out, b) = __parallel::at(first, b);
+                for (size_t i = b + 1; i < e; ++i) {
+                    __parallel::at(out, i) = op(__parallel::at(out, i - 1), __parallel::at(first, i));
+                }
+            }
+        };
+        // add the total of the chunks before to all but the last element
+        // of each chunk, whose totals are already complete
+        auto carry = [out, n, grain, &op](size_t lo, size_t hi) {
+            for (size_t c = lo > 0 ? lo : 1; c < hi; ++c) {
+                size_t b = c * grain;
+                size_t e = b + grain < n ? b + grain : n;
+                for (size_t i = b; i + 1 < e; ++i) {
+                    __parallel::at(out, i) = op(__parallel::at(out, b - 1), __parallel::at(out, i));
+                }
+            }
+        };
+        auto algorithm = [&]() {
+            __parallel::for_range(ex, 0, chunks, 1, local);
+            for (size_t c = 1; c < chunks; ++c) {
+                size_t last_of = (c + 1) * grain < n ? (c + 1) * grain - 1 : n - 1;
+                __parallel::at(out, last_of) = op(__parallel::at(out, c * grain - 1), __parallel::at(out, last_of));
+            }
+            __parallel::for_range(ex, 0, chunks, 1, carry);
+        };
+        __parallel::run(ex, algorithm);
+        return end;
+    }
+
+    /**
+     * Sort the elements, not keeping the order of equal elements.
+     *
+     * @param cmp   comparator whose @code __lt__ @endcode orders elements
+     * @param grain the largest range sorted by one task, or zero
+     */
+    template<
+            typename Executor,
+            typename RandomAccessIterator,
+            typename Cmp,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>() &&
+                    is_comparator<Cmp, typename RandomAccessIterator::val_type>()
+            >::type
+    >
+    void parallel_sort(
+            Executor &ex,
+            RandomAccessIterator first,
+            RandomAccessIterator last,
+            Cmp cmp,
+            size_t grain = 0
+    ) {
+        size_t n = static_cast<size_t>(last - first);
+        grain = __parallel::grain_of(grain, n, ex.size());
+        size_t depth = 0;
+        for (size_t m = n; m > 1; m >>= 1) {
+            depth += 2;
+        }
+        auto algorithm = [&]() { __parallel::sort_range(ex, first, 0, n, grain, depth, cmp); };
+        __parallel::run(ex, algorithm);
+    }
+
+    /**
+     * Sort the elements from smallest to largest.
+     */
+    template<
+            typename Executor,
+            typename RandomAccessIterator,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type
+    >
+    void parallel_sort(
+            Executor &ex,
+            RandomAccessIterator first,
+            RandomAccessIterator last
+    ) {
+        parallel_sort(ex, first, last, comparator<typename RandomAccessIterator::val_type>());
+    }
+
+    /**
+     * Move the elements satisfying a predicate before those that do
+     * not, not keeping their order.
+     *
+     * @param pred predicate taking an element
+     * @return an iterator to the first element not satisfying it
+     */
+    template<
+            typename Executor,
+            typename RandomAccessIterator,
+            typename Pred,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type
+    >
+    RandomAccessIterator parallel_partition(
+            Executor &ex,
+            RandomAccessIterator first,
+            RandomAccessIterator last,
+            Pred pred,
+            size_t grain = 0
+    ) {
+        size_t n = static_cast<size_t>(last - first);
+        grain = __parallel::grain_of(grain, n, ex.size());
+        size_t cut = 0;
+        auto algorithm = [&]() { cut = __parallel::partition_range(ex, first, 0, n, grain, pred); };
+        __parallel::run(ex, algorithm);
+        return first + static_cast<typename RandomAccessIterator::size_type>(cut);
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_PARALLELALGORITHM_H
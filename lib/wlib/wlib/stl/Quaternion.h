@@ -0,0 +1,243 @@
+/**
+ * @file Quaternion.h
+ * @brief Quaternion for representing rotations.
+ *
+ * Components are stored as (x, y, z, w) in a vector4d so that the
+ * Hamilton product and the norm use the four-lane primitives of
+ * vector4d. Constructors take the scalar part first.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_QUATERNION_H
+#define EMBEDDEDCPLUSPLUS_QUATERNION_H
+
+#include <math.h>
+
+#include <wlib/type_traits>
+#include <wlib/stl/InitializerList.h>
+#include <wlib/stl/Mat3.h>
+#include <wlib/stl/Mat4.h>
+#include <wlib/stl/Vector4D.h>
+
+namespace wlp {
+
+    template<typename val_t>
+    class quaternion {
+        typedef __vec4_ops<val_t> ops;
+
+    public:
+        /**
+         * Create the identity rotation.
+         */
+        constexpr quaternion() :
+            m_q(0, 0, 0, 1) {}
+
+        constexpr quaternion(val_t w, val_t x, val_t y, val_t z) :
+            m_q(x, y, z, w) {}
+
+        /**
+         * Create a quaternion from a scalar part and a vector part.
+         */
+        constexpr quaternion(val_t w, const vector3d<val_t> &v) :
+            m_q(v, w) {}
+
+        /**
+         * Create a quaternion from four elements ordered (w, x, y, z).
+         */
+        quaternion(wlp::initializer_list<val_t> l) :
+            m_q(l.begin()[1], l.begin()[2], l.begin()[3], l.begin()[0]) {}
+
+        /**
+         * Create the rotation by @code angle @endcode radians about
+         * @code axis @endcode, which must have unit length.
+         */
+        static quaternion<val_t> from_axis_angle(const vector3d<val_t> &axis, val_t angle) {
+            val_t half = angle / 2;
+            return quaternion<val_t>(static_cast<val_t>(cos(half)), axis * static_cast<val_t>(sin(half)));
+        }
+
+        val_t &w() {
+            return m_q.w();
+        }
+
+        val_t &x() {
+            return m_q.x();
+        }
+
+        val_t &y() {
+            return m_q.y();
+        }
+
+        val_t &z() {
+            return m_q.z();
+        }
+
+        constexpr const val_t &w() const {
+            return m_q.w();
+        }
+
+        constexpr const val_t &x() const {
+            return m_q.x();
+        }
+
+        constexpr const val_t &y() const {
+            return m_q.y();
+        }
+
+        constexpr const val_t &z() const {
+            return m_q.z();
+        }
+
+        /**
+         * @return the vector part
+         */
+        constexpr vector3d<val_t> vec() const {
+            return m_q.xyz();
+        }
+
+        val_t norm() const {
+            return m_q.norm();
+        }
+
+        val_t norm_sq() const {
+            return m_q.norm_sq();
+        }
+
+        quaternion<val_t> n() const {
+            return *this / norm();
+        }
+
+        val_t dot(const quaternion<val_t> &o) const {
+            return m_q.dot(o.m_q);
+        }
+
+        constexpr quaternion<val_t> conjugate() const {
+            return quaternion<val_t>(w(), -x(), -y(), -z());
+        }
+
+        quaternion<val_t> inverse() const {
+            return conjugate() / norm_sq();
+        }
+
+        quaternion<val_t> operator+(const quaternion<val_t> &o) const {
+            return quaternion<val_t>(m_q + o.m_q);
+        }
+
+        quaternion<val_t> operator-(const quaternion<val_t> &o) const {
+            return quaternion<val_t>(m_q - o.m_q);
+        }
+
+        /**
+         * Hamilton product. The rotation of the result applies
+         * @code o @endcode first and then this rotation.
+         */
+        quaternion<val_t> operator*(const quaternion<val_t> &o) const {
+            quaternion<val_t> r;
+            ops::qmul(m_q.data(), o.m_q.data(), r.m_q.data());
+            return r;
+        }
+
+        quaternion<val_t> &operator*=(const quaternion<val_t> &o) {
+            ops::qmul(m_q.data(), o.m_q.data(), m_q.data());
+            return *this;
+        }
+
+        template<
+            typename scalar_t,
+            typename = typename enable_if<
+                is_arithmetic<scalar_t>::value
+            >::type
+        >
+        quaternion<val_t> operator*(scalar_t b) const {
+            return quaternion<val_t>(m_q * b);
+        }
+
+        template<
+            typename scalar_t,
+            typename = typename enable_if<
+                is_arithmetic<scalar_t>::value
+            >::type
+        >
+        quaternion<val_t> operator/(scalar_t b) const {
+            return quaternion<val_t>(m_q / b);
+        }
+
+        bool operator==(const quaternion<val_t> &o) const {
+            return m_q == o.m_q;
+        }
+
+        bool operator!=(const quaternion<val_t> &o) const {
+            return m_q != o.m_q;
+        }
+
+        /**
+         * Rotate a vector by this quaternion, which must have unit
+         * length.
+         */
+        vector3d<val_t> rotate(const vector3d<val_t> &v) const {
+            vector3d<val_t> u = vec();
+            vector3d<val_t> t = u.cross(v) * static_cast<val_t>(2);
+            return v + t * w() + u.cross(t);
+        }
+
+        /**
+         * @return the rotation matrix of this quaternion, which
+         * must have unit length
+         */
+        mat3<val_t> to_mat3() const {
+            val_t xx = x() * x(), yy = y() * y(), zz = z() * z();
+            val_t xy = x() * y(), xz = x() * z(), yz = y() * z();
+            val_t wx = w() * x(), wy = w() * y(), wz = w() * z();
+            return mat3<val_t>(
+                1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy),
+                2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx),
+                2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy));
+        }
+
+        /**
+         * @return the rotation matrix of this quaternion, combined
+         * with the translation @code t @endcode
+         */
+        mat4<val_t> to_mat4(const vector3d<val_t> &t = vector3d<val_t>()) const {
+            return mat4<val_t>(to_mat3(), t);
+        }
+
+    private:
+        explicit quaternion(const vector4d<val_t> &q) :
+            m_q(q) {}
+
+        vector4d<val_t> m_q;
+    };
+
+    /**
+     * Spherical linear interpolation between two unit quaternions
+     * along the shorter arc. Nearly parallel inputs fall back to a
+     * normalized linear interpolation.
+     *
+     * @param a rotation at @code t = 0 @endcode
+     * @param b rotation at @code t = 1 @endcode
+     * @param t interpolation parameter
+     * @return the interpolated rotation
+     */
+    template<typename val_t>
+    quaternion<val_t> slerp(const quaternion<val_t> &a, const quaternion<val_t> &b, val_t t) {
+        quaternion<val_t> end = b;
+        val_t d = a.dot(b);
+        if (d < 0) {
+            end = b * -1;
+            d = -d;
+        }
+        if (d > static_cast<val_t>(0.9995)) {
+            return (a + (end - a) * t).n();
+        }
+        val_t theta = static_cast<val_t>(acos(d));
+        val_t s = static_cast<val_t>(sin(theta));
+        val_t wa = static_cast<val_t>(sin((1 - t) * theta)) / s;
+        val_t wb = static_cast<val_t>(sin(t * theta)) / s;
+        return a * wa + end * wb;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_QUATERNION_H
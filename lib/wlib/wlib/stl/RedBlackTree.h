@@ -13,7 +13,9 @@
 #ifndef EMBEDDEDCPLUSPLUS_REDBLACKTREE_H
 #define EMBEDDEDCPLUSPLUS_REDBLACKTREE_H
 
+#include <wlib/stl/Allocator.h>
 #include <wlib/stl/Comparator.h>
+#include <wlib/stl/ContainerStats.h>
 #include <wlib/stl/Pair.h>
 #include <wlib/memory>
 
@@ -344,25 +346,28 @@ namespace wlp {
      * @tparam Cmp     key comparator type, which uses the default comparator
      * @tparam GetKey  functor type used to get element key
      * @tparam GetVal  functor type used to get element value
+     * @tparam Alloc   allocator of the tree nodes
      */
     template<typename Element,
             typename Key,
             typename Val,
             typename GetKey,
             typename GetVal,
-            typename Cmp = wlp::comparator<Key>>
-    class tree {
+            typename Cmp = wlp::comparator<Key>,
+            typename Alloc = allocator>
+    class tree : private Alloc {
     public:
         typedef Key key_type;
         typedef Val val_type;
         typedef Cmp comparator;
         typedef size_t size_type;
         typedef RedBlackTreeNode<Element> node_type;
-        typedef tree<Element, Key, Val, GetKey, GetVal, Cmp> tree_type;
+        typedef tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc> tree_type;
         typedef RedBlackTreeIterator<Element, Key, Val, Val &, Val *, GetKey, GetVal> iterator;
         typedef RedBlackTreeIterator<Element, Key, Val, const Val &, const Val *, GetKey, GetVal> const_iterator;
         typedef GetKey get_key;
         typedef GetVal get_val;
+        typedef Alloc allocator_type;
 
     protected:
         typedef RedBlackTreeColor color;
@@ -385,13 +390,17 @@ namespace wlp {
          */
         get_key m_get_key{};
 
+#ifdef WLIB_CONTAINER_STATS
+        container_stats m_stats{&container_stats_global(tree_kind)};
+#endif
+
         /**
          * Allocate a new node.
          *
          * @return pointer to the new node
          */
         node_type *create_node() {
-            return create<node_type>();
+            return alloc_create<node_type>(get_alloc());
         }
 
         /**
@@ -415,7 +424,11 @@ namespace wlp {
          * @param node node to deallocate
          */
         void destroy_node(node_type *node) {
-            destroy<node_type>(node);
+            alloc_destroy(get_alloc(), node);
+        }
+
+        Alloc &get_alloc() {
+            return *this;
         }
 
         /**
@@ -498,10 +511,11 @@ namespace wlp {
         /**
          * Create an empty red black tree.
          *
-         * @param n reserved space for nodes
+         * @param alloc allocator of the tree nodes
          */
-        explicit tree()
-                : m_header(nullptr),
+        explicit tree(const Alloc &alloc = Alloc())
+                : Alloc(alloc),
+                  m_header(nullptr),
                   m_size(0) {
             m_header = create_node();
             empty_initialize();
@@ -518,7 +532,8 @@ namespace wlp {
          * @param tree tree to move
          */
         tree(tree_type &&tree)
-                : m_header(move(tree.m_header)),
+                : Alloc(tree.get_allocator()),
+                  m_header(move(tree.m_header)),
                   m_size(move(tree.m_size)) {
             tree.m_header = nullptr;
             tree.m_size = 0;
@@ -534,6 +549,22 @@ namespace wlp {
             }
         }
 
+        /**
+         * @return a copy of the allocator of this tree
+         */
+        allocator_type get_allocator() const {
+            return *this;
+        }
+
+#ifdef WLIB_CONTAINER_STATS
+        /**
+         * @return the operation counters of this tree
+         */
+        const container_stats &stats() const {
+            return m_stats;
+        }
+#endif
+
         /**
          * @return an iterator to the leftmost node in the tree
          */
@@ -774,6 +805,7 @@ namespace wlp {
         tree_type &operator=(tree_type &&tree) {
             clear();
             destroy_node(m_header);
+            get_alloc() = tree.get_alloc();
             m_size = move(tree.m_size);
             m_header = move(tree.m_header);
             tree.m_size = 0;
@@ -784,9 +816,10 @@ namespace wlp {
     };
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::rotateLeft(node_type *node, node_type *&root) {
+        WLIB_CONTAINER_STAT(m_stats.record_rotation());
         node_type *carry = node->m_right;
         node->m_right = carry->m_left;
         if (carry->m_left) {
@@ -805,9 +838,10 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::rotateRight(node_type *node, node_type *&root) {
+        WLIB_CONTAINER_STAT(m_stats.record_rotation());
         node_type *carry = node->m_left;
         node->m_left = carry->m_right;
         if (carry->m_right) {
@@ -826,8 +860,8 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::rebalance(node_type *node, node_type *&root) {
         node->m_color = color::RED;
         while (node != root && node->m_parent->m_color == color::RED) {
@@ -869,9 +903,9 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::node_type *
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::node_type *
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::erase_rebalance(
             node_type *node,
             node_type *&root,
@@ -1031,14 +1065,14 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
     template<typename E>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::insert(node_type *cur, node_type *carry, E &&element) {
         node_type *node = create_node();
         node->m_element = forward<E>(element);
-        if (carry == m_header || cur || m_cmp.__lt__(m_get_key(element), m_get_key(carry->m_element))) {
+        if (carry == m_header || cur || m_cmp.__lt__(m_get_key(node->m_element), m_get_key(carry->m_element))) {
             carry->m_left = node;
             if (carry == m_header) {
                 m_header->m_parent = node;
@@ -1061,10 +1095,10 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
     template<typename E>
-    pair<typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator, bool>
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+    pair<typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::iterator, bool>
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::insert_unique(E &&element) {
         node_type *carry = m_header;
         node_type *cur = m_header->m_parent;
@@ -1089,10 +1123,10 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
     template<typename E>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::insert_equal(E &&element) {
         node_type *carry = m_header;
         node_type *cur = m_header->m_parent;
@@ -1104,8 +1138,8 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::erase(node_type *root) {
         node_type *current;
         node_type *pre;
@@ -1140,8 +1174,8 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::erase(const iterator &pos) {
         node_type *carry = erase_rebalance(pos.m_node, m_header->m_parent, m_header->m_left, m_header->m_right);
         destroy_node(carry);
@@ -1149,18 +1183,18 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::size_type
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::size_type
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::erase(const key_type &cur) {
         pair<iterator, iterator> res = equal_range(cur);
         return erase(res.m_first, res.m_second);
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::size_type
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::size_type
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::erase(const iterator &first, const iterator &last) {
         size_type count;
         if (first == begin() && last == end()) {
@@ -1178,9 +1212,9 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::find(const key_type &key) {
         node_type *carry = m_header;
         node_type *cur = m_header->m_parent;
@@ -1197,9 +1231,9 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::const_iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::const_iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::find(const key_type &key) const {
         node_type *carry = m_header;
         node_type *cur = m_header->m_parent;
@@ -1216,9 +1250,9 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::size_type
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::size_type
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::count(const key_type &key) const {
         pair<const_iterator, const_iterator> res = equal_range(key);
         size_type count = 0;
@@ -1230,9 +1264,9 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::lower_bound(const key_type &key) {
         node_type *carry = m_header;
         node_type *cur = m_header->m_parent;
@@ -1248,9 +1282,9 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::upper_bound(const key_type &key) {
         node_type *carry = m_header;
         node_type *cur = m_header->m_parent;
@@ -1267,9 +1301,9 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::const_iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::const_iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::lower_bound(const key_type &key) const {
         node_type *carry = m_header;
         node_type *cur = m_header->m_parent;
@@ -1285,9 +1319,9 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::const_iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::const_iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::upper_bound(const key_type &key) const {
         node_type *carry = m_header;
         node_type *cur = m_header->m_parent;
@@ -1304,24 +1338,24 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
     inline pair<
-            typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator,
-            typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
+            typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::iterator,
+            typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::iterator
     >
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::equal_range(const key_type &key) {
         return pair<iterator, iterator>(lower_bound(key), upper_bound(key));
     }
 
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
+            typename GetKey, typename GetVal, typename Cmp, typename Alloc>
     inline pair<
-            typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::const_iterator,
-            typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::const_iterator
+            typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::const_iterator,
+            typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>::const_iterator
     >
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Alloc>
     ::equal_range(const key_type &key) const {
         return pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
     }
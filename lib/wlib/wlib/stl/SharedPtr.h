@@ -6,8 +6,11 @@
  * ownership of the same underlying pointer, and which intelligently
  * disposes of the pointer.
  *
- * The implementation is not thread-safe, and is assuming single-threaded
- * use on Arduino.
+ * The reference counts are modified through a count policy, see
+ * CountPolicy.h. The default policy is not thread-safe and assumes
+ * single-threaded use on Arduino; builds that share pointers across
+ * threads select @code atomic_count @endcode either per pointer type
+ * or with @code WLIB_SHARED_PTR_ATOMIC @endcode.
  *
  * @author Jeff Niu
  * @date November 24, 2017
@@ -17,23 +20,22 @@
 #ifndef EMBEDDEDCPLUSPLUS_SHAREDPTR_H
 #define EMBEDDEDCPLUSPLUS_SHAREDPTR_H
 
+#include <wlib/stl/Allocator.h>
+#include <wlib/stl/CountPolicy.h>
 #include <wlib/stl/UniquePtr.h>
 
 namespace wlp {
 
-    template<typename IntType>
-    static inline IntType exchange_and_add(IntType *mem, IntType val) {
-        IntType res = *mem;
-        *mem = static_cast<IntType>(*mem + val);
-        return res;
+    template<typename Ptr>
+    inline void __reference_dispose(Ptr ptr) {
+        wlp::destroy(ptr);
     }
 
-    template<typename IntType>
-    static inline IntType exchange_and_sub(IntType *mem, IntType val) {
-        IntType res = *mem;
-        *mem = static_cast<IntType>(*mem - val);
-        return res;
-    }
+    /**
+     * Overload for null pointers which avoids freeing
+     * null pointers upon destruction.
+     */
+    inline void __reference_dispose(nullptr_t) {}
 
     /**
      * This class tracks the number of weak references and strong references
@@ -45,21 +47,19 @@ namespace wlp {
      * The class frees the managed pointer when there are no more strong references
      * to the pointer and destroys itself when there are no references at all.
      *
-     * @tparam Ptr
+     * How the pointer is freed and where the count itself lives is up to
+     * the derived class: @code ReferenceCount @endcode manages a separately
+     * allocated pointer, while @code InplaceReferenceCount @endcode holds
+     * the object in the same allocation as the counts.
+     *
+     * @tparam Policy the count policy
      */
-    template<typename Ptr>
-    class ReferenceCount {
+    template<typename Policy = default_count>
+    class ReferenceCountBase {
     public:
-        typedef Ptr pointer;
-        typedef uint16_t ptr_use_count;
+        typedef typename Policy::count_type ptr_use_count;
 
     private:
-        /**
-         * The managed underlying pointer. This class cannot
-         * be used to access the pointe directly; it only
-         * has a copy to manage its deletion.
-         */
-        pointer m_ptr;
         /**
          * The number of shared pointers which claim ownership
          * of the underlying pointer.
@@ -73,53 +73,45 @@ namespace wlp {
 
     public:
         /**
-         * A reference count is created with a copy of the underlying pointer
-         * and with the use count and weak count set to 1. There is always
-         * exactly one shared pointer referring to the pointer when this class
-         * is constructed for the first time. The choice of 1 for weak count
-         * is to avoid underflow.
-         *
-         * @param ptr the underlying pointer
+         * A reference count is created with the use count and weak count
+         * set to 1. There is always exactly one shared pointer referring to
+         * the pointer when this class is constructed for the first time.
+         * The choice of 1 for weak count is to avoid underflow.
          */
-        ReferenceCount(pointer ptr)
-                : m_ptr(ptr),
-                  m_use_count(1),
+        ReferenceCountBase()
+                : m_use_count(1),
                   m_weak_count(1) {}
 
-        ~ReferenceCount() {}
+        virtual ~ReferenceCountBase() {}
 
         /**
          * Free the underlying pointer.
          */
-        void dispose() {
-            wlp::destroy(m_ptr);
-        }
+        virtual void dispose() = 0;
 
         /**
-         * Destroy the reference count instance.
-         * The instance must be dynamically allocated.
+         * Destroy the reference count instance and release
+         * the memory it occupies.
          */
-        void destroy() {
-            wlp::destroy(this);
-        }
+        virtual void destroy() = 0;
 
         /**
          * A shared pointer has been copied through construction
          * or assignment, thus increment the use count.
          */
         void add_copied_reference() {
-            ++m_use_count;
+            Policy::increment(&m_use_count);
         }
 
         /**
          * A weak pointer is locking its reference to the
          * underlying pointer, but if the actual strong reference
          * count is zero, then the underlying pointer has expired.
+         *
+         * @return whether a strong reference was added
          */
-        void add_locked_reference() {
-            if (exchange_and_add<ptr_use_count>(&m_use_count, 1) == 0) {
-                m_use_count = 0;
-            }
+        bool add_locked_reference() {
+            return Policy::increment_if_nonzero(&m_use_count);
         }
 
         /**
@@ -129,9 +121,9 @@ namespace wlp {
          * no more weak references, then this object is also destroyed.
          */
         void release() {
-            if (exchange_and_sub<ptr_use_count>(&m_use_count, 1) == 1) {
+            if (Policy::decrement(&m_use_count) == 1) {
                 dispose();
-                if (exchange_and_sub<ptr_use_count>(&m_weak_count, 1) == 1) {
+                if (Policy::decrement(&m_weak_count) == 1) {
                     destroy();
                 }
             }
@@ -143,7 +135,7 @@ namespace wlp {
          * increment the weak reference count.
          */
         void add_weak_reference() {
-            ++m_weak_count;
+            Policy::increment(&m_weak_count);
         }
 
         /**
@@ -153,7 +145,7 @@ namespace wlp {
          * underlying pointer, then this object is subsequently destroyed.
          */
         void weak_release() {
-            if (exchange_and_sub<ptr_use_count>(&m_weak_count, 1) == 1) {
+            if (Policy::decrement(&m_weak_count) == 1) {
                 destroy();
             }
         }
@@ -162,39 +154,121 @@ namespace wlp {
          * @return the number of active strong references
          */
         ptr_use_count use_count() const {
-            return m_use_count;
+            return Policy::load(&m_use_count);
         }
 
         /**
          * @return the number of active weak references
          */
         ptr_use_count weak_count() const {
-            return m_weak_count;
+            return Policy::load(&m_weak_count);
         }
 
     private:
-        ReferenceCount(const ReferenceCount &) = delete;
+        ReferenceCountBase(const ReferenceCountBase &) = delete;
 
-        ReferenceCount &operator=(const ReferenceCount &) = delete;
+        ReferenceCountBase &operator=(const ReferenceCountBase &) = delete;
     };
 
     /**
-     * Specialization for null pointers which avoid freeing
-     * null pointers upon destruction.
+     * Reference count for a pointer that was allocated on its own,
+     * for instance with @code create @endcode. The reference count
+     * itself is allocated from @code Alloc @endcode.
+     *
+     * @tparam Ptr    the type of the managed pointer
+     * @tparam Policy the count policy
+     * @tparam Alloc  the allocator that provided this reference count
+     */
+    template<typename Ptr, typename Policy = default_count, typename Alloc = allocator>
+    class ReferenceCount : public ReferenceCountBase<Policy>, private Alloc {
+    public:
+        typedef Ptr pointer;
+
+    private:
+        /**
+         * The managed underlying pointer. This class cannot
+         * be used to access the pointe directly; it only
+         * has a copy to manage its deletion.
+         */
+        pointer m_ptr;
+
+    public:
+        /**
+         * @param ptr   the underlying pointer
+         * @param alloc the allocator that provided this reference count
+         */
+        ReferenceCount(pointer ptr, const Alloc &alloc)
+                : Alloc(alloc),
+                  m_ptr(ptr) {}
+
+        void dispose() override {
+            __reference_dispose(m_ptr);
+        }
+
+        /**
+         * The instance must have been created with @code alloc_create @endcode
+         * from a copy of its allocator.
+         */
+        void destroy() override {
+            Alloc alloc(*static_cast<Alloc *>(this));
+            alloc_destroy(alloc, this);
+        }
+    };
+
+    /**
+     * Reference count that holds the managed object in its own storage,
+     * so that the counts and the object share one allocation. The object
+     * is destroyed when the last strong reference is released and the
+     * storage is returned to the allocator when the last weak reference
+     * is released.
+     *
+     * The allocator is a base class so that stateless allocators
+     * take no space.
+     *
+     * @tparam T      the type of the managed object
+     * @tparam Alloc  the allocator that provided the storage
+     * @tparam Policy the count policy
      */
-    template<>
-    inline void ReferenceCount<nullptr_t>::dispose() {}
+    template<typename T, typename Alloc, typename Policy = default_count>
+    class InplaceReferenceCount : public ReferenceCountBase<Policy>, private Alloc {
+    public:
+        template<typename... Args>
+        InplaceReferenceCount(const Alloc &alloc, Args &&... args)
+                : Alloc(alloc) {
+            new (static_cast<void *>(m_storage)) T(forward<Args>(args)...);
+        }
 
-    template<typename T>
+        /**
+         * @return pointer to the managed object
+         */
+        T *get() {
+            return reinterpret_cast<T *>(m_storage);
+        }
+
+        void dispose() override {
+            get()->~T();
+        }
+
+        void destroy() override {
+            Alloc alloc(*static_cast<Alloc *>(this));
+            this->~InplaceReferenceCount();
+            alloc.deallocate(this, sizeof(InplaceReferenceCount), alignof(InplaceReferenceCount));
+        }
+
+    private:
+        alignas(T) unsigned char m_storage[sizeof(T)];
+    };
+
+    template<typename T, typename Policy = default_count>
     class shared_ptr;
 
-    template<typename T>
+    template<typename T, typename Policy = default_count>
     class weak_ptr;
 
-    template<typename Ptr>
+    template<typename Ptr, typename Policy = default_count>
     class SharedCount;
 
-    template<typename Ptr>
+    template<typename Ptr, typename Policy = default_count>
     class WeakCount;
 
     /**
@@ -202,18 +276,19 @@ namespace wlp {
      * object shared among all classes which refer to the same
      * underlying pointer, for shared pointers.
      *
-     * @tparam Ptr the type of the managed pointer
+     * @tparam Ptr    the type of the managed pointer
+     * @tparam Policy the count policy
      */
-    template<typename Ptr>
+    template<typename Ptr, typename Policy>
     class SharedCount {
     public:
         typedef Ptr pointer;
-        typedef typename ReferenceCount<Ptr>::ptr_use_count ptr_use_count;
+        typedef typename ReferenceCountBase<Policy>::ptr_use_count ptr_use_count;
 
     private:
-        friend class WeakCount<Ptr>;
+        friend class WeakCount<Ptr, Policy>;
 
-        ReferenceCount<Ptr> *m_pi;
+        ReferenceCountBase<Policy> *m_pi;
 
     public:
         constexpr SharedCount()
@@ -231,8 +306,27 @@ namespace wlp {
          */
         template<typename PtrType>
         explicit SharedCount(PtrType ptr)
+                : SharedCount(ptr, allocator()) {}
+
+        /**
+         * Constructor that allocates the reference count object from
+         * the given allocator. The managed pointer itself is still
+         * released with @code destroy @endcode. If the allocator fails,
+         * the pointer is released at once and the shared count is
+         * left empty.
+         *
+         * @tparam PtrType the supplied pointer type
+         * @param ptr   the new underlying pointer
+         * @param alloc allocator of the reference count object
+         */
+        template<typename PtrType, typename Alloc>
+        SharedCount(PtrType ptr, const Alloc &alloc)
                 : m_pi(nullptr) {
-            m_pi = create<ReferenceCount<PtrType>>(ptr);
+            Alloc a(alloc);
+            m_pi = alloc_create<ReferenceCount<PtrType, Policy, Alloc>>(a, ptr, alloc);
+            if (!m_pi) {
+                __reference_dispose(ptr);
+            }
         }
 
         /**
@@ -240,17 +334,52 @@ namespace wlp {
          * of the pointer managed from the unique pointer such that the latter
          * no longer controls any pointers.
          *
+         * If the count cannot be allocated, the unique pointer keeps
+         * its pointer and the count is left empty.
+         *
          * @tparam U unique pointer type
-         * @param up the unique pointer to take
+         * @param up    the unique pointer to take
+         * @param alloc the allocator of the count
          */
-        template<typename U>
-        SharedCount(unique_ptr <U> &&up)
+        template<typename U, typename Alloc = allocator>
+        SharedCount(unique_ptr <U> &&up, const Alloc &alloc = Alloc())
                 : m_pi(nullptr) {
-            m_pi = create<ReferenceCount<U *>>(up.get());
-            up.release();
+            Alloc a(alloc);
+            m_pi = alloc_create<ReferenceCount<U *, Policy, Alloc>>(a, up.get(), alloc);
+            if (m_pi) {
+                up.release();
+            }
         }
 
-        explicit SharedCount(const WeakCount<Ptr> &);
+        /**
+         * Lock a weak reference. If the underlying pointer has
+         * expired, the shared count is left empty.
+         */
+        explicit SharedCount(const WeakCount<Ptr, Policy> &);
+
+        /**
+         * Create the managed object together with its reference count in
+         * a single allocation. If the allocator fails, the shared count
+         * is left empty.
+         *
+         * @tparam T     the type of the object
+         * @param alloc  allocator providing the storage
+         * @param args   constructor arguments of the object
+         * @return pointer to the new object, or null
+         */
+        template<typename T, typename Alloc, typename... Args>
+        T *emplace(const Alloc &alloc, Args &&... args) {
+            typedef InplaceReferenceCount<T, Alloc, Policy> block_type;
+            Alloc a(alloc);
+            void *mem = a.allocate(sizeof(block_type), alignof(block_type));
+            if (!mem) {
+                return nullptr;
+            }
+            block_type *block = new (mem) block_type(alloc, forward<Args>(args)...);
+            if (m_pi) { m_pi->release(); }
+            m_pi = block;
+            return block->get();
+        }
 
         /**
          * Upon destruction, the shared pointer managing
@@ -269,7 +398,7 @@ namespace wlp {
          *
          * @param sc shared count to copy
          */
-        SharedCount(const SharedCount<Ptr> &sc)
+        SharedCount(const SharedCount<Ptr, Policy> &sc)
                 : m_pi(sc.m_pi) {
             if (m_pi) { m_pi->add_copied_reference(); }
         }
@@ -284,8 +413,8 @@ namespace wlp {
          * @param sc shared count to copy
          * @return reference to this shared count
          */
-        SharedCount<Ptr> &operator=(const SharedCount<Ptr> &sc) {
-            ReferenceCount<Ptr> *tmp = sc.m_pi;
+        SharedCount<Ptr, Policy> &operator=(const SharedCount<Ptr, Policy> &sc) {
+            ReferenceCountBase<Policy> *tmp = sc.m_pi;
             if (tmp != m_pi) {
                 if (tmp) { tmp->add_copied_reference(); }
                 if (m_pi) { m_pi->release(); }
@@ -294,7 +423,7 @@ namespace wlp {
             return *this;
         }
 
-        void swap(SharedCount<Ptr> &sc) {
+        void swap(SharedCount<Ptr, Policy> &sc) {
             wlp::swap(m_pi, sc.m_pi);
         }
 
@@ -314,12 +443,18 @@ namespace wlp {
             return use_count() == 1;
         }
 
-        bool less(const SharedCount<Ptr> &) const;
+        /**
+         * @return whether this shared count refers to no pointer
+         */
+        bool empty() const {
+            return m_pi == nullptr;
+        }
 
-        bool less(const WeakCount<Ptr> &) const;
+        bool less(const SharedCount<Ptr, Policy> &) const;
 
-        template<typename PtrType>
-        friend inline bool operator==(const SharedCount<PtrType> &sc1, const SharedCount<PtrType> &sc2) {
+        bool less(const WeakCount<Ptr, Policy> &) const;
+
+        friend inline bool operator==(const SharedCount<Ptr, Policy> &sc1, const SharedCount<Ptr, Policy> &sc2) {
             return sc1.m_pi == sc2.m_pi;
         }
 
@@ -330,18 +465,19 @@ namespace wlp {
      * object that all weak references to the underlying pointer
      * contain, for weak pointers.
      *
-     * @tparam Ptr pointer type
+     * @tparam Ptr    pointer type
+     * @tparam Policy the count policy
      */
-    template<typename Ptr>
+    template<typename Ptr, typename Policy>
     class WeakCount {
     public:
         typedef Ptr pointer;
-        typedef typename ReferenceCount<Ptr>::ptr_use_count ptr_use_count;
+        typedef typename ReferenceCountBase<Policy>::ptr_use_count ptr_use_count;
 
     private:
-        friend class SharedCount<Ptr>;
+        friend class SharedCount<Ptr, Policy>;
 
-        ReferenceCount<Ptr> *m_pi;
+        ReferenceCountBase<Policy> *m_pi;
 
     public:
         constexpr WeakCount()
@@ -354,7 +490,7 @@ namespace wlp {
          *
          * @param sc shared count to copy
          */
-        WeakCount(const SharedCount<Ptr> &sc)
+        WeakCount(const SharedCount<Ptr, Policy> &sc)
                 : m_pi(sc.m_pi) {
             if (m_pi) { m_pi->add_weak_reference(); }
         }
@@ -366,7 +502,7 @@ namespace wlp {
          *
          * @param wc weak count to copy
          */
-        WeakCount(const WeakCount<Ptr> &wc)
+        WeakCount(const WeakCount<Ptr, Policy> &wc)
                 : m_pi(wc.m_pi) {
             if (m_pi) { m_pi->add_weak_reference(); }
         }
@@ -390,8 +526,8 @@ namespace wlp {
          * @param sc shared count to copy
          * @return reference to this weak count
          */
-        WeakCount<Ptr> &operator=(const SharedCount<Ptr> &sc) {
-            ReferenceCount<Ptr> *tmp = sc.m_pi;
+        WeakCount<Ptr, Policy> &operator=(const SharedCount<Ptr, Policy> &sc) {
+            ReferenceCountBase<Policy> *tmp = sc.m_pi;
             if (tmp) { tmp->add_weak_reference(); }
             if (m_pi) { m_pi->weak_release(); }
             m_pi = tmp;
@@ -407,73 +543,94 @@ namespace wlp {
          * @param sc shared count to copy
          * @return reference to this weak count
          */
-        WeakCount<Ptr> &operator=(const WeakCount<Ptr> &wc) {
-            ReferenceCount<Ptr> *tmp = wc.m_pi;
+        WeakCount<Ptr, Policy> &operator=(const WeakCount<Ptr, Policy> &wc) {
+            ReferenceCountBase<Policy> *tmp = wc.m_pi;
             if (tmp) { tmp->add_weak_reference(); }
             if (m_pi) { m_pi->weak_release(); }
             m_pi = tmp;
             return *this;
         }
 
-        void swap(WeakCount<Ptr> &wc) {
+        void swap(WeakCount<Ptr, Policy> &wc) {
             wlp::swap(m_pi, wc.m_pi);
         }
 
         ptr_use_count use_count() const {
-            return m_pi->use_count();
+            return m_pi ? m_pi->use_count() : static_cast<ptr_use_count>(0);
         }
 
-        bool less(const SharedCount<Ptr> &) const;
+        bool less(const SharedCount<Ptr, Policy> &) const;
 
-        bool less(const WeakCount<Ptr> &) const;
+        bool less(const WeakCount<Ptr, Policy> &) const;
     };
 
-    template<typename Ptr>
-    inline bool SharedCount<Ptr>::less(const WeakCount<Ptr> &wc) const {
+    template<typename Ptr, typename Policy>
+    inline bool SharedCount<Ptr, Policy>::less(const WeakCount<Ptr, Policy> &wc) const {
         return m_pi < wc.m_pi;
     }
 
-    template<typename Ptr>
-    inline bool SharedCount<Ptr>::less(const SharedCount<Ptr> &sc) const {
+    template<typename Ptr, typename Policy>
+    inline bool SharedCount<Ptr, Policy>::less(const SharedCount<Ptr, Policy> &sc) const {
         return m_pi < sc.m_pi;
     }
 
-    template<typename Ptr>
-    inline bool WeakCount<Ptr>::less(const WeakCount<Ptr> &wc) const {
+    template<typename Ptr, typename Policy>
+    inline bool WeakCount<Ptr, Policy>::less(const WeakCount<Ptr, Policy> &wc) const {
         return m_pi < wc.m_pi;
     }
 
-    template<typename Ptr>
-    inline bool WeakCount<Ptr>::less(const SharedCount<Ptr> &sc) const {
+    template<typename Ptr, typename Policy>
+    inline bool WeakCount<Ptr, Policy>::less(const SharedCount<Ptr, Policy> &sc) const {
         return m_pi < sc.m_pi;
     }
 
     /**
      * Creation of a shared count from a weak count, means that
      * the weak pointer is locking its reference to a shared pointer.
+     * The lock fails, leaving this count empty, if the last strong
+     * reference has already been released.
      *
-     * @tparam Ptr pointer type
+     * @tparam Ptr    pointer type
+     * @tparam Policy the count policy
      * @param wc weak count to copy
      */
-    template<typename Ptr>
-    inline SharedCount<Ptr>::SharedCount(const WeakCount<Ptr> &wc)
-            : m_pi(wc.m_pi)
-    { m_pi->add_locked_reference(); }
+    template<typename Ptr, typename Policy>
+    inline SharedCount<Ptr, Policy>::SharedCount(const WeakCount<Ptr, Policy> &wc)
+            : m_pi(wc.m_pi) {
+        if (m_pi && !m_pi->add_locked_reference()) {
+            m_pi = nullptr;
+        }
+    }
 
-    template<typename T>
+    /**
+     * Tag selecting the shared pointer constructor which creates
+     * the object in the same allocation as its reference count.
+     */
+    struct __make_shared_tag {};
+
+    /**
+     * Shared pointer to a dynamically allocated object.
+     *
+     * @tparam T      pointed-to type
+     * @tparam Policy the count policy, by default selected at build
+     *                time; shared pointers only convert between
+     *                types with the same policy
+     */
+    template<typename T, typename Policy>
     class shared_ptr {
     public:
         typedef T val_type;
-        typedef typename ReferenceCount<T *>::ptr_use_count ptr_use_count;
+        typedef Policy count_policy;
+        typedef typename ReferenceCountBase<Policy>::ptr_use_count ptr_use_count;
 
     private:
-        template<typename U> friend
+        template<typename U, typename P> friend
         class shared_ptr;
 
-        template<typename U> friend
+        template<typename U, typename P> friend
         class weak_ptr;
 
-        SharedCount<T *> m_refcount;
+        SharedCount<T *, Policy> m_refcount;
         val_type *m_ptr;
 
     public:
@@ -487,26 +644,42 @@ namespace wlp {
         >::type>
         explicit shared_ptr(U *ptr)
                 : m_refcount(ptr),
-                  m_ptr(ptr)
+                  m_ptr(m_refcount.empty() ? nullptr : ptr)
+        { static_assert(sizeof(U) > 0, "Pointer to incomplete type"); }
+
+        /**
+         * Take ownership of a pointer, allocating the reference count
+         * from the given allocator. If the allocator fails, the object
+         * is destroyed and the shared pointer is left empty.
+         *
+         * @param ptr   the pointer to manage
+         * @param alloc the allocator of the reference count
+         */
+        template<typename U, typename Alloc, typename = typename enable_if<
+                is_convertible<U *, T *>::value
+        >::type>
+        shared_ptr(U *ptr, const Alloc &alloc)
+                : m_refcount(ptr, alloc),
+                  m_ptr(m_refcount.empty() ? nullptr : ptr)
         { static_assert(sizeof(U) > 0, "Pointer to incomplete type"); }
 
         template<typename U>
-        shared_ptr(const shared_ptr<U> &sp, T *ptr)
+        shared_ptr(const shared_ptr<U, Policy> &sp, T *ptr)
                 : m_refcount(sp.m_refcount),
                   m_ptr(ptr) {}
 
         template<typename U, typename = typename enable_if<
                 is_convertible<U *, T *>::value
         >::type>
-        shared_ptr(const shared_ptr<U> &sp)
+        shared_ptr(const shared_ptr<U, Policy> &sp)
                 : m_refcount(sp.m_refcount),
                   m_ptr(sp.m_ptr) {}
 
-        shared_ptr(const shared_ptr<T> &sp)
+        shared_ptr(const shared_ptr<T, Policy> &sp)
                 : m_refcount(sp.m_refcount),
                   m_ptr(sp.m_ptr) {}
 
-        shared_ptr(shared_ptr<T> &&sp)
+        shared_ptr(shared_ptr<T, Policy> &&sp)
                 : m_refcount(),
                   m_ptr(sp.m_ptr) {
             m_refcount.swap(sp.m_refcount);
@@ -516,7 +689,7 @@ namespace wlp {
         template<typename U, typename = typename enable_if<
                 is_convertible<U *, T *>::value
         >::type>
-        shared_ptr(shared_ptr<U> &&sp)
+        shared_ptr(shared_ptr<U, Policy> &&sp)
                 : m_refcount(),
                   m_ptr(sp.m_ptr) {
             m_refcount.swap(sp.m_refcount);
@@ -526,50 +699,82 @@ namespace wlp {
         template<typename U, typename = typename enable_if<
                 is_convertible<U *, T *>::value
         >::type>
-        explicit shared_ptr(const weak_ptr<U> &wp)
+        explicit shared_ptr(const weak_ptr<U, Policy> &wp)
                 : m_refcount(wp.m_refcount),
-                  m_ptr(wp.m_ptr) {}
+                  m_ptr(m_refcount.empty() ? nullptr : wp.m_ptr) {}
 
         template<typename U, typename = typename enable_if<
                 is_convertible<U *, T *>::value
         >::type>
         shared_ptr(unique_ptr <U> &&up)
+                : shared_ptr(move(up), allocator()) {}
+
+        /**
+         * Take the pointer of a unique pointer, allocating the reference
+         * count from the given allocator. If the allocator fails, the
+         * unique pointer keeps its pointer and the shared pointer is
+         * left empty.
+         *
+         * @param up    the unique pointer to take
+         * @param alloc the allocator of the reference count
+         */
+        template<typename U, typename Alloc, typename = typename enable_if<
+                is_convertible<U *, T *>::value
+        >::type>
+        shared_ptr(unique_ptr <U> &&up, const Alloc &alloc)
                 : m_refcount(),
-                  m_ptr(up.get()) {
-            U *tmp = up.get();
-            m_refcount = SharedCount<T *>(move(up));
+                  m_ptr(nullptr) {
+            U *ptr = up.get();
+            m_refcount = SharedCount<T *, Policy>(move(up), alloc);
+            m_ptr = m_refcount.empty() ? nullptr : ptr;
         }
 
         constexpr shared_ptr(nullptr_t)
                 : m_refcount(),
                   m_ptr(nullptr) {}
 
-        shared_ptr<T> &operator=(const shared_ptr<T> &sp) {
+        /**
+         * Constructor used by @code make_shared @endcode and
+         * @code allocate_shared @endcode.
+         */
+        template<typename Alloc, typename... Args>
+        shared_ptr(__make_shared_tag, const Alloc &alloc, Args &&... args)
+                : m_refcount(),
+                  m_ptr(nullptr) {
+            m_ptr = m_refcount.template emplace<T>(alloc, forward<Args>(args)...);
+        }
+
+        shared_ptr<T, Policy> &operator=(const shared_ptr<T, Policy> &sp) {
             m_ptr = sp.m_ptr;
             m_refcount = sp.m_refcount;
             return *this;
         }
 
         template<typename U>
-        shared_ptr<T> &operator=(const shared_ptr<U> &sp) {
+        shared_ptr<T, Policy> &operator=(const shared_ptr<U, Policy> &sp) {
             m_ptr = sp.m_ptr;
             m_refcount = sp.m_refcount;
             return *this;
         }
 
-        shared_ptr<T> &operator=(shared_ptr<T> &&sp) {
+        shared_ptr<T, Policy> &operator=(shared_ptr<T, Policy> &&sp) {
             shared_ptr(move(sp)).swap(*this);
             return *this;
         }
 
         template<typename U>
-        shared_ptr<T> &operator=(shared_ptr<U> &&sp) {
+        shared_ptr<T, Policy> &operator=(shared_ptr<U, Policy> &&sp) {
             shared_ptr(move(sp)).swap(*this);
             return *this;
         }
 
+        /**
+         * Take the pointer of a unique pointer. If the reference count
+         * cannot be allocated, the unique pointer keeps its pointer and
+         * this shared pointer is left empty.
+         */
         template<typename U>
-        shared_ptr<T> &operator=(unique_ptr <U> &&up) {
+        shared_ptr<T, Policy> &operator=(unique_ptr <U> &&up) {
             shared_ptr(move(up)).swap(*this);
             return *this;
         }
@@ -607,70 +812,109 @@ namespace wlp {
             return m_refcount.use_count();
         }
 
-        void swap(shared_ptr<T> &sp) {
+        void swap(shared_ptr<T, Policy> &sp) {
             wlp::swap(m_ptr, sp.m_ptr);
             m_refcount.swap(sp.m_refcount);
         }
 
         template<typename U>
-        bool owner_before(const shared_ptr<U> &sp) const {
+        bool owner_before(const shared_ptr<U, Policy> &sp) const {
             return m_refcount.less(sp.m_refcount);
         }
 
         template<typename U>
-        bool owner_before(const weak_ptr<U> &wp) const {
+        bool owner_before(const weak_ptr<U, Policy> &wp) const {
             return m_refcount.less(wp.m_refcount);
         }
 
-        weak_ptr<T> weak() const {
-            return weak_ptr<T>(*this);
+        weak_ptr<T, Policy> weak() const {
+            return weak_ptr<T, Policy>(*this);
         }
 
     };
 
-    template<typename T>
-    inline void swap(shared_ptr<T> &sp1, shared_ptr<T> &sp2) {
+    template<typename T, typename Policy>
+    inline void swap(shared_ptr<T, Policy> &sp1, shared_ptr<T, Policy> &sp2) {
         sp1.swap(sp2);
     }
 
-    template<typename T, typename U>
-    inline shared_ptr<T> static_pointer_cast(const shared_ptr<U> &sp) {
-        return shared_ptr<T>(sp, static_cast<T *>(sp.get()));
+    /**
+     * Create an object managed by a shared pointer, placing the object
+     * and its reference count in one block obtained from an allocator.
+     * The object is destroyed when the last shared pointer is released,
+     * and the block is returned when the last weak pointer is released.
+     *
+     * @tparam T      the type of the object
+     * @tparam Policy the count policy
+     * @param alloc the allocator, see Allocator.h
+     * @param args  constructor arguments of the object
+     * @return a shared pointer to the object, which is empty if
+     * the allocator is out of memory
+     */
+    template<typename T, typename Policy = default_count, typename Alloc, typename... Args>
+    inline shared_ptr<T, Policy> allocate_shared(const Alloc &alloc, Args &&... args) {
+        return shared_ptr<T, Policy>(__make_shared_tag(), alloc, forward<Args>(args)...);
     }
 
-    template<typename T, typename U>
-    inline shared_ptr<T> const_pointer_cast(const shared_ptr<U> &sp) {
-        return shared_ptr<T>(sp, const_cast<T *>(sp.get()));
+    /**
+     * Create an object managed by a shared pointer with a single
+     * allocation from the wlib memory functions.
+     *
+     * @tparam T      the type of the object
+     * @tparam Policy the count policy
+     * @param args constructor arguments of the object
+     * @return a shared pointer to the object
+     */
+    template<typename T, typename Policy = default_count, typename... Args>
+    inline shared_ptr<T, Policy> make_shared(Args &&... args) {
+        return shared_ptr<T, Policy>(__make_shared_tag(), allocator(), forward<Args>(args)...);
+    }
+
+    template<typename T, typename U, typename Policy>
+    inline shared_ptr<T, Policy> static_pointer_cast(const shared_ptr<U, Policy> &sp) {
+        return shared_ptr<T, Policy>(sp, static_cast<T *>(sp.get()));
+    }
+
+    template<typename T, typename U, typename Policy>
+    inline shared_ptr<T, Policy> const_pointer_cast(const shared_ptr<U, Policy> &sp) {
+        return shared_ptr<T, Policy>(sp, const_cast<T *>(sp.get()));
     };
 
-    template<typename T, typename U>
-    inline shared_ptr<T> dynamic_pointer_cast(const shared_ptr<U> &sp) {
+    template<typename T, typename U, typename Policy>
+    inline shared_ptr<T, Policy> dynamic_pointer_cast(const shared_ptr<U, Policy> &sp) {
         if (T *ptr = dynamic_cast<T *>(sp.get())) {
-            return shared_ptr<T>(sp, ptr);
+            return shared_ptr<T, Policy>(sp, ptr);
         }
-        return shared_ptr<T>();
+        return shared_ptr<T, Policy>();
     };
 
-    template<typename T, typename U>
-    inline shared_ptr<T> reinterpret_pointer_cast(const shared_ptr<U> &sp) {
-        return shared_ptr<T>(sp, reinterpret_cast<T *>(sp.get()));
+    template<typename T, typename U, typename Policy>
+    inline shared_ptr<T, Policy> reinterpret_pointer_cast(const shared_ptr<U, Policy> &sp) {
+        return shared_ptr<T, Policy>(sp, reinterpret_cast<T *>(sp.get()));
     };
 
-    template<typename T>
+    /**
+     * Non-owning reference to an object managed by shared pointers.
+     *
+     * @tparam T      pointed-to type
+     * @tparam Policy the count policy
+     */
+    template<typename T, typename Policy>
     class weak_ptr {
     public:
         typedef T val_type;
-        typedef typename ReferenceCount<T *>::ptr_use_count ptr_use_count;
+        typedef Policy count_policy;
+        typedef typename ReferenceCountBase<Policy>::ptr_use_count ptr_use_count;
 
     private:
 
-        template<typename U> friend
+        template<typename U, typename P> friend
         class shared_ptr;
 
-        template<typename U> friend
+        template<typename U, typename P> friend
         class weak_ptr;
 
-        WeakCount<T *> m_refcount;
+        WeakCount<T *, Policy> m_refcount;
         val_type *m_ptr;
 
     public:
@@ -682,7 +926,7 @@ namespace wlp {
         template<typename U, typename = typename enable_if<
                 is_convertible<U *, T *>::value
         >::type>
-        weak_ptr(const weak_ptr<U> &wp)
+        weak_ptr(const weak_ptr<U, Policy> &wp)
                 : m_refcount(wp.m_refcount) {
             m_ptr = wp.lock().get();
         };
@@ -690,26 +934,33 @@ namespace wlp {
         template<typename U, typename = typename enable_if<
                 is_convertible<U *, T *>::value
         >::type>
-        weak_ptr(const shared_ptr<U> &sp)
+        weak_ptr(const shared_ptr<U, Policy> &sp)
                 : m_refcount(sp.m_refcount),
                   m_ptr(sp.m_ptr) {}
 
         template<typename U>
-        weak_ptr &operator=(const weak_ptr<U> &wp) {
+        weak_ptr &operator=(const weak_ptr<U, Policy> &wp) {
             m_ptr = wp.lock().get();
             m_refcount = wp.m_refcount;
             return *this;
         }
 
         template<typename U>
-        weak_ptr &operator=(const shared_ptr<U> &sp) {
+        weak_ptr &operator=(const shared_ptr<U, Policy> &sp) {
             m_ptr = sp.m_ptr;
             m_refcount = sp.m_refcount;
             return *this;
         }
 
-        shared_ptr<T> lock() const {
-            return expired() ? shared_ptr<T>() : shared_ptr<T>(*this);
+        /**
+         * Obtain a shared pointer to the object, or an empty shared
+         * pointer if the object has expired. Checking and acquiring
+         * ownership is a single step, so the result is never a
+         * dangling pointer even if the last owner is released
+         * concurrently.
+         */
+        shared_ptr<T, Policy> lock() const {
+            return shared_ptr<T, Policy>(*this);
         }
 
         ptr_use_count use_count() const {
@@ -721,12 +972,12 @@ namespace wlp {
         }
 
         template<typename U>
-        bool owner_before(const shared_ptr<U> &sp) {
+        bool owner_before(const shared_ptr<U, Policy> &sp) {
             return m_refcount.less(sp.m_refcount);
         }
 
         template<typename U>
-        bool owner_before(const weak_ptr<U> &wp) {
+        bool owner_before(const weak_ptr<U, Policy> &wp) {
             return m_refcount.less(wp.m_refcount);
         }
 
@@ -734,14 +985,14 @@ namespace wlp {
             weak_ptr().swap(*this);
         }
 
-        void swap(weak_ptr<T> &wp) {
+        void swap(weak_ptr<T, Policy> &wp) {
             wlp::swap(m_ptr, wp.m_ptr);
             m_refcount.swap(wp.m_refcount);
         }
     };
 
-    template<typename T>
-    inline void swap(weak_ptr<T> &wp1, weak_ptr<T> &wp2) {
+    template<typename T, typename Policy>
+    inline void swap(weak_ptr<T, Policy> &wp1, weak_ptr<T, Policy> &wp2) {
         wp1.swap(wp2);
     }
 
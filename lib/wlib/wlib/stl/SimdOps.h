@@ -0,0 +1,267 @@
+/**
+ * @file SimdOps.h
+ * @brief Vectorized elementwise primitives.
+ *
+ * Loops over contiguous arrays of float, double and int use SSE2,
+ * SSE4.1 or AVX when the compiler targets them. Defining
+ * @code WLIB_NO_SIMD @endcode, or compiling for a target without
+ * these instruction sets, selects the scalar loops.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_SIMDOPS_H
+#define EMBEDDEDCPLUSPLUS_SIMDOPS_H
+
+#include <stddef.h>
+
+#if !defined(WLIB_NO_SIMD) && (defined(__SSE2__) || defined(__AVX__))
+#define WLIB_SIMD
+#include <immintrin.h>
+#endif
+
+namespace wlp {
+
+    /**
+     * Elementwise primitives over contiguous arrays. The generic
+     * version is a plain loop; specializations for float, double
+     * and int process several elements per instruction.
+     *
+     * The float and double specializations also expose their
+     * register type and operations so that other kernels can build
+     * vector loops on top of them; @code simd_float @endcode is
+     * true exactly for those.
+     *
+     * @tparam T element type
+     */
+    template<typename T>
+    struct __simd_ops {
+        static constexpr bool simd_float = false;
+
+        static void add(const T *a, const T *b, T *out, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(a[i] + b[i]);
+            }
+        }
+
+        static void sub(const T *a, const T *b, T *out, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(a[i] - b[i]);
+            }
+        }
+
+        static void mul(const T *a, const T *b, T *out, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(a[i] * b[i]);
+            }
+        }
+
+        static void scale(const T *a, T s, T *out, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(a[i] * s);
+            }
+        }
+
+        /**
+         * Compute @code y += s * x @endcode.
+         */
+        static void axpy(T s, const T *x, T *y, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                y[i] = static_cast<T>(y[i] + s * x[i]);
+            }
+        }
+    };
+
+#ifdef WLIB_SIMD
+
+    template<>
+    struct __simd_ops<float> {
+        static constexpr bool simd_float = true;
+#ifdef __AVX__
+        static constexpr size_t width = 8;
+        typedef __m256 reg;
+        static reg load(const float *p) { return _mm256_loadu_ps(p); }
+        static void store(float *p, reg v) { _mm256_storeu_ps(p, v); }
+        static reg set1(float s) { return _mm256_set1_ps(s); }
+        static reg vadd(reg a, reg b) { return _mm256_add_ps(a, b); }
+        static reg vsub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+        static reg vmul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+        static reg vdiv(reg a, reg b) { return _mm256_div_ps(a, b); }
+        static reg vsqrt(reg a) { return _mm256_sqrt_ps(a); }
+        static reg vkeep_nonzero(reg c, reg v) { return _mm256_and_ps(_mm256_cmp_ps(c, _mm256_setzero_ps(), _CMP_NEQ_UQ), v); }
+#else
+        static constexpr size_t width = 4;
+        typedef __m128 reg;
+        static reg load(const float *p) { return _mm_loadu_ps(p); }
+        static void store(float *p, reg v) { _mm_storeu_ps(p, v); }
+        static reg set1(float s) { return _mm_set1_ps(s); }
+        static reg vadd(reg a, reg b) { return _mm_add_ps(a, b); }
+        static reg vsub(reg a, reg b) { return _mm_sub_ps(a, b); }
+        static reg vmul(reg a, reg b) { return _mm_mul_ps(a, b); }
+        static reg vdiv(reg a, reg b) { return _mm_div_ps(a, b); }
+        static reg vsqrt(reg a) { return _mm_sqrt_ps(a); }
+        static reg vkeep_nonzero(reg c, reg v) { return _mm_and_ps(_mm_cmpneq_ps(c, _mm_setzero_ps()), v); }
+#endif
+
+        static void add(const float *a, const float *b, float *out, size_t n) {
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, vadd(load(a + i), load(b + i))); }
+            for (; i < n; ++i) { out[i] = a[i] + b[i]; }
+        }
+
+        static void sub(const float *a, const float *b, float *out, size_t n) {
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, vsub(load(a + i), load(b + i))); }
+            for (; i < n; ++i) { out[i] = a[i] - b[i]; }
+        }
+
+        static void mul(const float *a, const float *b, float *out, size_t n) {
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, vmul(load(a + i), load(b + i))); }
+            for (; i < n; ++i) { out[i] = a[i] * b[i]; }
+        }
+
+        static void scale(const float *a, float s, float *out, size_t n) {
+            reg vs = set1(s);
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, vmul(load(a + i), vs)); }
+            for (; i < n; ++i) { out[i] = a[i] * s; }
+        }
+
+        static void axpy(float s, const float *x, float *y, size_t n) {
+            reg vs = set1(s);
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(y + i, vadd(load(y + i), vmul(vs, load(x + i)))); }
+            for (; i < n; ++i) { y[i] += s * x[i]; }
+        }
+    };
+
+    template<>
+    struct __simd_ops<double> {
+        static constexpr bool simd_float = true;
+#ifdef __AVX__
+        static constexpr size_t width = 4;
+        typedef __m256d reg;
+        static reg load(const double *p) { return _mm256_loadu_pd(p); }
+        static void store(double *p, reg v) { _mm256_storeu_pd(p, v); }
+        static reg set1(double s) { return _mm256_set1_pd(s); }
+        static reg vadd(reg a, reg b) { return _mm256_add_pd(a, b); }
+        static reg vsub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+        static reg vmul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+        static reg vdiv(reg a, reg b) { return _mm256_div_pd(a, b); }
+        static reg vsqrt(reg a) { return _mm256_sqrt_pd(a); }
+        static reg vkeep_nonzero(reg c, reg v) { return _mm256_and_pd(_mm256_cmp_pd(c, _mm256_setzero_pd(), _CMP_NEQ_UQ), v); }
+#else
+        static constexpr size_t width = 2;
+        typedef __m128d reg;
+        static reg load(const double *p) { return _mm_loadu_pd(p); }
+        static void store(double *p, reg v) { _mm_storeu_pd(p, v); }
+        static reg set1(double s) { return _mm_set1_pd(s); }
+        static reg vadd(reg a, reg b) { return _mm_add_pd(a, b); }
+        static reg vsub(reg a, reg b) { return _mm_sub_pd(a, b); }
+        static reg vmul(reg a, reg b) { return _mm_mul_pd(a, b); }
+        static reg vdiv(reg a, reg b) { return _mm_div_pd(a, b); }
+        static reg vsqrt(reg a) { return _mm_sqrt_pd(a); }
+        static reg vkeep_nonzero(reg c, reg v) { return _mm_and_pd(_mm_cmpneq_pd(c, _mm_setzero_pd()), v); }
+#endif
+
+        static void add(const double *a, const double *b, double *out, size_t n) {
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, vadd(load(a + i), load(b + i))); }
+            for (; i < n; ++i) { out[i] = a[i] + b[i]; }
+        }
+
+        static void sub(const double *a, const double *b, double *out, size_t n) {
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, vsub(load(a + i), load(b + i))); }
+            for (; i < n; ++i) { out[i] = a[i] - b[i]; }
+        }
+
+        static void mul(const double *a, const double *b, double *out, size_t n) {
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, vmul(load(a + i), load(b + i))); }
+            for (; i < n; ++i) { out[i] = a[i] * b[i]; }
+        }
+
+        static void scale(const double *a, double s, double *out, size_t n) {
+            reg vs = set1(s);
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, vmul(load(a + i), vs)); }
+            for (; i < n; ++i) { out[i] = a[i] * s; }
+        }
+
+        static void axpy(double s, const double *x, double *y, size_t n) {
+            reg vs = set1(s);
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(y + i, vadd(load(y + i), vmul(vs, load(x + i)))); }
+            for (; i < n; ++i) { y[i] += s * x[i]; }
+        }
+    };
+
+    /**
+     * Integer addition and subtraction need only SSE2. Lane-wise
+     * 32-bit multiplication needs SSE4.1, otherwise the scalar
+     * loop is used for the multiplying primitives.
+     */
+    template<>
+    struct __simd_ops<int> {
+        static constexpr bool simd_float = false;
+        typedef __m128i reg;
+        static constexpr size_t width = 4;
+        static reg load(const int *p) { return _mm_loadu_si128(reinterpret_cast<const reg *>(p)); }
+        static void store(int *p, reg v) { _mm_storeu_si128(reinterpret_cast<reg *>(p), v); }
+
+        static void add(const int *a, const int *b, int *out, size_t n) {
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, _mm_add_epi32(load(a + i), load(b + i))); }
+            for (; i < n; ++i) { out[i] = a[i] + b[i]; }
+        }
+
+        static void sub(const int *a, const int *b, int *out, size_t n) {
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, _mm_sub_epi32(load(a + i), load(b + i))); }
+            for (; i < n; ++i) { out[i] = a[i] - b[i]; }
+        }
+
+#ifdef __SSE4_1__
+        static void mul(const int *a, const int *b, int *out, size_t n) {
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, _mm_mullo_epi32(load(a + i), load(b + i))); }
+            for (; i < n; ++i) { out[i] = a[i] * b[i]; }
+        }
+
+        static void scale(const int *a, int s, int *out, size_t n) {
+            reg vs = _mm_set1_epi32(s);
+            size_t i = 0;
+            for (; i + width <= n; i += width) { store(out + i, _mm_mullo_epi32(load(a + i), vs)); }
+            for (; i < n; ++i) { out[i] = a[i] * s; }
+        }
+
+        static void axpy(int s, const int *x, int *y, size_t n) {
+            reg vs = _mm_set1_epi32(s);
+            size_t i = 0;
+            for (; i + width <= n; i += width) {
+                store(y + i, _mm_add_epi32(load(y + i), _mm_mullo_epi32(vs, load(x + i))));
+            }
+            for (; i < n; ++i) { y[i] += s * x[i]; }
+        }
+#else
+        static void mul(const int *a, const int *b, int *out, size_t n) {
+            for (size_t i = 0; i < n; ++i) { out[i] = a[i] * b[i]; }
+        }
+
+        static void scale(const int *a, int s, int *out, size_t n) {
+            for (size_t i = 0; i < n; ++i) { out[i] = a[i] * s; }
+        }
+
+        static void axpy(int s, const int *x, int *y, size_t n) {
+            for (size_t i = 0; i < n; ++i) { y[i] += s * x[i]; }
+        }
+#endif
+    };
+
+#endif // WLIB_SIMD
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_SIMDOPS_H
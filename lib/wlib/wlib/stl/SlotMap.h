@@ -0,0 +1,320 @@
+/**
+ * @file SlotMap.h
+ * @brief Densely packed object store addressed by generational handles.
+ *
+ * A slot map stores values contiguously and hands out a handle for
+ * each one. A handle names a slot by index and carries the generation
+ * of the slot when the value was inserted; erasing a value advances
+ * the generation, so handles to erased values are detected instead of
+ * resolving to whatever reuses the slot. Insertion, erasure and lookup
+ * are constant time, and iteration walks only live values.
+ *
+ * Values move when another value is erased, since the last value is
+ * moved into the hole to keep the array packed. Pointers and iterators
+ * to values are invalidated by erasure and insertion; handles are not.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_SLOTMAP_H
+#define EMBEDDEDCPLUSPLUS_SLOTMAP_H
+
+#include <stdint.h>
+
+#include <wlib/utility>
+#include <wlib/stl/Allocator.h>
+#include <wlib/stl/ArrayList.h>
+
+namespace wlp {
+
+    /**
+     * Handle to a value in a slot map, packed into 64 bits. The
+     * default handle refers to no value.
+     */
+    struct slot_handle {
+        uint32_t index;
+        uint32_t generation;
+
+        constexpr slot_handle()
+                : index(0),
+                  generation(0) {}
+
+        constexpr slot_handle(uint32_t i, uint32_t g)
+                : index(i),
+                  generation(g) {}
+
+        /**
+         * @return the handle as one integer, for storage or hashing
+         */
+        constexpr uint64_t raw() const {
+            return (static_cast<uint64_t>(generation) << 32) | index;
+        }
+
+        static constexpr slot_handle from_raw(uint64_t raw) {
+            return slot_handle(static_cast<uint32_t>(raw), static_cast<uint32_t>(raw >> 32));
+        }
+
+        bool operator==(const slot_handle &h) const {
+            return index == h.index && generation == h.generation;
+        }
+
+        bool operator!=(const slot_handle &h) const {
+            return !(*this == h);
+        }
+    };
+
+    /**
+     * Slot map of values of type @code T @endcode, which must be
+     * default constructible and move assignable.
+     *
+     * @tparam T     value type
+     * @tparam Alloc allocator of the value and index arrays
+     */
+    template<typename T, typename Alloc = allocator>
+    class slot_map {
+    public:
+        typedef T val_type;
+        typedef uint32_t size_type;
+        typedef Alloc allocator_type;
+        typedef array_list<T, Alloc> value_list;
+        typedef typename value_list::iterator iterator;
+        typedef typename value_list::const_iterator const_iterator;
+
+    private:
+        static constexpr uint32_t no_slot = static_cast<uint32_t>(-1);
+
+        /**
+         * A slot holds the position of its value in the dense array,
+         * or the next free slot while it is unused. Generations of
+         * live slots are odd and of free slots even, so that the
+         * default handle never matches.
+         */
+        struct slot {
+            uint32_t m_target;
+            uint32_t m_generation;
+        };
+
+        /**
+         * Packed values.
+         */
+        value_list m_values;
+        /**
+         * Slot of each packed value, parallel to the values.
+         */
+        array_list<uint32_t, Alloc> m_owner;
+        array_list<slot, Alloc> m_slots;
+        uint32_t m_free_head;
+
+    public:
+        /**
+         * Create an empty slot map.
+         *
+         * @param n     initial capacity, at least one
+         * @param alloc allocator of the arrays
+         */
+        explicit slot_map(size_type n = 12, const Alloc &alloc = Alloc())
+                : m_values(n, alloc),
+                  m_owner(n, alloc),
+                  m_slots(n, alloc),
+                  m_free_head(no_slot) {}
+
+        slot_map(const slot_map &) = delete;
+
+        slot_map(slot_map &&map)
+                : m_values(move(map.m_values)),
+                  m_owner(move(map.m_owner)),
+                  m_slots(move(map.m_slots)),
+                  m_free_head(map.m_free_head) {
+            map.m_free_head = no_slot;
+        }
+
+        slot_map &operator=(const slot_map &) = delete;
+
+        slot_map &operator=(slot_map &&map) {
+            m_values = move(map.m_values);
+            m_owner = move(map.m_owner);
+            m_slots = move(map.m_slots);
+            m_free_head = map.m_free_head;
+            map.m_free_head = no_slot;
+            return *this;
+        }
+
+        /**
+         * Insert a value.
+         *
+         * @param val the value
+         * @return a handle to the value, or the default handle if the
+         *         arrays could not grow, in which case nothing changes
+         */
+        template<typename V>
+        slot_handle insert(V &&val) {
+            uint32_t i = m_free_head;
+            if (i == no_slot) {
+                i = static_cast<uint32_t>(m_slots.size());
+                m_slots.push_back(slot{no_slot, 0});
+                if (m_slots.size() == i) {
+                    return slot_handle();
+                }
+            }
+            uint32_t pos = static_cast<uint32_t>(m_values.size());
+            m_values.push_back(forward<V>(val));
+            if (m_values.size() == pos) {
+                if (i != m_free_head) {
+                    m_slots.pop_back();
+                }
+                return slot_handle();
+            }
+            m_owner.push_back(i);
+            if (m_owner.size() == pos) {
+                m_values[pos] = T();
+                m_values.pop_back();
+                if (i != m_free_head) {
+                    m_slots.pop_back();
+                }
+                return slot_handle();
+            }
+            slot &s = m_slots[i];
+            if (i == m_free_head) {
+                m_free_head = s.m_target;
+            }
+            s.m_target = pos;
+            ++s.m_generation;
+            return slot_handle(i, s.m_generation);
+        }
+
+        /**
+         * Erase the value of a handle. The last value is moved into
+         * its place.
+         *
+         * @param h the handle
+         * @return false if the handle was stale
+         */
+        bool erase(const slot_handle &h) {
+            if (!contains(h)) {
+                return false;
+            }
+            slot &s = m_slots[h.index];
+            uint32_t pos = s.m_target;
+            uint32_t last = static_cast<uint32_t>(m_values.size() - 1);
+            if (pos != last) {
+                m_values[pos] = move(m_values[last]);
+                m_owner[pos] = m_owner[last];
+                m_slots[m_owner[pos]].m_target = pos;
+            }
+            // the list only shrinks its size, so release the value here
+            m_values[last] = T();
+            m_values.pop_back();
+            m_owner.pop_back();
+            ++s.m_generation;
+            s.m_target = m_free_head;
+            m_free_head = h.index;
+            return true;
+        }
+
+        /**
+         * @return true if the handle refers to a value in this map
+         */
+        bool contains(const slot_handle &h) const {
+            return h.index < m_slots.size() && m_slots[h.index].m_generation == h.generation
+                   && (h.generation & 1);
+        }
+
+        /**
+         * @return pointer to the value of the handle, or null if
+         *         the handle is stale
+         */
+        T *get(const slot_handle &h) {
+            return contains(h) ? &m_values[m_slots[h.index].m_target] : nullptr;
+        }
+
+        const T *get(const slot_handle &h) const {
+            return contains(h) ? &m_values[m_slots[h.index].m_target] : nullptr;
+        }
+
+        /**
+         * Access the value of a handle, which must be valid.
+         */
+        T &operator[](const slot_handle &h) {
+            return m_values[m_slots[h.index].m_target];
+        }
+
+        const T &operator[](const slot_handle &h) const {
+            return m_values[m_slots[h.index].m_target];
+        }
+
+        /**
+         * @param pos position of a value in iteration order
+         * @return the handle of that value
+         */
+        slot_handle handle_at(size_type pos) const {
+            uint32_t i = m_owner[pos];
+            return slot_handle(i, m_slots[i].m_generation);
+        }
+
+        /**
+         * Erase every value. All handles become stale.
+         */
+        void clear() {
+            for (size_type pos = 0; pos < m_owner.size(); ++pos) {
+                slot &s = m_slots[m_owner[pos]];
+                ++s.m_generation;
+                s.m_target = m_free_head;
+                m_free_head = m_owner[pos];
+                m_values[pos] = T();
+            }
+            m_values.clear();
+            m_owner.clear();
+        }
+
+        /**
+         * Reserve space for @code n @endcode values.
+         */
+        void reserve(size_type n) {
+            m_values.reserve(n);
+            m_owner.reserve(n);
+            m_slots.reserve(n);
+        }
+
+        size_type size() const {
+            return static_cast<size_type>(m_values.size());
+        }
+
+        bool empty() const {
+            return m_values.empty();
+        }
+
+        /**
+         * @return the packed values, in iteration order
+         */
+        T *data() {
+            return m_values.data();
+        }
+
+        const T *data() const {
+            return m_values.data();
+        }
+
+        iterator begin() {
+            return m_values.begin();
+        }
+
+        iterator end() {
+            return m_values.end();
+        }
+
+        const_iterator begin() const {
+            return m_values.begin();
+        }
+
+        const_iterator end() const {
+            return m_values.end();
+        }
+
+        allocator_type get_allocator() const {
+            return m_values.get_allocator();
+        }
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_SLOTMAP_H
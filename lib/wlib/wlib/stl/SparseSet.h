@@ -0,0 +1,410 @@
+/**
+ * @file SparseSet.h
+ * @brief Set of small integers with constant time operations.
+ *
+ * A sparse set stores its members packed in a dense array, and keeps
+ * for every possible key the position where that key would be in the
+ * dense array. A key is a member if the dense array holds it at that
+ * position. Insertion, erasure and lookup are constant time, clearing
+ * only resets the member count, and iteration visits the members only.
+ *
+ * The index array has one entry per possible key, so the set suits
+ * keys drawn from a small range such as entity or channel numbers.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_SPARSESET_H
+#define EMBEDDEDCPLUSPLUS_SPARSESET_H
+
+#include <stdint.h>
+
+#include <wlib/utility>
+#include <wlib/stl/Allocator.h>
+#include <wlib/stl/ArrayList.h>
+
+namespace wlp {
+
+    /**
+     * Sparse set of unsigned integer keys.
+     *
+     * @tparam Key   unsigned integer key type, which also bounds the
+     *               number of members
+     * @tparam Alloc allocator of the index and member arrays
+     */
+    template<typename Key = uint16_t, typename Alloc = allocator>
+    class sparse_set : private Alloc {
+    public:
+        typedef Key key_type;
+        typedef size_t size_type;
+        typedef Alloc allocator_type;
+        typedef typename array_list<Key, Alloc>::const_iterator const_iterator;
+
+    private:
+        /**
+         * Position of each key in the dense array, valid only for
+         * members.
+         */
+        Key *m_sparse;
+        size_type m_universe;
+        array_list<Key, Alloc> m_dense;
+
+    public:
+        /**
+         * Create an empty set.
+         *
+         * @param universe one more than the largest key expected; the
+         *                 index grows if a larger key is inserted, and
+         *                 is empty if it could not be allocated
+         * @param alloc    allocator of the arrays
+         */
+        explicit sparse_set(size_type universe = 64, const Alloc &alloc = Alloc())
+                : Alloc(alloc),
+                  m_sparse(nullptr),
+                  m_universe(universe > 0 ? universe : 1),
+                  m_dense(12, alloc) {
+            m_sparse = alloc_create_array<Key>(get_alloc(), m_universe);
+            if (!m_sparse) {
+                m_universe = 0;
+            }
+        }
+
+        sparse_set(const sparse_set &) = delete;
+
+        sparse_set(sparse_set &&set)
+                : Alloc(set.get_allocator()),
+                  m_sparse(set.m_sparse),
+                  m_universe(set.m_universe),
+                  m_dense(move(set.m_dense)) {
+            set.m_sparse = nullptr;
+            set.m_universe = 0;
+        }
+
+        ~sparse_set() {
+            alloc_destroy_array(get_alloc(), m_sparse, m_universe);
+        }
+
+        sparse_set &operator=(const sparse_set &) = delete;
+
+        sparse_set &operator=(sparse_set &&set) {
+            alloc_destroy_array(get_alloc(), m_sparse, m_universe);
+            get_alloc() = set.get_alloc();
+            m_sparse = set.m_sparse;
+            m_universe = set.m_universe;
+            m_dense = move(set.m_dense);
+            set.m_sparse = nullptr;
+            set.m_universe = 0;
+            return *this;
+        }
+
+        /**
+         * @return the position of a key among the members, or the
+         *         size of the set if it is not a member
+         */
+        size_type index_of(Key key) const {
+            if (key >= m_universe) {
+                return size();
+            }
+            size_type pos = m_sparse[key];
+            return pos < m_dense.size() && m_dense[pos] == key ? pos : size();
+        }
+
+        bool contains(Key key) const {
+            return index_of(key) != size();
+        }
+
+        /**
+         * Add a key to the set.
+         *
+         * @return false if the key was already a member or the arrays
+         *         could not grow to hold it
+         */
+        bool insert(Key key) {
+            if (contains(key)) {
+                return false;
+            }
+            if (key >= m_universe && !grow(static_cast<size_type>(key) + 1)) {
+                return false;
+            }
+            size_type pos = m_dense.size();
+            m_dense.push_back(key);
+            if (m_dense.size() == pos) {
+                return false;
+            }
+            m_sparse[key] = static_cast<Key>(pos);
+            return true;
+        }
+
+        /**
+         * Remove a key from the set. The last member takes its position.
+         *
+         * @return false if the key was not a member
+         */
+        bool erase(Key key) {
+            size_type pos = index_of(key);
+            if (pos == size()) {
+                return false;
+            }
+            Key last = m_dense.back();
+            m_dense[pos] = last;
+            m_sparse[last] = static_cast<Key>(pos);
+            m_dense.pop_back();
+            return true;
+        }
+
+        /**
+         * Remove every member in constant time.
+         */
+        void clear() {
+            m_dense.clear();
+        }
+
+        size_type size() const {
+            return m_dense.size();
+        }
+
+        bool empty() const {
+            return m_dense.empty();
+        }
+
+        /**
+         * @return one more than the largest key the index can hold
+         */
+        size_type universe() const {
+            return m_universe;
+        }
+
+        /**
+         * @return the members, packed, in iteration order
+         */
+        const Key *data() const {
+            return m_dense.data();
+        }
+
+        const_iterator begin() const {
+            return m_dense.begin();
+        }
+
+        const_iterator end() const {
+            return m_dense.end();
+        }
+
+        allocator_type get_allocator() const {
+            return *this;
+        }
+
+    private:
+        Alloc &get_alloc() {
+            return *this;
+        }
+
+        bool grow(size_type need) {
+            size_type universe = 2 * m_universe > need ? 2 * m_universe : need;
+            Key *sparse = alloc_create_array<Key>(get_alloc(), universe);
+            if (!sparse) {
+                return false;
+            }
+            for (size_type i = 0; i < m_universe; ++i) {
+                sparse[i] = m_sparse[i];
+            }
+            alloc_destroy_array(get_alloc(), m_sparse, m_universe);
+            m_sparse = sparse;
+            m_universe = universe;
+            return true;
+        }
+    };
+
+    /**
+     * Map from small unsigned integer keys to values, built on a sparse
+     * set of the keys with the values packed in the same order.
+     *
+     * @tparam Val   value type, default constructible and move assignable
+     * @tparam Key   unsigned integer key type
+     * @tparam Alloc allocator of the arrays
+     */
+    template<typename Val, typename Key = uint16_t, typename Alloc = allocator>
+    class sparse_map {
+    public:
+        typedef Key key_type;
+        typedef Val val_type;
+        typedef size_t size_type;
+        typedef Alloc allocator_type;
+        typedef typename array_list<Val, Alloc>::iterator iterator;
+        typedef typename array_list<Val, Alloc>::const_iterator const_iterator;
+
+    private:
+        sparse_set<Key, Alloc> m_keys;
+        array_list<Val, Alloc> m_values;
+
+    public:
+        /**
+         * Create an empty map.
+         *
+         * @param universe one more than the largest key expected
+         * @param alloc    allocator of the arrays
+         */
+        explicit sparse_map(size_type universe = 64, const Alloc &alloc = Alloc())
+                : m_keys(universe, alloc),
+                  m_values(12, alloc) {}
+
+        sparse_map(const sparse_map &) = delete;
+
+        sparse_map(sparse_map &&map)
+                : m_keys(move(map.m_keys)),
+                  m_values(move(map.m_values)) {}
+
+        sparse_map &operator=(const sparse_map &) = delete;
+
+        sparse_map &operator=(sparse_map &&map) {
+            m_keys = move(map.m_keys);
+            m_values = move(map.m_values);
+            return *this;
+        }
+
+        /**
+         * Insert a value if the key is not present.
+         *
+         * @return false if the key was present or could not be added
+         */
+        template<typename V>
+        bool insert(Key key, V &&val) {
+            if (m_keys.contains(key)) {
+                return false;
+            }
+            size_type pos = m_values.size();
+            m_values.push_back(forward<V>(val));
+            if (m_values.size() == pos) {
+                return false;
+            }
+            if (!m_keys.insert(key)) {
+                m_values.back() = Val();
+                m_values.pop_back();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @return pointer to the value of a key, inserting a default
+         *         value if the key is not present, or null if it could
+         *         not be added
+         */
+        Val *find_or_insert(Key key) {
+            size_type pos = m_keys.index_of(key);
+            if (pos == m_keys.size() && !insert(key, Val())) {
+                return nullptr;
+            }
+            return &m_values[pos];
+        }
+
+        /**
+         * @return the value of a key, inserting a default value if the
+         *         key is not present; the key must be one that can be
+         *         added, see @code find_or_insert @endcode
+         */
+        Val &operator[](Key key) {
+            return *find_or_insert(key);
+        }
+
+        /**
+         * @return pointer to the value of a key, or null
+         */
+        Val *get(Key key) {
+            size_type pos = m_keys.index_of(key);
+            return pos == m_keys.size() ? nullptr : &m_values[pos];
+        }
+
+        const Val *get(Key key) const {
+            size_type pos = m_keys.index_of(key);
+            return pos == m_keys.size() ? nullptr : &m_values[pos];
+        }
+
+        bool contains(Key key) const {
+            return m_keys.contains(key);
+        }
+
+        /**
+         * Remove a key and its value. The last entry takes its position.
+         *
+         * @return false if the key was not present
+         */
+        bool erase(Key key) {
+            size_type pos = m_keys.index_of(key);
+            if (pos == m_keys.size()) {
+                return false;
+            }
+            m_keys.erase(key);
+            if (pos != m_values.size() - 1) {
+                m_values[pos] = move(m_values.back());
+            }
+            // the list only shrinks its size, so release the value here
+            m_values.back() = Val();
+            m_values.pop_back();
+            return true;
+        }
+
+        void clear() {
+            m_keys.clear();
+            for (size_type pos = 0; pos < m_values.size(); ++pos) {
+                m_values[pos] = Val();
+            }
+            m_values.clear();
+        }
+
+        size_type size() const {
+            return m_keys.size();
+        }
+
+        bool empty() const {
+            return m_keys.empty();
+        }
+
+        /**
+         * @return the key of the entry at a position in iteration order
+         */
+        Key key_at(size_type pos) const {
+            return m_keys.data()[pos];
+        }
+
+        /**
+         * @return the set of keys, in the same order as the values
+         */
+        const sparse_set<Key, Alloc> &keys() const {
+            return m_keys;
+        }
+
+        /**
+         * @return the packed values, in iteration order
+         */
+        Val *data() {
+            return m_values.data();
+        }
+
+        const Val *data() const {
+            return m_values.data();
+        }
+
+        iterator begin() {
+            return m_values.begin();
+        }
+
+        iterator end() {
+            return m_values.end();
+        }
+
+        const_iterator begin() const {
+            return m_values.begin();
+        }
+
+        const_iterator end() const {
+            return m_values.end();
+        }
+
+        allocator_type get_allocator() const {
+            return m_keys.get_allocator();
+        }
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_SPARSESET_H
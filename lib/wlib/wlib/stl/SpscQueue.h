@@ -0,0 +1,251 @@
+/**
+ * @file SpscQueue.h
+ * @brief Bounded lock-free queue for one producer and one consumer.
+ *
+ * The queue is a ring of slots, a power of two in number, indexed by a
+ * head advanced only by the consumer and a tail advanced only by the
+ * producer. Each side reads the other's index only when its cached copy
+ * says the ring is full or empty, and the two indices sit on separate
+ * cache lines, so in the steady state the threads do not write to the
+ * same line. Batches move many elements for one index update.
+ *
+ * @code spsc_queue @endcode takes its slots from an allocator once, when
+ * constructed; @code static_spsc_queue @endcode keeps them inside the
+ * object. Neither allocates afterwards.
+ *
+ * Exactly one thread may push and exactly one other thread may pop at a
+ * time. Other members may be called by either.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_SPSCQUEUE_H
+#define EMBEDDEDCPLUSPLUS_SPSCQUEUE_H
+
+#include <stddef.h>
+
+#include <wlib/memory>
+#include <wlib/utility>
+#include <wlib/stl/Allocator.h>
+
+namespace wlp {
+
+    /**
+     * Single-producer single-consumer queue.
+     *
+     * @tparam T     element type
+     * @tparam Alloc allocator of the slots, see Allocator.h
+     */
+    template<typename T, typename Alloc = allocator>
+    class spsc_queue : private Alloc {
+    public:
+        typedef T val_type;
+        typedef size_t size_type;
+
+        /**
+         * Allocate the slots.
+         *
+         * @param capacity the least number of elements held, rounded up
+         *                 to a power of two; the capacity is zero if the
+         *                 slots could not be allocated
+         * @param alloc    the allocator
+         */
+        explicit spsc_queue(size_type capacity, const Alloc &alloc = Alloc())
+                : Alloc(alloc),
+                  m_head(0),
+                  m_tail_cache(0),
+                  m_tail(0),
+                  m_head_cache(0),
+                  m_slots(nullptr),
+                  m_capacity(0),
+                  m_owned(true) {
+            size_type n = 1;
+            while (n < capacity) {
+                n <<= 1;
+            }
+            m_slots = static_cast<T *>(this->allocate(n * sizeof(T), alignof(T)));
+            m_capacity = m_slots ? n : 0;
+        }
+
+        spsc_queue(const spsc_queue &) = delete;
+
+        ~spsc_queue() {
+            for (size_type i = m_head; i != m_tail; ++i) {
+                m_slots[i & (m_capacity - 1)].~T();
+            }
+            if (m_owned && m_slots) {
+                this->deallocate(m_slots, m_capacity * sizeof(T), alignof(T));
+            }
+        }
+
+        spsc_queue &operator=(const spsc_queue &) = delete;
+
+        /**
+         * Add an element. Producer only.
+         *
+         * @return false if the queue is full
+         */
+        bool push(const T &val) {
+            return emplace(val);
+        }
+
+        bool push(T &&val) {
+            return emplace(move(val));
+        }
+
+        template<typename... Args>
+        bool emplace(Args &&... args) {
+            size_type tail = m_tail;
+            if (tail - m_head_cache == m_capacity) {
+                m_head_cache = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+                if (tail - m_head_cache == m_capacity) {
+                    return false;
+                }
+            }
+            new (static_cast<void *>(m_slots + (tail & (m_capacity - 1)))) T(forward<Args>(args)...);
+            __atomic_store_n(&m_tail, tail + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        /**
+         * Add as many of the given elements as fit, in order. Producer
+         * only.
+         *
+         * @return the number of elements added
+         */
+        size_type push_n(const T *vals, size_type n) {
+            size_type tail = m_tail;
+            size_type space = m_capacity - (tail - m_head_cache);
+            if (space < n) {
+                m_head_cache = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+                space = m_capacity - (tail - m_head_cache);
+            }
+            n = n < space ? n : space;
+            for (size_type i = 0; i < n; ++i) {
+                new (static_cast<void *>(m_slots + ((tail + i) & (m_capacity - 1)))) T(vals[i]);
+            }
+            if (n > 0) {
+                __atomic_store_n(&m_tail, tail + n, __ATOMIC_RELEASE);
+            }
+            return n;
+        }
+
+        /**
+         * Move the oldest element out. Consumer only.
+         *
+         * @return false if the queue is empty
+         */
+        bool pop(T &val) {
+            size_type head = m_head;
+            if (head == m_tail_cache) {
+                m_tail_cache = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+                if (head == m_tail_cache) {
+                    return false;
+                }
+            }
+            T *slot = m_slots + (head & (m_capacity - 1));
+            val = move(*slot);
+            slot->~T();
+            __atomic_store_n(&m_head, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        /**
+         * Move out up to the given number of the oldest elements, in
+         * order. Consumer only.
+         *
+         * @return the number of elements moved out
+         */
+        size_type pop_n(T *vals, size_type n) {
+            size_type head = m_head;
+            size_type avail = m_tail_cache - head;
+            if (avail < n) {
+                m_tail_cache = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+                avail = m_tail_cache - head;
+            }
+            n = n < avail ? n : avail;
+            for (size_type i = 0; i < n; ++i) {
+                T *slot = m_slots + ((head + i) & (m_capacity - 1));
+                vals[i] = move(*slot);
+                slot->~T();
+            }
+            if (n > 0) {
+                __atomic_store_n(&m_head, head + n, __ATOMIC_RELEASE);
+            }
+            return n;
+        }
+
+        /**
+         * @return the number of elements, which may be out of date by
+         *         the time it is read if the other thread is active
+         */
+        size_type size() const {
+            size_type head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+            return __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE) - head;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        size_type capacity() const {
+            return m_capacity;
+        }
+
+    protected:
+        /**
+         * Use slots owned by a derived class.
+         *
+         * @param slots    storage for the elements
+         * @param capacity number of slots, a power of two
+         */
+        spsc_queue(T *slots, size_type capacity)
+                : m_head(0),
+                  m_tail_cache(0),
+                  m_tail(0),
+                  m_head_cache(0),
+                  m_slots(slots),
+                  m_capacity(capacity),
+                  m_owned(false) {}
+
+    private:
+        /**
+         * Index of the next element to pop, and the consumer's copy of
+         * the tail.
+         */
+        alignas(64) size_type m_head;
+        size_type m_tail_cache;
+        /**
+         * Index of the next slot to push, and the producer's copy of the
+         * head.
+         */
+        alignas(64) size_type m_tail;
+        size_type m_head_cache;
+        alignas(64) T *m_slots;
+        size_type m_capacity;
+        bool m_owned;
+    };
+
+    /**
+     * Single-producer single-consumer queue with its slots inside the
+     * object.
+     *
+     * @tparam T         element type
+     * @tparam tCapacity number of elements held, a power of two
+     */
+    template<typename T, size_t tCapacity>
+    class static_spsc_queue : public spsc_queue<T> {
+        static_assert(tCapacity > 0 && (tCapacity & (tCapacity - 1)) == 0,
+                      "capacity must be a power of two");
+
+    public:
+        static_spsc_queue()
+                : spsc_queue<T>(reinterpret_cast<T *>(m_storage), tCapacity) {}
+
+    private:
+        alignas(T) unsigned char m_storage[tCapacity * sizeof(T)];
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_SPSCQUEUE_H
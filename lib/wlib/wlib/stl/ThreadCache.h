@@ -0,0 +1,385 @@
+/**
+ * @file ThreadCache.h
+ * @brief Per-thread caching front end for the wlib memory pool.
+ *
+ * The memory pool behind @code mem::alloc @endcode is one heap shared
+ * by every thread. The thread cache keeps, for each thread, free lists
+ * of small blocks sorted into size classes, so that most allocations
+ * and frees touch only the calling thread's lists. A thread that runs
+ * out of blocks of a class refills a batch from a central list, which
+ * in turn carves new blocks out of spans from the pool; a thread whose
+ * list grows too long flushes a batch back to the central list.
+ *
+ * Blocks do not belong to the thread that allocated them. A block
+ * freed by another thread joins that thread's cache and reaches the
+ * allocating thread again through the central list, so producer and
+ * consumer threads need no special handling. A thread's cache is
+ * flushed to the central lists when the thread exits.
+ *
+ * Requests larger than the largest size class, and all calls into
+ * the pool, are serialised by one lock, since the pool itself need
+ * not be thread-safe. Spans carved into small blocks are kept by the
+ * cache for reuse and are never returned to the pool.
+ *
+ * The cache needs the size of a block when it is freed, which the
+ * allocator concept of Allocator.h provides. Building with
+ * @code WLIB_THREAD_CACHE @endcode routes the default allocator
+ * through the cache; it can otherwise be used explicitly through
+ * @code thread_cache_allocator @endcode.
+ *
+ * The lock only covers calls made through the cache. Code that calls
+ * @code mem::alloc @endcode, @code mem::free @endcode, @code create @endcode
+ * or @code destroy @endcode directly bypasses it, so the cache is safe
+ * with several threads only if every thread allocating from the pool
+ * does so through an allocator.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_THREADCACHE_H
+#define EMBEDDEDCPLUSPLUS_THREADCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <wlib/memory>
+
+namespace wlp {
+
+    /**
+     * Lock that spins, for short critical sections.
+     */
+    class spin_lock {
+    public:
+        constexpr spin_lock()
+                : m_locked(false) {}
+
+        void lock() {
+            while (__atomic_exchange_n(&m_locked, true, __ATOMIC_ACQUIRE)) {
+                while (__atomic_load_n(&m_locked, __ATOMIC_RELAXED)) {
+#if defined(__x86_64__) || defined(__i386__)
+                    __builtin_ia32_pause();
+#endif
+                }
+            }
+        }
+
+        void unlock() {
+            __atomic_store_n(&m_locked, false, __ATOMIC_RELEASE);
+        }
+
+    private:
+        bool m_locked;
+    };
+
+    /**
+     * Holds a lock for the duration of a scope.
+     */
+    template<typename Lock>
+    class lock_guard {
+    public:
+        explicit lock_guard(Lock &lock)
+                : m_lock(lock) {
+            m_lock.lock();
+        }
+
+        ~lock_guard() {
+            m_lock.unlock();
+        }
+
+    private:
+        Lock &m_lock;
+
+        lock_guard(const lock_guard &) = delete;
+
+        lock_guard &operator=(const lock_guard &) = delete;
+    };
+
+    namespace __thread_cache {
+
+        constexpr size_t num_classes = 12;
+        constexpr size_t max_size = 1024;
+        constexpr size_t span_size = 16384;
+
+        /**
+         * Block size of each class. Every size is a multiple of 16,
+         * so blocks are aligned for any fundamental type.
+         */
+        constexpr size_t class_size[num_classes] = {
+                16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024
+        };
+
+        /**
+         * @return the smallest class holding @code size @endcode bytes,
+         *         where @code size <= max_size @endcode
+         */
+        inline size_t class_of(size_t size) {
+            size_t c = 0;
+            while (class_size[c] < size) {
+                ++c;
+            }
+            return c;
+        }
+
+        /**
+         * Number of blocks moved between a thread and the central list
+         * at once, about 4 KiB worth but at least 4.
+         */
+        inline size_t batch_of(size_t c) {
+            size_t n = 4096 / class_size[c];
+            return n < 4 ? 4 : n;
+        }
+
+        struct free_block {
+            free_block *m_next;
+        };
+
+        /**
+         * Free blocks of one class shared by all threads.
+         */
+        struct central_list {
+            constexpr central_list()
+                    : m_lock(),
+                      m_head(nullptr),
+                      m_span_cur(nullptr),
+                      m_span_end(nullptr) {}
+
+            spin_lock m_lock;
+            free_block *m_head;
+            /**
+             * Unused tail of the current span.
+             */
+            char *m_span_cur;
+            char *m_span_end;
+        };
+
+        /**
+         * Process-wide state. A template so that the header can define
+         * it; every member is constant-initialised before any thread
+         * starts.
+         */
+        template<typename = void>
+        struct central {
+            static central_list lists[num_classes];
+            static spin_lock pool_lock;
+        };
+
+        template<typename V>
+        central_list central<V>::lists[num_classes];
+
+        template<typename V>
+        spin_lock central<V>::pool_lock;
+
+        inline void *pool_alloc(size_t size) {
+            lock_guard<spin_lock> guard(central<>::pool_lock);
+            return mem::alloc(size);
+        }
+
+        inline void pool_free(void *ptr) {
+            lock_guard<spin_lock> guard(central<>::pool_lock);
+            mem::free(ptr);
+        }
+
+        /**
+         * Allocate from the pool with an alignment stricter than 16,
+         * storing the pointer from the pool just before the block.
+         */
+        inline void *pool_alloc_aligned(size_t size, size_t align) {
+            void *raw = pool_alloc(size + align + sizeof(void *));
+            if (!raw) {
+                return nullptr;
+            }
+            uintptr_t addr = reinterpret_cast<uintptr_t>(raw) + sizeof(void *);
+            addr = (addr + align - 1) & ~static_cast<uintptr_t>(align - 1);
+            void **aligned = reinterpret_cast<void **>(addr);
+            aligned[-1] = raw;
+            return aligned;
+        }
+
+        inline void pool_free_aligned(void *ptr) {
+            pool_free(static_cast<void **>(ptr)[-1]);
+        }
+
+        /**
+         * Take up to @code n @endcode blocks of class @code c @endcode
+         * from the central list, carving a new span if it is empty.
+         *
+         * @return the blocks as a list, or null if the pool is exhausted
+         */
+        inline free_block *central_take(size_t c, size_t n, size_t &taken) {
+            central_list &list = central<>::lists[c];
+            size_t size = class_size[c];
+            lock_guard<spin_lock> guard(list.m_lock);
+            free_block *head = nullptr;
+            taken = 0;
+            while (taken < n && list.m_head) {
+                free_block *b = list.m_head;
+                list.m_head = b->m_next;
+                b->m_next = head;
+                head = b;
+                ++taken;
+            }
+            while (taken < n) {
+                if (!list.m_span_cur || list.m_span_cur + size > list.m_span_end) {
+                    char *span = static_cast<char *>(pool_alloc(span_size));
+                    if (!span) {
+                        break;
+                    }
+                    list.m_span_cur = span;
+                    list.m_span_end = span + span_size;
+                }
+                free_block *b = reinterpret_cast<free_block *>(list.m_span_cur);
+                list.m_span_cur += size;
+                b->m_next = head;
+                head = b;
+                ++taken;
+            }
+            return head;
+        }
+
+        /**
+         * Give a list of blocks of class @code c @endcode back to the
+         * central list.
+         */
+        inline void central_give(size_t c, free_block *head, free_block *tail) {
+            central_list &list = central<>::lists[c];
+            lock_guard<spin_lock> guard(list.m_lock);
+            tail->m_next = list.m_head;
+            list.m_head = head;
+        }
+
+        /**
+         * Free lists of one thread.
+         */
+        class cache {
+        public:
+            constexpr cache()
+                    : m_head{},
+                      m_count{} {}
+
+            ~cache() {
+                for (size_t c = 0; c < num_classes; ++c) {
+                    flush(c, m_count[c]);
+                }
+            }
+
+            void *allocate(size_t c) {
+                free_block *b = m_head[c];
+                if (!b) {
+                    size_t taken;
+                    b = central_take(c, batch_of(c), taken);
+                    if (!b) {
+                        return nullptr;
+                    }
+                    m_count[c] = taken;
+                }
+                m_head[c] = b->m_next;
+                --m_count[c];
+                return b;
+            }
+
+            void deallocate(void *ptr, size_t c) {
+                free_block *b = static_cast<free_block *>(ptr);
+                b->m_next = m_head[c];
+                m_head[c] = b;
+                if (++m_count[c] >= 2 * batch_of(c)) {
+                    flush(c, batch_of(c));
+                }
+            }
+
+        private:
+            /**
+             * Move the first @code n @endcode blocks of class @code c @endcode
+             * to the central list.
+             */
+            void flush(size_t c, size_t n) {
+                if (n == 0) {
+                    return;
+                }
+                free_block *head = m_head[c];
+                free_block *tail = head;
+                for (size_t i = 1; i < n; ++i) {
+                    tail = tail->m_next;
+                }
+                m_head[c] = tail->m_next;
+                m_count[c] -= n;
+                central_give(c, head, tail);
+            }
+
+            free_block *m_head[num_classes];
+            size_t m_count[num_classes];
+        };
+
+        inline cache &local() {
+            static thread_local cache c;
+            return c;
+        }
+
+    }
+
+    /**
+     * Allocate from the calling thread's cache.
+     *
+     * @param size number of bytes
+     * @return memory aligned for any fundamental type, or null
+     */
+    inline void *thread_cache_alloc(size_t size) {
+        if (size > __thread_cache::max_size) {
+            return __thread_cache::pool_alloc(size);
+        }
+        return __thread_cache::local().allocate(__thread_cache::class_of(size));
+    }
+
+    /**
+     * Free memory from @code thread_cache_alloc @endcode, from any
+     * thread. Null pointers are ignored.
+     *
+     * @param ptr  the memory
+     * @param size the size it was allocated with
+     */
+    inline void thread_cache_free(void *ptr, size_t size) {
+        if (!ptr) {
+            return;
+        }
+        if (size > __thread_cache::max_size) {
+            __thread_cache::pool_free(ptr);
+            return;
+        }
+        __thread_cache::local().deallocate(ptr, __thread_cache::class_of(size));
+    }
+
+    /**
+     * Stateless allocator over the thread cache. Requests aligned
+     * beyond 16 bytes bypass the cache and go to the pool under its
+     * lock.
+     */
+    struct thread_cache_allocator {
+        static constexpr size_t cache_alignment = 16;
+
+        void *allocate(size_t size, size_t align) const {
+            if (align > cache_alignment) {
+                return __thread_cache::pool_alloc_aligned(size, align);
+            }
+            return thread_cache_alloc(size);
+        }
+
+        void deallocate(void *ptr, size_t size, size_t align) const {
+            if (ptr && align > cache_alignment) {
+                __thread_cache::pool_free_aligned(ptr);
+                return;
+            }
+            thread_cache_free(ptr, size);
+        }
+
+        bool operator==(const thread_cache_allocator &) const {
+            return true;
+        }
+
+        bool operator!=(const thread_cache_allocator &) const {
+            return false;
+        }
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_THREADCACHE_H
@@ -0,0 +1,950 @@
+/**
+ * @file ThreadPool.h
+ * @brief Work-stealing thread pool for POSIX hosts.
+ *
+ * Each worker thread owns a Chase-Lev deque. Tasks spawned by a worker
+ * go to the bottom of its own deque and are taken back from there, most
+ * recent first, while idle workers steal the oldest tasks from the top
+ * of other deques. Tasks submitted from other threads go through a
+ * shared queue. A thread waiting for a task inside the pool runs other
+ * tasks in the meantime, so that fork-join code never blocks a worker.
+ *
+ * Submitting does not allocate. Callables are stored inline in a
+ * @code task @endcode, and the state shared with a @code future @endcode
+ * is a job taken from a fixed set made when the pool is created; when
+ * every job is in use, the submitting thread waits for one to be freed,
+ * helping with the work if it is a worker. A job is freed once it has
+ * run and its future is gone, so the pool needs more jobs than the
+ * futures that waiting tasks hold at once. Jobs of
+ * @code parallel_invoke @endcode live on the stack of the caller.
+ *
+ * Futures must not outlive their pool. Destroying the pool runs every
+ * task already queued, including tasks those spawn, before the workers
+ * exit. A pool whose threads could not be started has no workers and
+ * runs each task when it is submitted. A pool that could not allocate
+ * its jobs has no workers either, and returns futures that are not
+ * valid without running their tasks.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_THREADPOOL_H
+#define EMBEDDEDCPLUSPLUS_THREADPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <wlib/memory>
+#include <wlib/type_traits>
+#include <wlib/utility>
+#include <wlib/stl/Allocator.h>
+
+namespace wlp {
+
+    /**
+     * Move-only callable taking no arguments, stored inline. A callable
+     * larger than the capacity does not compile.
+     */
+    class task {
+    public:
+        static constexpr size_t capacity = 8 * sizeof(void *);
+
+        task()
+                : m_ops(nullptr) {}
+
+        template<typename F, typename = typename enable_if<
+                !is_same<typename decay<F>::type, task>::value>::type>
+        task(F &&f)
+                : m_ops(&ops_of<typename decay<F>::type>::ops) {
+            typedef typename decay<F>::type Fn;
+            static_assert(sizeof(Fn) <= capacity, "callable is too large for a task");
+            static_assert(alignof(Fn) <= alignof(max_align_t), "callable is over-aligned for a task");
+            new (static_cast<void *>(m_storage)) Fn(forward<F>(f));
+        }
+
+        task(task &&t)
+                : m_ops(t.m_ops) {
+            if (m_ops) {
+                m_ops->relocate(m_storage, t.m_storage);
+                t.m_ops = nullptr;
+            }
+        }
+
+        task(const task &) = delete;
+
+        ~task() {
+            reset();
+        }
+
+        task &operator=(task &&t) {
+            if (this != &t) {
+                reset();
+                m_ops = t.m_ops;
+                if (m_ops) {
+                    m_ops->relocate(m_storage, t.m_storage);
+                    t.m_ops = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        task &operator=(const task &) = delete;
+
+        void operator()() {
+            m_ops->invoke(m_storage);
+        }
+
+        explicit operator bool() const {
+            return m_ops != nullptr;
+        }
+
+        /**
+         * Destroy the callable, leaving the task empty.
+         */
+        void reset() {
+            if (m_ops) {
+                m_ops->destroy(m_storage);
+                m_ops = nullptr;
+            }
+        }
+
+    private:
+        struct operations {
+            void (*invoke)(void *);
+            /**
+             * Move the callable to new storage and destroy the old one.
+             */
+            void (*relocate)(void *, void *);
+            void (*destroy)(void *);
+        };
+
+        template<typename Fn>
+        struct ops_of {
+            static void invoke(void *fn) {
+                (*static_cast<Fn *>(fn))();
+            }
+
+            static void relocate(void *to, void *from) {
+                new (to) Fn(move(*static_cast<Fn *>(from)));
+                static_cast<Fn *>(from)->~Fn();
+            }
+
+            static void destroy(void *fn) {
+                static_cast<Fn *>(fn)->~Fn();
+            }
+
+            static const operations ops;
+        };
+
+        const operations *m_ops;
+        alignas(max_align_t) unsigned char m_storage[capacity];
+    };
+
+    template<typename Fn>
+    const task::operations task::ops_of<Fn>::ops = {
+            &task::ops_of<Fn>::invoke,
+            &task::ops_of<Fn>::relocate,
+            &task::ops_of<Fn>::destroy
+    };
+
+    class thread_pool;
+
+    namespace __thread_pool {
+
+        static constexpr uint32_t no_index = static_cast<uint32_t>(-1);
+
+        /**
+         * Bytes of a task result kept in its job.
+         */
+        static constexpr size_t result_capacity = 4 * sizeof(void *);
+
+        /**
+         * A task and the state shared with its future.
+         */
+        struct job {
+            task fn;
+            uint32_t done;
+            /**
+             * References from the future and from the pool, for jobs
+             * of the fixed set, which return to the free list at zero.
+             */
+            uint32_t refs;
+            uint32_t index;
+            uint32_t next_free;
+            void (*destroy_result)(void *);
+            alignas(max_align_t) unsigned char result[result_capacity];
+
+            job()
+                    : done(0),
+                      refs(0),
+                      index(no_index),
+                      next_free(0),
+                      destroy_result(nullptr) {}
+        };
+
+        template<typename R>
+        void destroy_result(void *result) {
+            static_cast<R *>(result)->~R();
+        }
+
+        /**
+         * Runs a callable and stores its result in the job.
+         */
+        template<typename R, typename Fn>
+        struct invoker {
+            static_assert(sizeof(R) <= result_capacity, "task result is too large for a future");
+            static_assert(alignof(R) <= alignof(max_align_t), "task result is over-aligned for a future");
+
+            Fn fn;
+            job *j;
+
+            void operator()() {
+                new (static_cast<void *>(j->result)) R(fn());
+                j->destroy_result = &destroy_result<R>;
+            }
+        };
+
+        template<typename Fn>
+        struct invoker<void, Fn> {
+            Fn fn;
+            job *j;
+
+            void operator()() {
+                fn();
+            }
+        };
+
+        /**
+         * Runs a callable that outlives the task.
+         */
+        template<typename Fn>
+        struct ref_invoker {
+            Fn *fn;
+
+            void operator()() {
+                (*fn)();
+            }
+        };
+
+        /**
+         * Chase-Lev deque of a fixed capacity, a power of two. Only the
+         * owner pushes and takes at the bottom; any thread steals at
+         * the top.
+         */
+        class work_deque {
+        public:
+            work_deque()
+                    : m_top(0),
+                      m_bottom(0),
+                      m_buffer(nullptr),
+                      m_mask(0) {}
+
+            void init(job **buffer, size_t capacity) {
+                m_buffer = buffer;
+                m_mask = static_cast<int64_t>(capacity - 1);
+            }
+
+            /**
+             * @return false if the deque is full
+             */
+            bool push(job *j) {
+                int64_t b = __atomic_load_n(&m_bottom, __ATOMIC_RELAXED);
+                int64_t t = __atomic_load_n(&m_top, __ATOMIC_ACQUIRE);
+                if (b - t > m_mask) {
+                    return false;
+                }
+                __atomic_store_n(&m_buffer[b & m_mask], j, __ATOMIC_RELAXED);
+                __atomic_thread_fence(__ATOMIC_RELEASE);
+                __atomic_store_n(&m_bottom, b + 1, __ATOMIC_RELAXED);
+                return true;
+            }
+
+            /**
+             * @return the most recently pushed job, or null
+             */
+            job *take() {
+                int64_t b = __atomic_load_n(&m_bottom, __ATOMIC_RELAXED) - 1;
+                __atomic_store_n(&m_bottom, b, __ATOMIC_RELAXED);
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+                int64_t t = __atomic_load_n(&m_top, __ATOMIC_RELAXED);
+                if (t > b) {
+                    __atomic_store_n(&m_bottom, b + 1, __ATOMIC_RELAXED);
+                    return nullptr;
+                }
+                job *j = __atomic_load_n(&m_buffer[b & m_mask], __ATOMIC_RELAXED);
+                if (t == b) {
+                    if (!__atomic_compare_exchange_n(&m_top, &t, t + 1, false,
+                                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                        j = nullptr;
+                    }
+                    __atomic_store_n(&m_bottom, b + 1, __ATOMIC_RELAXED);
+                }
+                return j;
+            }
+
+            /**
+             * @return the oldest job, or null if the deque is empty or
+             *         another thread took it first
+             */
+            job *steal() {
+                int64_t t = __atomic_load_n(&m_top, __ATOMIC_ACQUIRE);
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+                int64_t b = __atomic_load_n(&m_bottom, __ATOMIC_ACQUIRE);
+                if (t >= b) {
+                    return nullptr;
+                }
+                job *j = __atomic_load_n(&m_buffer[t & m_mask], __ATOMIC_RELAXED);
+                if (!__atomic_compare_exchange_n(&m_top, &t, t + 1, false,
+                                                 __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                    return nullptr;
+                }
+                return j;
+            }
+
+        private:
+            /**
+             * The ends are written by different threads, so they are
+             * kept on separate cache lines.
+             */
+            alignas(64) int64_t m_top;
+            alignas(64) int64_t m_bottom;
+            alignas(64) job **m_buffer;
+            int64_t m_mask;
+        };
+
+        struct worker {
+            thread_pool *pool;
+            size_t id;
+            uint32_t rng;
+            pthread_t thread;
+            work_deque deque;
+        };
+
+        /**
+         * Worker of the calling thread, a template so that the header
+         * can define it.
+         */
+        template<typename = void>
+        struct registry {
+            static thread_local worker *current;
+        };
+
+        template<typename V>
+        thread_local worker *registry<V>::current = nullptr;
+
+        inline size_t round_up_pow2(size_t n) {
+            size_t p = 1;
+            while (p < n) {
+                p <<= 1;
+            }
+            return p;
+        }
+
+    }
+
+    /**
+     * Handle to the result of a task.
+     *
+     * @tparam T the result type
+     */
+    template<typename T>
+    class future;
+
+    template<typename T>
+    class basic_future {
+    public:
+        basic_future()
+                : m_pool(nullptr),
+                  m_job(nullptr) {}
+
+        basic_future(basic_future &&f)
+                : m_pool(f.m_pool),
+                  m_job(f.m_job) {
+            f.m_job = nullptr;
+        }
+
+        basic_future(const basic_future &) = delete;
+
+        ~basic_future();
+
+        basic_future &operator=(basic_future &&f);
+
+        basic_future &operator=(const basic_future &) = delete;
+
+        /**
+         * @return true if the future refers to a task
+         */
+        bool valid() const {
+            return m_job != nullptr;
+        }
+
+        /**
+         * @return true if the task has finished
+         */
+        bool ready() const {
+            return __atomic_load_n(&m_job->done, __ATOMIC_ACQUIRE) != 0;
+        }
+
+        /**
+         * Wait for the task to finish, running other tasks meanwhile if
+         * called from a worker.
+         */
+        void wait() const;
+
+    protected:
+        basic_future(thread_pool *pool, __thread_pool::job *j)
+                : m_pool(pool),
+                  m_job(j) {}
+
+        thread_pool *m_pool;
+        __thread_pool::job *m_job;
+
+        friend class thread_pool;
+    };
+
+    template<typename T>
+    class future : public basic_future<T> {
+    public:
+        future() = default;
+
+        /**
+         * Wait for the task and move its result out. May be called once.
+         */
+        T get() {
+            this->wait();
+            return move(*reinterpret_cast<T *>(this->m_job->result));
+        }
+
+    private:
+        future(thread_pool *pool, __thread_pool::job *j)
+                : basic_future<T>(pool, j) {}
+
+        friend class thread_pool;
+    };
+
+    template<>
+    class future<void> : public basic_future<void> {
+    public:
+        future() = default;
+
+        void get() {
+            wait();
+        }
+
+    private:
+        future(thread_pool *pool, __thread_pool::job *j)
+                : basic_future<void>(pool, j) {}
+
+        friend class thread_pool;
+    };
+
+    class thread_pool {
+        typedef __thread_pool::job job;
+        typedef __thread_pool::worker worker;
+
+    public:
+        /**
+         * Start the workers.
+         *
+         * @param threads number of workers, or zero for one per
+         *                online processor
+         * @param jobs    number of tasks with futures that may be
+         *                queued or unclaimed at once
+         * @param deque   capacity of each worker's deque; a task that
+         *                does not fit is run by the thread spawning it
+         */
+        explicit thread_pool(size_t threads = 0, size_t jobs = 1024, size_t deque = 1024);
+
+        thread_pool(const thread_pool &) = delete;
+
+        ~thread_pool();
+
+        thread_pool &operator=(const thread_pool &) = delete;
+
+        /**
+         * @return the number of workers
+         */
+        size_t size() const {
+            return m_num_workers;
+        }
+
+        /**
+         * Queue a task from any thread, to be run in roughly the order
+         * of submission.
+         *
+         * @return a future for the result of the task, which is not
+         *         valid if the pool could not allocate its jobs
+         */
+        template<typename F>
+        future<decltype(declval<typename decay<F>::type &>()())> submit(F &&f) {
+            return enqueue(forward<F>(f), false);
+        }
+
+        /**
+         * Queue a task on the deque of the calling worker, where it runs
+         * before older tasks unless stolen. Outside the pool this is the
+         * same as @code submit @endcode.
+         *
+         * @return a future for the result of the task, which is not
+         *         valid if the pool could not allocate its jobs
+         */
+        template<typename F>
+        future<decltype(declval<typename decay<F>::type &>()())> spawn(F &&f) {
+            return enqueue(forward<F>(f), true);
+        }
+
+        /**
+         * Run callables in parallel and return when all have finished.
+         * The first runs on the calling thread.
+         */
+        template<typename F>
+        void parallel_invoke(F &&f) {
+            f();
+        }
+
+        template<typename F, typename... Fs>
+        void parallel_invoke(F &&f, Fs &&... fs);
+
+        /**
+         * Run one queued task on the calling worker.
+         *
+         * @return false if called outside the pool or no task was found
+         */
+        bool run_one();
+
+        /**
+         * @return the pool of the calling worker, or null
+         */
+        static thread_pool *current() {
+            worker *w = __thread_pool::registry<>::current;
+            return w ? w->pool : nullptr;
+        }
+
+    protected:
+        /**
+         * Set the sizes, leaving the storage to @code start @endcode.
+         */
+        thread_pool(size_t threads, size_t jobs, size_t deque, bool);
+
+        /**
+         * Allocate the jobs, queues and workers and start the threads.
+         * Jobs are usable as soon as they are allocated; workers are
+         * started only if everything could be allocated.
+         */
+        template<typename Alloc>
+        void start(Alloc &alloc);
+
+        /**
+         * Join the workers and free what @code start @endcode allocated
+         * with the same allocator. Calling it again does nothing.
+         */
+        template<typename Alloc>
+        void stop(Alloc &alloc);
+
+    private:
+        template<typename F>
+        future<decltype(declval<typename decay<F>::type &>()())> enqueue(F &&f, bool local);
+
+        template<typename Fn>
+        void prepare(job &j, Fn &fn) {
+            j.fn = __thread_pool::ref_invoker<Fn>{&fn};
+            j.done = 0;
+        }
+
+        worker *local_worker() const {
+            worker *w = __thread_pool::registry<>::current;
+            return w && w->pool == this ? w : nullptr;
+        }
+
+        job *acquire_job();
+        void release_job(job *j);
+        void push(job *j, bool local);
+        void run_job(job *j);
+        job *find_work(worker *w);
+        job *pop_injected();
+        void wait_for(const job *j);
+        void work(worker *w);
+
+        static void *thread_main(void *arg);
+
+        allocator m_alloc;
+        worker *m_workers;
+        size_t m_threads;
+        size_t m_num_workers;
+        job *m_jobs;
+        size_t m_num_jobs;
+        job **m_deque_buffers;
+        size_t m_deque_capacity;
+        /**
+         * Free jobs, as the index plus one of the first, tagged with a
+         * count in the high half against reuse races.
+         */
+        uint64_t m_free_head;
+        /**
+         * Tasks queued and not yet taken by a thread.
+         */
+        size_t m_pending;
+        size_t m_sleeping;
+        bool m_stop;
+        pthread_mutex_t m_mutex;
+        pthread_cond_t m_wake;
+        /**
+         * Ring of tasks submitted from outside the workers.
+         */
+        job **m_injected;
+        size_t m_injected_capacity;
+        size_t m_injected_head;
+        size_t m_injected_size;
+
+        template<typename T>
+        friend class basic_future;
+    };
+
+    /**
+     * Thread pool taking its jobs, queues and workers from the given
+     * allocator rather than the default one.
+     *
+     * @tparam Alloc allocator of the pool's storage, see Allocator.h
+     */
+    template<typename Alloc>
+    class basic_thread_pool : private Alloc, public thread_pool {
+    public:
+        explicit basic_thread_pool(size_t threads = 0, size_t jobs = 1024, size_t deque = 1024,
+                                   const Alloc &alloc = Alloc())
+                : Alloc(alloc),
+                  thread_pool(threads, jobs, deque, false) {
+            start(static_cast<Alloc &>(*this));
+        }
+
+        ~basic_thread_pool() {
+            stop(static_cast<Alloc &>(*this));
+        }
+    };
+
+    template<typename T>
+    basic_future<T>::~basic_future() {
+        if (m_job) {
+            m_pool->release_job(m_job);
+        }
+    }
+
+    template<typename T>
+    basic_future<T> &basic_future<T>::operator=(basic_future &&f) {
+        if (this != &f) {
+            if (m_job) {
+                m_pool->release_job(m_job);
+            }
+            m_pool = f.m_pool;
+            m_job = f.m_job;
+            f.m_job = nullptr;
+        }
+        return *this;
+    }
+
+    template<typename T>
+    void basic_future<T>::wait() const {
+        m_pool->wait_for(m_job);
+    }
+
+    inline thread_pool::thread_pool(size_t threads, size_t jobs, size_t deque)
+            : thread_pool(threads, jobs, deque, false) {
+        start(m_alloc);
+    }
+
+    inline thread_pool::thread_pool(size_t threads, size_t jobs, size_t deque, bool)
+            : m_workers(nullptr),
+              m_threads(threads),
+              m_num_workers(0),
+              m_jobs(nullptr),
+              m_num_jobs(jobs > 0 ? jobs : 1),
+              m_deque_buffers(nullptr),
+              m_deque_capacity(__thread_pool::round_up_pow2(deque > 1 ? deque : 2)),
+              m_free_head(0),
+              m_pending(0),
+              m_sleeping(0),
+              m_stop(false),
+              m_injected(nullptr),
+              m_injected_capacity(jobs > 0 ? jobs : 1),
+              m_injected_head(0),
+              m_injected_size(0) {
+        pthread_mutex_init(&m_mutex, nullptr);
+        pthread_cond_init(&m_wake, nullptr);
+        if (m_threads == 0) {
+            long online = sysconf(_SC_NPROCESSORS_ONLN);
+            m_threads = online > 0 ? static_cast<size_t>(online) : 1;
+        }
+    }
+
+    template<typename Alloc>
+    void thread_pool::start(Alloc &alloc) {
+        m_jobs = alloc_create_array<job>(alloc, m_num_jobs);
+        if (!m_jobs) {
+            return;
+        }
+        for (size_t i = m_num_jobs; i > 0; --i) {
+            m_jobs[i - 1].index = static_cast<uint32_t>(i - 1);
+            m_jobs[i - 1].refs = 1;
+            release_job(&m_jobs[i - 1]);
+        }
+        m_injected = alloc_create_array<job *>(alloc, m_injected_capacity);
+        m_workers = alloc_create_array<worker>(alloc, m_threads);
+        m_deque_buffers = alloc_create_array<job *>(alloc, m_threads * m_deque_capacity);
+        if (!m_injected || !m_workers || !m_deque_buffers) {
+            return;
+        }
+        for (size_t i = 0; i < m_threads; ++i) {
+            worker &w = m_workers[i];
+            w.pool = this;
+            w.id = i;
+            w.rng = static_cast<uint32_t>(2654435761u * (i + 1));
+            w.deque.init(m_deque_buffers + i * m_deque_capacity, m_deque_capacity);
+        }
+        for (size_t i = 0; i < m_threads; ++i) {
+            if (pthread_create(&m_workers[i].thread, nullptr, &thread_main, &m_workers[i]) != 0) {
+                break;
+            }
+            ++m_num_workers;
+        }
+    }
+
+    inline thread_pool::~thread_pool() {
+        stop(m_alloc);
+        pthread_cond_destroy(&m_wake);
+        pthread_mutex_destroy(&m_mutex);
+    }
+
+    template<typename Alloc>
+    void thread_pool::stop(Alloc &alloc) {
+        pthread_mutex_lock(&m_mutex);
+        __atomic_store_n(&m_stop, true, __ATOMIC_SEQ_CST);
+        pthread_cond_broadcast(&m_wake);
+        pthread_mutex_unlock(&m_mutex);
+        for (size_t i = 0; i < m_num_workers; ++i) {
+            pthread_join(m_workers[i].thread, nullptr);
+        }
+        m_num_workers = 0;
+        alloc_destroy_array(alloc, m_deque_buffers, m_threads * m_deque_capacity);
+        alloc_destroy_array(alloc, m_workers, m_threads);
+        alloc_destroy_array(alloc, m_injected, m_injected_capacity);
+        alloc_destroy_array(alloc, m_jobs, m_num_jobs);
+        m_deque_buffers = nullptr;
+        m_workers = nullptr;
+        m_injected = nullptr;
+        m_jobs = nullptr;
+    }
+
+    template<typename F>
+    future<decltype(declval<typename decay<F>::type &>()())> thread_pool::enqueue(F &&f, bool local) {
+        typedef typename decay<F>::type Fn;
+        typedef decltype(declval<Fn &>()()) R;
+        job *j = acquire_job();
+        if (!j) {
+            return future<R>();
+        }
+        j->fn = __thread_pool::invoker<R, Fn>{forward<F>(f), j};
+        j->destroy_result = nullptr;
+        __atomic_store_n(&j->done, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&j->refs, 2, __ATOMIC_RELAXED);
+        push(j, local);
+        return future<R>(this, j);
+    }
+
+    template<typename F, typename... Fs>
+    void thread_pool::parallel_invoke(F &&f, Fs &&... fs) {
+        job jobs[sizeof...(Fs)];
+        size_t i = 0;
+        int expand[] = {(prepare(jobs[i++], fs), 0)...};
+        (void) expand;
+        for (i = 0; i < sizeof...(Fs); ++i) {
+            push(&jobs[i], true);
+        }
+        f();
+        for (i = sizeof...(Fs); i > 0; --i) {
+            wait_for(&jobs[i - 1]);
+        }
+    }
+
+    inline bool thread_pool::run_one() {
+        worker *w = local_worker();
+        job *j = w ? find_work(w) : nullptr;
+        if (!j) {
+            return false;
+        }
+        run_job(j);
+        return true;
+    }
+
+    inline __thread_pool::job *thread_pool::acquire_job() {
+        if (!m_jobs) {
+            return nullptr;
+        }
+        for (;;) {
+            uint64_t head = __atomic_load_n(&m_free_head, __ATOMIC_ACQUIRE);
+            while (static_cast<uint32_t>(head) != 0) {
+                job *j = &m_jobs[static_cast<uint32_t>(head) - 1];
+                uint32_t next = __atomic_load_n(&j->next_free, __ATOMIC_RELAXED);
+                uint64_t tagged = ((head >> 32) + 1) << 32 | next;
+                if (__atomic_compare_exchange_n(&m_free_head, &head, tagged, true,
+                                                __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+                    return j;
+                }
+            }
+            if (!run_one()) {
+                sched_yield();
+            }
+        }
+    }
+
+    inline void thread_pool::release_job(job *j) {
+        if (j->index == __thread_pool::no_index ||
+            __atomic_sub_fetch(&j->refs, 1, __ATOMIC_ACQ_REL) > 0) {
+            return;
+        }
+        if (j->destroy_result) {
+            j->destroy_result(j->result);
+            j->destroy_result = nullptr;
+        }
+        uint64_t head = __atomic_load_n(&m_free_head, __ATOMIC_RELAXED);
+        uint64_t tagged;
+        do {
+            __atomic_store_n(&j->next_free, static_cast<uint32_t>(head), __ATOMIC_RELAXED);
+            tagged = ((head >> 32) + 1) << 32 | (j->index + 1);
+        } while (!__atomic_compare_exchange_n(&m_free_head, &head, tagged, true,
+                                              __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+
+    inline void thread_pool::push(job *j, bool local) {
+        if (m_num_workers == 0) {
+            run_job(j);
+            return;
+        }
+        worker *w = local ? local_worker() : nullptr;
+        __atomic_add_fetch(&m_pending, 1, __ATOMIC_SEQ_CST);
+        bool queued;
+        if (w) {
+            queued = w->deque.push(j);
+        } else {
+            pthread_mutex_lock(&m_mutex);
+            queued = m_injected_size < m_injected_capacity;
+            if (queued) {
+                m_injected[(m_injected_head + m_injected_size) % m_injected_capacity] = j;
+                __atomic_store_n(&m_injected_size, m_injected_size + 1, __ATOMIC_RELAXED);
+            }
+            pthread_mutex_unlock(&m_mutex);
+        }
+        if (!queued) {
+            __atomic_sub_fetch(&m_pending, 1, __ATOMIC_SEQ_CST);
+            run_job(j);
+            return;
+        }
+        if (__atomic_load_n(&m_sleeping, __ATOMIC_SEQ_CST) > 0) {
+            pthread_mutex_lock(&m_mutex);
+            pthread_cond_signal(&m_wake);
+            pthread_mutex_unlock(&m_mutex);
+        }
+    }
+
+    inline void thread_pool::run_job(job *j) {
+        j->fn();
+        j->fn.reset();
+        // a job on the stack of its waiter may be gone once it is done
+        bool pooled = j->index != __thread_pool::no_index;
+        __atomic_store_n(&j->done, 1, __ATOMIC_RELEASE);
+        if (pooled) {
+            release_job(j);
+        }
+    }
+
+    inline __thread_pool::job *thread_pool::pop_injected() {
+        if (__atomic_load_n(&m_injected_size, __ATOMIC_RELAXED) == 0) {
+            return nullptr;
+        }
+        job *j = nullptr;
+        pthread_mutex_lock(&m_mutex);
+        if (m_injected_size > 0) {
+            j = m_injected[m_injected_head];
+            m_injected_head = (m_injected_head + 1) % m_injected_capacity;
+            __atomic_store_n(&m_injected_size, m_injected_size - 1, __ATOMIC_RELAXED);
+        }
+        pthread_mutex_unlock(&m_mutex);
+        return j;
+    }
+
+    inline __thread_pool::job *thread_pool::find_work(worker *w) {
+        job *j = w->deque.take();
+        if (!j) {
+            j = pop_injected();
+        }
+        for (size_t tries = 0; !j && tries < 2 * m_num_workers; ++tries) {
+            w->rng ^= w->rng << 13;
+            w->rng ^= w->rng >> 17;
+            w->rng ^= w->rng << 5;
+            worker &victim = m_workers[w->rng % m_num_workers];
+            if (&victim != w) {
+                j = victim.deque.steal();
+            }
+        }
+        if (j) {
+            __atomic_sub_fetch(&m_pending, 1, __ATOMIC_SEQ_CST);
+        }
+        return j;
+    }
+
+    inline void thread_pool::wait_for(const job *j) {
+        worker *w = local_worker();
+        unsigned idle = 0;
+        while (!__atomic_load_n(&j->done, __ATOMIC_ACQUIRE)) {
+            job *other = w ? find_work(w) : nullptr;
+            if (other) {
+                run_job(other);
+                idle = 0;
+            } else if (++idle < 64) {
+                sched_yield();
+            } else {
+                timespec pause = {0, 50000};
+                nanosleep(&pause, nullptr);
+            }
+        }
+    }
+
+    inline void thread_pool::work(worker *w) {
+        for (;;) {
+            for (unsigned spins = 0; spins < 64; ++spins) {
+                job *j = find_work(w);
+                if (j) {
+                    run_job(j);
+                    spins = 0;
+                } else {
+                    sched_yield();
+                }
+            }
+            pthread_mutex_lock(&m_mutex);
+            __atomic_add_fetch(&m_sleeping, 1, __ATOMIC_SEQ_CST);
+            bool stop = __atomic_load_n(&m_stop, __ATOMIC_SEQ_CST);
+            bool idle = __atomic_load_n(&m_pending, __ATOMIC_SEQ_CST) == 0;
+            if (idle && !stop) {
+                pthread_cond_wait(&m_wake, &m_mutex);
+            }
+            __atomic_sub_fetch(&m_sleeping, 1, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(&m_mutex);
+            if (idle && stop) {
+                return;
+            }
+        }
+    }
+
+    inline void *thread_pool::thread_main(void *arg) {
+        worker *w = static_cast<worker *>(arg);
+        __thread_pool::registry<>::current = w;
+        w->pool->work(w);
+        __thread_pool::registry<>::current = nullptr;
+        return nullptr;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_THREADPOOL_H
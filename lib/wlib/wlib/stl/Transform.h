@@ -0,0 +1,192 @@
+/**
+ * @file Transform.h
+ * @brief Batched transforms of arrays of points.
+ *
+ * Every transform of vector3d points reduces to one affine kernel
+ * that applies a three-by-four matrix. For float, the kernel loads
+ * four packed points at a time as three registers and produces the
+ * three output registers directly, so no per-point horizontal work
+ * or output shuffling is needed.
+ *
+ * Input and output may be the same array.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_TRANSFORM_H
+#define EMBEDDEDCPLUSPLUS_TRANSFORM_H
+
+#include <wlib/stl/Mat3.h>
+#include <wlib/stl/Mat4.h>
+#include <wlib/stl/Quaternion.h>
+#include <wlib/stl/SimdOps.h>
+#include <wlib/stl/Vector3D.h>
+#include <wlib/stl/Vector4D.h>
+
+namespace wlp {
+
+    /**
+     * Apply @code p' = A p + t @endcode to an array of points, where
+     * @code r @endcode holds the rows of @code [A | t] @endcode as
+     * twelve values in row-major order.
+     *
+     * @tparam T element type
+     */
+    template<typename T>
+    void __affine_scalar(const T *r, const vector3d<T> *in, vector3d<T> *out, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            T x = in[i].x();
+            T y = in[i].y();
+            T z = in[i].z();
+            out[i] = vector3d<T>(
+                r[0] * x + r[1] * y + r[2] * z + r[3],
+                r[4] * x + r[5] * y + r[6] * z + r[7],
+                r[8] * x + r[9] * y + r[10] * z + r[11]);
+        }
+    }
+
+    template<typename T>
+    struct __affine_kernel {
+        static void apply(const T *r, const vector3d<T> *in, vector3d<T> *out, size_t n) {
+            __affine_scalar(r, in, out, n);
+        }
+    };
+
+#ifdef WLIB_SIMD
+
+    template<>
+    struct __affine_kernel<float> {
+        static_assert(sizeof(vector3d<float>) == 3 * sizeof(float), "vector3d<float> must be packed");
+
+        static void apply(const float *r, const vector3d<float> *in, vector3d<float> *out, size_t n) {
+            // Four packed points span three registers whose lanes hold
+            // the rows (0 1 2 0), (1 2 0 1) and (2 0 1 2) of successive
+            // outputs. Each register is computed in place from lane-wise
+            // coefficients, so only the inputs need to be shuffled.
+            __m128 ca[4];
+            __m128 cb[4];
+            __m128 cc[4];
+            for (int k = 0; k < 4; ++k) {
+                ca[k] = _mm_setr_ps(r[k], r[4 + k], r[8 + k], r[k]);
+                cb[k] = _mm_setr_ps(r[4 + k], r[8 + k], r[k], r[4 + k]);
+                cc[k] = _mm_setr_ps(r[8 + k], r[k], r[4 + k], r[8 + k]);
+            }
+            const float *src = reinterpret_cast<const float *>(in);
+            float *dst = reinterpret_cast<float *>(out);
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4, src += 12, dst += 12) {
+                // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+                __m128 a = _mm_loadu_ps(src);
+                __m128 b = _mm_loadu_ps(src + 4);
+                __m128 c = _mm_loadu_ps(src + 8);
+                __m128 ab1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+                __m128 ab2 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+                __m128 bc2 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+                __m128 bc3 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+                __m128 ra = _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_mul_ps(ca[0], _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 0, 0))),
+                        _mm_mul_ps(ca[1], _mm_shuffle_ps(ab1, ab1, _MM_SHUFFLE(2, 0, 0, 0)))),
+                    _mm_add_ps(
+                        _mm_mul_ps(ca[2], _mm_shuffle_ps(ab2, ab2, _MM_SHUFFLE(2, 0, 0, 0))),
+                        ca[3]));
+                __m128 rb = _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_mul_ps(cb[0], _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 2, 3, 3))),
+                        _mm_mul_ps(cb[1], _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 0, 0)))),
+                    _mm_add_ps(
+                        _mm_mul_ps(cb[2], _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 0, 1, 1))),
+                        cb[3]));
+                __m128 rc = _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_mul_ps(cc[0], _mm_shuffle_ps(bc2, bc2, _MM_SHUFFLE(2, 2, 2, 0))),
+                        _mm_mul_ps(cc[1], _mm_shuffle_ps(bc3, bc3, _MM_SHUFFLE(2, 2, 2, 0)))),
+                    _mm_add_ps(
+                        _mm_mul_ps(cc[2], _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 0))),
+                        cc[3]));
+                _mm_storeu_ps(dst, ra);
+                _mm_storeu_ps(dst + 4, rb);
+                _mm_storeu_ps(dst + 8, rc);
+            }
+            __affine_scalar(r, in + i, out + i, n - i);
+        }
+    };
+
+#endif // WLIB_SIMD
+
+    template<typename T>
+    void __affine_rows(const mat3<T> &m, const vector3d<T> &t, T *r) {
+        for (size_t i = 0; i < 3; ++i) {
+            r[4 * i] = m(i, 0);
+            r[4 * i + 1] = m(i, 1);
+            r[4 * i + 2] = m(i, 2);
+        }
+        r[3] = t.x();
+        r[7] = t.y();
+        r[11] = t.z();
+    }
+
+    /**
+     * Apply the affine part of a transform to each point, taking
+     * the fourth component as one. The bottom row of the matrix is
+     * ignored, so no perspective division is done.
+     *
+     * @param m   transform
+     * @param in  points to transform
+     * @param out receives the transformed points
+     * @param n   number of points
+     */
+    template<typename T>
+    void transform_points(const mat4<T> &m, const vector3d<T> *in, vector3d<T> *out, size_t n) {
+        T r[12];
+        __affine_rows(m.linear(), m.col(3).xyz(), r);
+        __affine_kernel<T>::apply(r, in, out, n);
+    }
+
+    /**
+     * Apply a transform to each direction, ignoring translation.
+     *
+     * @param m   transform
+     * @param in  directions to transform
+     * @param out receives the transformed directions
+     * @param n   number of directions
+     */
+    template<typename T>
+    void transform_vectors(const mat4<T> &m, const vector3d<T> *in, vector3d<T> *out, size_t n) {
+        T r[12];
+        __affine_rows(m.linear(), vector3d<T>(), r);
+        __affine_kernel<T>::apply(r, in, out, n);
+    }
+
+    /**
+     * Multiply each point by a three-by-three matrix.
+     */
+    template<typename T>
+    void transform_points(const mat3<T> &m, const vector3d<T> *in, vector3d<T> *out, size_t n) {
+        T r[12];
+        __affine_rows(m, vector3d<T>(), r);
+        __affine_kernel<T>::apply(r, in, out, n);
+    }
+
+    /**
+     * Rotate each point by a unit quaternion. The quaternion is
+     * converted to a matrix once for the whole batch.
+     */
+    template<typename T>
+    void rotate_points(const quaternion<T> &q, const vector3d<T> *in, vector3d<T> *out, size_t n) {
+        transform_points(q.to_mat3(), in, out, n);
+    }
+
+    /**
+     * Multiply each homogeneous point by a four-by-four matrix.
+     */
+    template<typename T>
+    void transform_points(const mat4<T> &m, const vector4d<T> *in, vector4d<T> *out, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = m * in[i];
+        }
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_TRANSFORM_H
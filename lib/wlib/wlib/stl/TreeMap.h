@@ -26,19 +26,21 @@ namespace wlp {
      * @tparam Key key type
      * @tparam Val value type
      * @tparam Cmp key comparator type, which uses the default comparator
+     * @tparam Alloc allocator of the tree nodes
      */
-    template<typename Key, typename Val, typename Cmp = comparator<Key>>
+    template<typename Key, typename Val, typename Cmp = comparator<Key>, typename Alloc = allocator>
     class tree_map {
     public:
-        typedef tree_map<Key, Val, Cmp> map_type;
+        typedef tree_map<Key, Val, Cmp, Alloc> map_type;
         typedef tree<tuple<Key, Val>,
                 Key, Val,
                 MapGetKey<Key, Val>, MapGetVal<Key, Val>,
-                Cmp
+                Cmp, Alloc
         > table_type;
         typedef typename table_type::iterator iterator;
         typedef typename table_type::const_iterator const_iterator;
         typedef typename table_type::size_type size_type;
+        typedef Alloc allocator_type;
 
         typedef Key key_type;
         typedef Val val_type;
@@ -47,8 +49,8 @@ namespace wlp {
         table_type m_table;
 
     public:
-        explicit tree_map()
-                : m_table() {
+        explicit tree_map(const Alloc &alloc = Alloc())
+                : m_table(alloc) {
         }
 
         tree_map(const map_type &) = delete;
@@ -57,6 +59,19 @@ namespace wlp {
                 : m_table(move(map.m_table)) {
         }
 
+        allocator_type get_allocator() const {
+            return m_table.get_allocator();
+        }
+
+#ifdef WLIB_CONTAINER_STATS
+        /**
+         * @return the operation counters of the underlying tree
+         */
+        const container_stats &stats() const {
+            return m_table.stats();
+        }
+#endif
+
         size_type size() const {
             return m_table.size();
         }
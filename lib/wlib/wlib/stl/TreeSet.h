@@ -24,19 +24,21 @@ namespace wlp {
      *
      * @tparam Key stored value type
      * @tparam Cmp comparator for stored value, which uses the default comparator
+     * @tparam Alloc allocator of the tree nodes
      */
-    template<typename Key, typename Cmp = comparator<Key>>
+    template<typename Key, typename Cmp = comparator<Key>, typename Alloc = allocator>
     class tree_set {
     public:
-        typedef tree_set<Key, Cmp> set_type;
+        typedef tree_set<Key, Cmp, Alloc> set_type;
         typedef tree<Key,
             Key, Key,
             SetGetKey<Key>, SetGetVal<Key>,
-            Cmp
+            Cmp, Alloc
         > table_type;
         typedef typename table_type::iterator iterator;
         typedef typename table_type::const_iterator const_iterator;
         typedef typename table_type::size_type size_type;
+        typedef Alloc allocator_type;
 
         typedef Key key_type;
 
@@ -44,8 +46,8 @@ namespace wlp {
         table_type m_table;
 
     public:
-        explicit tree_set()
-                : m_table() {
+        explicit tree_set(const Alloc &alloc = Alloc())
+                : m_table(alloc) {
         }
 
         tree_set(const set_type &) = delete;
@@ -54,6 +56,19 @@ namespace wlp {
                 : m_table(move(set.m_table)) {
         }
 
+        allocator_type get_allocator() const {
+            return m_table.get_allocator();
+        }
+
+#ifdef WLIB_CONTAINER_STATS
+        /**
+         * @return the operation counters of the underlying tree
+         */
+        const container_stats &stats() const {
+            return m_table.stats();
+        }
+#endif
+
         size_type size() const {
             return m_table.size();
         }
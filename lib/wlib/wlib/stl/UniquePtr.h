@@ -3,7 +3,8 @@
  * @brief Unique pointer implementation
  *
  * Implementation of a unique pointer class, a smart pointer which
- * manages a single pointer and cannot share with another unique pointer.
+ * manages a single pointer and cannot share with another unique pointer,
+ * and of the deleters it may free that pointer with.
  *
  * @author Jeff Niu
  * @date November 22, 2017
@@ -13,6 +14,7 @@
 #ifndef EMBEDDEDCPLUSPLUS_UNIQUEPTR_H
 #define EMBEDDEDCPLUSPLUS_UNIQUEPTR_H
 
+#include <wlib/stl/CompressedPair.h>
 #include <wlib/stl/Helper.h>
 #include <wlib/tmp/Convertible.h>
 #include <wlib/type_traits>
@@ -20,6 +22,135 @@
 
 namespace wlp {
 
+    /**
+     * Deleter which frees a pointer obtained from @code create @endcode.
+     *
+     * @tparam T the type of the object
+     */
+    template<typename T>
+    struct default_delete {
+        constexpr default_delete() = default;
+
+        template<typename U, typename = typename enable_if<
+            is_convertible<U *, T *>::value
+        >::type>
+        default_delete(const default_delete<U> &) {}
+
+        void operator()(T *ptr) const {
+            destroy<T>(ptr);
+        }
+    };
+
+    /**
+     * Deleter which frees an array obtained from @code create @endcode.
+     */
+    template<typename T>
+    struct default_delete<T[]> {
+        constexpr default_delete() = default;
+
+        void operator()(T *ptr) const {
+            destroy<T[]>(ptr);
+        }
+    };
+
+    /**
+     * Deleter which destroys an object and returns its storage to the
+     * allocator, for instance a pool, that provided it. The allocator
+     * is a base class so that stateless allocators take no space.
+     *
+     * @tparam T     the type of the object
+     * @tparam Alloc the allocator, see Allocator.h
+     */
+    template<typename T, typename Alloc>
+    class allocator_delete : private Alloc {
+    public:
+        allocator_delete()
+                : Alloc() {}
+
+        explicit allocator_delete(const Alloc &alloc)
+                : Alloc(alloc) {}
+
+        void operator()(T *ptr) {
+            ptr->~T();
+            static_cast<Alloc &>(*this).deallocate(ptr, sizeof(T), alignof(T));
+        }
+
+        const Alloc &get_allocator() const {
+            return *this;
+        }
+    };
+
+    /**
+     * Deleter for an array of @code count @endcode objects allocated
+     * as one block from an allocator.
+     */
+    template<typename T, typename Alloc>
+    class allocator_delete<T[], Alloc> : private Alloc {
+    public:
+        allocator_delete()
+                : Alloc(),
+                  m_count(0) {}
+
+        allocator_delete(const Alloc &alloc, size_t count)
+                : Alloc(alloc),
+                  m_count(count) {}
+
+        void operator()(T *ptr) {
+            for (size_t i = m_count; i > 0; --i) {
+                ptr[i - 1].~T();
+            }
+            static_cast<Alloc &>(*this).deallocate(ptr, m_count * sizeof(T), alignof(T));
+        }
+
+        const Alloc &get_allocator() const {
+            return *this;
+        }
+
+        size_t count() const {
+            return m_count;
+        }
+
+    private:
+        size_t m_count;
+    };
+
+    /**
+     * Deleter for objects placed in an arena, which reclaims its
+     * memory all at once. The object is destroyed but its storage
+     * is left to the arena.
+     *
+     * @tparam T the type of the object
+     */
+    template<typename T>
+    struct arena_delete {
+        void operator()(T *ptr) const {
+            ptr->~T();
+        }
+    };
+
+    template<typename T>
+    class arena_delete<T[]> {
+    public:
+        arena_delete()
+                : m_count(0) {}
+
+        explicit arena_delete(size_t count)
+                : m_count(count) {}
+
+        void operator()(T *ptr) const {
+            for (size_t i = m_count; i > 0; --i) {
+                ptr[i - 1].~T();
+            }
+        }
+
+        size_t count() const {
+            return m_count;
+        }
+
+    private:
+        size_t m_count;
+    };
+
     /**
      * A unique pointer is a smart pointer that handles exactly one pointer
      * that cannot and should not at any moment be shared with another class.
@@ -33,51 +164,59 @@ namespace wlp {
      * and associated resources in its destructor when the class reaches the
      * end of scope.
      *
-     * Supplying a non-dynamically allocated pointer or sharing a provided
+     * Supplying a pointer that the deleter cannot free or sharing a provided
      * pointer with different unique pointer leads to undefined behaviour, and
      * with Memory, segmentation faults.
      *
-     * Construction is recommended with @code make_unique @endcode.
-     * 
-     * Unique pointer class does not currently support multiple deleter
-     * types, and uses only functions in Memory. Adding deleters for other
-     * Memory solutions can be a future feature, but makes the class more complex.
+     * Construction is recommended with @code make_unique @endcode, or
+     * @code allocate_unique @endcode for objects from an allocator.
+     *
+     * The pointer is freed by a deleter, which by default returns it to
+     * Memory with @code destroy @endcode. Stateless deleters are stored
+     * as an empty base and do not change the size of the pointer.
      *
-     * @tparam T the type pointed to by this unique pointer
-     * @tparam T_Deleter deleter type used to free the pointer
+     * @tparam T       the type pointed to by this unique pointer
+     * @tparam Deleter deleter type used to free the pointer
      */
-    template<typename T>
+    template<typename T, typename Deleter = default_delete<T>>
     class unique_ptr {
-        typedef T *unique_ptr::* unspecified_bool_type;
-        typedef T *unique_ptr::* unspecified_pointer_type;
-        typedef unique_ptr<T> unique_ptr_t;
+        typedef unique_ptr<T, Deleter> unique_ptr_t;
 
     public:
         typedef T *pointer;
         typedef T val_type;
+        typedef Deleter deleter_type;
 
     private:
-        val_type *m_ptr;
+        template<typename U, typename E> friend
+        class unique_ptr;
+
+        __compressed_pair<pointer, deleter_type> m_data;
 
     public:
 
         unique_ptr()
-                : m_ptr(pointer()) {
+                : m_data(pointer()) {
         }
 
         explicit
         unique_ptr(pointer ptr)
-                : m_ptr(ptr) {
+                : m_data(ptr) {
         }
 
+        unique_ptr(pointer ptr, const deleter_type &deleter)
+                : m_data(ptr, deleter) {
+        }
 
         unique_ptr(unique_ptr_t &&ptr)
-                : m_ptr(ptr.release()) {
+                : m_data(ptr.get(), move(ptr.get_deleter())) {
+            ptr.release();
         }
 
-        template<typename U>
-        unique_ptr(unique_ptr<U> &&ptr)
-                : m_ptr(ptr.release()) {
+        template<typename U, typename E>
+        unique_ptr(unique_ptr<U, E> &&ptr)
+                : m_data(ptr.get(), move(ptr.get_deleter())) {
+            ptr.release();
         };
 
         ~unique_ptr() {
@@ -86,88 +225,110 @@ namespace wlp {
 
         unique_ptr_t &operator=(unique_ptr_t &&ptr) {
             reset(ptr.release());
+            get_deleter() = move(ptr.get_deleter());
             return *this;
         }
 
-        template<typename U>
-        unique_ptr_t &operator=(unique_ptr<U> &&ptr) {
+        template<typename U, typename E>
+        unique_ptr_t &operator=(unique_ptr<U, E> &&ptr) {
             reset(ptr.release());
+            get_deleter() = move(ptr.get_deleter());
             return *this;
         };
 
-        unique_ptr_t &operator=(unspecified_pointer_type) {
+        unique_ptr_t &operator=(nullptr_t) {
             reset();
             return *this;
         }
 
         typename add_lvalue_reference<val_type>::type operator*() const {
-            return *m_ptr;
+            return *m_data.first();
         };
 
         pointer operator->() const {
-            return m_ptr;
+            return m_data.first();
         }
 
         pointer get() const {
-            return m_ptr;
+            return m_data.first();
         }
 
+        deleter_type &get_deleter() {
+            return m_data.second();
+        }
 
-        operator unspecified_bool_type() const {
-            return m_ptr == nullptr ? 0 : &unique_ptr::m_ptr;
+        const deleter_type &get_deleter() const {
+            return m_data.second();
+        }
+
+        explicit operator bool() const {
+            return m_data.first() != nullptr;
         }
 
         pointer release() {
-            pointer ptr = m_ptr;
-            m_ptr = nullptr;
+            pointer ptr = m_data.first();
+            m_data.first() = nullptr;
             return ptr;
         }
 
         void reset(pointer ptr = pointer()) {
-            if (ptr != m_ptr) {
-                destroy<val_type>(m_ptr);
-                m_ptr = ptr;
+            pointer old = m_data.first();
+            if (ptr != old) {
+                m_data.first() = ptr;
+                if (old) { get_deleter()(old); }
             }
         }
 
+        void swap(unique_ptr_t &ptr) {
+            m_data.swap(ptr.m_data);
+        }
+
         void swap(unique_ptr_t &&ptr) {
-            wlp::swap(m_ptr, ptr.m_ptr);
+            m_data.swap(ptr.m_data);
         }
 
     private:
         unique_ptr(const unique_ptr_t &) = delete;
 
-        template<typename U>
-        unique_ptr(const unique_ptr<U> &) = delete;
+        template<typename U, typename E>
+        unique_ptr(const unique_ptr<U, E> &) = delete;
 
         unique_ptr_t &operator=(const unique_ptr_t &) = delete;
 
-        template<typename U>
-        unique_ptr_t &operator=(const unique_ptr<U> &) = delete;
+        template<typename U, typename E>
+        unique_ptr_t &operator=(const unique_ptr<U, E> &) = delete;
 
     };
 
-    template<typename T>
-    class unique_ptr<T[]> {
-        typedef T *unique_ptr::* unspecified_bool_type;
-        typedef T *unique_ptr::* unspecified_pointer_type;
-        typedef unique_ptr<T> unique_ptr_t;
+    template<typename T, typename Deleter>
+    class unique_ptr<T[], Deleter> {
+        typedef unique_ptr<T[], Deleter> unique_ptr_t;
 
     public:
         typedef T *pointer;
         typedef T val_type;
+        typedef Deleter deleter_type;
 
     private:
-        val_type *m_ptr;
+        __compressed_pair<pointer, deleter_type> m_data;
 
     public:
         unique_ptr()
-                : m_ptr(pointer()) {
+                : m_data(pointer()) {
         }
 
         explicit
         unique_ptr(pointer ptr)
-                : m_ptr(ptr) {
+                : m_data(ptr) {
+        }
+
+        unique_ptr(pointer ptr, const deleter_type &deleter)
+                : m_data(ptr, deleter) {
+        }
+
+        unique_ptr(unique_ptr_t &&ptr)
+                : m_data(ptr.get(), move(ptr.get_deleter())) {
+            ptr.release();
         }
 
         ~unique_ptr() {
@@ -176,50 +337,58 @@ namespace wlp {
 
         unique_ptr_t &operator=(unique_ptr_t &&ptr) {
             reset(ptr.release());
+            get_deleter() = move(ptr.get_deleter());
             return *this;
         }
 
-        template<typename U>
-        unique_ptr_t &operator=(unique_ptr<U> &&ptr) {
-            reset(ptr.release());
-            return *this;
-        };
-
-        unique_ptr_t &operator=(unspecified_pointer_type) {
+        unique_ptr_t &operator=(nullptr_t) {
             reset();
             return *this;
         }
 
         typename add_lvalue_reference<val_type>::type operator[](size_t i) const {
-            return m_ptr[i];
+            return m_data.first()[i];
         }
 
         pointer get() const {
-            return m_ptr;
+            return m_data.first();
         }
 
-        operator unspecified_bool_type() const {
-            return m_ptr == nullptr ? 0 : &unique_ptr::m_ptr;
-        };
+        deleter_type &get_deleter() {
+            return m_data.second();
+        }
+
+        const deleter_type &get_deleter() const {
+            return m_data.second();
+        }
+
+        explicit operator bool() const {
+            return m_data.first() != nullptr;
+        }
 
         pointer release() {
-            pointer ptr = m_ptr;
-            m_ptr = nullptr;
+            pointer ptr = m_data.first();
+            m_data.first() = nullptr;
             return ptr;
         }
 
         void reset(pointer ptr = pointer()) {
-            if (ptr != m_ptr) {
-                destroy<val_type[]>(m_ptr);
-                m_ptr = ptr;
+            pointer old = m_data.first();
+            if (ptr != old) {
+                m_data.first() = ptr;
+                if (old) { get_deleter()(old); }
             }
         }
 
         template<typename U>
         void reset(U) = delete;
 
+        void swap(unique_ptr_t &u) {
+            m_data.swap(u.m_data);
+        }
+
         void swap(unique_ptr_t &&u) {
-            wlp::swap(m_ptr, u.m_ptr);
+            m_data.swap(u.m_data);
         }
 
     private:
@@ -232,53 +401,50 @@ namespace wlp {
         >::type * = 0) = delete;
 
         unique_ptr_t &operator=(const unique_ptr_t &) = delete;
-
-        template<typename U, typename U_Deleter>
-        unique_ptr_t &operator=(const unique_ptr<U> &) = delete;
     };
 
-    template<typename T>
-    inline void swap(unique_ptr<T> &x, unique_ptr<T> &y) {
+    template<typename T, typename D>
+    inline void swap(unique_ptr<T, D> &x, unique_ptr<T, D> &y) {
         x.swap(y);
     };
 
-    template<typename T>
-    inline void swap(unique_ptr<T> &&x, unique_ptr<T> &y) {
+    template<typename T, typename D>
+    inline void swap(unique_ptr<T, D> &&x, unique_ptr<T, D> &y) {
         x.swap(y);
     };
 
-    template<typename T>
-    inline void swap(unique_ptr<T> &x, unique_ptr<T> &&y) {
+    template<typename T, typename D>
+    inline void swap(unique_ptr<T, D> &x, unique_ptr<T, D> &&y) {
         x.swap(y);
     }
 
-    template<typename T, typename U>
-    inline bool operator==(const unique_ptr<T> &x, const unique_ptr<U> &y) {
+    template<typename T, typename D, typename U, typename E>
+    inline bool operator==(const unique_ptr<T, D> &x, const unique_ptr<U, E> &y) {
         return x.get() == y.get();
     }
 
-    template<typename T, typename U>
-    inline bool operator!=(const unique_ptr<T> &x, const unique_ptr<U> &y) {
+    template<typename T, typename D, typename U, typename E>
+    inline bool operator!=(const unique_ptr<T, D> &x, const unique_ptr<U, E> &y) {
         return !(x.get() == y.get());
     }
 
-    template<typename T, typename U>
-    inline bool operator<(const unique_ptr<T> &x, const unique_ptr<U> &y) {
+    template<typename T, typename D, typename U, typename E>
+    inline bool operator<(const unique_ptr<T, D> &x, const unique_ptr<U, E> &y) {
         return x.get() < y.get();
     }
 
-    template<typename T, typename U>
-    inline bool operator<=(const unique_ptr<T> &x, const unique_ptr<U> &y) {
+    template<typename T, typename D, typename U, typename E>
+    inline bool operator<=(const unique_ptr<T, D> &x, const unique_ptr<U, E> &y) {
         return !(y.get() < x.get());
     }
 
-    template<typename T, typename U>
-    inline bool operator>(const unique_ptr<T> &x, const unique_ptr<U> &y) {
+    template<typename T, typename D, typename U, typename E>
+    inline bool operator>(const unique_ptr<T, D> &x, const unique_ptr<U, E> &y) {
         return y.get() < x.get();
     }
 
-    template<typename T, typename U>
-    inline bool operator>=(const unique_ptr<T> &x, const unique_ptr<U> &y) {
+    template<typename T, typename D, typename U, typename E>
+    inline bool operator>=(const unique_ptr<T, D> &x, const unique_ptr<U, E> &y) {
         return !(x.get() < y.get());
     }
 
@@ -287,6 +453,54 @@ namespace wlp {
         return unique_ptr<T>(create<T>(forward<Args>(args)...));
     };
 
+    template<typename T, typename Alloc>
+    struct __allocate_unique {
+        typedef unique_ptr<T, allocator_delete<T, Alloc>> type;
+
+        template<typename... Args>
+        static type make(const Alloc &alloc, Args &&... args) {
+            void *mem = Alloc(alloc).allocate(sizeof(T), alignof(T));
+            if (!mem) {
+                return type(nullptr, allocator_delete<T, Alloc>(alloc));
+            }
+            return type(new (mem) T(forward<Args>(args)...), allocator_delete<T, Alloc>(alloc));
+        }
+    };
+
+    template<typename T, typename Alloc>
+    struct __allocate_unique<T[], Alloc> {
+        typedef unique_ptr<T[], allocator_delete<T[], Alloc>> type;
+
+        static type make(const Alloc &alloc, size_t count) {
+            void *mem = Alloc(alloc).allocate(count * sizeof(T), alignof(T));
+            if (!mem) {
+                return type(nullptr, allocator_delete<T[], Alloc>(alloc, 0));
+            }
+            T *arr = static_cast<T *>(mem);
+            for (size_t i = 0; i < count; ++i) {
+                new (static_cast<void *>(arr + i)) T();
+            }
+            return type(arr, allocator_delete<T[], Alloc>(alloc, count));
+        }
+    };
+
+    /**
+     * Create an object, or a default-constructed array when @code T @endcode
+     * is @code U[] @endcode, in storage from an allocator. The returned
+     * pointer returns the storage to a copy of the same allocator.
+     *
+     * @tparam T the type of the object, or an array type
+     * @param alloc the allocator, see Allocator.h
+     * @param args  constructor arguments of the object, or the
+     *              number of elements of the array
+     * @return a unique pointer to the object, which is empty if the
+     * allocator is out of memory
+     */
+    template<typename T, typename Alloc, typename... Args>
+    typename __allocate_unique<T, Alloc>::type allocate_unique(const Alloc &alloc, Args &&... args) {
+        return __allocate_unique<T, Alloc>::make(alloc, forward<Args>(args)...);
+    }
+
 };
 
 #endif //EMBEDDEDCPLUSPLUS_UNIQUEPTR_H
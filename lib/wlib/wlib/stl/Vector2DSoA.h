@@ -0,0 +1,491 @@
+/**
+ * @file Vector2DSoA.h
+ * @brief Structure-of-arrays container for 2D vectors.
+ *
+ * A @code vector2d_soa @endcode stores the x and y components of
+ * many vectors in two separate arrays, so that bulk operations
+ * sweep linearly through memory and vectorize. Kernels over the
+ * container use SSE or AVX for float and double where available.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_VECTOR2DSOA_H
+#define EMBEDDEDCPLUSPLUS_VECTOR2DSOA_H
+
+#include <math.h>
+
+#include <wlib/type_traits>
+#include <wlib/memory>
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/SimdOps.h>
+#include <wlib/stl/Vector2D.h>
+
+namespace wlp {
+
+    /**
+     * Container of 2D vectors stored as an array of x components
+     * followed by an array of y components in one allocation.
+     *
+     * @tparam val_t component type
+     */
+    template<typename val_t>
+    class vector2d_soa {
+    public:
+        typedef val_t val_type;
+        typedef size_t size_type;
+        typedef vector2d_soa<val_t> soa_type;
+
+    private:
+        /**
+         * Backing block; x components start at index zero
+         * and y components at index @code m_capacity @endcode.
+         */
+        val_type *m_data;
+        size_type m_size;
+        size_type m_capacity;
+
+    public:
+        /**
+         * @param initial_capacity number of vectors to reserve
+         */
+        explicit vector2d_soa(size_type initial_capacity = 12)
+            : m_data(nullptr),
+              m_size(0),
+              m_capacity(0) {
+            reserve(initial_capacity);
+        }
+
+        /**
+         * Create from an array-of-structures list.
+         *
+         * @param list vectors to copy
+         */
+        explicit vector2d_soa(const array_list<vector2d<val_t>> &list)
+            : vector2d_soa(list.size()) {
+            assign(list);
+        }
+
+        vector2d_soa(soa_type &&soa)
+            : m_data(soa.m_data),
+              m_size(soa.m_size),
+              m_capacity(soa.m_capacity) {
+            soa.m_data = nullptr;
+            soa.m_size = 0;
+            soa.m_capacity = 0;
+        }
+
+        ~vector2d_soa() {
+            if (m_data) {
+                destroy<val_type[]>(m_data);
+            }
+        }
+
+        soa_type &operator=(soa_type &&soa) {
+            if (this != &soa) {
+                if (m_data) {
+                    destroy<val_type[]>(m_data);
+                }
+                m_data = soa.m_data;
+                m_size = soa.m_size;
+                m_capacity = soa.m_capacity;
+                soa.m_data = nullptr;
+                soa.m_size = 0;
+                soa.m_capacity = 0;
+            }
+            return *this;
+        }
+
+        vector2d_soa(const soa_type &) = delete;
+
+        soa_type &operator=(const soa_type &) = delete;
+
+        size_type size() const {
+            return m_size;
+        }
+
+        size_type capacity() const {
+            return m_capacity;
+        }
+
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        void clear() {
+            m_size = 0;
+        }
+
+        /**
+         * @return pointer to the array of x components
+         */
+        val_type *x_data() {
+            return m_data;
+        }
+
+        const val_type *x_data() const {
+            return m_data;
+        }
+
+        /**
+         * @return pointer to the array of y components
+         */
+        val_type *y_data() {
+            return m_data + m_capacity;
+        }
+
+        const val_type *y_data() const {
+            return m_data + m_capacity;
+        }
+
+        val_type &x(size_type i) {
+            return m_data[i];
+        }
+
+        const val_type &x(size_type i) const {
+            return m_data[i];
+        }
+
+        val_type &y(size_type i) {
+            return m_data[m_capacity + i];
+        }
+
+        const val_type &y(size_type i) const {
+            return m_data[m_capacity + i];
+        }
+
+        /**
+         * @param i vector index
+         * @return a copy of the vector at the index
+         */
+        vector2d<val_t> get(size_type i) const {
+            return vector2d<val_t>(x(i), y(i));
+        }
+
+        void set(size_type i, const vector2d<val_t> &v) {
+            x(i) = v.x();
+            y(i) = v.y();
+        }
+
+        /**
+         * Append a vector. Nothing is appended if the container
+         * is full and cannot grow.
+         */
+        void push_back(val_type vx, val_type vy) {
+            if (m_size == m_capacity && !reserve(m_capacity ? 2 * m_capacity : 4)) {
+                return;
+            }
+            m_data[m_size] = vx;
+            m_data[m_capacity + m_size] = vy;
+            ++m_size;
+        }
+
+        void push_back(const vector2d<val_t> &v) {
+            push_back(v.x(), v.y());
+        }
+
+        /**
+         * Set the number of vectors. New vectors are uninitialized.
+         *
+         * @param n new size
+         * @return false if the container could not grow, in which
+         *         case the size is unchanged
+         */
+        bool resize(size_type n) {
+            if (!reserve(n)) {
+                return false;
+            }
+            m_size = n;
+            return true;
+        }
+
+        /**
+         * Grow the backing block to hold at least the given number
+         * of vectors. Does nothing if the capacity is already enough.
+         *
+         * @param new_capacity number of vectors to reserve
+         * @return false if the block could not be allocated, in which
+         *         case the old block and its contents are kept
+         */
+        bool reserve(size_type new_capacity);
+
+        /**
+         * Replace the contents with the vectors in a list.
+         *
+         * @param list vectors to copy
+         */
+        void assign(const array_list<vector2d<val_t>> &list) {
+            if (!resize(list.size())) {
+                return;
+            }
+            for (size_type i = 0; i < m_size; ++i) {
+                m_data[i] = list[i].x();
+                m_data[m_capacity + i] = list[i].y();
+            }
+        }
+
+        /**
+         * Replace the contents of a list with the vectors
+         * in this container.
+         *
+         * @param list list to fill
+         */
+        void to_list(array_list<vector2d<val_t>> &list) const {
+            list.clear();
+            list.reserve(m_size);
+            for (size_type i = 0; i < m_size; ++i) {
+                list.push_back(vector2d<val_t>(m_data[i], m_data[m_capacity + i]));
+            }
+        }
+    };
+
+    template<typename val_t>
+    bool vector2d_soa<val_t>::reserve(size_type new_capacity) {
+        if (new_capacity <= m_capacity && m_data) {
+            return true;
+        }
+        if (new_capacity > static_cast<size_type>(-1) / 2) {
+            return false;
+        }
+        val_type *new_data = create<val_type[]>(2 * new_capacity);
+        if (!new_data) {
+            return false;
+        }
+        if (m_data) {
+            for (size_type i = 0; i < m_size; ++i) {
+                new_data[i] = m_data[i];
+                new_data[new_capacity + i] = m_data[m_capacity + i];
+            }
+            destroy<val_type[]>(m_data);
+        }
+        m_data = new_data;
+        m_capacity = new_capacity;
+        return true;
+    }
+
+    template<typename T>
+    inline T __soa_sqrt(T v) {
+        return static_cast<T>(sqrt(static_cast<double>(v)));
+    }
+
+    /**
+     * Per-element vector kernels. The scalar version handles any
+     * arithmetic type and the tail of the vectorized loops.
+     */
+    template<typename T, bool = __simd_ops<T>::simd_float>
+    struct __vector2d_kernels {
+        static void dot(const T *ax, const T *ay, const T *bx, const T *by, T *out, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<T>(ax[i] * bx[i] + ay[i] * by[i]);
+            }
+        }
+
+        static void norm(const T *x, const T *y, T *out, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = __soa_sqrt<T>(static_cast<T>(x[i] * x[i] + y[i] * y[i]));
+            }
+        }
+
+        static void normalize(const T *x, const T *y, T *ox, T *oy, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                T len = __soa_sqrt<T>(static_cast<T>(x[i] * x[i] + y[i] * y[i]));
+                if (len == T()) {
+                    ox[i] = T();
+                    oy[i] = T();
+                } else {
+                    ox[i] = static_cast<T>(x[i] / len);
+                    oy[i] = static_cast<T>(y[i] / len);
+                }
+            }
+        }
+
+        static void rotate(const T *x, const T *y, T c, T s, T *ox, T *oy, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                T rx = static_cast<T>(c * x[i] - s * y[i]);
+                T ry = static_cast<T>(s * x[i] + c * y[i]);
+                ox[i] = rx;
+                oy[i] = ry;
+            }
+        }
+
+        static void distance(const T *x, const T *y, T px, T py, T *out, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                T dx = static_cast<T>(x[i] - px);
+                T dy = static_cast<T>(y[i] - py);
+                out[i] = __soa_sqrt<T>(static_cast<T>(dx * dx + dy * dy));
+            }
+        }
+    };
+
+    template<typename T>
+    struct __vector2d_kernels<T, true> {
+        typedef __simd_ops<T> ops;
+        typedef typename ops::reg reg;
+        typedef __vector2d_kernels<T, false> tail;
+
+        static void dot(const T *ax, const T *ay, const T *bx, const T *by, T *out, size_t n) {
+            size_t i = 0;
+            for (; i + ops::width <= n; i += ops::width) {
+                reg r = ops::vadd(ops::vmul(ops::load(ax + i), ops::load(bx + i)),
+                                  ops::vmul(ops::load(ay + i), ops::load(by + i)));
+                ops::store(out + i, r);
+            }
+            tail::dot(ax + i, ay + i, bx + i, by + i, out + i, n - i);
+        }
+
+        static void norm(const T *x, const T *y, T *out, size_t n) {
+            size_t i = 0;
+            for (; i + ops::width <= n; i += ops::width) {
+                reg vx = ops::load(x + i);
+                reg vy = ops::load(y + i);
+                ops::store(out + i, ops::vsqrt(ops::vadd(ops::vmul(vx, vx), ops::vmul(vy, vy))));
+            }
+            tail::norm(x + i, y + i, out + i, n - i);
+        }
+
+        static void normalize(const T *x, const T *y, T *ox, T *oy, size_t n) {
+            const reg one = ops::set1(static_cast<T>(1));
+            size_t i = 0;
+            for (; i + ops::width <= n; i += ops::width) {
+                reg vx = ops::load(x + i);
+                reg vy = ops::load(y + i);
+                reg len = ops::vsqrt(ops::vadd(ops::vmul(vx, vx), ops::vmul(vy, vy)));
+                reg inv = ops::vkeep_nonzero(len, ops::vdiv(one, len));
+                ops::store(ox + i, ops::vmul(vx, inv));
+                ops::store(oy + i, ops::vmul(vy, inv));
+            }
+            tail::normalize(x + i, y + i, ox + i, oy + i, n - i);
+        }
+
+        static void rotate(const T *x, const T *y, T c, T s, T *ox, T *oy, size_t n) {
+            const reg vc = ops::set1(c);
+            const reg vs = ops::set1(s);
+            size_t i = 0;
+            for (; i + ops::width <= n; i += ops::width) {
+                reg vx = ops::load(x + i);
+                reg vy = ops::load(y + i);
+                ops::store(ox + i, ops::vsub(ops::vmul(vc, vx), ops::vmul(vs, vy)));
+                ops::store(oy + i, ops::vadd(ops::vmul(vs, vx), ops::vmul(vc, vy)));
+            }
+            tail::rotate(x + i, y + i, c, s, ox + i, oy + i, n - i);
+        }
+
+        static void distance(const T *x, const T *y, T px, T py, T *out, size_t n) {
+            const reg vpx = ops::set1(px);
+            const reg vpy = ops::set1(py);
+            size_t i = 0;
+            for (; i + ops::width <= n; i += ops::width) {
+                reg dx = ops::vsub(ops::load(x + i), vpx);
+                reg dy = ops::vsub(ops::load(y + i), vpy);
+                ops::store(out + i, ops::vsqrt(ops::vadd(ops::vmul(dx, dx), ops::vmul(dy, dy))));
+            }
+            tail::distance(x + i, y + i, px, py, out + i, n - i);
+        }
+    };
+
+    /**
+     * Add two containers of vectors elementwise. The output is
+     * resized to match and may be one of the inputs.
+     *
+     * @return false if the inputs differ in size or the output
+     *         could not be resized
+     */
+    template<typename T>
+    bool add(const vector2d_soa<T> &a, const vector2d_soa<T> &b, vector2d_soa<T> &out) {
+        if (a.size() != b.size() || !out.resize(a.size())) {
+            return false;
+        }
+        __simd_ops<T>::add(a.x_data(), b.x_data(), out.x_data(), a.size());
+        __simd_ops<T>::add(a.y_data(), b.y_data(), out.y_data(), a.size());
+        return true;
+    }
+
+    /**
+     * Multiply every vector by a scalar. The output is resized
+     * to match and may be the input.
+     *
+     * @return false if the output could not be resized
+     */
+    template<typename T>
+    bool scale(const vector2d_soa<T> &a, T s, vector2d_soa<T> &out) {
+        if (!out.resize(a.size())) {
+            return false;
+        }
+        __simd_ops<T>::scale(a.x_data(), s, out.x_data(), a.size());
+        __simd_ops<T>::scale(a.y_data(), s, out.y_data(), a.size());
+        return true;
+    }
+
+    /**
+     * Compute the dot product of each pair of vectors.
+     *
+     * @param out array of at least @code a.size() @endcode elements
+     * @return false if the inputs differ in size
+     */
+    template<typename T>
+    bool dot(const vector2d_soa<T> &a, const vector2d_soa<T> &b, T *out) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        __vector2d_kernels<T>::dot(a.x_data(), a.y_data(), b.x_data(), b.y_data(), out, a.size());
+        return true;
+    }
+
+    /**
+     * Compute the length of each vector.
+     *
+     * @param out array of at least @code a.size() @endcode elements
+     */
+    template<typename T>
+    void norm(const vector2d_soa<T> &a, T *out) {
+        __vector2d_kernels<T>::norm(a.x_data(), a.y_data(), out, a.size());
+    }
+
+    /**
+     * Scale each vector to unit length with one square root and
+     * one reciprocal per vector. Zero vectors remain zero. The
+     * output is resized to match and may be the input.
+     *
+     * @return false if the output could not be resized
+     */
+    template<typename T>
+    bool normalize(const vector2d_soa<T> &a, vector2d_soa<T> &out) {
+        if (!out.resize(a.size())) {
+            return false;
+        }
+        __vector2d_kernels<T>::normalize(a.x_data(), a.y_data(), out.x_data(), out.y_data(), a.size());
+        return true;
+    }
+
+    /**
+     * Rotate every vector counter-clockwise about the origin. The
+     * sine and cosine are computed once. The output is resized to
+     * match and may be the input.
+     *
+     * @param angle rotation in radians
+     * @return false if the output could not be resized
+     */
+    template<typename T>
+    bool rotate(const vector2d_soa<T> &a, T angle, vector2d_soa<T> &out) {
+        if (!out.resize(a.size())) {
+            return false;
+        }
+        T c = static_cast<T>(cos(static_cast<double>(angle)));
+        T s = static_cast<T>(sin(static_cast<double>(angle)));
+        __vector2d_kernels<T>::rotate(a.x_data(), a.y_data(), c, s, out.x_data(), out.y_data(), a.size());
+        return true;
+    }
+
+    /**
+     * Compute the distance from each vector to a point.
+     *
+     * @param out array of at least @code a.size() @endcode elements
+     */
+    template<typename T>
+    void distance(const vector2d_soa<T> &a, const vector2d<T> &p, T *out) {
+        __vector2d_kernels<T>::distance(a.x_data(), a.y_data(), p.x(), p.y(), out, a.size());
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_VECTOR2DSOA_H
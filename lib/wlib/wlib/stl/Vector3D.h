@@ -0,0 +1,185 @@
+/**
+ * @file Vector3D.h
+ * @brief Three-component vector in the style of vector2d.
+ *
+ * The components are stored packed, so an array of vector3d is a
+ * plain run of @code 3 * n @endcode values that the batched
+ * transform functions in Transform.h can sweep directly.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_VECTOR3D_H
+#define EMBEDDEDCPLUSPLUS_VECTOR3D_H
+
+#include <math.h>
+
+#include <wlib/type_traits>
+#include <wlib/stl/InitializerList.h>
+
+namespace wlp {
+
+    template<typename val_t>
+    class vector3d {
+    public:
+        constexpr vector3d() :
+            m_x(0),
+            m_y(0),
+            m_z(0) {}
+
+        constexpr vector3d(val_t x, val_t y, val_t z) :
+            m_x(x),
+            m_y(y),
+            m_z(z) {}
+
+        vector3d(wlp::initializer_list<val_t> l) :
+            m_x(l.begin()[0]),
+            m_y(l.begin()[1]),
+            m_z(l.begin()[2]) {}
+
+        template<typename u_val_t>
+        vector3d(wlp::initializer_list<u_val_t> l) :
+            m_x(static_cast<val_t>(l.begin()[0])),
+            m_y(static_cast<val_t>(l.begin()[1])),
+            m_z(static_cast<val_t>(l.begin()[2])) {}
+
+        template<typename u_val_t>
+        constexpr vector3d(const vector3d<u_val_t> &p) :
+            m_x(static_cast<val_t>(p.x())),
+            m_y(static_cast<val_t>(p.y())),
+            m_z(static_cast<val_t>(p.z())) {}
+
+        val_t &x() {
+            return m_x;
+        }
+
+        val_t &y() {
+            return m_y;
+        }
+
+        val_t &z() {
+            return m_z;
+        }
+
+        constexpr const val_t &x() const {
+            return m_x;
+        }
+
+        constexpr const val_t &y() const {
+            return m_y;
+        }
+
+        constexpr const val_t &z() const {
+            return m_z;
+        }
+
+        val_t norm() const {
+            return static_cast<val_t>(sqrt(norm_sq()));
+        }
+
+        constexpr val_t norm_sq() const {
+            return m_x * m_x + m_y * m_y + m_z * m_z;
+        }
+
+        vector3d<val_t> n() const {
+            return *this / norm();
+        }
+
+        vector3d<val_t> &operator=(wlp::initializer_list<val_t> l) {
+            m_x = l.begin()[0];
+            m_y = l.begin()[1];
+            m_z = l.begin()[2];
+            return *this;
+        }
+
+        template<typename u_val_t>
+        vector3d<val_t> &operator=(wlp::initializer_list<u_val_t> l) {
+            m_x = static_cast<val_t>(l.begin()[0]);
+            m_y = static_cast<val_t>(l.begin()[1]);
+            m_z = static_cast<val_t>(l.begin()[2]);
+            return *this;
+        }
+
+        constexpr vector3d<val_t> operator+(const vector3d<val_t> &o) const {
+            return {m_x + o.m_x, m_y + o.m_y, m_z + o.m_z};
+        }
+
+        constexpr vector3d<val_t> operator-(const vector3d<val_t> &o) const {
+            return {m_x - o.m_x, m_y - o.m_y, m_z - o.m_z};
+        }
+
+        constexpr vector3d<val_t> operator-() const {
+            return {-m_x, -m_y, -m_z};
+        }
+
+        vector3d<val_t> &operator+=(const vector3d<val_t> &o) {
+            m_x += o.m_x;
+            m_y += o.m_y;
+            m_z += o.m_z;
+            return *this;
+        }
+
+        vector3d<val_t> &operator-=(const vector3d<val_t> &o) {
+            m_x -= o.m_x;
+            m_y -= o.m_y;
+            m_z -= o.m_z;
+            return *this;
+        }
+
+        constexpr bool operator==(const vector3d<val_t> &o) const {
+            return (m_x == o.m_x) && (m_y == o.m_y) && (m_z == o.m_z);
+        }
+
+        constexpr bool operator!=(const vector3d<val_t> &o) const {
+            return (m_x != o.m_x) || (m_y != o.m_y) || (m_z != o.m_z);
+        }
+
+        template<
+            typename scalar_t,
+            typename = typename enable_if<
+                is_arithmetic<scalar_t>::value
+            >::type
+        >
+        constexpr vector3d<val_t> operator*(scalar_t b) const {
+            return {
+                static_cast<val_t>(m_x * b),
+                static_cast<val_t>(m_y * b),
+                static_cast<val_t>(m_z * b)
+            };
+        };
+
+        template<
+            typename scalar_t,
+            typename = typename enable_if<
+                is_arithmetic<scalar_t>::value
+            >::type
+        >
+        constexpr vector3d<val_t> operator/(scalar_t b) const {
+            return {
+                static_cast<val_t>(m_x / b),
+                static_cast<val_t>(m_y / b),
+                static_cast<val_t>(m_z / b)
+            };
+        };
+
+        constexpr val_t dot(const vector3d<val_t> &v) const {
+            return m_x * v.m_x + m_y * v.m_y + m_z * v.m_z;
+        }
+
+        constexpr vector3d<val_t> cross(const vector3d<val_t> &w) const {
+            return {
+                m_y * w.m_z - m_z * w.m_y,
+                m_z * w.m_x - m_x * w.m_z,
+                m_x * w.m_y - m_y * w.m_x
+            };
+        }
+
+    private:
+        val_t m_x;
+        val_t m_y;
+        val_t m_z;
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_VECTOR3D_H
@@ -0,0 +1,351 @@
+/**
+ * @file Vector4D.h
+ * @brief Four-component vector in the style of vector2d.
+ *
+ * The arithmetic of vector4d, mat4 and quaternion is routed through
+ * the four-lane primitives in @code __vec4_ops @endcode, whose float
+ * specialization holds one value in a single SSE register. Other
+ * element types, or builds with @code WLIB_NO_SIMD @endcode, use
+ * plain loops.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_VECTOR4D_H
+#define EMBEDDEDCPLUSPLUS_VECTOR4D_H
+
+#include <math.h>
+
+#include <wlib/type_traits>
+#include <wlib/stl/InitializerList.h>
+#include <wlib/stl/SimdOps.h>
+#include <wlib/stl/Vector3D.h>
+
+namespace wlp {
+
+    /**
+     * Primitives over four packed values.
+     *
+     * @tparam T element type
+     */
+    template<typename T>
+    struct __vec4_ops {
+        static constexpr size_t alignment = alignof(T);
+
+        static void add(const T *a, const T *b, T *out) {
+            for (int i = 0; i < 4; ++i) {
+                out[i] = static_cast<T>(a[i] + b[i]);
+            }
+        }
+
+        static void sub(const T *a, const T *b, T *out) {
+            for (int i = 0; i < 4; ++i) {
+                out[i] = static_cast<T>(a[i] - b[i]);
+            }
+        }
+
+        static void mul(const T *a, const T *b, T *out) {
+            for (int i = 0; i < 4; ++i) {
+                out[i] = static_cast<T>(a[i] * b[i]);
+            }
+        }
+
+        static void scale(const T *a, T s, T *out) {
+            for (int i = 0; i < 4; ++i) {
+                out[i] = static_cast<T>(a[i] * s);
+            }
+        }
+
+        static T dot(const T *a, const T *b) {
+            return static_cast<T>(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+        }
+
+        /**
+         * Compute @code out = c[0] * s[0] + ... + c[3] * s[3] @endcode
+         * where each @code c[k] @endcode points to four values. This
+         * is the product of a column-major matrix and a vector.
+         */
+        static void combine(const T *const *c, const T *s, T *out) {
+            T r[4];
+            for (int i = 0; i < 4; ++i) {
+                r[i] = static_cast<T>(c[0][i] * s[0] + c[1][i] * s[1] + c[2][i] * s[2] + c[3][i] * s[3]);
+            }
+            for (int i = 0; i < 4; ++i) {
+                out[i] = r[i];
+            }
+        }
+
+        /**
+         * Hamilton product of quaternions stored as (x, y, z, w).
+         */
+        static void qmul(const T *a, const T *b, T *out) {
+            T x = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+            T y = a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0];
+            T z = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3];
+            T w = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+            out[0] = x;
+            out[1] = y;
+            out[2] = z;
+            out[3] = w;
+        }
+    };
+
+#ifdef WLIB_SIMD
+
+    template<>
+    struct __vec4_ops<float> {
+        static constexpr size_t alignment = 16;
+
+        static void add(const float *a, const float *b, float *out) {
+            _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+        }
+
+        static void sub(const float *a, const float *b, float *out) {
+            _mm_storeu_ps(out, _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+        }
+
+        static void mul(const float *a, const float *b, float *out) {
+            _mm_storeu_ps(out, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+        }
+
+        static void scale(const float *a, float s, float *out) {
+            _mm_storeu_ps(out, _mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(s)));
+        }
+
+        static float dot(const float *a, const float *b) {
+            __m128 p = _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b));
+            __m128 s = _mm_add_ps(p, _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 0, 1)));
+            s = _mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+            return _mm_cvtss_f32(s);
+        }
+
+        static void combine(const float *const *c, const float *s, float *out) {
+            __m128 r = _mm_mul_ps(_mm_loadu_ps(c[0]), _mm_set1_ps(s[0]));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(c[1]), _mm_set1_ps(s[1])));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(c[2]), _mm_set1_ps(s[2])));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(c[3]), _mm_set1_ps(s[3])));
+            _mm_storeu_ps(out, r);
+        }
+
+        static void qmul(const float *a, const float *b, float *out) {
+            __m128 qa = _mm_loadu_ps(a);
+            __m128 qb = _mm_loadu_ps(b);
+            __m128 t0 = _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(3, 3, 3, 3)), qb);
+            __m128 t1 = _mm_mul_ps(
+                _mm_shuffle_ps(qa, qa, _MM_SHUFFLE(0, 2, 1, 0)),
+                _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(0, 3, 3, 3)));
+            __m128 t2 = _mm_mul_ps(
+                _mm_shuffle_ps(qa, qa, _MM_SHUFFLE(1, 0, 2, 1)),
+                _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(1, 1, 0, 2)));
+            __m128 t3 = _mm_mul_ps(
+                _mm_shuffle_ps(qa, qa, _MM_SHUFFLE(2, 1, 0, 2)),
+                _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(2, 0, 2, 1)));
+            // the w lane subtracts the t1 and t2 terms instead of adding them
+            __m128 sign = _mm_set_ps(-0.0f, 0.0f, 0.0f, 0.0f);
+            __m128 r = _mm_add_ps(t0, _mm_xor_ps(_mm_add_ps(t1, t2), sign));
+            _mm_storeu_ps(out, _mm_sub_ps(r, t3));
+        }
+    };
+
+#endif // WLIB_SIMD
+
+    template<typename val_t>
+    class alignas(__vec4_ops<val_t>::alignment) vector4d {
+        typedef __vec4_ops<val_t> ops;
+
+    public:
+        constexpr vector4d() :
+            m_v{0, 0, 0, 0} {}
+
+        constexpr vector4d(val_t x, val_t y, val_t z, val_t w) :
+            m_v{x, y, z, w} {}
+
+        /**
+         * Extend a three-component vector with a fourth component.
+         */
+        constexpr vector4d(const vector3d<val_t> &v, val_t w) :
+            m_v{v.x(), v.y(), v.z(), w} {}
+
+        vector4d(wlp::initializer_list<val_t> l) :
+            m_v{l.begin()[0], l.begin()[1], l.begin()[2], l.begin()[3]} {}
+
+        template<typename u_val_t>
+        vector4d(wlp::initializer_list<u_val_t> l) :
+            m_v{
+                static_cast<val_t>(l.begin()[0]),
+                static_cast<val_t>(l.begin()[1]),
+                static_cast<val_t>(l.begin()[2]),
+                static_cast<val_t>(l.begin()[3])
+            } {}
+
+        template<typename u_val_t>
+        constexpr vector4d(const vector4d<u_val_t> &p) :
+            m_v{
+                static_cast<val_t>(p.x()),
+                static_cast<val_t>(p.y()),
+                static_cast<val_t>(p.z()),
+                static_cast<val_t>(p.w())
+            } {}
+
+        val_t &x() {
+            return m_v[0];
+        }
+
+        val_t &y() {
+            return m_v[1];
+        }
+
+        val_t &z() {
+            return m_v[2];
+        }
+
+        val_t &w() {
+            return m_v[3];
+        }
+
+        constexpr const val_t &x() const {
+            return m_v[0];
+        }
+
+        constexpr const val_t &y() const {
+            return m_v[1];
+        }
+
+        constexpr const val_t &z() const {
+            return m_v[2];
+        }
+
+        constexpr const val_t &w() const {
+            return m_v[3];
+        }
+
+        val_t &operator[](size_t i) {
+            return m_v[i];
+        }
+
+        constexpr const val_t &operator[](size_t i) const {
+            return m_v[i];
+        }
+
+        /**
+         * @return pointer to the four packed components
+         */
+        val_t *data() {
+            return m_v;
+        }
+
+        const val_t *data() const {
+            return m_v;
+        }
+
+        /**
+         * @return the first three components
+         */
+        constexpr vector3d<val_t> xyz() const {
+            return {m_v[0], m_v[1], m_v[2]};
+        }
+
+        val_t norm() const {
+            return static_cast<val_t>(sqrt(norm_sq()));
+        }
+
+        val_t norm_sq() const {
+            return ops::dot(m_v, m_v);
+        }
+
+        vector4d<val_t> n() const {
+            return *this / norm();
+        }
+
+        vector4d<val_t> &operator=(wlp::initializer_list<val_t> l) {
+            for (size_t i = 0; i < 4; ++i) {
+                m_v[i] = l.begin()[i];
+            }
+            return *this;
+        }
+
+        template<typename u_val_t>
+        vector4d<val_t> &operator=(wlp::initializer_list<u_val_t> l) {
+            for (size_t i = 0; i < 4; ++i) {
+                m_v[i] = static_cast<val_t>(l.begin()[i]);
+            }
+            return *this;
+        }
+
+        vector4d<val_t> operator+(const vector4d<val_t> &o) const {
+            vector4d<val_t> r;
+            ops::add(m_v, o.m_v, r.m_v);
+            return r;
+        }
+
+        vector4d<val_t> operator-(const vector4d<val_t> &o) const {
+            vector4d<val_t> r;
+            ops::sub(m_v, o.m_v, r.m_v);
+            return r;
+        }
+
+        vector4d<val_t> &operator+=(const vector4d<val_t> &o) {
+            ops::add(m_v, o.m_v, m_v);
+            return *this;
+        }
+
+        vector4d<val_t> &operator-=(const vector4d<val_t> &o) {
+            ops::sub(m_v, o.m_v, m_v);
+            return *this;
+        }
+
+        bool operator==(const vector4d<val_t> &o) const {
+            return m_v[0] == o.m_v[0] && m_v[1] == o.m_v[1] && m_v[2] == o.m_v[2] && m_v[3] == o.m_v[3];
+        }
+
+        bool operator!=(const vector4d<val_t> &o) const {
+            return !(*this == o);
+        }
+
+        template<
+            typename scalar_t,
+            typename = typename enable_if<
+                is_arithmetic<scalar_t>::value
+            >::type
+        >
+        vector4d<val_t> operator*(scalar_t b) const {
+            vector4d<val_t> r;
+            ops::scale(m_v, static_cast<val_t>(b), r.m_v);
+            return r;
+        };
+
+        template<
+            typename scalar_t,
+            typename = typename enable_if<
+                is_arithmetic<scalar_t>::value
+            >::type
+        >
+        vector4d<val_t> operator/(scalar_t b) const {
+            return {
+                static_cast<val_t>(m_v[0] / b),
+                static_cast<val_t>(m_v[1] / b),
+                static_cast<val_t>(m_v[2] / b),
+                static_cast<val_t>(m_v[3] / b)
+            };
+        };
+
+        /**
+         * @return the componentwise product
+         */
+        vector4d<val_t> operator*(const vector4d<val_t> &o) const {
+            vector4d<val_t> r;
+            ops::mul(m_v, o.m_v, r.m_v);
+            return r;
+        }
+
+        val_t dot(const vector4d<val_t> &v) const {
+            return ops::dot(m_v, v.m_v);
+        }
+
+    private:
+        val_t m_v[4];
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_VECTOR4D_H
@@ -14,6 +14,8 @@
 
 #include <wlib/strings/StringIterator.h>
 #include <wlib/tmp/NullptrType.h>
+#include <wlib/stl/Allocator.h>
+#include <wlib/stl/ContainerStats.h>
 #include <wlib/stl/Helper.h>
 #include <stdint.h>
 #include <string.h>
@@ -23,7 +25,10 @@ namespace wlp {
     template<size_t tSize>
     class static_string;
 
-    class dynamic_string;
+    template<typename Alloc>
+    class basic_dynamic_string;
+
+    typedef basic_dynamic_string<allocator> dynamic_string;
 
     template<size_t tSize>
     class static_string {
@@ -746,69 +751,103 @@ namespace wlp {
         return {&lhs, rhs.c_str(), 1, rhs.length()};
     }
 
-    class dynamic_string {
+    /**
+     * String of characters in a heap array that is reallocated to fit
+     * its contents. The array is obtained from an allocator.
+     *
+     * @tparam Alloc allocator of the character array
+     */
+    template<typename Alloc>
+    class basic_dynamic_string : private Alloc {
     public:
         // Required types for concept check
         typedef size_t size_type;
         typedef ptrdiff_t diff_type;
+        typedef Alloc allocator_type;
 
         // Iterator types
-        typedef StringIterator<dynamic_string, char &, char *> iterator;
-        typedef StringIterator<const dynamic_string, const char &, const char *> const_iterator;
+        typedef StringIterator<basic_dynamic_string, char &, char *> iterator;
+        typedef StringIterator<const basic_dynamic_string, const char &, const char *> const_iterator;
 
         /**
          * Default constructor creates string with no characters.
          */
-        dynamic_string();
+        basic_dynamic_string();
+
+        /**
+         * Create an empty string that allocates from the given allocator.
+         *
+         * @param alloc allocator of the character array
+         */
+        explicit basic_dynamic_string(const Alloc &alloc);
 
         /**
          * Constructor of nullptr_t makes empty string.
          */
-        explicit dynamic_string(nullptr_t);
+        explicit basic_dynamic_string(nullptr_t);
 
         /**
          * Constructor creates string using character array.
          *
-         * @param str char string
+         * @param str   char string
+         * @param alloc allocator of the character array
          */
-        explicit dynamic_string(const char *str);
+        explicit basic_dynamic_string(const char *str, const Alloc &alloc = Alloc());
 
         /**
          * Construct a dynamic string from a static string.
          *
-         * @param str static string to copy
+         * @param str   static string to copy
+         * @param alloc allocator of the character array
          */
         template<size_t tSize>
-        explicit dynamic_string(const static_string<tSize> &str)
-                : dynamic_string(str.c_str(), str.length()) {}
+        explicit basic_dynamic_string(const static_string<tSize> &str, const Alloc &alloc = Alloc())
+                : basic_dynamic_string(str.c_str(), str.length(), alloc) {}
 
         /**
          * Construct a dynamic string from a character array and
          * a known length.
          *
-         * @param str character array
-         * @param len length of the array
+         * @param str   character array
+         * @param len   length of the array
+         * @param alloc allocator of the character array
          */
-        dynamic_string(const char *str, size_type len);
+        basic_dynamic_string(const char *str, size_type len, const Alloc &alloc = Alloc());
 
         /**
          * Constructor creates string using DynamicString object.
          *
          * @param str @code DynamicString @endcode object
          */
-        dynamic_string(const dynamic_string &str);
+        basic_dynamic_string(const basic_dynamic_string &str);
 
         /**
          * Move constructor will transfer the underlying string.
          *
          * @param str the @code DynamicString @endcode to move
          */
-        dynamic_string(dynamic_string &&str) noexcept;
+        basic_dynamic_string(basic_dynamic_string &&str) noexcept;
 
         /**
           * Destructor for DynamicString object.
           */
-        ~dynamic_string();
+        ~basic_dynamic_string();
+
+        /**
+         * @return a copy of the allocator of this string
+         */
+        allocator_type get_allocator() const {
+            return *this;
+        }
+
+#ifdef WLIB_CONTAINER_STATS
+        /**
+         * @return the operation counters of this string
+         */
+        const container_stats &stats() const {
+            return m_stats;
+        }
+#endif
 
         void set_value(const char *str, size_type len);
 
@@ -818,10 +857,10 @@ namespace wlp {
          * @param str @code DynamicString @endcode object
          * @return current object
          */
-        dynamic_string &operator=(const dynamic_string &str);
+        basic_dynamic_string &operator=(const basic_dynamic_string &str);
 
         template<size_t tSize>
-        dynamic_string &operator=(const static_string<tSize> &str) {
+        basic_dynamic_string &operator=(const static_string<tSize> &str) {
             set_value(str.c_str(), str.length());
             return *this;
         }
@@ -832,7 +871,7 @@ namespace wlp {
          * @param str
          * @return current object
          */
-        dynamic_string &operator=(const char *str);
+        basic_dynamic_string &operator=(const char *str);
 
         /**
          * Move assignment operator transfers the underlying
@@ -840,7 +879,7 @@ namespace wlp {
          *
          * @param str the @code DynamicString @endcode to move
          */
-        dynamic_string &operator=(dynamic_string &&str) noexcept;
+        basic_dynamic_string &operator=(basic_dynamic_string &&str) noexcept;
 
         /**
          * Assignment operator for a single character.
@@ -848,7 +887,7 @@ namespace wlp {
          * @param c character to assign
          * @return reference to this string
          */
-        dynamic_string &operator=(char c);
+        basic_dynamic_string &operator=(char c);
 
         /**
          * Provides current length of string.
@@ -945,7 +984,7 @@ namespace wlp {
          * @param c character to add
          * @return the current string
          */
-        dynamic_string &operator+=(char c);
+        basic_dynamic_string &operator+=(char c);
 
         /**
          * Modifier operator adds char string to the current string.
@@ -953,18 +992,18 @@ namespace wlp {
          * @param val char string to add
          * @return the current string
          */
-        dynamic_string &operator+=(const char *val);
+        basic_dynamic_string &operator+=(const char *val);
 
         /**
-         * Modifier operator adds @code dynamic_string @endcode object to the current string.
+         * Modifier operator adds @code basic_dynamic_string @endcode object to the current string.
          *
          * @param other @code DynamicString @endcode string to add
          * @return the current string
          */
-        dynamic_string &operator+=(const dynamic_string &other);
+        basic_dynamic_string &operator+=(const basic_dynamic_string &other);
 
         template<size_t tSize>
-        dynamic_string &operator+=(const static_string<tSize> &str) {
+        basic_dynamic_string &operator+=(const static_string<tSize> &str) {
             return append(str.c_str(), str.length());
         }
 
@@ -974,7 +1013,7 @@ namespace wlp {
          * @param str character string to add
          * @return the current string
          */
-        dynamic_string &append(const char *str);
+        basic_dynamic_string &append(const char *str);
 
         /**
          * Appends a DynamicString string to the current string.
@@ -982,7 +1021,7 @@ namespace wlp {
          * @param str DynamicString string to add
          * @return the current string
          */
-        dynamic_string &append(const dynamic_string &str);
+        basic_dynamic_string &append(const basic_dynamic_string &str);
 
         /**
          * Appends a character to the current string.
@@ -1024,7 +1063,8 @@ namespace wlp {
          * with one of size @code len + 1 @endcode. The first character
          * is set to null and the length is zero to zero.
          *
-         * Used for direct writing to the underlying array.
+         * Used for direct writing to the underlying array. If the
+         * array cannot be allocated, @code c_str @endcode is null.
          *
          * @param len the number of characters to hold
          */
@@ -1045,7 +1085,7 @@ namespace wlp {
          * @param length length of the new string
          * @return new string which is a substring of current string
          */
-        dynamic_string substr(size_type pos, size_type length) const;
+        basic_dynamic_string substr(size_type pos, size_type length) const;
 
         /**
          * Compares two strings and return 0 if they are equal, less than 0 if
@@ -1055,7 +1095,7 @@ namespace wlp {
          * @param str @code DynamicString string to compare against current string
          * @return a signed number based on how strings compare
          */
-        diff_type compare(const dynamic_string &str) const;
+        diff_type compare(const basic_dynamic_string &str) const;
 
         template<size_t tSize>
         diff_type compare(const static_string<tSize> &str) const {
@@ -1099,32 +1139,54 @@ namespace wlp {
         }
 
         template<size_t tSize>
-        dynamic_string operator+(const static_string<tSize> &str) {
-            return {m_buffer, str.c_str(), m_len, str.length()};
+        basic_dynamic_string operator+(const static_string<tSize> &str) {
+            return {m_buffer, str.c_str(), m_len, str.length(), get_allocator()};
         }
 
     private:
         char *m_buffer;
         size_type m_len;
+        /**
+         * Size of the backing array, which is handed back to the
+         * allocator along with it.
+         */
+        size_type m_size;
+
+#ifdef WLIB_CONTAINER_STATS
+        container_stats m_stats{&container_stats_global(dynamic_string_kind)};
+#endif
+
+        Alloc &get_alloc() {
+            return *this;
+        }
 
         /**
-         * Constructor used by other String constructors to create @code dynamic_string @endcode.
+         * Replace the backing array with a new one of the given size.
+         * The contents are not preserved.
+         */
+        void reallocate(size_type size);
+
+        /**
+         * Constructor used by other String constructors to create @code basic_dynamic_string @endcode.
          *
          * @param str1 first string to use in making
          * @param str2 second string to use in making
          * @param len1 length of first string
          * @param len2 length of second string
+         * @param alloc allocator of the character array
          */
-        dynamic_string(const char *str1, const char *str2, size_type len1, size_type len2);
+        basic_dynamic_string(const char *str1, const char *str2, size_type len1, size_type len2,
+                             const Alloc &alloc);
 
         /**
-         * Constructor for populating a dynamic_string with a dynamically allocated
+         * Constructor for populating a basic_dynamic_string with a dynamically allocated
          * character array which the string takes ownership of and its length.
          *
          * @param str dynamically allocated character array filled with characters
          * @param len length of the string
+         * @param alloc the allocator that allocated @p str, with size @p len + 1
          */
-        dynamic_string(size_type len, char *str);
+        basic_dynamic_string(size_type len, char *str, const Alloc &alloc);
 
         /**
          * Append method used by other public append methods.
@@ -1133,35 +1195,445 @@ namespace wlp {
          * @param len length of @p c_str
          * @return the @code DynamicString @endcode with @p c_str append to it
          */
-        dynamic_string &append(const char *c_str, size_type len);
+        basic_dynamic_string &append(const char *c_str, size_type len);
+
+        template<typename A>
+        friend basic_dynamic_string<A> operator+(const basic_dynamic_string<A> &lhs, const basic_dynamic_string<A> &rhs);
+
+        template<typename A>
+        friend basic_dynamic_string<A> operator+(const char *lhs, const basic_dynamic_string<A> &rhs);
+
+        template<typename A>
+        friend basic_dynamic_string<A> operator+(const basic_dynamic_string<A> &lhs, const char *rhs);
 
-        friend dynamic_string operator+(const dynamic_string &lhs, const dynamic_string &rhs);
-        friend dynamic_string operator+(const char *lhs, const dynamic_string &rhs);
-        friend dynamic_string operator+(const dynamic_string &lhs, const char *rhs);
-        friend dynamic_string operator+(char lhs, const dynamic_string &rhs);
-        friend dynamic_string operator+(const dynamic_string &lhs, char rhs);
+        template<typename A>
+        friend basic_dynamic_string<A> operator+(char lhs, const basic_dynamic_string<A> &rhs);
+
+        template<typename A>
+        friend basic_dynamic_string<A> operator+(const basic_dynamic_string<A> &lhs, char rhs);
     };
 
-    bool operator==(const dynamic_string &lhs, const dynamic_string &rhs);
-    bool operator!=(const dynamic_string &lhs, const dynamic_string &rhs);
-    bool operator>(const dynamic_string &lhs, const dynamic_string &rhs);
-    bool operator>=(const dynamic_string &lhs, const dynamic_string &rhs);
-    bool operator<(const dynamic_string &lhs, const dynamic_string &rhs);
-    bool operator<=(const dynamic_string &lhs, const dynamic_string &rhs);
-    bool operator==(const char *lhs, const dynamic_string &rhs);
-    bool operator!=(const char *lhs, const dynamic_string &rhs);
-    bool operator>(const char *lhs, const dynamic_string &rhs);
-    bool operator>=(const char *lhs, const dynamic_string &rhs);
-    bool operator<(const char *lhs, const dynamic_string &rhs);
-    bool operator<=(const char *lhs, const dynamic_string &rhs);
-    bool operator==(const dynamic_string &lhs, const char *rhs);
-    bool operator!=(const dynamic_string &lhs, const char *rhs);
-    bool operator>(const dynamic_string &lhs, const char *rhs);
-    bool operator>=(const dynamic_string &lhs, const char *rhs);
-    bool operator<(const dynamic_string &lhs, const char *rhs);
-    bool operator<=(const dynamic_string &lhs, const char *rhs);
-    bool operator==(char lhs, const dynamic_string &rhs);
-    bool operator==(const dynamic_string &lhs, char rhs);
+    template<typename Alloc>
+    basic_dynamic_string<Alloc>::basic_dynamic_string()
+            : basic_dynamic_string(nullptr, nullptr, 0, 0, Alloc()) {}
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc>::basic_dynamic_string(const Alloc &alloc)
+            : basic_dynamic_string(nullptr, nullptr, 0, 0, alloc) {}
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc>::basic_dynamic_string(nullptr_t)
+            : basic_dynamic_string(nullptr, nullptr, 0, 0, Alloc()) {}
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc>::basic_dynamic_string(const char *str, const Alloc &alloc)
+            : basic_dynamic_string(str, nullptr, static_cast<size_type>(strlen(str)), 0, alloc) {}
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc>::basic_dynamic_string(const char *str, size_type len, const Alloc &alloc)
+            : basic_dynamic_string(str, nullptr, len, 0, alloc) {}
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc>::basic_dynamic_string(size_type len, char *str, const Alloc &alloc)
+            : Alloc(alloc),
+              m_buffer(str),
+              m_len(len),
+              m_size(static_cast<size_type>(len + 1)) {}
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc>::basic_dynamic_string(const basic_dynamic_string &str)
+            : basic_dynamic_string(str.c_str(), nullptr, str.length(), 0, str.get_allocator()) {}
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc>::basic_dynamic_string(basic_dynamic_string &&str) noexcept
+            : Alloc(str.get_allocator()),
+              m_buffer(str.m_buffer),
+              m_len(str.m_len),
+              m_size(str.m_size) {
+        str.m_buffer = nullptr;
+        str.reallocate(1);
+        str.m_buffer[0] = '\0';
+        str.m_len = 0;
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc>::basic_dynamic_string(
+            const char *str1, const char *str2,
+            size_type len1, size_type len2,
+            const Alloc &alloc)
+            : Alloc(alloc),
+              m_buffer(nullptr),
+              m_len(static_cast<size_type>(len1 + len2)),
+              m_size(0) {
+        reallocate(static_cast<size_type>(m_len + 1));
+        memcpy(m_buffer, str1, len1);
+        memcpy(m_buffer + len1, str2, len2);
+        m_buffer[m_len] = '\0';
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc>::~basic_dynamic_string() {
+        alloc_destroy_array(get_alloc(), m_buffer, m_size);
+    }
+
+    template<typename Alloc>
+    void basic_dynamic_string<Alloc>::reallocate(size_type size) {
+        alloc_destroy_array(get_alloc(), m_buffer, m_size);
+        m_buffer = alloc_create_array<char>(get_alloc(), size);
+        m_size = size;
+    }
+
+    template<typename Alloc>
+    void basic_dynamic_string<Alloc>::set_value(const char *str, size_type len) {
+        if (len >= m_size) {
+            WLIB_CONTAINER_STAT(m_stats.record_growth(0));
+            reallocate(static_cast<size_type>(len + 1));
+        }
+        m_len = len;
+        memcpy(m_buffer, str, len);
+        m_buffer[len] = '\0';
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> &basic_dynamic_string<Alloc>::operator=(const basic_dynamic_string &str) {
+        set_value(str.c_str(), str.length());
+        return *this;
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> &basic_dynamic_string<Alloc>::operator=(const char *str) {
+        set_value(str, static_cast<size_type>(strlen(str)));
+        return *this;
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> &basic_dynamic_string<Alloc>::operator=(basic_dynamic_string &&str) noexcept {
+        alloc_destroy_array(get_alloc(), m_buffer, m_size);
+        get_alloc() = str.get_alloc();
+        m_buffer = str.m_buffer;
+        m_len = str.m_len;
+        m_size = str.m_size;
+        str.m_buffer = nullptr;
+        str.reallocate(1);
+        str.m_buffer[0] = '\0';
+        str.m_len = 0;
+        return *this;
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> &basic_dynamic_string<Alloc>::operator=(const char c) {
+        const char array[2] = {c, '\0'};
+        set_value(array, 1);
+        return *this;
+    }
+
+    template<typename Alloc>
+    typename basic_dynamic_string<Alloc>::size_type basic_dynamic_string<Alloc>::length() const {
+        return m_len;
+    }
+
+    template<typename Alloc>
+    typename basic_dynamic_string<Alloc>::size_type basic_dynamic_string<Alloc>::capacity() const {
+        return static_cast<size_type>(-1);
+    }
+
+    template<typename Alloc>
+    void basic_dynamic_string<Alloc>::clear() noexcept {
+        m_buffer[0] = '\0';
+        m_len = 0;
+    }
+
+    template<typename Alloc>
+    char &basic_dynamic_string<Alloc>::operator[](size_type pos) {
+        return m_buffer[pos];
+    }
+
+    template<typename Alloc>
+    const char &basic_dynamic_string<Alloc>::operator[](size_type pos) const {
+        return m_buffer[pos];
+    }
+
+    template<typename Alloc>
+    char &basic_dynamic_string<Alloc>::at(size_type pos) {
+        return pos < m_len ? m_buffer[pos] : m_buffer[m_len];
+    }
+
+    template<typename Alloc>
+    const char &basic_dynamic_string<Alloc>::at(size_type pos) const {
+        return pos < m_len ? m_buffer[pos] : m_buffer[m_len];
+    }
+
+    template<typename Alloc>
+    bool basic_dynamic_string<Alloc>::empty() const {
+        return m_len == 0;
+    }
+
+    template<typename Alloc>
+    char &basic_dynamic_string<Alloc>::front() {
+        return m_buffer[0];
+    }
+
+    template<typename Alloc>
+    const char &basic_dynamic_string<Alloc>::front() const {
+        return m_buffer[0];
+    }
+
+    template<typename Alloc>
+    char &basic_dynamic_string<Alloc>::back() {
+        return empty() ? m_buffer[0] : m_buffer[m_len - 1];
+    }
+
+    template<typename Alloc>
+    const char &basic_dynamic_string<Alloc>::back() const {
+        return empty() ? m_buffer[0] : m_buffer[m_len - 1];
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> &basic_dynamic_string<Alloc>::operator+=(char c) {
+        const char array[2] = {c, '\0'};
+        return append(array, 1);
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> &basic_dynamic_string<Alloc>::operator+=(const char *val) {
+        return append(val, static_cast<size_type>(strlen(val)));
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> &basic_dynamic_string<Alloc>::operator+=(const basic_dynamic_string &other) {
+        return append(other.c_str(), other.length());
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> &basic_dynamic_string<Alloc>::append(const char *c_str, size_type len) {
+        auto newLength = static_cast<size_type>(m_len + len);
+        char *newBuffer = alloc_create_array<char>(get_alloc(), static_cast<size_type>(newLength + 1));
+        memcpy(newBuffer, m_buffer, m_len);
+        memcpy(newBuffer + m_len, c_str, len);
+        WLIB_CONTAINER_STAT(m_stats.record_growth(m_len));
+        alloc_destroy_array(get_alloc(), m_buffer, m_size);
+        m_buffer = newBuffer;
+        m_size = static_cast<size_type>(newLength + 1);
+
+        m_buffer[newLength] = '\0';
+        m_len = newLength;
+
+        return *this;
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> &basic_dynamic_string<Alloc>::append(const char *str) {
+        return append(str, static_cast<size_type>(strlen(str)));
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> &basic_dynamic_string<Alloc>::append(const basic_dynamic_string &str) {
+        return append(str.c_str(), str.length());
+    }
+
+    template<typename Alloc>
+    void basic_dynamic_string<Alloc>::push_back(const char c) {
+        const char array[2] = {c, '\0'};
+        append(array, 1);
+    }
+
+    template<typename Alloc>
+    void basic_dynamic_string<Alloc>::erase(size_type pos) {
+        if (m_len == 0 || pos >= m_len) { return; }
+        m_len--;
+        memmove(m_buffer + pos, m_buffer + pos + 1, m_len - pos);
+        m_buffer[m_len] = '\0';
+    }
+
+    template<typename Alloc>
+    void basic_dynamic_string<Alloc>::pop_back() {
+        if (m_len != 0) {
+            m_buffer[m_len - 1] = '\0';
+            m_len--;
+        }
+    }
+
+    template<typename Alloc>
+    char *basic_dynamic_string<Alloc>::c_str() {
+        return m_buffer;
+    }
+
+    template<typename Alloc>
+    const char *basic_dynamic_string<Alloc>::c_str() const {
+        return m_buffer;
+    }
+
+    template<typename Alloc>
+    void basic_dynamic_string<Alloc>::resize(size_type len) {
+        reallocate(static_cast<size_type>(len + 1));
+        if (m_buffer) {
+            m_buffer[0] = '\0';
+        }
+        m_len = 0;
+    }
+
+    template<typename Alloc>
+    void basic_dynamic_string<Alloc>::length_set(size_type len) {
+        m_len = len;
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> basic_dynamic_string<Alloc>::substr(size_type pos, size_type length) const {
+        length = pos >= m_len ? 0 : MIN(length, m_len - pos);
+        Alloc alloc = get_allocator();
+        char *newBuffer = alloc_create_array<char>(alloc, static_cast<size_type>(length + 1));
+        memcpy(newBuffer, m_buffer + pos, length);
+        newBuffer[length] = '\0';
+        return {length, newBuffer, alloc};
+    }
+
+    template<typename Alloc>
+    typename basic_dynamic_string<Alloc>::diff_type
+    basic_dynamic_string<Alloc>::compare(const basic_dynamic_string &str) const {
+        return compare(str.c_str());
+    }
+
+    template<typename Alloc>
+    typename basic_dynamic_string<Alloc>::diff_type basic_dynamic_string<Alloc>::compare(const char *str) const {
+        return static_cast<diff_type>(strcmp(c_str(), str));
+    }
+
+    template<typename Alloc>
+    typename basic_dynamic_string<Alloc>::diff_type basic_dynamic_string<Alloc>::compare(char c) const {
+        const char array[2] = {c, '\0'};
+        return static_cast<diff_type>(strcmp(c_str(), array));
+    }
+
+    template<typename Alloc>
+    bool operator==(const basic_dynamic_string<Alloc> &lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return lhs.compare(rhs) == 0;
+    }
+
+    template<typename Alloc>
+    bool operator!=(const basic_dynamic_string<Alloc> &lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return lhs.compare(rhs) != 0;
+    }
+
+    template<typename Alloc>
+    bool operator>(const basic_dynamic_string<Alloc> &lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<typename Alloc>
+    bool operator>=(const basic_dynamic_string<Alloc> &lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<typename Alloc>
+    bool operator<(const basic_dynamic_string<Alloc> &lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<typename Alloc>
+    bool operator<=(const basic_dynamic_string<Alloc> &lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<typename Alloc>
+    bool operator==(const char *lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return rhs.compare(lhs) == 0;
+    }
+
+    template<typename Alloc>
+    bool operator!=(const char *lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return rhs.compare(lhs) != 0;
+    }
+
+    template<typename Alloc>
+    bool operator>(const char *lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return rhs.compare(lhs) <= 0;
+    }
+
+    template<typename Alloc>
+    bool operator>=(const char *lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return rhs.compare(lhs) < 0;
+    }
+
+    template<typename Alloc>
+    bool operator<(const char *lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return rhs.compare(lhs) >= 0;
+    }
+
+    template<typename Alloc>
+    bool operator<=(const char *lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return rhs.compare(lhs) > 0;
+    }
+
+    template<typename Alloc>
+    bool operator==(const basic_dynamic_string<Alloc> &lhs, const char *rhs) {
+        return lhs.compare(rhs) == 0;
+    }
+
+    template<typename Alloc>
+    bool operator!=(const basic_dynamic_string<Alloc> &lhs, const char *rhs) {
+        return lhs.compare(rhs) != 0;
+    }
+
+    template<typename Alloc>
+    bool operator>(const basic_dynamic_string<Alloc> &lhs, const char *rhs) {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<typename Alloc>
+    bool operator>=(const basic_dynamic_string<Alloc> &lhs, const char *rhs) {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<typename Alloc>
+    bool operator<(const basic_dynamic_string<Alloc> &lhs, const char *rhs) {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<typename Alloc>
+    bool operator<=(const basic_dynamic_string<Alloc> &lhs, const char *rhs) {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<typename Alloc>
+    bool operator==(char lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return rhs.compare(lhs) == 0;
+    }
+
+    template<typename Alloc>
+    bool operator==(const basic_dynamic_string<Alloc> &lhs, char rhs) {
+        return lhs.compare(rhs) == 0;
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> operator+(const basic_dynamic_string<Alloc> &lhs, const basic_dynamic_string<Alloc> &rhs) {
+        return {lhs.c_str(), rhs.c_str(), lhs.length(), rhs.length(), lhs.get_allocator()};
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> operator+(const char *lhs, const basic_dynamic_string<Alloc> &rhs) {
+        typedef typename basic_dynamic_string<Alloc>::size_type size_type;
+        return {lhs, rhs.c_str(), static_cast<size_type>(strlen(lhs)), rhs.length(), rhs.get_allocator()};
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> operator+(const basic_dynamic_string<Alloc> &lhs, const char *rhs) {
+        typedef typename basic_dynamic_string<Alloc>::size_type size_type;
+        return {lhs.c_str(), rhs, lhs.length(), static_cast<size_type>(strlen(rhs)), lhs.get_allocator()};
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> operator+(char lhs, const basic_dynamic_string<Alloc> &rhs) {
+        const char temp[2] = {lhs, '\0'};
+        return {temp, rhs.c_str(), 1, rhs.length(), rhs.get_allocator()};
+    }
+
+    template<typename Alloc>
+    basic_dynamic_string<Alloc> operator+(const basic_dynamic_string<Alloc> &lhs, char rhs) {
+        const char temp[2] = {rhs, '\0'};
+        return {lhs.c_str(), temp, lhs.length(), 1, lhs.get_allocator()};
+    }
+
+    extern template class basic_dynamic_string<allocator>;
 
     template<size_t tSize>
     static_string<tSize>::static_string(const dynamic_string &str)
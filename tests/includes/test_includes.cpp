@@ -1,8 +1,12 @@
 #include <wlib/array_heap>
 #include <wlib/array_list>
+#include <wlib/allocator>
+#include <wlib/arena>
 #include <wlib/array2d>
+#include <wlib/array2d_kernels>
 #include <wlib/bit_set>
 #include <wlib/comparator>
+#include <wlib/container_stats>
 #include <wlib/dynamic_string>
 #include <wlib/equals>
 #include <wlib/hash>
@@ -10,15 +14,28 @@
 #include <wlib/hash_set>
 #include <wlib/hash_table>
 #include <wlib/initializer_list>
+#include <wlib/latency_histogram>
 #include <wlib/linked_list>
+#include <wlib/mem_stats>
 #include <wlib/memory>
+#include <wlib/mpmc_queue>
 #include <wlib/open_map>
 #include <wlib/open_set>
 #include <wlib/open_table>
 #include <wlib/pair>
+#include <wlib/parallel_algorithm>
+#include <wlib/count_policy>
 #include <wlib/shared_ptr>
+#include <wlib/atomic_shared_ptr>
+#include <wlib/intrusive_ptr>
+#include <wlib/slot_map>
+#include <wlib/sparse_map>
+#include <wlib/sparse_set>
+#include <wlib/spsc_queue>
 #include <wlib/static_string>
 #include <wlib/string>
+#include <wlib/thread_cache>
+#include <wlib/thread_pool>
 #include <wlib/tree>
 #include <wlib/tree_map>
 #include <wlib/tree_set>
@@ -27,6 +44,13 @@
 #include <wlib/unique_ptr>
 #include <wlib/utility>
 #include <wlib/vector2d>
+#include <wlib/vector2d_soa>
+#include <wlib/vector3d>
+#include <wlib/vector4d>
+#include <wlib/mat3>
+#include <wlib/mat4>
+#include <wlib/quaternion>
+#include <wlib/transform>
 
 void include_test() {
     wlp::array_list<int> list;
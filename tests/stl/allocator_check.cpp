@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <wlib/stl/Allocator.h>
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/LinkedList.h>
+#include <wlib/stl/HashMap.h>
+#include <wlib/stl/HashSet.h>
+#include <wlib/stl/OpenMap.h>
+#include <wlib/stl/OpenSet.h>
+#include <wlib/stl/TreeMap.h>
+#include <wlib/stl/TreeSet.h>
+#include <wlib/stl/SharedPtr.h>
+#include <wlib/strings/String.h>
+
+using namespace wlp;
+
+struct alloc_stats {
+    int allocations;
+    int deallocations;
+    size_t bytes;
+};
+
+/**
+ * Stateful allocator that counts into the statistics it was given, and
+ * checks that every deallocation returns the size it was allocated with.
+ */
+struct stats_allocator {
+    alloc_stats *stats;
+
+    explicit stats_allocator(alloc_stats *s)
+            : stats(s) {}
+
+    void *allocate(size_t size, size_t align) {
+        ++stats->allocations;
+        stats->bytes += size;
+        return allocator().allocate(size, align);
+    }
+
+    void deallocate(void *ptr, size_t size, size_t align) {
+        ++stats->deallocations;
+        stats->bytes -= size;
+        allocator().deallocate(ptr, size, align);
+    }
+};
+
+typedef basic_dynamic_string<stats_allocator> counted_string;
+
+TEST(allocator_test, test_stateless_allocator_takes_no_space) {
+    struct plain_list {
+        int *data;
+        size_t size;
+        size_t capacity;
+    };
+#ifndef WLIB_CONTAINER_STATS
+    static_assert(sizeof(array_list<int>) == sizeof(plain_list), "array_list grew");
+#endif
+    static_assert(sizeof(array_list<int, stats_allocator>) > sizeof(array_list<int>), "stateful allocator not stored");
+    static_assert(sizeof(tree_map<int, int>) == sizeof(tree_map<int, int, comparator<int>, allocator>), "defaults differ");
+    static_assert(__is_empty(allocator), "default allocator must be empty");
+}
+
+TEST(allocator_test, test_alloc_create_destroy) {
+    alloc_stats stats = {0, 0, 0};
+    stats_allocator alloc(&stats);
+    int *i = alloc_create<int>(alloc, 7);
+    ASSERT_EQ(7, *i);
+    int *arr = alloc_create_array<int>(alloc, 10);
+    ASSERT_EQ(0, arr[9]);
+    ASSERT_EQ(2, stats.allocations);
+    ASSERT_EQ(sizeof(int) * 11, stats.bytes);
+    alloc_destroy(alloc, i);
+    alloc_destroy_array(alloc, arr, 10);
+    alloc_destroy(alloc, static_cast<int *>(nullptr));
+    ASSERT_EQ(2, stats.deallocations);
+    ASSERT_EQ(0u, stats.bytes);
+}
+
+TEST(allocator_test, test_over_aligned_allocation) {
+    struct alignas(64) wide {
+        char c;
+    };
+    allocator alloc;
+    wide *w = alloc_create_array<wide>(alloc, 3);
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(w) % 64);
+    alloc_destroy_array(alloc, w, 3);
+}
+
+TEST(allocator_test, test_sequence_containers) {
+    alloc_stats stats = {0, 0, 0};
+    {
+        array_list<int, stats_allocator> list(4, stats_allocator(&stats));
+        for (int i = 0; i < 20; ++i) {
+            list.push_back(i);
+        }
+        ASSERT_EQ(19, list[19]);
+        ASSERT_TRUE(list.get_allocator().stats == &stats);
+        array_list<int, stats_allocator> moved(move(list));
+        ASSERT_EQ(20u, moved.size());
+
+        linked_list<int, stats_allocator> ll{stats_allocator(&stats)};
+        ll.push_back(1);
+        ll.push_front(0);
+        ASSERT_EQ(0, ll.front());
+    }
+    ASSERT_LT(0, stats.allocations);
+    ASSERT_EQ(stats.allocations, stats.deallocations);
+    ASSERT_EQ(0u, stats.bytes);
+}
+
+TEST(allocator_test, test_associative_containers) {
+    alloc_stats stats = {0, 0, 0};
+    {
+        hash_map<int, int, hash<int, uint16_t>, equals<int>, stats_allocator>
+                hmap(4, 75, stats_allocator(&stats));
+        open_map<int, int, hash<int, uint16_t>, equals<int>, stats_allocator>
+                omap(4, 75, stats_allocator(&stats));
+        tree_map<int, int, comparator<int>, stats_allocator> tmap{stats_allocator(&stats)};
+        hash_set<int, hash<int, uint16_t>, equals<int>, stats_allocator>
+                hset(4, 75, stats_allocator(&stats));
+        open_set<int, hash<int, uint16_t>, equals<int>, stats_allocator>
+                oset(4, 75, stats_allocator(&stats));
+        tree_set<int, comparator<int>, stats_allocator> tset{stats_allocator(&stats)};
+        for (int i = 0; i < 50; ++i) {
+            hmap.insert(i, i);
+            omap.insert(i, i);
+            tmap.insert(i, i);
+            hset.insert(i);
+            oset.insert(i);
+            tset.insert(i);
+        }
+        for (int i = 0; i < 50; i += 2) {
+            hmap.erase(i);
+            omap.erase(i);
+            tmap.erase(i);
+        }
+        ASSERT_EQ(25u, hmap.size());
+        ASSERT_EQ(25u, omap.size());
+        ASSERT_EQ(25u, tmap.size());
+        ASSERT_EQ(49, hmap[49]);
+        ASSERT_EQ(49, omap[49]);
+        ASSERT_EQ(49, tmap[49]);
+    }
+    ASSERT_LT(0, stats.allocations);
+    ASSERT_EQ(stats.allocations, stats.deallocations);
+    ASSERT_EQ(0u, stats.bytes);
+}
+
+TEST(allocator_test, test_dynamic_string) {
+    alloc_stats stats = {0, 0, 0};
+    {
+        stats_allocator alloc(&stats);
+        counted_string s1("hello", alloc);
+        counted_string s2(s1);
+        s2 += " world";
+        counted_string s3 = s1 + s2;
+        ASSERT_STREQ("hellohello world", s3.c_str());
+        ASSERT_TRUE(s3.substr(5, 5) == "hello");
+        s1 = "a much longer string than before";
+        counted_string s4(move(s1));
+        s1 = move(s4);
+        ASSERT_TRUE(s1 == "a much longer string than before");
+        s2.resize(40);
+        s2 = 'x';
+        ASSERT_EQ(1u, s2.length());
+        ASSERT_TRUE(s2 == 'x');
+    }
+    ASSERT_LT(0, stats.allocations);
+    ASSERT_EQ(stats.allocations, stats.deallocations);
+    ASSERT_EQ(0u, stats.bytes);
+}
+
+struct Tracked {
+    static int destructs;
+
+    ~Tracked() { ++destructs; }
+};
+
+int Tracked::destructs = 0;
+
+TEST(allocator_test, test_shared_ptr_count_allocator) {
+    alloc_stats stats = {0, 0, 0};
+    Tracked::destructs = 0;
+    {
+        shared_ptr<Tracked> sp(create<Tracked>(), stats_allocator(&stats));
+        ASSERT_EQ(1, stats.allocations);
+        weak_ptr<Tracked> wp(sp);
+        sp.reset();
+        ASSERT_EQ(1, Tracked::destructs);
+        ASSERT_EQ(0, stats.deallocations);
+    }
+    ASSERT_EQ(1, stats.deallocations);
+    ASSERT_EQ(0u, stats.bytes);
+}
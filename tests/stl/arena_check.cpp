@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <wlib/stl/Arena.h>
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/HashMap.h>
+#include <wlib/strings/String.h>
+
+using namespace wlp;
+
+typedef array_list<int, arena_allocator> arena_list;
+typedef hash_map<int, int, hash<int, uint16_t>, equals<int>, arena_allocator> arena_map;
+typedef basic_dynamic_string<arena_allocator> arena_string;
+
+TEST(arena_test, test_bump_and_alignment) {
+    char buffer[256];
+    arena a(buffer, sizeof(buffer), 0);
+    char *c = static_cast<char *>(a.allocate(1, 1));
+    ASSERT_TRUE(c >= buffer && c < buffer + sizeof(buffer));
+    void *d = a.allocate(sizeof(double), alignof(double));
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(d) % alignof(double));
+    void *w = a.allocate(8, 64);
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(w) % 64);
+    ASSERT_TRUE(a.used() <= sizeof(buffer));
+    ASSERT_TRUE(a.allocate(512, 1) == nullptr);
+    ASSERT_EQ(sizeof(buffer), a.capacity());
+}
+
+TEST(arena_test, test_last_allocation_is_reclaimed) {
+    inline_arena<128> a(0);
+    void *p = a.allocate(32, 8);
+    size_t used = a.used();
+    void *q = a.allocate(16, 8);
+    a.deallocate(p, 32, 8);
+    ASSERT_EQ(used + 16, a.used());
+    a.deallocate(q, 16, 8);
+    ASSERT_EQ(used, a.used());
+}
+
+TEST(arena_test, test_growth_and_reuse_after_reset) {
+    char buffer[64];
+    arena a(buffer, sizeof(buffer), 128);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(a.allocate(40, 8) != nullptr);
+    }
+    size_t capacity = a.capacity();
+    ASSERT_GT(capacity, sizeof(buffer));
+    void *big = a.allocate(1000, 8);
+    ASSERT_TRUE(big != nullptr);
+    capacity = a.capacity();
+
+    a.reset();
+    ASSERT_EQ(0u, a.used());
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(a.allocate(40, 8) != nullptr);
+    }
+    ASSERT_TRUE(a.allocate(1000, 8) != nullptr);
+    ASSERT_EQ(capacity, a.capacity());
+}
+
+TEST(arena_test, test_scope_rewinds) {
+    arena a(256);
+    void *before = a.allocate(8, 8);
+    size_t used = a.used();
+    arena::marker m = a.mark();
+    {
+        arena_scope scope(a);
+        for (int i = 0; i < 20; ++i) {
+            a.allocate(100, 8);
+        }
+        ASSERT_GT(a.used(), used);
+    }
+    ASSERT_EQ(used, a.used());
+    a.allocate(300, 8);
+    a.rewind(m);
+    ASSERT_EQ(used, a.used());
+    ASSERT_TRUE(before != nullptr);
+}
+
+TEST(arena_test, test_containers_in_arena) {
+    inline_arena<1024> a;
+    size_t capacity = 0;
+    for (int tick = 0; tick < 5; ++tick) {
+        arena_scope scope(a);
+        arena_allocator alloc(a);
+        arena_list list(4, alloc);
+        arena_map map(8, 75, alloc);
+        arena_string str("tick ", alloc);
+        for (int i = 0; i < 100; ++i) {
+            list.push_back(i);
+            map[i] = i * tick;
+        }
+        str += "done";
+        ASSERT_EQ(100u, list.size());
+        ASSERT_EQ(99, list[99]);
+        ASSERT_EQ(99 * tick, map[99]);
+        ASSERT_STREQ("tick done", str.c_str());
+        ASSERT_TRUE(list.get_allocator().get_arena() == &a);
+        if (tick == 1) {
+            capacity = a.capacity();
+        } else if (tick > 1) {
+            ASSERT_EQ(capacity, a.capacity());
+        }
+    }
+    ASSERT_EQ(0u, a.used());
+}
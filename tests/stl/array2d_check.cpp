@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <wlib/stl/Array2D.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+TEST(array2d_test, test_contiguous_layout) {
+    array2d<int> arr(3, 4);
+    ASSERT_EQ(3u, arr.x());
+    ASSERT_EQ(4u, arr.y());
+    ASSERT_EQ(12u, arr.xy());
+    ASSERT_EQ(4u, arr.stride());
+    ASSERT_TRUE(arr.packed());
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            ASSERT_EQ(0, arr(i, j));
+            arr[i][j] = static_cast<int>(i * 4 + j);
+        }
+    }
+    const int *data = arr.data();
+    for (int k = 0; k < 12; ++k) {
+        ASSERT_EQ(k, data[k]);
+    }
+    ASSERT_EQ(&arr(1, 0), &arr(0, 3) + 1);
+}
+
+TEST(array2d_test, test_alignment_and_stride) {
+    size_t stride = array2d<float>::padded_stride(5);
+    ASSERT_EQ(0u, stride * sizeof(float) % array2d<float>::alignment);
+    array2d<float> arr(4, 5, stride);
+    ASSERT_EQ(stride, arr.stride());
+    ASSERT_FALSE(arr.packed());
+    ASSERT_EQ(4 * stride, arr.capacity());
+    for (size_t i = 0; i < arr.x(); ++i) {
+        uintptr_t addr = reinterpret_cast<uintptr_t>(arr.row(i).data());
+        ASSERT_EQ(0u, addr % array2d<float>::alignment);
+    }
+    array2d<int> small(2, 6, 3);
+    ASSERT_EQ(6u, small.stride());
+}
+
+TEST(array2d_test, test_fill_and_zero_clear) {
+    array2d<int, int> arr(5, 7, 8);
+    arr.fill(9);
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 7; ++j) {
+            ASSERT_EQ(9, arr(i, j));
+        }
+    }
+    arr.zero_clear();
+    for (size_t k = 0; k < arr.capacity(); ++k) {
+        ASSERT_EQ(0, arr.data()[k]);
+    }
+}
+
+TEST(array2d_test, test_row_and_col_views) {
+    array2d<int, int> arr(2, 3);
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            arr(i, j) = i * 3 + j + 1;
+        }
+    }
+    ASSERT_EQ(2, arr.x());
+    ASSERT_EQ(3, arr.y());
+    array2d<int, int>::row_type row = arr.row(1);
+    ASSERT_EQ(3, row.size());
+    int sum = 0;
+    for (int v : row) {
+        sum += v;
+    }
+    ASSERT_EQ(15, sum);
+    array2d<int, int>::col_type col = arr.col(2);
+    ASSERT_EQ(2, col.size());
+    ASSERT_EQ(3, col[0]);
+    ASSERT_EQ(6, col[1]);
+    col[0] = 30;
+    ASSERT_EQ(30, arr[0][2]);
+    const array2d<int, int> &carr = arr;
+    ASSERT_EQ(30, carr.col(2)[0]);
+    ASSERT_EQ(4, carr[1][0]);
+    arr.get()[1][2] = 60;
+    ASSERT_EQ(60, carr.get()[1][2]);
+    ASSERT_EQ(arr.row(1).data(), arr[1].get());
+}
+
+TEST(array2d_test, test_move) {
+    array2d<int> a(2, 2);
+    a(1, 1) = 4;
+    array2d<int> b(move(a));
+    ASSERT_EQ(nullptr, a.data());
+    ASSERT_EQ(0u, a.x());
+    ASSERT_EQ(4, b(1, 1));
+    array2d<int> c(1, 1);
+    c = move(b);
+    ASSERT_EQ(2u, c.x());
+    ASSERT_EQ(4, c(1, 1));
+    ASSERT_EQ(nullptr, b.data());
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <wlib/stl/Array2DKernels.h>
+
+using namespace wlp;
+
+template<typename T>
+static void fill_sequence(array2d<T> &arr, int seed) {
+    for (size_t i = 0; i < arr.x(); ++i) {
+        for (size_t j = 0; j < arr.y(); ++j) {
+            arr(i, j) = static_cast<T>((static_cast<int>(i * 7 + j * 3) + seed) % 11 - 5);
+        }
+    }
+}
+
+TEST(array2d_kernels_test, test_elementwise) {
+    array2d<float> a(5, 9, array2d<float>::padded_stride(9));
+    array2d<float> b(5, 9);
+    array2d<float> out(5, 9);
+    fill_sequence(a, 1);
+    fill_sequence(b, 4);
+    ASSERT_TRUE(add(a, b, out));
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < 9; ++j) {
+            ASSERT_FLOAT_EQ(a(i, j) + b(i, j), out(i, j));
+        }
+    }
+    ASSERT_TRUE(subtract(a, b, out));
+    ASSERT_FLOAT_EQ(a(4, 8) - b(4, 8), out(4, 8));
+    ASSERT_TRUE(multiply_elements(a, b, out));
+    ASSERT_FLOAT_EQ(a(3, 2) * b(3, 2), out(3, 2));
+    ASSERT_TRUE(scale(a, 2.5f, out));
+    ASSERT_FLOAT_EQ(a(2, 7) * 2.5f, out(2, 7));
+    array2d<float> wrong(9, 5);
+    ASSERT_FALSE(add(a, b, wrong));
+}
+
+TEST(array2d_kernels_test, test_elementwise_int) {
+    array2d<int> a(3, 17);
+    array2d<int> b(3, 17);
+    fill_sequence(a, 2);
+    fill_sequence(b, 7);
+    array2d<int> out(3, 17);
+    ASSERT_TRUE(multiply_elements(a, b, out));
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 17; ++j) {
+            ASSERT_EQ(a(i, j) * b(i, j), out(i, j));
+        }
+    }
+    ASSERT_TRUE(add(a, b, a));
+    ASSERT_EQ(out.x(), a.x());
+}
+
+TEST(array2d_kernels_test, test_transpose) {
+    array2d<float> src(37, 70);
+    array2d<float> dst(70, 37, array2d<float>::padded_stride(37));
+    fill_sequence(src, 3);
+    ASSERT_TRUE(transpose(src, dst));
+    for (size_t i = 0; i < 37; ++i) {
+        for (size_t j = 0; j < 70; ++j) {
+            ASSERT_EQ(src(i, j), dst(j, i));
+        }
+    }
+    array2d<double> dsrc(3, 2);
+    array2d<double> ddst(2, 3);
+    dsrc(2, 1) = 5.0;
+    ASSERT_TRUE(transpose(dsrc, ddst));
+    ASSERT_EQ(5.0, ddst(1, 2));
+    ASSERT_FALSE(transpose(dsrc, dsrc));
+}
+
+template<typename T>
+static void check_multiply(size_t x, size_t n, size_t y) {
+    array2d<T> a(x, n);
+    array2d<T> b(n, y);
+    array2d<T> c(x, y);
+    fill_sequence(a, 1);
+    fill_sequence(b, 5);
+    ASSERT_TRUE(multiply(a, b, c));
+    for (size_t i = 0; i < x; ++i) {
+        for (size_t j = 0; j < y; ++j) {
+            T sum = 0;
+            for (size_t k = 0; k < n; ++k) {
+                sum = static_cast<T>(sum + a(i, k) * b(k, j));
+            }
+            ASSERT_EQ(sum, c(i, j));
+        }
+    }
+}
+
+TEST(array2d_kernels_test, test_multiply) {
+    check_multiply<int>(13, 150, 270);
+    check_multiply<double>(4, 7, 9);
+    check_multiply<float>(6, 5, 11);
+    array2d<int> a(2, 3);
+    array2d<int> b(2, 3);
+    array2d<int> c(2, 3);
+    ASSERT_FALSE(multiply(a, b, c));
+}
+
+TEST(array2d_kernels_test, test_convolve) {
+    array2d<double> src(6, 7);
+    fill_sequence(src, 0);
+    array2d<double> kernel(3, 2);
+    fill_sequence(kernel, 9);
+    array2d<double> dst(6, 7);
+    ASSERT_TRUE(convolve(src, kernel, dst));
+    for (long i = 0; i < 6; ++i) {
+        for (long j = 0; j < 7; ++j) {
+            double sum = 0;
+            for (long u = 0; u < 3; ++u) {
+                for (long v = 0; v < 2; ++v) {
+                    long si = i + 1 - u;
+                    long sj = j + 1 - v;
+                    if (si >= 0 && si < 6 && sj >= 0 && sj < 7) {
+                        sum += kernel(static_cast<size_t>(u), static_cast<size_t>(v)) *
+                               src(static_cast<size_t>(si), static_cast<size_t>(sj));
+                    }
+                }
+            }
+            ASSERT_DOUBLE_EQ(sum, dst(static_cast<size_t>(i), static_cast<size_t>(j)));
+        }
+    }
+}
+
+TEST(array2d_kernels_test, test_box_filter) {
+    array2d<int> src(9, 8);
+    fill_sequence(src, 6);
+    array2d<int> dst(9, 8);
+    ASSERT_TRUE(box_filter(src, static_cast<size_t>(2), dst));
+    for (long i = 0; i < 9; ++i) {
+        for (long j = 0; j < 8; ++j) {
+            int sum = 0;
+            for (long u = i - 2; u <= i + 2; ++u) {
+                for (long v = j - 2; v <= j + 2; ++v) {
+                    if (u >= 0 && u < 9 && v >= 0 && v < 8) {
+                        sum += src(static_cast<size_t>(u), static_cast<size_t>(v));
+                    }
+                }
+            }
+            ASSERT_EQ(sum / 25, dst(static_cast<size_t>(i), static_cast<size_t>(j)));
+        }
+    }
+    array2d<float> fsrc(4, 4);
+    fsrc.fill(1.0f);
+    ASSERT_TRUE(box_filter(fsrc, static_cast<size_t>(1), fsrc));
+    ASSERT_FLOAT_EQ(1.0f, fsrc(1, 1));
+    ASSERT_FLOAT_EQ(4.0f / 9.0f, fsrc(0, 0));
+}
@@ -8,6 +8,27 @@ using namespace wlp;
 typedef size_t size_type;
 typedef array_list<int>::const_iterator cit;
 
+/**
+ * Allocator that fails once a budget of allocations is spent.
+ */
+struct list_budget_allocator {
+    static int budget;
+
+    void *allocate(size_t size, size_t align) const {
+        if (budget == 0) {
+            return nullptr;
+        }
+        --budget;
+        return allocator().allocate(size, align);
+    }
+
+    void deallocate(void *ptr, size_t size, size_t align) const {
+        allocator().deallocate(ptr, size, align);
+    }
+};
+
+int list_budget_allocator::budget = 0;
+
 TEST(array_list_test, test_constructors) {
     int values[] = {1, 2, 3, 4, 5};
     array_list<int> list(values, 5, 2);
@@ -346,6 +367,28 @@ TEST(array_list_test, test_shrink) {
     ASSERT_EQ(1, list[0]);
 }
 
+TEST(array_list_test, test_failed_growth_leaves_list_unchanged) {
+    list_budget_allocator::budget = 1;
+    array_list<int, list_budget_allocator> list(2);
+    list.push_back(1);
+    list.push_back(2);
+    list.push_back(3);
+    ASSERT_EQ(2u, list.size());
+    ASSERT_EQ(2u, list.capacity());
+    list.push_front(0);
+    ASSERT_EQ(2u, list.size());
+    ASSERT_EQ(list.end(), list.insert(static_cast<size_type>(1), 5));
+    ASSERT_EQ(list.end(), list.insert(list.begin(), 5));
+    list.reserve(10);
+    ASSERT_EQ(2u, list.capacity());
+    ASSERT_EQ(1, list.at(0));
+    ASSERT_EQ(2, list.at(1));
+    list_budget_allocator::budget = 1;
+    list.push_back(3);
+    ASSERT_EQ(3u, list.size());
+    ASSERT_EQ(3, list.back());
+}
+
 TEST(list_iterator_test, test_default_ctor) {
     array_list<int>::iterator it;
 }
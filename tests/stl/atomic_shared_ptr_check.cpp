@@ -0,0 +1,93 @@
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wlib/stl/AtomicSharedPtr.h>
+
+using namespace wlp;
+
+static int __constructs;
+static int __destructs;
+
+struct Config {
+    int a;
+    int b;
+
+    Config(int v) : a(v), b(v) { __atomic_fetch_add(&__constructs, 1, __ATOMIC_RELAXED); }
+
+    ~Config() { __atomic_fetch_add(&__destructs, 1, __ATOMIC_RELAXED); }
+};
+
+typedef atomic_count<uint32_t> policy;
+typedef shared_ptr<Config, policy> cptr;
+typedef atomic_shared_ptr<Config, policy> acptr;
+
+TEST(atomic_shared_ptr_test, test_load_store_exchange) {
+    __constructs = 0;
+    __destructs = 0;
+    {
+        acptr ap;
+        ASSERT_FALSE(ap.load());
+        ASSERT_TRUE(ap.store(make_shared<Config, policy>(1)));
+        cptr c1 = ap.load();
+        ASSERT_EQ(1, c1->a);
+        ASSERT_EQ(2u, c1.use_count());
+        cptr old = ap.exchange(make_shared<Config, policy>(2));
+        ASSERT_TRUE(old.get() == c1.get());
+        cptr c2 = ap;
+        ASSERT_EQ(2, c2->a);
+        ap = cptr();
+        ASSERT_FALSE(ap.load());
+        ASSERT_EQ(1u, c2.use_count());
+    }
+    ASSERT_EQ(2, __destructs);
+}
+
+TEST(atomic_shared_ptr_test, test_old_version_outlives_store) {
+    __destructs = 0;
+    acptr ap(make_shared<Config, policy>(1));
+    cptr snapshot = ap.load();
+    ap.store(make_shared<Config, policy>(2));
+    ap.store(make_shared<Config, policy>(3));
+    ASSERT_EQ(1, __destructs);
+    ASSERT_EQ(1, snapshot->a);
+    snapshot.reset();
+    ASSERT_EQ(2, __destructs);
+    ASSERT_EQ(3, ap.load()->b);
+}
+
+TEST(atomic_shared_ptr_test, test_concurrent_readers_and_writer) {
+    __constructs = 0;
+    __destructs = 0;
+    const int readers = 4;
+    const int updates = 5000;
+    {
+        acptr ap(make_shared<Config, policy>(0));
+        int done = 0;
+        int torn = 0;
+        std::vector<std::thread> workers;
+        for (int r = 0; r < readers; ++r) {
+            workers.push_back(std::thread([&ap, &done, &torn]() {
+                int last = 0;
+                while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+                    cptr c = ap.load();
+                    if (c->a != c->b || c->a < last) {
+                        __atomic_fetch_add(&torn, 1, __ATOMIC_RELAXED);
+                    }
+                    last = c->a;
+                }
+            }));
+        }
+        for (int i = 1; i <= updates; ++i) {
+            ap.store(make_shared<Config, policy>(i));
+        }
+        __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+        for (std::thread &w : workers) {
+            w.join();
+        }
+        ASSERT_EQ(0, torn);
+        ASSERT_EQ(updates, ap.load()->a);
+        ASSERT_EQ(updates, __destructs);
+    }
+    ASSERT_EQ(__constructs, __destructs);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/ContainerStats.h>
+#include <wlib/stl/HashMap.h>
+#include <wlib/stl/OpenMap.h>
+#include <wlib/stl/TreeMap.h>
+#include <wlib/strings/String.h>
+
+using namespace wlp;
+
+TEST(container_stats_test, test_probe_buckets) {
+    ASSERT_EQ(0u, container_stats::probe_bucket(0));
+    ASSERT_EQ(1u, container_stats::probe_bucket(1));
+    ASSERT_EQ(2u, container_stats::probe_bucket(2));
+    ASSERT_EQ(2u, container_stats::probe_bucket(3));
+    ASSERT_EQ(3u, container_stats::probe_bucket(4));
+    ASSERT_EQ(container_stats::probe_buckets - 1, container_stats::probe_bucket(1000));
+}
+
+TEST(container_stats_test, test_parent_receives_updates) {
+    container_stats parent;
+    container_stats child(&parent);
+    child.record_growth(64);
+    child.record_lookup(3);
+    child.record_rotation();
+    child.reset();
+    ASSERT_EQ(0u, child.growths());
+    ASSERT_EQ(1u, parent.growths());
+    ASSERT_EQ(64u, parent.bytes_moved());
+    ASSERT_EQ(1u, parent.probe_count(2));
+    ASSERT_EQ(3u, parent.max_probe());
+    ASSERT_EQ(1u, parent.rotations());
+}
+
+#ifdef WLIB_CONTAINER_STATS
+TEST(container_stats_test, test_array_list_growth) {
+    size_t global = container_stats_global(array_list_kind).growths();
+    array_list<int> list(4);
+    for (int i = 0; i < 16; ++i) {
+        list.push_back(i);
+    }
+    ASSERT_EQ(2u, list.stats().growths());
+    ASSERT_EQ((4 + 8) * sizeof(int), list.stats().bytes_moved());
+    ASSERT_EQ(global + 2, container_stats_global(array_list_kind).growths());
+}
+
+TEST(container_stats_test, test_hash_map_lookups) {
+    hash_map<int, int> map(4, 75);
+    for (int i = 0; i < 8; ++i) {
+        map[i] = i;
+    }
+    ASSERT_LT(0u, map.stats().growths());
+    size_t lookups = map.stats().lookups();
+    ASSERT_TRUE(map.find(3) != map.end());
+    ASSERT_TRUE(map.find(100) == map.end());
+    ASSERT_EQ(lookups + 2, map.stats().lookups());
+    size_t counted = 0;
+    for (size_t b = 0; b < container_stats::probe_buckets; ++b) {
+        counted += map.stats().probe_count(b);
+    }
+    ASSERT_EQ(map.stats().lookups(), counted);
+}
+
+TEST(container_stats_test, test_open_map_probes) {
+    open_map<int, int> map(8, 75);
+    map[1] = 1;
+    size_t lookups = map.stats().lookups();
+    ASSERT_TRUE(map.find(1) != map.end());
+    ASSERT_EQ(lookups + 1, map.stats().lookups());
+    ASSERT_LE(1u, map.stats().max_probe());
+    size_t growths = map.stats().growths();
+    map.erase(1);
+    ASSERT_EQ(growths + 1, map.stats().growths());
+}
+
+TEST(container_stats_test, test_tree_rotations) {
+    tree_map<int, int> map;
+    for (int i = 0; i < 16; ++i) {
+        map[i] = i;
+    }
+    ASSERT_LT(0u, map.stats().rotations());
+}
+
+TEST(container_stats_test, test_string_growth) {
+    dynamic_string str("ab");
+    str += "cd";
+    ASSERT_EQ(1u, str.stats().growths());
+    ASSERT_EQ(2u, str.stats().bytes_moved());
+}
+#endif
@@ -0,0 +1,218 @@
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wlib/stl/IntrusivePtr.h>
+
+using namespace wlp;
+
+static int __destructs;
+
+struct Counted : public intrusive_ref_counter<> {
+    int v;
+
+    Counted(int i) : v(i) {}
+
+    virtual ~Counted() { ++__destructs; }
+};
+
+struct Derived : public Counted {
+    Derived(int i) : Counted(i) {}
+};
+
+struct AtomicCounted : public intrusive_ref_counter<atomic_count<uint32_t>> {
+    int v;
+
+    AtomicCounted(int i) : v(i) {}
+
+    ~AtomicCounted() { ++__destructs; }
+};
+
+// Type without member hooks, counted through a specialization
+struct Foreign {
+    int refs;
+    int v;
+};
+
+namespace wlp {
+    template<>
+    struct intrusive_hooks<Foreign> {
+        static void add_ref(Foreign *p) {
+            ++p->refs;
+        }
+
+        static bool release(Foreign *p) {
+            if (--p->refs == 0) {
+                ++__destructs;
+                return true;
+            }
+            return false;
+        }
+    };
+}
+
+typedef intrusive_ptr<Counted> cptr;
+
+TEST(intrusive_ptr_test, test_one_pointer_wide) {
+    static_assert(sizeof(cptr) == sizeof(Counted *), "intrusive_ptr must be one pointer wide");
+    static_assert(sizeof(intrusive_ptr<AtomicCounted>) == sizeof(AtomicCounted *), "intrusive_ptr must be one pointer wide");
+    cptr p;
+    ASSERT_FALSE(p);
+    ASSERT_TRUE(p == nullptr);
+}
+
+TEST(intrusive_ptr_test, test_copy_move_reset) {
+    __destructs = 0;
+    cptr p1 = make_intrusive<Counted>(5);
+    ASSERT_EQ(1, p1->use_count());
+    {
+        cptr p2 = p1;
+        ASSERT_EQ(2, p1->use_count());
+        ASSERT_TRUE(p1 == p2);
+        cptr p3 = move(p2);
+        ASSERT_FALSE(p2);
+        ASSERT_EQ(2, p3->use_count());
+        ASSERT_EQ(5, (*p3).v);
+    }
+    ASSERT_EQ(0, __destructs);
+    ASSERT_EQ(1, p1->use_count());
+    cptr p4(create<Counted>(6));
+    p4 = p1;
+    ASSERT_EQ(1, __destructs);
+    ASSERT_EQ(2, p1->use_count());
+    p4.reset();
+    p1.reset();
+    ASSERT_EQ(2, __destructs);
+}
+
+TEST(intrusive_ptr_test, test_copied_object_has_own_count) {
+    __destructs = 0;
+    cptr p1 = make_intrusive<Counted>(3);
+    cptr p2 = p1;
+    cptr p3 = make_intrusive<Counted>(*p1);
+    ASSERT_EQ(2, p1->use_count());
+    ASSERT_EQ(1, p3->use_count());
+    ASSERT_EQ(3, p3->v);
+}
+
+TEST(intrusive_ptr_test, test_detach_and_adopt) {
+    __destructs = 0;
+    cptr p1 = make_intrusive<Counted>(1);
+    Counted *raw = p1.detach();
+    ASSERT_FALSE(p1);
+    ASSERT_EQ(1, raw->use_count());
+    p1.reset(raw, false);
+    ASSERT_EQ(1, p1->use_count());
+    cptr p2(raw);
+    ASSERT_EQ(2, p1->use_count());
+    p1.reset();
+    p2.reset();
+    ASSERT_EQ(1, __destructs);
+}
+
+TEST(intrusive_ptr_test, test_conversion_and_cast) {
+    __destructs = 0;
+    intrusive_ptr<Derived> d = make_intrusive<Derived>(4);
+    cptr b = d;
+    ASSERT_EQ(2, d->use_count());
+    intrusive_ptr<Derived> d2 = static_pointer_cast<Derived>(b);
+    ASSERT_TRUE(d2 == d);
+    ASSERT_EQ(3, b->use_count());
+    intrusive_ptr<Derived> d3 = dynamic_pointer_cast<Derived>(b);
+    ASSERT_EQ(4, b->use_count());
+    cptr b2 = make_intrusive<Counted>(8);
+    ASSERT_FALSE(dynamic_pointer_cast<Derived>(b2));
+    b2.reset();
+    d.reset();
+    d2.reset();
+    d3.reset();
+    ASSERT_EQ(1, __destructs);
+    b.reset();
+    ASSERT_EQ(2, __destructs);
+}
+
+TEST(intrusive_ptr_test, test_custom_hooks) {
+    __destructs = 0;
+    Foreign *f = create<Foreign>();
+    f->refs = 0;
+    f->v = 9;
+    intrusive_ptr<Foreign> p1(f);
+    intrusive_ptr<Foreign> p2 = p1;
+    ASSERT_EQ(2, f->refs);
+    p1.reset();
+    ASSERT_EQ(1, f->refs);
+    ASSERT_EQ(9, p2->v);
+    p2.reset();
+    ASSERT_EQ(1, __destructs);
+}
+
+TEST(intrusive_ptr_test, test_unique_ptr_handoff) {
+    __destructs = 0;
+    unique_ptr<Counted> up(create<Counted>(7));
+    cptr p1(move(up));
+    ASSERT_FALSE(up.get());
+    ASSERT_EQ(1, p1->use_count());
+    cptr p2 = p1;
+
+    unique_ptr<Counted> back = p2.release_unique();
+    ASSERT_FALSE(back.get());
+    ASSERT_FALSE(p2);
+    ASSERT_EQ(1, p1->use_count());
+
+    back = p1.release_unique();
+    ASSERT_FALSE(p1);
+    ASSERT_EQ(7, back->v);
+    ASSERT_EQ(0, back->use_count());
+    ASSERT_EQ(0, __destructs);
+
+    p1 = move(back);
+    ASSERT_EQ(1, p1->use_count());
+    p1.reset();
+    ASSERT_EQ(1, __destructs);
+}
+
+TEST(intrusive_ptr_test, test_atomic_count_stress) {
+    __destructs = 0;
+    const int threads = 8;
+    const int iterations = 20000;
+    intrusive_ptr<AtomicCounted> sp = make_intrusive<AtomicCounted>(1);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&sp]() {
+            for (int i = 0; i < iterations; ++i) {
+                intrusive_ptr<AtomicCounted> copy = sp;
+                intrusive_ptr<AtomicCounted> moved = move(copy);
+            }
+        }));
+    }
+    for (std::thread &w : workers) {
+        w.join();
+    }
+    ASSERT_EQ(1u, sp->use_count());
+    ASSERT_EQ(0, __destructs);
+}
+
+TEST(intrusive_ptr_test, test_atomic_release_unique_race) {
+    __destructs = 0;
+    const int threads = 4;
+    for (int r = 0; r < 200; ++r) {
+        intrusive_ptr<AtomicCounted> sp = make_intrusive<AtomicCounted>(r);
+        std::vector<intrusive_ptr<AtomicCounted>> owners(threads, sp);
+        sp.reset();
+        int winners = 0;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.push_back(std::thread([&owners, &winners, t]() {
+                unique_ptr<AtomicCounted> up = owners[static_cast<size_t>(t)].release_unique();
+                if (up.get()) {
+                    __atomic_fetch_add(&winners, 1, __ATOMIC_RELAXED);
+                }
+            }));
+        }
+        for (std::thread &w : workers) {
+            w.join();
+        }
+        ASSERT_EQ(1, winners);
+    }
+    ASSERT_EQ(200, __destructs);
+}
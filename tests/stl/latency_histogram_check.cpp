@@ -0,0 +1,172 @@
+#include <string.h>
+
+#include <gtest/gtest.h>
+#include <wlib/stl/LatencyHistogram.h>
+
+using namespace wlp;
+
+static uint64_t fake_ticks = 0;
+
+static uint64_t fake_clock() {
+    return fake_ticks;
+}
+
+/**
+ * Allocator that fails once a budget of allocations is spent.
+ */
+struct histogram_budget_allocator {
+    static int budget;
+
+    void *allocate(size_t size, size_t align) const {
+        if (budget == 0) {
+            return nullptr;
+        }
+        --budget;
+        return allocator().allocate(size, align);
+    }
+
+    void deallocate(void *ptr, size_t size, size_t align) const {
+        allocator().deallocate(ptr, size, align);
+    }
+};
+
+int histogram_budget_allocator::budget = 0;
+
+TEST(latency_histogram_test, test_bucket_bounds) {
+    typedef latency_histogram<3, 16> histogram;
+    ASSERT_EQ(4u, histogram::sub_buckets);
+    for (uint64_t v = 0; v < 8; ++v) {
+        ASSERT_EQ(v, histogram::bucket_of(v));
+        ASSERT_EQ(v, histogram::lowest(v));
+        ASSERT_EQ(v, histogram::highest(v));
+    }
+    ASSERT_EQ(8u, histogram::bucket_of(8));
+    ASSERT_EQ(8u, histogram::bucket_of(9));
+    ASSERT_EQ(9u, histogram::bucket_of(10));
+    ASSERT_EQ(8u, histogram::lowest(8));
+    ASSERT_EQ(9u, histogram::highest(8));
+    for (uint64_t v = 8; v < (1u << 16); v += 7) {
+        size_t b = histogram::bucket_of(v);
+        ASSERT_LE(histogram::lowest(b), v);
+        ASSERT_GE(histogram::highest(b), v);
+        ASSERT_LE(histogram::highest(b) - histogram::lowest(b), v / 4);
+    }
+    ASSERT_EQ(histogram::buckets - 1, histogram::bucket_of(1u << 16));
+    ASSERT_EQ(histogram::buckets - 1, histogram::bucket_of(static_cast<uint64_t>(-1)));
+}
+
+TEST(latency_histogram_test, test_summary) {
+    latency_histogram<> h;
+    ASSERT_EQ(0u, h.count());
+    ASSERT_EQ(0u, h.min());
+    ASSERT_EQ(0u, h.percentile(50));
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        h.record(v);
+    }
+    ASSERT_EQ(1000u, h.count());
+    ASSERT_EQ(1u, h.min());
+    ASSERT_EQ(1000u, h.max());
+    ASSERT_EQ(500u, h.mean());
+    ASSERT_EQ(500500u, h.sum());
+    ASSERT_EQ(1u, h.percentile(0));
+    ASSERT_EQ(1000u, h.percentile(100));
+    uint64_t p50 = h.percentile(50);
+    uint64_t p99 = h.percentile(99);
+    ASSERT_GE(p50, 500u);
+    ASSERT_LE(p50, 500u + 500u / 16);
+    ASSERT_GE(p99, 990u);
+    ASSERT_LE(p99, 1000u);
+}
+
+TEST(latency_histogram_test, test_merge_and_reset) {
+    latency_histogram<4, 20> a;
+    latency_histogram<4, 20> b;
+    a.record(10, 3);
+    b.record(5000);
+    b.record(2);
+    a.merge(b);
+    ASSERT_EQ(5u, a.count());
+    ASSERT_EQ(2u, a.min());
+    ASSERT_EQ(5000u, a.max());
+    ASSERT_EQ(3u, a.count_at(a.bucket_of(10)));
+    ASSERT_EQ(10u, a.percentile(80));
+    ASSERT_EQ(5000u, a.percentile(100));
+    a.reset();
+    ASSERT_EQ(0u, a.count());
+    ASSERT_EQ(0u, a.max());
+    ASSERT_EQ(0u, a.count_at(a.bucket_of(10)));
+}
+
+TEST(latency_histogram_test, test_saturation) {
+    latency_histogram<3, 10> h;
+    h.record(100000);
+    h.record(5);
+    ASSERT_EQ(1u, h.count_at(h.buckets - 1));
+    ASSERT_EQ(100000u, h.percentile(100));
+    ASSERT_EQ(5u, h.percentile(50));
+}
+
+TEST(latency_histogram_test, test_json) {
+    latency_histogram<3, 16> h;
+    h.record(3, 2);
+    h.record(100);
+    char buf[256];
+    size_t len = h.json(buf, sizeof(buf));
+    ASSERT_EQ(strlen(buf), len);
+    ASSERT_STREQ("{\"count\":3,\"min\":3,\"max\":100,\"mean\":35,\"p50\":3,\"p90\":100,"
+                 "\"p99\":100,\"p99.9\":100,\"buckets\":[[3,2],[111,1]]}", buf);
+    char small[8];
+    ASSERT_EQ(len, h.json(small, sizeof(small)));
+    ASSERT_EQ(7u, strlen(small));
+    ASSERT_EQ(len, h.json(nullptr, 0));
+    dynamic_string str;
+    ASSERT_TRUE(h.json(str));
+    ASSERT_EQ(len, str.length());
+    ASSERT_STREQ(buf, str.c_str());
+}
+
+TEST(latency_histogram_test, test_json_string_allocation_failure) {
+    latency_histogram<3, 16> h;
+    h.record(7);
+    histogram_budget_allocator::budget = 1;
+    basic_dynamic_string<histogram_budget_allocator> str;
+    ASSERT_FALSE(h.json(str));
+    ASSERT_TRUE(str.c_str() == nullptr);
+    ASSERT_EQ(0u, str.length());
+}
+
+TEST(latency_histogram_test, test_json_escapes_strings) {
+    char buf[64];
+    json_buffer out(buf, sizeof(buf));
+    out.put_string("a\"b\\c\nd\te\rf\x01g\x1f");
+    ASSERT_STREQ("\"a\\\"b\\\\c\\nd\\te\\rf\\u0001g\\u001f\"", buf);
+    ASSERT_EQ(strlen(buf), out.length());
+}
+
+TEST(latency_histogram_test, test_scoped_timer) {
+    set_latency_clock_source(fake_clock);
+    latency_histogram<> h;
+    fake_ticks = 100;
+    {
+        scoped_timer<pluggable_clock> timer(h);
+        fake_ticks = 142;
+        ASSERT_EQ(42u, timer.elapsed());
+    }
+    {
+        scoped_timer<pluggable_clock> timer(h);
+        fake_ticks = 1000;
+        timer.cancel();
+    }
+    ASSERT_EQ(1u, h.count());
+    ASSERT_EQ(42u, h.max());
+    set_latency_clock_source(nullptr);
+    ASSERT_EQ(0u, pluggable_clock::now());
+}
+
+TEST(latency_histogram_test, test_default_clock) {
+    latency_histogram<> h;
+    {
+        scoped_timer<> timer(h);
+    }
+    ASSERT_EQ(1u, h.count());
+}
@@ -0,0 +1,115 @@
+#include <string.h>
+
+#include <gtest/gtest.h>
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/HashMap.h>
+#include <wlib/stl/MemStats.h>
+
+using namespace wlp;
+
+static mem_tag list_tag("mem_stats_test.list");
+static mem_tag map_tag("mem_stats_test.map");
+static mem_tag failing_tag("mem_stats_test.failing");
+
+struct exhausted_allocator {
+    void *allocate(size_t, size_t) {
+        return nullptr;
+    }
+
+    void deallocate(void *, size_t, size_t) {}
+
+    bool operator==(const exhausted_allocator &) const {
+        return true;
+    }
+};
+
+static bool fake_pool_probe(mem_pool_info &info) {
+    info.free_bytes = 4000;
+    info.largest_free_block = 1000;
+    return true;
+}
+
+TEST(mem_stats_test, test_size_classes) {
+    ASSERT_EQ(0u, mem_size_class(1));
+    ASSERT_EQ(0u, mem_size_class(16));
+    ASSERT_EQ(1u, mem_size_class(17));
+    ASSERT_EQ(6u, mem_size_class(1024));
+    ASSERT_EQ(mem_size_classes - 1, mem_size_class(1 << 20));
+}
+
+TEST(mem_stats_test, test_tagged_container) {
+    typedef tagged_allocator<> alloc_type;
+    {
+        array_list<int, alloc_type> list(8, alloc_type(list_tag));
+        ASSERT_EQ(8 * sizeof(int), list_tag.live_bytes());
+        for (int i = 0; i < 16; ++i) {
+            list.push_back(i);
+        }
+        ASSERT_EQ(16 * sizeof(int), list_tag.live_bytes());
+        ASSERT_LE(24 * sizeof(int), list_tag.peak_bytes());
+    }
+    ASSERT_EQ(0u, list_tag.live_bytes());
+    ASSERT_EQ(list_tag.allocations(), list_tag.frees());
+    size_t counted = 0;
+    for (size_t c = 0; c < mem_size_classes; ++c) {
+        counted += list_tag.class_allocations(c);
+    }
+    ASSERT_EQ(list_tag.allocations(), counted);
+    list_tag.reset_peak();
+    ASSERT_EQ(0u, list_tag.peak_bytes());
+}
+
+TEST(mem_stats_test, test_registry_and_failures) {
+    {
+        hash_map<int, int, hash<int, uint16_t>, equals<int>, tagged_allocator<>>
+                map(12, 75, tagged_allocator<>(map_tag));
+        map[1] = 1;
+        ASSERT_LT(0u, map_tag.live_bytes());
+    }
+    ASSERT_EQ(&map_tag, mem_stats_find("mem_stats_test.map"));
+    ASSERT_TRUE(mem_stats_find("mem_stats_test.unused") == nullptr);
+
+    tagged_allocator<exhausted_allocator> alloc(failing_tag);
+    ASSERT_TRUE(alloc.allocate(32, 8) == nullptr);
+    ASSERT_EQ(1u, failing_tag.failures());
+    ASSERT_EQ(0u, failing_tag.allocations());
+    ASSERT_EQ(&failing_tag, mem_stats_find("mem_stats_test.failing"));
+}
+
+TEST(mem_stats_test, test_json_dump) {
+    tagged_allocator<> alloc(list_tag);
+    void *ptr = alloc.allocate(100, 8);
+    mem_stats_set_pool_probe(fake_pool_probe);
+    char buf[4096];
+    size_t len = mem_stats_json(buf, sizeof(buf));
+    char small[16];
+    size_t cut = mem_stats_json(small, sizeof(small));
+    mem_stats_set_pool_probe(nullptr);
+    alloc.deallocate(ptr, 100, 8);
+
+    ASSERT_LT(len, sizeof(buf));
+    ASSERT_EQ(len, strlen(buf));
+    ASSERT_EQ('{', buf[0]);
+    ASSERT_EQ('}', buf[len - 1]);
+    ASSERT_TRUE(strstr(buf, "\"name\":\"mem_stats_test.list\",\"live_bytes\":100,") != nullptr);
+    ASSERT_TRUE(strstr(buf, "\"pool\":{\"free_bytes\":4000,\"largest_free_block\":1000,"
+                            "\"fragmentation_percent\":75}") != nullptr);
+
+    ASSERT_EQ(len, cut);
+    ASSERT_EQ(sizeof(small) - 1, strlen(small));
+    ASSERT_EQ(0, strncmp(buf, small, sizeof(small) - 1));
+}
+
+#ifdef WLIB_MEM_STATS
+TEST(mem_stats_test, test_default_allocator_counted) {
+    mem_tag &global = mem_stats_global();
+    size_t allocs = global.allocations();
+    size_t live = global.live_bytes();
+    {
+        array_list<int> list(10);
+        ASSERT_EQ(live + 10 * sizeof(int), global.live_bytes());
+    }
+    ASSERT_EQ(allocs + 1, global.allocations());
+    ASSERT_EQ(live, global.live_bytes());
+}
+#endif
@@ -0,0 +1,142 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wlib/stl/MpmcQueue.h>
+
+using namespace wlp;
+
+struct mpmc_probe {
+    static int live;
+    int value;
+
+    mpmc_probe()
+            : value(0) {
+        ++live;
+    }
+
+    explicit mpmc_probe(int v)
+            : value(v) {
+        ++live;
+    }
+
+    mpmc_probe(const mpmc_probe &p)
+            : value(p.value) {
+        ++live;
+    }
+
+    mpmc_probe &operator=(const mpmc_probe &p) {
+        value = p.value;
+        return *this;
+    }
+
+    ~mpmc_probe() {
+        --live;
+    }
+};
+
+int mpmc_probe::live = 0;
+
+TEST(mpmc_queue_test, test_capacity_rounds_up) {
+    mpmc_queue<int> q(5);
+    ASSERT_EQ(8u, q.capacity());
+    mpmc_queue<int> one(1);
+    ASSERT_EQ(2u, one.capacity());
+    static_mpmc_queue<int, 4> s;
+    ASSERT_EQ(4u, s.capacity());
+    ASSERT_TRUE(s.empty());
+}
+
+TEST(mpmc_queue_test, test_fifo_full_and_empty) {
+    static_mpmc_queue<int, 4> q;
+    int v = -1;
+    ASSERT_FALSE(q.try_pop(v));
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(q.try_push(round * 10 + i));
+        }
+        ASSERT_TRUE(q.full());
+        ASSERT_FALSE(q.try_push(99));
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(q.try_pop(v));
+            ASSERT_EQ(round * 10 + i, v);
+        }
+        ASSERT_FALSE(q.try_pop(v));
+    }
+}
+
+TEST(mpmc_queue_test, test_elements_destroyed) {
+    {
+        mpmc_queue<mpmc_probe> q(4);
+        q.try_emplace(1);
+        q.push(mpmc_probe(2));
+        q.emplace(3);
+        mpmc_probe out;
+        q.pop(out);
+        ASSERT_EQ(1, out.value);
+        ASSERT_EQ(3, mpmc_probe::live);
+    }
+    ASSERT_EQ(0, mpmc_probe::live);
+}
+
+TEST(mpmc_queue_test, test_many_producers_and_consumers) {
+    const int producers = 4;
+    const int consumers = 4;
+    const int per_producer = 20000;
+    mpmc_queue<int> q(16);
+    std::atomic<long> sum(0);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.push_back(std::thread([&q, p]() {
+            for (int i = 0; i < per_producer; ++i) {
+                int v = p * per_producer + i;
+                if (i % 2 == 0) {
+                    q.push(v);
+                } else {
+                    while (!q.try_push(v)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }));
+    }
+    std::vector<std::vector<int>> seen(consumers);
+    for (int c = 0; c < consumers; ++c) {
+        threads.push_back(std::thread([&q, &sum, &seen, c]() {
+            for (int i = 0; i < producers * per_producer / consumers; ++i) {
+                int v;
+                q.pop(v);
+                sum += v;
+                seen[static_cast<size_t>(c)].push_back(v);
+            }
+        }));
+    }
+    for (std::thread &t : threads) {
+        t.join();
+    }
+    long n = producers * per_producer;
+    ASSERT_EQ(n * (n - 1) / 2, sum.load());
+    ASSERT_TRUE(q.empty());
+    // each consumer sees the elements of one producer in order
+    for (const std::vector<int> &s : seen) {
+        std::vector<int> last(producers, -1);
+        for (int v : s) {
+            ASSERT_LT(last[static_cast<size_t>(v / per_producer)], v);
+            last[static_cast<size_t>(v / per_producer)] = v;
+        }
+    }
+}
+
+TEST(mpmc_queue_test, test_blocking_pop_wakes) {
+    mpmc_queue<int> q(2);
+    int got = 0;
+    std::thread consumer([&q, &got]() {
+        q.pop(got);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.push(42);
+    consumer.join();
+    ASSERT_EQ(42, got);
+}
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/ParallelAlgorithm.h>
+
+using namespace wlp;
+
+static array_list<int> scrambled(size_t n) {
+    array_list<int> list(n);
+    uint32_t state = 2463534242u;
+    for (size_t i = 0; i < n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        list.push_back(static_cast<int>(state % 1000));
+    }
+    return list;
+}
+
+static std::vector<int> to_vector(array_list<int> &list) {
+    return std::vector<int>(list.data(), list.data() + list.size());
+}
+
+template<typename Executor>
+static void check_all(Executor &ex) {
+    const size_t sizes[] = {0, 1, 17, 1000, 20000};
+    for (size_t n : sizes) {
+        array_list<int> list = scrambled(n);
+        std::vector<int> expect = to_vector(list);
+
+        parallel_for_each(ex, list.begin(), list.end(), [](int &v) { v *= 2; }, 64);
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(2 * expect[i], list[i]);
+        }
+
+        array_list<int> out(n);
+        for (size_t i = 0; i < n; ++i) {
+            out.push_back(0);
+        }
+        parallel_transform(ex, list.begin(), list.end(), out.begin(), [](int v) { return v + 1; }, 64);
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(2 * expect[i] + 1, out[i]);
+        }
+
+        long sum = 0;
+        for (int v : expect) {
+            sum += 2 * v;
+        }
+        ASSERT_EQ(sum + 5, parallel_reduce(ex, list.begin(), list.end(), 5L,
+                                           [](long a, long b) { return a + b; }, 64));
+        ASSERT_EQ(sum / 2, parallel_transform_reduce(ex, list.begin(), list.end(), 0L,
+                                                     [](long a, long b) { return a + b; },
+                                                     [](int v) { return static_cast<long>(v / 2); }, 64));
+
+        parallel_inclusive_scan(ex, list.begin(), list.end(), out.begin(),
+                                [](int a, int b) { return a + b; }, 64);
+        int running = 0;
+        for (size_t i = 0; i < n; ++i) {
+            running += list[i];
+            ASSERT_EQ(running, out[i]);
+        }
+
+        array_list<int>::iterator cut = parallel_partition(ex, list.begin(), list.end(),
+                                                           [](int v) { return v % 3 == 0; }, 64);
+        size_t threes = static_cast<size_t>(std::count_if(expect.begin(), expect.end(),
+                                                          [](int v) { return (2 * v) % 3 == 0; }));
+        ASSERT_EQ(threes, static_cast<size_t>(cut - list.begin()));
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(i < threes, list[i] % 3 == 0);
+        }
+
+        parallel_sort(ex, list.begin(), list.end());
+        std::vector<int> sorted = expect;
+        for (int &v : sorted) {
+            v *= 2;
+        }
+        std::sort(sorted.begin(), sorted.end());
+        ASSERT_EQ(sorted, to_vector(list));
+
+        parallel_sort(ex, list.begin(), list.end(), reverse_comparator<int>(), 100);
+        std::reverse(sorted.begin(), sorted.end());
+        ASSERT_EQ(sorted, to_vector(list));
+    }
+}
+
+TEST(parallel_algorithm_test, test_serial_executor) {
+    serial_executor ex;
+    check_all(ex);
+}
+
+TEST(parallel_algorithm_test, test_thread_pool) {
+    thread_pool pool(4);
+    check_all(pool);
+}
+
+TEST(parallel_algorithm_test, test_scan_keeps_order) {
+    thread_pool pool(3);
+    array_list<int> marks(1000);
+    array_list<int> out(1000);
+    for (int i = 0; i < 1000; ++i) {
+        marks.push_back(i % 7 == 3 ? i : 0);
+        out.push_back(0);
+    }
+    // the last non-zero value, associative but not commutative
+    parallel_inclusive_scan(pool, marks.begin(), marks.end(), out.begin(),
+                            [](int a, int b) { return b != 0 ? b : a; }, 5);
+    int expect = 0;
+    for (size_t i = 0; i < 1000; ++i) {
+        expect = marks[i] != 0 ? marks[i] : expect;
+        ASSERT_EQ(expect, out[i]);
+    }
+}
+
+TEST(parallel_algorithm_test, test_sort_worst_cases) {
+    thread_pool pool(2);
+    const size_t n = 5000;
+    array_list<int> same(n);
+    array_list<int> descending(n);
+    array_list<int> organ(n);
+    for (size_t i = 0; i < n; ++i) {
+        same.push_back(7);
+        descending.push_back(static_cast<int>(n - i));
+        organ.push_back(static_cast<int>(i < n / 2 ? i : n - i));
+    }
+    parallel_sort(pool, same.begin(), same.end());
+    parallel_sort(pool, descending.begin(), descending.end());
+    parallel_sort(pool, organ.begin(), organ.end());
+    for (size_t i = 1; i < n; ++i) {
+        ASSERT_EQ(7, same[i]);
+        ASSERT_LE(descending[i - 1], descending[i]);
+        ASSERT_LE(organ[i - 1], organ[i]);
+    }
+}
+
+TEST(parallel_algorithm_test, test_runs_inside_pool) {
+    thread_pool pool(2);
+    array_list<int> list = scrambled(4096);
+    future<long> f = pool.submit([&pool, &list]() {
+        return parallel_reduce(pool, list.begin(), list.end(), 0L, [](long a, long b) { return a + b; });
+    });
+    long sum = 0;
+    for (size_t i = 0; i < list.size(); ++i) {
+        sum += list[i];
+    }
+    ASSERT_EQ(sum, f.get());
+}
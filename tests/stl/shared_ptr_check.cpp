@@ -1,3 +1,6 @@
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <wlib/stl/SharedPtr.h>
 
@@ -113,3 +116,212 @@ TEST(shared_ptr_test, test_weak_ptr) {
     ASSERT_TRUE(wp2.expired());
     ASSERT_TRUE(wp3.expired());
 }
+
+TEST(shared_ptr_test, test_weak_ptr_lock_expired) {
+    iwptr empty;
+    ASSERT_TRUE(empty.expired());
+    ASSERT_FALSE(static_cast<bool>(empty.lock()));
+    iwptr wp;
+    {
+        iptr sp = iptr(create<Integer>(2));
+        wp = sp;
+        ASSERT_EQ(2, wp.lock()->v);
+    }
+    iptr locked = wp.lock();
+    ASSERT_FALSE(static_cast<bool>(locked));
+    ASSERT_EQ(nullptr, locked.get());
+    ASSERT_EQ(0, locked.use_count());
+}
+
+TEST(shared_ptr_test, test_wide_count_policy) {
+    typedef shared_ptr<Integer, plain_count<uint32_t>> wide_ptr;
+    const size_t copies = 70000;
+    wide_ptr sp(create<Integer>(3));
+    wide_ptr *arr = create<wide_ptr[]>(copies);
+    for (size_t i = 0; i < copies; ++i) {
+        arr[i] = sp;
+    }
+    ASSERT_EQ(copies + 1, sp.use_count());
+    destroy<wide_ptr[]>(arr);
+    ASSERT_EQ(1u, sp.use_count());
+}
+
+typedef shared_ptr<Integer, atomic_count<uint32_t>> aptr;
+typedef weak_ptr<Integer, atomic_count<uint32_t>> awptr;
+
+TEST(shared_ptr_test, test_atomic_copy_stress) {
+    __destructs = 0;
+    const int threads = 8;
+    const int rounds = 20000;
+    aptr sp(create<Integer>(7));
+    awptr wp = sp.weak();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&sp, &wp]() {
+            for (int i = 0; i < rounds; ++i) {
+                aptr copy = sp;
+                aptr locked = wp.lock();
+                awptr weak = copy.weak();
+                if (copy->v != 7 || locked->v != 7) {
+                    ADD_FAILURE();
+                }
+            }
+        }));
+    }
+    for (std::thread &w : workers) {
+        w.join();
+    }
+    ASSERT_EQ(1u, sp.use_count());
+    ASSERT_EQ(0, __destructs);
+    sp.reset();
+    ASSERT_EQ(1, __destructs);
+    ASSERT_TRUE(wp.expired());
+}
+
+TEST(shared_ptr_test, test_atomic_concurrent_release) {
+    __destructs = 0;
+    const int threads = 4;
+    const int rounds = 500;
+    for (int r = 0; r < rounds; ++r) {
+        aptr sp(create<Integer>(r));
+        awptr wp = sp.weak();
+        std::vector<aptr> owners(threads, sp);
+        sp.reset();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.push_back(std::thread([&owners, &wp, t, r]() {
+                aptr locked = wp.lock();
+                if (locked && locked->v != r) {
+                    ADD_FAILURE();
+                }
+                owners[static_cast<size_t>(t)].reset();
+            }));
+        }
+        for (std::thread &w : workers) {
+            w.join();
+        }
+        ASSERT_TRUE(wp.expired());
+        ASSERT_EQ(r + 1, __destructs);
+    }
+}
+
+struct counting_allocator {
+    static int allocations;
+    static int deallocations;
+
+    void *allocate(size_t size, size_t align) const {
+        ++allocations;
+        return allocator().allocate(size, align);
+    }
+
+    void deallocate(void *ptr, size_t size, size_t align) const {
+        ++deallocations;
+        allocator().deallocate(ptr, size, align);
+    }
+};
+
+int counting_allocator::allocations = 0;
+int counting_allocator::deallocations = 0;
+
+struct failing_allocator {
+    void *allocate(size_t, size_t) const {
+        return nullptr;
+    }
+
+    void deallocate(void *, size_t, size_t) const {}
+};
+
+struct alignas(64) Aligned {
+    int v;
+
+    Aligned(int i) : v(i) {}
+};
+
+TEST(shared_ptr_test, test_allocate_shared_single_allocation) {
+    __destructs = 0;
+    counting_allocator::allocations = 0;
+    counting_allocator::deallocations = 0;
+    iwptr wp;
+    {
+        iptr sp = allocate_shared<Integer>(counting_allocator(), 5);
+        ASSERT_EQ(1, counting_allocator::allocations);
+        ASSERT_EQ(5, sp->v);
+        ASSERT_EQ(1, sp.use_count());
+        iptr copy = sp;
+        wp = sp;
+        ASSERT_EQ(2, sp.use_count());
+        ASSERT_EQ(1, counting_allocator::allocations);
+    }
+    ASSERT_EQ(1, __destructs);
+    ASSERT_TRUE(wp.expired());
+    ASSERT_EQ(0, counting_allocator::deallocations);
+    wp.reset();
+    ASSERT_EQ(1, counting_allocator::deallocations);
+    ASSERT_EQ(1, __destructs);
+}
+
+TEST(shared_ptr_test, test_count_allocation_failure) {
+    __destructs = 0;
+    iptr sp(create<Integer>(4), failing_allocator());
+    ASSERT_FALSE(static_cast<bool>(sp));
+    ASSERT_EQ(nullptr, sp.get());
+    ASSERT_EQ(0, sp.use_count());
+    ASSERT_EQ(1, __destructs);
+    sp.reset();
+    ASSERT_EQ(1, __destructs);
+}
+
+TEST(shared_ptr_test, test_unique_ptr_count_allocation_failure) {
+    __destructs = 0;
+    unique_ptr<Integer> up(create<Integer>(4));
+    Integer *raw = up.get();
+    iptr sp(move(up), failing_allocator());
+    ASSERT_FALSE(static_cast<bool>(sp));
+    ASSERT_EQ(nullptr, sp.get());
+    ASSERT_EQ(0, sp.use_count());
+    ASSERT_EQ(raw, up.get());
+    ASSERT_EQ(0, __destructs);
+
+    iptr taken(move(up), counting_allocator());
+    ASSERT_EQ(raw, taken.get());
+    ASSERT_EQ(nullptr, up.get());
+    ASSERT_EQ(1, taken.use_count());
+
+    unique_ptr<Integer> other(create<Integer>(7));
+    taken = move(other);
+    ASSERT_EQ(1, __destructs);
+    ASSERT_EQ(7, taken->v);
+    ASSERT_EQ(nullptr, other.get());
+    taken.reset();
+    ASSERT_EQ(2, __destructs);
+}
+
+TEST(shared_ptr_test, test_make_shared) {
+    __destructs = 0;
+    iptr sp = make_shared<Integer>(9);
+    ASSERT_EQ(9, (*sp).v);
+    ASSERT_TRUE(sp.unique());
+    iptr other = make_shared<Integer>();
+    ASSERT_EQ(0, other->v);
+    other = sp;
+    ASSERT_EQ(1, __destructs);
+    ASSERT_EQ(2, sp.use_count());
+    iwptr wp = sp;
+    ASSERT_EQ(9, wp.lock()->v);
+    sp.reset();
+    other.reset();
+    ASSERT_EQ(2, __destructs);
+    ASSERT_FALSE(static_cast<bool>(wp.lock()));
+
+    shared_ptr<Aligned> aligned = make_shared<Aligned>(4);
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(aligned.get()) % alignof(Aligned));
+    ASSERT_EQ(4, aligned->v);
+
+    iptr failed = allocate_shared<Integer>(failing_allocator(), 1);
+    ASSERT_FALSE(static_cast<bool>(failed));
+    ASSERT_EQ(0, failed.use_count());
+
+    aptr atomic = make_shared<Integer, atomic_count<uint32_t>>(3);
+    aptr atomic_copy = atomic;
+    ASSERT_EQ(2u, atomic.use_count());
+}
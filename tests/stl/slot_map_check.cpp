@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include <wlib/stl/SlotMap.h>
+
+using namespace wlp;
+
+struct Entity {
+    int id;
+    float x;
+
+    Entity() : id(-1), x(0) {}
+
+    Entity(int i, float px) : id(i), x(px) {}
+};
+
+/**
+ * Value owning a resource, counting those not yet released.
+ */
+struct slot_resource {
+    static int held;
+    bool owns;
+
+    slot_resource() : owns(false) {}
+
+    explicit slot_resource(int) : owns(true) { ++held; }
+
+    slot_resource(const slot_resource &r) : owns(false) { acquire(r); }
+
+    slot_resource(slot_resource &&r) : owns(r.owns) { r.owns = false; }
+
+    slot_resource &operator=(const slot_resource &r) {
+        if (this != &r) {
+            release();
+            acquire(r);
+        }
+        return *this;
+    }
+
+    slot_resource &operator=(slot_resource &&r) {
+        if (this != &r) {
+            release();
+            owns = r.owns;
+            r.owns = false;
+        }
+        return *this;
+    }
+
+    ~slot_resource() { release(); }
+
+    void acquire(const slot_resource &r) {
+        if (r.owns) {
+            ++held;
+            owns = true;
+        }
+    }
+
+    void release() {
+        if (owns) {
+            --held;
+            owns = false;
+        }
+    }
+};
+
+int slot_resource::held = 0;
+
+/**
+ * Allocator that fails once a budget of allocations is spent.
+ */
+struct slot_budget_allocator {
+    static int budget;
+
+    void *allocate(size_t size, size_t align) const {
+        if (budget == 0) {
+            return nullptr;
+        }
+        --budget;
+        return allocator().allocate(size, align);
+    }
+
+    void deallocate(void *ptr, size_t size, size_t align) const {
+        allocator().deallocate(ptr, size, align);
+    }
+};
+
+int slot_budget_allocator::budget = 0;
+
+TEST(slot_map_test, test_insert_get_erase) {
+    slot_map<Entity> map;
+    slot_handle a = map.insert(Entity(1, 1.0f));
+    slot_handle b = map.insert(Entity(2, 2.0f));
+    slot_handle c = map.insert(Entity(3, 3.0f));
+    ASSERT_EQ(3u, map.size());
+    ASSERT_EQ(2, map.get(b)->id);
+    ASSERT_EQ(3, map[c].id);
+
+    ASSERT_TRUE(map.erase(a));
+    ASSERT_FALSE(map.erase(a));
+    ASSERT_FALSE(map.contains(a));
+    ASSERT_TRUE(map.get(a) == nullptr);
+    ASSERT_EQ(2u, map.size());
+    ASSERT_EQ(2, map.get(b)->id);
+    ASSERT_EQ(3, map.get(c)->id);
+}
+
+TEST(slot_map_test, test_stale_handle_after_reuse) {
+    slot_map<int> map;
+    slot_handle a = map.insert(10);
+    map.erase(a);
+    slot_handle b = map.insert(20);
+    ASSERT_EQ(a.index, b.index);
+    ASSERT_NE(a.generation, b.generation);
+    ASSERT_TRUE(map.get(a) == nullptr);
+    ASSERT_EQ(20, *map.get(b));
+    ASSERT_FALSE(map.contains(slot_handle()));
+    ASSERT_FALSE(map.contains(slot_handle(100, 1)));
+}
+
+TEST(slot_map_test, test_raw_round_trip) {
+    slot_map<int> map;
+    map.insert(1);
+    slot_handle h = map.insert(2);
+    slot_handle r = slot_handle::from_raw(h.raw());
+    ASSERT_TRUE(r == h);
+    ASSERT_EQ(2, *map.get(r));
+    static_assert(sizeof(slot_handle) == sizeof(uint64_t), "handle must be 64 bits");
+}
+
+TEST(slot_map_test, test_iteration_is_dense) {
+    slot_map<int> map;
+    slot_handle handles[100];
+    for (int i = 0; i < 100; ++i) {
+        handles[i] = map.insert(i);
+    }
+    for (int i = 0; i < 100; i += 2) {
+        map.erase(handles[i]);
+    }
+    int sum = 0;
+    int count = 0;
+    for (int v : map) {
+        ASSERT_EQ(1, v % 2);
+        sum += v;
+        ++count;
+    }
+    ASSERT_EQ(50, count);
+    ASSERT_EQ(2500, sum);
+    for (uint32_t pos = 0; pos < map.size(); ++pos) {
+        slot_handle h = map.handle_at(pos);
+        ASSERT_EQ(map.data()[pos], *map.get(h));
+        ASSERT_TRUE(h == handles[map.data()[pos]]);
+    }
+}
+
+TEST(slot_map_test, test_clear_invalidates_handles) {
+    slot_map<int> map;
+    slot_handle a = map.insert(1);
+    slot_handle b = map.insert(2);
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_FALSE(map.contains(a));
+    ASSERT_FALSE(map.contains(b));
+    slot_handle c = map.insert(3);
+    slot_handle d = map.insert(4);
+    slot_handle e = map.insert(5);
+    ASSERT_EQ(3u, map.size());
+    ASSERT_EQ(3, map[c]);
+    ASSERT_EQ(4, map[d]);
+    ASSERT_EQ(5, map[e]);
+    ASSERT_FALSE(map.contains(a));
+}
+
+TEST(slot_map_test, test_erase_releases_values) {
+    slot_resource::held = 0;
+    {
+        slot_map<slot_resource> map;
+        slot_handle a = map.insert(slot_resource(1));
+        slot_handle b = map.insert(slot_resource(2));
+        map.insert(slot_resource(3));
+        ASSERT_EQ(3, slot_resource::held);
+        map.erase(a);
+        ASSERT_EQ(2, slot_resource::held);
+        map.erase(b);
+        ASSERT_EQ(1, slot_resource::held);
+        map.insert(slot_resource(4));
+        map.insert(slot_resource(5));
+        ASSERT_EQ(3, slot_resource::held);
+        map.clear();
+        ASSERT_EQ(0, slot_resource::held);
+        map.insert(slot_resource(6));
+        ASSERT_EQ(1, slot_resource::held);
+    }
+    ASSERT_EQ(0, slot_resource::held);
+}
+
+TEST(slot_map_test, test_failed_insert_changes_nothing) {
+    // the three arrays, then the slots, values and owners grow in turn
+    for (int budget = 3; budget < 6; ++budget) {
+        slot_budget_allocator::budget = budget;
+        slot_map<int, slot_budget_allocator> map(2);
+        slot_handle a = map.insert(1);
+        slot_handle b = map.insert(2);
+        slot_handle failed = map.insert(3);
+        ASSERT_FALSE(map.contains(failed));
+        ASSERT_EQ(2u, map.size());
+        ASSERT_EQ(1, map[a]);
+        ASSERT_EQ(2, map[b]);
+        ASSERT_TRUE(map.erase(a));
+        slot_handle c = map.insert(4);
+        ASSERT_TRUE(map.contains(c));
+        ASSERT_EQ(a.index, c.index);
+        ASSERT_FALSE(map.contains(a));
+        ASSERT_EQ(4, map[c]);
+        ASSERT_EQ(2, map[b]);
+        ASSERT_EQ(2u, map.size());
+    }
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include <wlib/stl/SparseSet.h>
+
+using namespace wlp;
+
+/**
+ * Value owning a resource, counting those not yet released.
+ */
+struct sparse_resource {
+    static int held;
+    bool owns;
+
+    sparse_resource() : owns(false) {}
+
+    explicit sparse_resource(int) : owns(true) { ++held; }
+
+    sparse_resource(const sparse_resource &r) : owns(false) { acquire(r); }
+
+    sparse_resource(sparse_resource &&r) : owns(r.owns) { r.owns = false; }
+
+    sparse_resource &operator=(const sparse_resource &r) {
+        if (this != &r) {
+            release();
+            acquire(r);
+        }
+        return *this;
+    }
+
+    sparse_resource &operator=(sparse_resource &&r) {
+        if (this != &r) {
+            release();
+            owns = r.owns;
+            r.owns = false;
+        }
+        return *this;
+    }
+
+    ~sparse_resource() { release(); }
+
+    void acquire(const sparse_resource &r) {
+        if (r.owns) {
+            ++held;
+            owns = true;
+        }
+    }
+
+    void release() {
+        if (owns) {
+            --held;
+            owns = false;
+        }
+    }
+};
+
+int sparse_resource::held = 0;
+
+/**
+ * Allocator that fails once a budget of allocations is spent.
+ */
+struct sparse_budget_allocator {
+    static int budget;
+
+    void *allocate(size_t size, size_t align) const {
+        if (budget == 0) {
+            return nullptr;
+        }
+        --budget;
+        return allocator().allocate(size, align);
+    }
+
+    void deallocate(void *ptr, size_t size, size_t align) const {
+        allocator().deallocate(ptr, size, align);
+    }
+};
+
+int sparse_budget_allocator::budget = 0;
+
+TEST(sparse_set_test, test_insert_contains_erase) {
+    sparse_set<> set(16);
+    ASSERT_TRUE(set.empty());
+    ASSERT_TRUE(set.insert(3));
+    ASSERT_TRUE(set.insert(7));
+    ASSERT_TRUE(set.insert(11));
+    ASSERT_FALSE(set.insert(7));
+    ASSERT_EQ(3u, set.size());
+    ASSERT_TRUE(set.contains(7));
+    ASSERT_FALSE(set.contains(8));
+
+    ASSERT_TRUE(set.erase(3));
+    ASSERT_FALSE(set.erase(3));
+    ASSERT_FALSE(set.contains(3));
+    ASSERT_TRUE(set.contains(7));
+    ASSERT_TRUE(set.contains(11));
+    ASSERT_EQ(2u, set.size());
+    ASSERT_EQ(11, set.data()[0]);
+    ASSERT_EQ(7, set.data()[1]);
+}
+
+TEST(sparse_set_test, test_clear_and_reinsert) {
+    sparse_set<> set(32);
+    for (uint16_t k = 0; k < 32; k += 2) {
+        set.insert(k);
+    }
+    set.clear();
+    ASSERT_TRUE(set.empty());
+    for (uint16_t k = 0; k < 32; ++k) {
+        ASSERT_FALSE(set.contains(k));
+    }
+    ASSERT_TRUE(set.insert(5));
+    ASSERT_TRUE(set.contains(5));
+    ASSERT_FALSE(set.contains(0));
+    ASSERT_EQ(1u, set.size());
+}
+
+TEST(sparse_set_test, test_grow_and_iterate) {
+    sparse_set<> set(4);
+    ASSERT_FALSE(set.contains(1000));
+    ASSERT_TRUE(set.insert(1000));
+    ASSERT_TRUE(set.insert(2));
+    ASSERT_LE(1001u, set.universe());
+    ASSERT_TRUE(set.contains(1000));
+    ASSERT_TRUE(set.contains(2));
+    unsigned sum = 0;
+    for (uint16_t k : set) {
+        sum += k;
+    }
+    ASSERT_EQ(1002u, sum);
+}
+
+TEST(sparse_map_test, test_insert_get_erase) {
+    sparse_map<int> map(16);
+    ASSERT_TRUE(map.insert(4, 40));
+    ASSERT_TRUE(map.insert(9, 90));
+    ASSERT_FALSE(map.insert(4, 41));
+    map[12] = 120;
+    ASSERT_EQ(3u, map.size());
+    ASSERT_EQ(40, *map.get(4));
+    ASSERT_EQ(120, map[12]);
+    ASSERT_TRUE(map.get(5) == nullptr);
+
+    ASSERT_TRUE(map.erase(4));
+    ASSERT_FALSE(map.erase(4));
+    ASSERT_TRUE(map.get(4) == nullptr);
+    ASSERT_EQ(90, *map.get(9));
+    ASSERT_EQ(120, *map.get(12));
+    for (sparse_map<int>::size_type i = 0; i < map.size(); ++i) {
+        ASSERT_EQ(map.key_at(i) * 10, map.data()[i]);
+    }
+}
+
+TEST(sparse_map_test, test_move_and_clear) {
+    sparse_map<int> map(8);
+    map[1] = 10;
+    map[2] = 20;
+    sparse_map<int> other(move(map));
+    ASSERT_EQ(2u, other.size());
+    ASSERT_EQ(20, *other.get(2));
+    other.clear();
+    ASSERT_TRUE(other.empty());
+    ASSERT_FALSE(other.contains(1));
+    other[1] = 11;
+    ASSERT_EQ(11, *other.get(1));
+}
+
+TEST(sparse_map_test, test_erase_releases_values) {
+    sparse_resource::held = 0;
+    {
+        sparse_map<sparse_resource> map(8);
+        map.insert(1, sparse_resource(1));
+        map.insert(2, sparse_resource(2));
+        map.insert(3, sparse_resource(3));
+        ASSERT_EQ(3, sparse_resource::held);
+        map.erase(1);
+        ASSERT_EQ(2, sparse_resource::held);
+        map.erase(2);
+        ASSERT_EQ(1, sparse_resource::held);
+        map.insert(4, sparse_resource(4));
+        ASSERT_EQ(2, sparse_resource::held);
+        map.clear();
+        ASSERT_EQ(0, sparse_resource::held);
+        map.insert(5, sparse_resource(5));
+        ASSERT_EQ(1, sparse_resource::held);
+    }
+    ASSERT_EQ(0, sparse_resource::held);
+}
+
+TEST(sparse_set_test, test_allocation_failure) {
+    // the members, then no index
+    sparse_budget_allocator::budget = 1;
+    sparse_set<uint16_t, sparse_budget_allocator> empty(16);
+    ASSERT_EQ(0u, empty.universe());
+    ASSERT_FALSE(empty.insert(3));
+    ASSERT_FALSE(empty.contains(3));
+    sparse_budget_allocator::budget = 1;
+    ASSERT_TRUE(empty.insert(3));
+    ASSERT_TRUE(empty.contains(3));
+
+    // the members and the index, but no growth of the members
+    sparse_budget_allocator::budget = 2;
+    sparse_set<uint16_t, sparse_budget_allocator> set(32);
+    for (uint16_t k = 0; k < 12; ++k) {
+        ASSERT_TRUE(set.insert(k));
+    }
+    ASSERT_FALSE(set.insert(12));
+    ASSERT_FALSE(set.contains(12));
+    ASSERT_EQ(12u, set.size());
+}
+
+TEST(sparse_map_test, test_allocation_failure_keeps_step) {
+    // index, keys and values, then the values fail to grow or grow
+    // and the keys fail
+    for (int budget = 3; budget < 5; ++budget) {
+        sparse_budget_allocator::budget = budget;
+        sparse_map<int, uint16_t, sparse_budget_allocator> map(32);
+        for (uint16_t k = 0; k < 12; ++k) {
+            ASSERT_TRUE(map.insert(k, k * 10));
+        }
+        ASSERT_FALSE(map.insert(12, 120));
+        ASSERT_FALSE(map.contains(12));
+        ASSERT_EQ(12u, map.size());
+        ASSERT_TRUE(map.find_or_insert(100) == nullptr);
+        ASSERT_EQ(12u, map.size());
+        ASSERT_EQ(110, *map.find_or_insert(11));
+        ASSERT_TRUE(map.erase(11));
+        ASSERT_TRUE(map.insert(12, 120));
+        for (sparse_map<int>::size_type i = 0; i < map.size(); ++i) {
+            ASSERT_EQ(map.key_at(i) * 10, map.data()[i]);
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <wlib/stl/SpscQueue.h>
+
+using namespace wlp;
+
+struct queue_probe {
+    static int live;
+    int value;
+
+    queue_probe()
+            : value(0) {
+        ++live;
+    }
+
+    explicit queue_probe(int v)
+            : value(v) {
+        ++live;
+    }
+
+    queue_probe(const queue_probe &p)
+            : value(p.value) {
+        ++live;
+    }
+
+    queue_probe &operator=(const queue_probe &p) {
+        value = p.value;
+        return *this;
+    }
+
+    ~queue_probe() {
+        --live;
+    }
+};
+
+int queue_probe::live = 0;
+
+TEST(spsc_queue_test, test_capacity_rounds_up) {
+    spsc_queue<int> q(5);
+    ASSERT_EQ(8u, q.capacity());
+    ASSERT_TRUE(q.empty());
+    static_spsc_queue<int, 4> s;
+    ASSERT_EQ(4u, s.capacity());
+}
+
+TEST(spsc_queue_test, test_fifo_full_and_empty) {
+    spsc_queue<int> q(4);
+    int v = -1;
+    ASSERT_FALSE(q.pop(v));
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(q.push(round * 10 + i));
+        }
+        ASSERT_FALSE(q.push(99));
+        ASSERT_EQ(4u, q.size());
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(q.pop(v));
+            ASSERT_EQ(round * 10 + i, v);
+        }
+        ASSERT_FALSE(q.pop(v));
+    }
+}
+
+TEST(spsc_queue_test, test_batches) {
+    static_spsc_queue<int, 8> q;
+    int in[12];
+    int out[12];
+    for (int i = 0; i < 12; ++i) {
+        in[i] = i;
+    }
+    ASSERT_EQ(5u, q.push_n(in, 5));
+    ASSERT_EQ(3u, q.pop_n(out, 3));
+    ASSERT_EQ(2, out[2]);
+    ASSERT_EQ(6u, q.push_n(in + 5, 7));
+    ASSERT_EQ(0u, q.push_n(in, 1));
+    ASSERT_EQ(8u, q.pop_n(out, 12));
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(i + 3, out[i]);
+    }
+    ASSERT_EQ(0u, q.pop_n(out, 12));
+}
+
+TEST(spsc_queue_test, test_elements_destroyed) {
+    {
+        spsc_queue<queue_probe> q(4);
+        q.emplace(1);
+        q.push(queue_probe(2));
+        q.emplace(3);
+        queue_probe out;
+        ASSERT_TRUE(q.pop(out));
+        ASSERT_EQ(1, out.value);
+        ASSERT_EQ(3, queue_probe::live);
+    }
+    ASSERT_EQ(0, queue_probe::live);
+}
+
+TEST(spsc_queue_test, test_producer_consumer) {
+    const size_t n = 200000;
+    spsc_queue<size_t> q(64);
+    std::thread producer([&q]() {
+        size_t batch[7];
+        size_t next = 0;
+        while (next < n) {
+            if (next % 3 == 0) {
+                size_t k = 0;
+                for (; k < 7 && next + k < n; ++k) {
+                    batch[k] = next + k;
+                }
+                next += q.push_n(batch, k);
+            } else if (q.push(next)) {
+                ++next;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    size_t expect = 0;
+    size_t batch[5];
+    while (expect < n) {
+        size_t k = q.pop_n(batch, 5);
+        if (k == 0) {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < k; ++i) {
+            ASSERT_EQ(expect++, batch[i]);
+        }
+    }
+    producer.join();
+    ASSERT_TRUE(q.empty());
+}
@@ -0,0 +1,108 @@
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wlib/stl/ThreadCache.h>
+#include <wlib/stl/HashMap.h>
+
+using namespace wlp;
+
+TEST(thread_cache_test, test_size_classes) {
+    for (size_t size = 1; size <= __thread_cache::max_size; ++size) {
+        size_t c = __thread_cache::class_of(size);
+        ASSERT_GE(__thread_cache::class_size[c], size);
+        if (c > 0) {
+            ASSERT_LT(__thread_cache::class_size[c - 1], size);
+        }
+    }
+}
+
+TEST(thread_cache_test, test_alloc_free_reuse) {
+    void *p = thread_cache_alloc(40);
+    ASSERT_TRUE(p != nullptr);
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(p) % 16);
+    memset(p, 0xab, 40);
+    thread_cache_free(p, 40);
+    void *q = thread_cache_alloc(48);
+    ASSERT_EQ(p, q);
+    thread_cache_free(q, 48);
+
+    void *big = thread_cache_alloc(5000);
+    ASSERT_TRUE(big != nullptr);
+    memset(big, 0, 5000);
+    thread_cache_free(big, 5000);
+    thread_cache_free(nullptr, 16);
+}
+
+TEST(thread_cache_test, test_over_aligned_allocator) {
+    thread_cache_allocator alloc;
+    void *p = alloc.allocate(100, 64);
+    ASSERT_TRUE(p != nullptr);
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(p) % 64);
+    memset(p, 0xcd, 100);
+    void *q = alloc.allocate(100, 16);
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(q) % 16);
+    alloc.deallocate(q, 100, 16);
+    alloc.deallocate(p, 100, 64);
+    alloc.deallocate(nullptr, 100, 64);
+}
+
+TEST(thread_cache_test, test_many_blocks_are_distinct) {
+    const size_t n = 1000;
+    std::vector<char *> blocks;
+    for (size_t i = 0; i < n; ++i) {
+        char *b = static_cast<char *>(thread_cache_alloc(64));
+        memset(b, static_cast<int>(i & 0xff), 64);
+        blocks.push_back(b);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(static_cast<char>(i & 0xff), blocks[i][63]);
+    }
+    for (char *b : blocks) {
+        thread_cache_free(b, 64);
+    }
+}
+
+TEST(thread_cache_test, test_cross_thread_free) {
+    const size_t n = 5000;
+    std::vector<void *> blocks(n);
+    std::thread producer([&blocks]() {
+        for (size_t i = 0; i < n; ++i) {
+            blocks[i] = thread_cache_alloc(32);
+            *static_cast<size_t *>(blocks[i]) = i;
+        }
+    });
+    producer.join();
+    std::thread consumer([&blocks]() {
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(i, *static_cast<size_t *>(blocks[i]));
+            thread_cache_free(blocks[i], 32);
+        }
+    });
+    consumer.join();
+}
+
+TEST(thread_cache_test, test_concurrent_containers) {
+    const int threads = 4;
+    std::vector<std::thread> workers;
+    int failures = 0;
+    for (int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([t, &failures]() {
+            for (int round = 0; round < 20; ++round) {
+                hash_map<int, int, hash<int, uint16_t>, equals<int>, thread_cache_allocator> map;
+                for (int i = 0; i < 200; ++i) {
+                    map[i] = i * t;
+                }
+                for (int i = 0; i < 200; ++i) {
+                    if (map[i] != i * t) {
+                        __atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+                    }
+                }
+            }
+        }));
+    }
+    for (std::thread &w : workers) {
+        w.join();
+    }
+    ASSERT_EQ(0, failures);
+}
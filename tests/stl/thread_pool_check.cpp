@@ -0,0 +1,211 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wlib/stl/ThreadPool.h>
+
+using namespace wlp;
+
+struct pool_probe {
+    static int live;
+    int value;
+
+    explicit pool_probe(int v)
+            : value(v) {
+        ++live;
+    }
+
+    pool_probe(pool_probe &&p)
+            : value(p.value) {
+        ++live;
+    }
+
+    pool_probe(const pool_probe &p)
+            : value(p.value) {
+        ++live;
+    }
+
+    ~pool_probe() {
+        --live;
+    }
+
+    int operator()() {
+        return value;
+    }
+};
+
+int pool_probe::live = 0;
+
+/**
+ * Allocator that fails once a budget of allocations is spent.
+ */
+struct pool_budget_allocator {
+    static int budget;
+    static int live;
+
+    void *allocate(size_t size, size_t align) const {
+        if (budget == 0) {
+            return nullptr;
+        }
+        --budget;
+        ++live;
+        return allocator().allocate(size, align);
+    }
+
+    void deallocate(void *ptr, size_t size, size_t align) const {
+        --live;
+        allocator().deallocate(ptr, size, align);
+    }
+};
+
+int pool_budget_allocator::budget = 0;
+int pool_budget_allocator::live = 0;
+
+static int parallel_fib(thread_pool &pool, int n) {
+    if (n < 2) {
+        return n;
+    }
+    future<int> a = pool.spawn([&pool, n]() { return parallel_fib(pool, n - 1); });
+    int b = parallel_fib(pool, n - 2);
+    return a.get() + b;
+}
+
+static int invoke_fib(thread_pool &pool, int n) {
+    if (n < 2) {
+        return n;
+    }
+    int a = 0;
+    int b = 0;
+    pool.parallel_invoke([&]() { a = invoke_fib(pool, n - 1); },
+                         [&]() { b = invoke_fib(pool, n - 2); });
+    return a + b;
+}
+
+TEST(thread_pool_test, test_task_move_and_destroy) {
+    {
+        task t(pool_probe(3));
+        ASSERT_EQ(1, pool_probe::live);
+        task u(move(t));
+        ASSERT_FALSE(static_cast<bool>(t));
+        ASSERT_TRUE(static_cast<bool>(u));
+        ASSERT_EQ(1, pool_probe::live);
+        task v;
+        v = move(u);
+        ASSERT_EQ(1, pool_probe::live);
+        v();
+        v.reset();
+        ASSERT_EQ(0, pool_probe::live);
+        v = pool_probe(4);
+        ASSERT_EQ(1, pool_probe::live);
+    }
+    ASSERT_EQ(0, pool_probe::live);
+}
+
+TEST(thread_pool_test, test_submit_and_get) {
+    thread_pool pool(4);
+    ASSERT_EQ(4u, pool.size());
+    std::vector<future<int>> results;
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(pool.submit([i]() { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(results[static_cast<size_t>(i)].valid());
+        ASSERT_EQ(i * i, results[static_cast<size_t>(i)].get());
+    }
+    std::atomic<int> ran(0);
+    future<void> done = pool.submit([&ran]() { ++ran; });
+    done.wait();
+    ASSERT_TRUE(done.ready());
+    ASSERT_EQ(1, ran.load());
+}
+
+TEST(thread_pool_test, test_result_destroyed_with_future) {
+    {
+        thread_pool pool(2);
+        future<pool_probe> f = pool.submit([]() { return pool_probe(7); });
+        ASSERT_EQ(7, f.get().value);
+        pool.submit([]() { return pool_probe(8); }).wait();
+    }
+    ASSERT_EQ(0, pool_probe::live);
+}
+
+TEST(thread_pool_test, test_recursive_spawn) {
+    thread_pool pool(4, 64, 64);
+    future<int> f = pool.submit([&pool]() { return parallel_fib(pool, 18); });
+    ASSERT_EQ(2584, f.get());
+}
+
+TEST(thread_pool_test, test_parallel_invoke) {
+    thread_pool pool(3);
+    future<int> f = pool.submit([&pool]() { return invoke_fib(pool, 20); });
+    ASSERT_EQ(6765, f.get());
+    ASSERT_EQ(55, invoke_fib(pool, 10));
+    int calls[3] = {0, 0, 0};
+    pool.parallel_invoke([&]() { ++calls[0]; }, [&]() { ++calls[1]; }, [&]() { ++calls[2]; });
+    ASSERT_EQ(1, calls[0]);
+    ASSERT_EQ(1, calls[1]);
+    ASSERT_EQ(1, calls[2]);
+}
+
+TEST(thread_pool_test, test_more_tasks_than_jobs) {
+    thread_pool pool(2, 4, 4);
+    std::atomic<int> sum(0);
+    for (int i = 0; i < 1000; ++i) {
+        pool.submit([&sum, i]() { sum += i; });
+    }
+    while (sum.load() != 999 * 1000 / 2) {
+        std::this_thread::yield();
+    }
+}
+
+TEST(thread_pool_test, test_destruction_drains_queue) {
+    std::atomic<int> ran(0);
+    {
+        thread_pool pool(2);
+        for (int i = 0; i < 200; ++i) {
+            pool.submit([&ran, &pool]() {
+                ++ran;
+                pool.spawn([&ran]() { ++ran; });
+            });
+        }
+    }
+    ASSERT_EQ(400, ran.load());
+}
+
+TEST(thread_pool_test, test_current) {
+    thread_pool pool(1);
+    ASSERT_TRUE(thread_pool::current() == nullptr);
+    ASSERT_FALSE(pool.run_one());
+    future<thread_pool *> f = pool.submit([]() { return thread_pool::current(); });
+    ASSERT_EQ(&pool, f.get());
+}
+
+TEST(thread_pool_test, test_allocation_failure) {
+    pool_budget_allocator::budget = 0;
+    {
+        basic_thread_pool<pool_budget_allocator> pool(2, 8, 8);
+        ASSERT_EQ(0u, pool.size());
+        future<int> f = pool.submit([]() { return 1; });
+        ASSERT_FALSE(f.valid());
+        ASSERT_FALSE(pool.spawn([]() {}).valid());
+    }
+    for (int spent = 1; spent < 4; ++spent) {
+        pool_budget_allocator::budget = spent;
+        basic_thread_pool<pool_budget_allocator> pool(2, 4, 8);
+        ASSERT_EQ(0u, pool.size());
+        for (int i = 0; i < 20; ++i) {
+            future<int> f = pool.submit([i]() { return i * 2; });
+            ASSERT_TRUE(f.valid());
+            ASSERT_EQ(i * 2, f.get());
+        }
+    }
+    ASSERT_EQ(0, pool_budget_allocator::live);
+    pool_budget_allocator::budget = 4;
+    {
+        basic_thread_pool<pool_budget_allocator> pool(2, 4, 8);
+        ASSERT_EQ(2u, pool.size());
+        ASSERT_EQ(7, pool.submit([]() { return 7; }).get());
+    }
+    ASSERT_EQ(0, pool_budget_allocator::live);
+}
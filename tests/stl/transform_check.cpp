@@ -0,0 +1,164 @@
+#include <math.h>
+
+#include <gtest/gtest.h>
+#include <wlib/stl/Transform.h>
+
+using namespace wlp;
+
+typedef vector3d<float> vec3f;
+typedef vector4d<float> vec4f;
+
+static void expect_near(const vec3f &e, const vec3f &a, float tol = 1e-5f) {
+    ASSERT_NEAR(e.x(), a.x(), tol);
+    ASSERT_NEAR(e.y(), a.y(), tol);
+    ASSERT_NEAR(e.z(), a.z(), tol);
+}
+
+TEST(vector3d_test, test_operations) {
+    constexpr vector3d<int> a(1, 2, 3);
+    constexpr vector3d<int> b(4, 5, 6);
+    static_assert(a.dot(b) == 32, "constexpr dot");
+    static_assert((a + b).dot(vector3d<int>(0, 0, 1)) == 9, "constexpr add");
+    ASSERT_EQ(vector3d<int>(-3, 6, -3), a.cross(b));
+    ASSERT_EQ(vector3d<int>(2, 4, 6), a * 2);
+    ASSERT_EQ(14, a.norm_sq());
+    ASSERT_FLOAT_EQ(1.0f, vec3f(3, 4, 12).n().norm());
+    vector3d<double> c(a);
+    ASSERT_DOUBLE_EQ(3.0, c.z());
+}
+
+TEST(vector4d_test, test_operations) {
+    vec4f a(1, 2, 3, 4);
+    vec4f b(5, 6, 7, 8);
+    ASSERT_EQ(vec4f(6, 8, 10, 12), a + b);
+    ASSERT_EQ(vec4f(4, 4, 4, 4), b - a);
+    ASSERT_EQ(vec4f(5, 12, 21, 32), a * b);
+    ASSERT_EQ(vec4f(2, 4, 6, 8), a * 2);
+    ASSERT_FLOAT_EQ(70.0f, a.dot(b));
+    ASSERT_FLOAT_EQ(30.0f, a.norm_sq());
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(&a) % alignof(vec4f));
+    ASSERT_EQ(vec3f(1, 2, 3), a.xyz());
+    vector4d<int> c(vec3f(1, 2, 3), 1.0f);
+    ASSERT_EQ(vector4d<int>(1, 2, 3, 1), c);
+}
+
+TEST(mat3_test, test_multiply_and_inverse) {
+    mat3<double> m(
+        2, 0, 1,
+        1, 3, 0,
+        0, 1, 4);
+    ASSERT_DOUBLE_EQ(1.0, m(0, 2));
+    ASSERT_DOUBLE_EQ(1.0, m(1, 0));
+    ASSERT_EQ(vector3d<double>(3, 4, 5), m * vector3d<double>(1, 1, 1));
+    ASSERT_DOUBLE_EQ(25.0, m.determinant());
+    mat3<double> inv;
+    ASSERT_TRUE(m.inverse(inv));
+    mat3<double> id = m * inv;
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            ASSERT_NEAR(i == j ? 1.0 : 0.0, id(i, j), 1e-12);
+        }
+    }
+    ASSERT_EQ(m, m.transpose().transpose());
+    ASSERT_DOUBLE_EQ(1.0, m.transpose()(2, 0));
+    mat3<double> singular(1, 2, 3, 2, 4, 6, 0, 0, 1);
+    ASSERT_FALSE(singular.inverse(inv));
+}
+
+TEST(mat4_test, test_multiply_and_inverse) {
+    mat4<float> t = mat4<float>::translation(vec3f(1, 2, 3));
+    mat4<float> s = mat4<float>::scaling(vec3f(2, 2, 2));
+    mat4<float> ts = t * s;
+    expect_near(vec3f(3, 4, 5), ts.transform_point(vec3f(1, 1, 1)));
+    expect_near(vec3f(2, 2, 2), ts.transform_vector(vec3f(1, 1, 1)));
+    mat4<float> m(
+        1, 2, 0, 1,
+        0, 1, 3, 0,
+        2, 0, 1, 1,
+        0, 1, 0, 2);
+    mat4<float> naive;
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            for (size_t k = 0; k < 4; ++k) {
+                naive(i, j) += m(i, k) * ts(k, j);
+            }
+        }
+    }
+    ASSERT_EQ(naive, m * ts);
+    ASSERT_EQ(vec4f(4, 4, 4, 3), m * vec4f(1, 1, 1, 1));
+    mat4<float> inv;
+    ASSERT_TRUE(m.inverse(inv));
+    mat4<float> id = m * inv;
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            ASSERT_NEAR(i == j ? 1.0f : 0.0f, id(i, j), 1e-5f);
+        }
+    }
+    ASSERT_NEAR(m.determinant(), m.transpose().determinant(), 1e-4f);
+    ASSERT_FALSE(mat4<float>().inverse(inv));
+}
+
+TEST(quaternion_test, test_rotation) {
+    float half_pi = static_cast<float>(M_PI / 2);
+    quaternion<float> qz = quaternion<float>::from_axis_angle(vec3f(0, 0, 1), half_pi);
+    quaternion<float> qx = quaternion<float>::from_axis_angle(vec3f(1, 0, 0), half_pi);
+    expect_near(vec3f(0, 1, 0), qz.rotate(vec3f(1, 0, 0)));
+    quaternion<float> q = qx * qz;
+    expect_near(qx.rotate(qz.rotate(vec3f(1, 2, 3))), q.rotate(vec3f(1, 2, 3)));
+    expect_near(q.rotate(vec3f(1, 2, 3)), q.to_mat3() * vec3f(1, 2, 3));
+    expect_near(vec3f(1, 2, 3), (q * q.inverse()).rotate(vec3f(1, 2, 3)));
+    quaternion<double> a(1, 2, 3, 4);
+    quaternion<double> b(5, 6, 7, 8);
+    quaternion<double> ab = a * b;
+    ASSERT_DOUBLE_EQ(-60.0, ab.w());
+    ASSERT_DOUBLE_EQ(12.0, ab.x());
+    ASSERT_DOUBLE_EQ(30.0, ab.y());
+    ASSERT_DOUBLE_EQ(24.0, ab.z());
+    quaternion<float> fa(1, 2, 3, 4);
+    quaternion<float> fab = fa * quaternion<float>(5, 6, 7, 8);
+    ASSERT_FLOAT_EQ(-60.0f, fab.w());
+    ASSERT_FLOAT_EQ(24.0f, fab.z());
+    quaternion<float> mid = slerp(quaternion<float>(), qz, 0.5f);
+    expect_near(vec3f(static_cast<float>(M_SQRT1_2), static_cast<float>(M_SQRT1_2), 0), mid.rotate(vec3f(1, 0, 0)));
+}
+
+TEST(transform_test, test_batched_points) {
+    const size_t n = 23;
+    vec3f pts[n];
+    vec3f out[n];
+    for (size_t i = 0; i < n; ++i) {
+        pts[i] = vec3f(static_cast<float>(i), static_cast<float>(i % 3) - 1.0f, 0.5f * static_cast<float>(i));
+    }
+    quaternion<float> q = quaternion<float>::from_axis_angle(vec3f(0, 0.6f, 0.8f), 0.7f);
+    mat4<float> m = q.to_mat4(vec3f(1, -2, 3)) * mat4<float>::scaling(vec3f(2, 3, 4));
+    transform_points(m, pts, out, n);
+    for (size_t i = 0; i < n; ++i) {
+        expect_near(m.transform_point(pts[i]), out[i], 1e-4f);
+    }
+    transform_vectors(m, pts, out, n);
+    for (size_t i = 0; i < n; ++i) {
+        expect_near(m.transform_vector(pts[i]), out[i], 1e-4f);
+    }
+    rotate_points(q, pts, out, n);
+    for (size_t i = 0; i < n; ++i) {
+        expect_near(q.rotate(pts[i]), out[i], 1e-4f);
+    }
+    vec3f copy[n];
+    for (size_t i = 0; i < n; ++i) {
+        copy[i] = pts[i];
+    }
+    transform_points(m.linear(), copy, copy, n);
+    for (size_t i = 0; i < n; ++i) {
+        expect_near(m.linear() * pts[i], copy[i], 1e-4f);
+    }
+    vec4f h[5];
+    vec4f hout[5];
+    for (size_t i = 0; i < 5; ++i) {
+        h[i] = vec4f(pts[i], 1);
+    }
+    transform_points(m, h, hout, 5);
+    expect_near(m.transform_point(pts[4]), hout[4].xyz(), 1e-4f);
+    vector3d<double> dp[3] = {vector3d<double>(1, 0, 0), vector3d<double>(0, 1, 0), vector3d<double>(0, 0, 1)};
+    transform_points(mat4<double>::translation(vector3d<double>(1, 1, 1)), dp, dp, 3);
+    ASSERT_EQ(vector3d<double>(1, 2, 1), dp[1]);
+}
@@ -60,3 +60,21 @@ TEST(tree_map, test_iterator_get_key) {
     }
     ASSERT_EQ(0, sum);
 }
+
+TEST(tree_map, test_moved_keys_keep_order) {
+    tree_map<dynamic_string, int> map;
+    const char *keys[] = {"m", "c", "x", "a", "e", "t", "z", "b"};
+    for (int i = 0; i < 8; ++i) {
+        map[dynamic_string(keys[i])] = i;
+    }
+    ASSERT_EQ(8u, map.size());
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(map.contains(dynamic_string(keys[i])));
+        ASSERT_EQ(i, map.at(dynamic_string(keys[i])));
+    }
+    dynamic_string prev("");
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        ASSERT_TRUE(prev < it.key());
+        prev = it.key();
+    }
+}
@@ -1,4 +1,7 @@
+#include <stdlib.h>
+
 #include <gtest/gtest.h>
+#include <wlib/stl/Allocator.h>
 #include <wlib/stl/UniquePtr.h>
 
 using namespace wlp;
@@ -144,3 +147,102 @@ TEST(unique_ptr_test, test_comparison_operators) {
     l_first_ptr.release();
     destroy<uint32_t>(twice16);
 }
+
+struct __CountingPool {
+    int *allocs;
+    int *frees;
+
+    void *allocate(size_t size, size_t) {
+        ++*allocs;
+        return malloc(size);
+    }
+
+    void deallocate(void *ptr, size_t, size_t) {
+        ++*frees;
+        free(ptr);
+    }
+};
+
+struct __RecordingDeleter {
+    int *calls;
+
+    void operator()(__TestObject *ptr) {
+        ++*calls;
+        destroy<__TestObject>(ptr);
+    }
+};
+
+TEST(unique_ptr_test, test_stateless_deleter_adds_no_size) {
+    static_assert(sizeof(unique_ptr<int>) == sizeof(int *), "default deleter must take no space");
+    static_assert(sizeof(unique_ptr<int[]>) == sizeof(int *), "default deleter must take no space");
+    static_assert(sizeof(unique_ptr<int, arena_delete<int>>) == sizeof(int *), "arena deleter must take no space");
+    static_assert(sizeof(unique_ptr<int, allocator_delete<int, allocator>>) == sizeof(int *),
+                  "deleter over a stateless allocator must take no space");
+    static_assert(sizeof(unique_ptr<int, __RecordingDeleter>) == 2 * sizeof(int *),
+                  "stateful deleter is stored");
+}
+
+TEST(unique_ptr_test, test_stateful_deleter) {
+    __reset_test();
+    int calls = 0;
+    typedef unique_ptr<__TestObject, __RecordingDeleter> rptr;
+    rptr p1(create<__TestObject>(1), __RecordingDeleter{&calls});
+    rptr p2(move(p1));
+    ASSERT_FALSE(p1);
+    ASSERT_EQ(&calls, p2.get_deleter().calls);
+    p2.reset(create<__TestObject>(2));
+    ASSERT_EQ(1, calls);
+    p2 = nullptr;
+    ASSERT_EQ(2, calls);
+    ASSERT_EQ(2, __deconstructs);
+}
+
+TEST(unique_ptr_test, test_allocate_unique_returns_to_pool) {
+    __reset_test();
+    int allocs = 0;
+    int frees = 0;
+    __CountingPool pool{&allocs, &frees};
+    {
+        auto p = allocate_unique<__TestObject>(pool, 7);
+        ASSERT_EQ(7, p->value);
+        ASSERT_EQ(1, allocs);
+        auto arr = allocate_unique<__TestObject[]>(pool, 4);
+        ASSERT_EQ(4u, arr.get_deleter().count());
+        arr[3].value = 3;
+        ASSERT_EQ(5, __constructs);
+        ASSERT_EQ(0, frees);
+    }
+    ASSERT_EQ(2, allocs);
+    ASSERT_EQ(2, frees);
+    ASSERT_EQ(5, __deconstructs);
+}
+
+TEST(unique_ptr_test, test_arena_delete_only_destroys) {
+    __reset_test();
+    alignas(__TestObject) unsigned char buffer[3 * sizeof(__TestObject)];
+    {
+        unique_ptr<__TestObject, arena_delete<__TestObject>> p(new (buffer) __TestObject(1));
+        __TestObject *arr = reinterpret_cast<__TestObject *>(buffer + sizeof(__TestObject));
+        new (arr) __TestObject(2);
+        new (arr + 1) __TestObject(3);
+        unique_ptr<__TestObject[], arena_delete<__TestObject[]>> a(arr, arena_delete<__TestObject[]>(2));
+        ASSERT_EQ(3, a[1].value);
+    }
+    ASSERT_EQ(3, __deconstructs);
+}
+
+struct __Base {
+    virtual ~__Base() { ++__deconstructs; }
+};
+
+struct __Derived : public __Base {};
+
+TEST(unique_ptr_test, test_converting_move) {
+    __reset_test();
+    unique_ptr<__Derived> d(create<__Derived>());
+    unique_ptr<__Base> b(move(d));
+    ASSERT_FALSE(d);
+    ASSERT_TRUE(b);
+    b.reset();
+    ASSERT_EQ(1, __deconstructs);
+}
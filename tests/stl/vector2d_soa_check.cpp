@@ -0,0 +1,117 @@
+#include <math.h>
+
+#include <gtest/gtest.h>
+#include <wlib/stl/Vector2DSoA.h>
+
+using namespace wlp;
+
+typedef vector2d_soa<float> soa_t;
+typedef vector2d<float> vec_t;
+
+static void fill_points(soa_t &soa, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        soa.push_back(static_cast<float>(i % 7) - 3.0f, static_cast<float>(i % 5) * 0.5f);
+    }
+}
+
+TEST(vector2d_soa_test, test_push_and_convert) {
+    array_list<vec_t> list;
+    for (int i = 0; i < 20; ++i) {
+        list.push_back(vec_t(static_cast<float>(i), static_cast<float>(-i)));
+    }
+    soa_t soa(list);
+    ASSERT_EQ(20u, soa.size());
+    ASSERT_EQ(7.0f, soa.x(7));
+    ASSERT_EQ(-7.0f, soa.y(7));
+    ASSERT_EQ(-3.0f, soa.get(3).y());
+    soa.push_back(vec_t(100.0f, 200.0f));
+    ASSERT_EQ(21u, soa.size());
+    ASSERT_EQ(19.0f, soa.x(19));
+    ASSERT_EQ(-19.0f, soa.y(19));
+    array_list<vec_t> out;
+    soa.to_list(out);
+    ASSERT_EQ(21u, out.size());
+    ASSERT_EQ(200.0f, out[20].y());
+    ASSERT_EQ(-5.0f, out[5].y());
+    soa_t moved(move(soa));
+    ASSERT_EQ(21u, moved.size());
+    ASSERT_TRUE(soa.empty());
+}
+
+TEST(vector2d_soa_test, test_add_scale_dot) {
+    soa_t a(0);
+    soa_t b(0);
+    fill_points(a, 37);
+    fill_points(b, 37);
+    soa_t out;
+    ASSERT_TRUE(add(a, b, out));
+    ASSERT_EQ(37u, out.size());
+    for (size_t i = 0; i < 37; ++i) {
+        ASSERT_FLOAT_EQ(2 * a.x(i), out.x(i));
+        ASSERT_FLOAT_EQ(2 * a.y(i), out.y(i));
+    }
+    scale(a, 3.0f, out);
+    ASSERT_FLOAT_EQ(3 * a.y(36), out.y(36));
+    float dots[37];
+    ASSERT_TRUE(dot(a, b, dots));
+    for (size_t i = 0; i < 37; ++i) {
+        ASSERT_FLOAT_EQ(a.get(i).dot(b.get(i)), dots[i]);
+    }
+    soa_t shorter;
+    fill_points(shorter, 3);
+    ASSERT_FALSE(add(a, shorter, out));
+}
+
+TEST(vector2d_soa_test, test_norm_normalize) {
+    soa_t a;
+    fill_points(a, 29);
+    float norms[29];
+    norm(a, norms);
+    for (size_t i = 0; i < 29; ++i) {
+        ASSERT_NEAR(sqrt(a.get(i).norm_sq()), norms[i], 1e-5);
+    }
+    soa_t unit;
+    normalize(a, unit);
+    for (size_t i = 0; i < 29; ++i) {
+        if (norms[i] == 0.0f) {
+            ASSERT_EQ(0.0f, unit.x(i));
+            ASSERT_EQ(0.0f, unit.y(i));
+        } else {
+            ASSERT_NEAR(1.0f, unit.get(i).norm_sq(), 1e-5);
+            ASSERT_NEAR(a.x(i) / norms[i], unit.x(i), 1e-5);
+        }
+    }
+}
+
+TEST(vector2d_soa_test, test_rotate_distance) {
+    vector2d_soa<double> a;
+    for (int i = 0; i < 11; ++i) {
+        a.push_back(static_cast<double>(i), 1.0);
+    }
+    vector2d_soa<double> r;
+    rotate(a, M_PI / 2, r);
+    for (size_t i = 0; i < 11; ++i) {
+        ASSERT_NEAR(-1.0, r.x(i), 1e-12);
+        ASSERT_NEAR(static_cast<double>(i), r.y(i), 1e-12);
+    }
+    double d[11];
+    distance(a, vector2d<double>(0.0, 1.0), d);
+    for (size_t i = 0; i < 11; ++i) {
+        ASSERT_DOUBLE_EQ(static_cast<double>(i), d[i]);
+    }
+}
+
+TEST(vector2d_soa_test, test_reserve_overflow_keeps_contents) {
+    soa_t soa;
+    fill_points(soa, 10);
+    size_t cap = soa.capacity();
+    ASSERT_FALSE(soa.reserve(static_cast<size_t>(-1) / 2 + 1));
+    ASSERT_FALSE(soa.resize(static_cast<size_t>(-1)));
+    ASSERT_EQ(10u, soa.size());
+    ASSERT_EQ(cap, soa.capacity());
+    ASSERT_EQ(-3.0f, soa.x(0));
+    ASSERT_EQ(1.5f, soa.y(8));
+    ASSERT_TRUE(soa.reserve(64));
+    ASSERT_EQ(10u, soa.size());
+    ASSERT_EQ(1.5f, soa.y(8));
+}
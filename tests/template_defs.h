@@ -104,11 +104,21 @@ namespace wlp {
     template
     class unique_ptr<int>;
 
+    template
+    class unique_ptr<int[]>;
+
+    template
+    class unique_ptr<int, allocator_delete<int, allocator>>;
+
 
     template class shared_ptr<int>;
 
     template class weak_ptr<int>;
 
+    template class shared_ptr<int, atomic_count<uint32_t>>;
+
+    template class weak_ptr<int, atomic_count<uint32_t>>;
+
 }
 
 #endif // TEMPLATE_DEFS_H